@@ -0,0 +1,92 @@
+#include "bench.hpp"
+#include "utility/shared_ptr.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr size_t reads_per_thread = 200'000;
+
+struct config {
+    int version;
+    int limits[15];
+};
+
+// 读者扩展性：threads 个读者各自反复取得当前配置的快照并读取，一个写者每 100us 替换一次配置。
+// 报告平均每次读取的耗时（总耗时 / 总读取次数）
+template <typename Holder>
+auto readers(const char *name, size_t threads) -> void {
+    auto label = std::string(name) + " readers=" + std::to_string(threads);
+    auto h = Holder();
+    bench::run(label.c_str(), reads_per_thread * threads, [&] {
+        auto stop = std::atomic<bool>(false);
+        auto writer = std::thread([&] {
+            for (auto v = 0; !stop.load(std::memory_order_relaxed); ++v) {
+                h.store(v);
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        });
+        auto ts = std::vector<std::thread>();
+        for (auto t = size_t{0}; t < threads; ++t) {
+            ts.emplace_back([&] {
+                auto sum = 0;
+                for (auto i = size_t{0}; i < reads_per_thread; ++i) {
+                    sum += h.version();
+                }
+                bench::do_not_optimize(sum);
+            });
+        }
+        for (auto &t : ts) {
+            t.join();
+        }
+        stop = true;
+        writer.join();
+    });
+}
+
+// 对照组：全局互斥锁保护的 mtl::shared_ptr，读者在锁内复制
+struct locked_holder {
+    auto store(int v) -> void {
+        auto p = mtl::shared_ptr<config>(new config{v, {}});
+        auto lock = std::lock_guard(m);
+        s.swap(p);
+    }
+
+    auto version() -> int {
+        auto lock = std::unique_lock(m);
+        auto p = s;
+        lock.unlock();
+        return p->version;
+    }
+
+    std::mutex m;
+    mtl::shared_ptr<config> s{new config{}};
+};
+
+struct std_atomic_holder {
+    auto store(int v) -> void { s.store(std::make_shared<config>(config{v, {}})); }
+
+    auto version() -> int { return s.load()->version; }
+
+    std::atomic<std::shared_ptr<config>> s{std::make_shared<config>()};
+};
+
+struct mtl_atomic_holder {
+    auto store(int v) -> void { s.store(mtl::shared_ptr<config>(new config{v, {}})); }
+
+    auto version() -> int { return s.load()->version; }
+
+    mtl::atomic_shared_ptr<config> s{mtl::shared_ptr<config>(new config{})};
+};
+
+auto main() -> int {
+    std::printf("std::atomic<std::shared_ptr> lock free: %d, mtl::atomic_shared_ptr lock free: %d\n", std::atomic<std::shared_ptr<config>>::is_always_lock_free,
+                mtl::atomic_shared_ptr<config>::is_always_lock_free);
+    for (auto threads = size_t{1}; threads <= 64; threads *= 2) {
+        readers<locked_holder>("mutex + mtl::shared_ptr", threads);
+        readers<std_atomic_holder>("std::atomic<std::shared_ptr>", threads);
+        readers<mtl_atomic_holder>("mtl::atomic_shared_ptr", threads);
+    }
+}
@@ -0,0 +1,35 @@
+/*
+    基准测试的计时与输出工具
+*/
+#pragma once
+#include <chrono>
+#include <cstdio>
+
+namespace bench {
+    // 阻止编译器优化掉 v 的计算
+    template <typename T>
+    inline auto do_not_optimize(const T &v) -> void {
+        asm volatile("" : : "r,m"(v) : "memory");
+    }
+
+    // 执行 f，返回耗时（纳秒）
+    template <typename F>
+    auto time_ns(F &&f) -> double {
+        auto beg = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - beg).count();
+    }
+
+    // 输出单项结果：名称、操作次数、单次耗时、吞吐
+    inline auto report(const char *name, size_t ops, double ns) -> void {
+        std::printf("%-48s %12zu ops %10.2f ns/op %10.2f Mops/s\n", name, ops, ns / ops, ops / ns * 1e3);
+    }
+
+    // 执行 f 并输出结果，f 内部共执行 ops 次操作
+    template <typename F>
+    auto run(const char *name, size_t ops, F &&f) -> void {
+        f(); // 预热
+        report(name, ops, time_ns(f));
+    }
+} // namespace bench
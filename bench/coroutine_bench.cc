@@ -0,0 +1,73 @@
+#include "bench.hpp"
+#include "concurrency/thread_pool.hpp"
+#include "coroutine/generator.hpp"
+#include "coroutine/task.hpp"
+#include <vector>
+
+constexpr size_t n = 10'000'000;
+
+[[gnu::noinline]] auto plain_add(size_t x) -> size_t { return x + 1; }
+
+[[gnu::noinline]] auto task_add(size_t x) -> mtl::task<size_t> { co_return x + 1; }
+
+// 每次 co_await 都创建一个新协程：分配帧、在 await_suspend 中执行、同步结束后返回 false 继续、销毁帧
+auto task_loop() -> mtl::task<size_t> {
+    auto sum = size_t{0};
+    for (auto i = size_t{0}; i < n; ++i) {
+        sum += co_await task_add(i);
+    }
+    co_return sum;
+}
+
+auto counter() -> mtl::generator<size_t> {
+    for (auto i = size_t{0};; ++i) {
+        co_yield i;
+    }
+}
+
+// 每次 co_await schedule 都把协程提交给线程池再恢复
+auto hop(mtl::thread_pool &pool, size_t rounds) -> mtl::task<> {
+    for (auto i = size_t{0}; i < rounds; ++i) {
+        co_await mtl::schedule(pool);
+    }
+}
+
+auto main() -> int {
+    bench::run("plain function call", n, [] {
+        auto sum = size_t{0};
+        for (auto i = size_t{0}; i < n; ++i) {
+            sum += plain_add(i);
+        }
+        bench::do_not_optimize(sum);
+    });
+    bench::run("mtl::task create + co_await", n, [] { bench::do_not_optimize(mtl::sync_wait(task_loop())); });
+
+    // 帧大小的分配与释放，对比 _frame_pool 与 ::operator new
+    bench::run("::operator new frame 128B", n, [] {
+        for (auto i = size_t{0}; i < n; ++i) {
+            auto p = ::operator new(128);
+            bench::do_not_optimize(p);
+            ::operator delete(p, 128);
+        }
+    });
+    bench::run("mtl::_frame_pool frame 128B", n, [] {
+        for (auto i = size_t{0}; i < n; ++i) {
+            auto p = mtl::_frame_pool::allocate(128);
+            bench::do_not_optimize(p);
+            mtl::_frame_pool::deallocate(p, 128);
+        }
+    });
+
+    bench::run("mtl::generator resume", n, [] {
+        auto sum = size_t{0};
+        auto g = counter();
+        auto it = g.begin();
+        for (auto i = size_t{0}; i < n; ++i, ++it) {
+            sum += *it;
+        }
+        bench::do_not_optimize(sum);
+    });
+
+    auto pool = mtl::thread_pool(1);
+    bench::run("mtl::schedule onto thread_pool", n / 10, [&] { mtl::sync_wait(hop(pool, n / 10)); });
+}
@@ -0,0 +1,49 @@
+#include "bench.hpp"
+#include "container/eytzinger.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+
+constexpr size_t lookups = 2'000'000;
+
+// 键为 0, 2, 4, ...，查询键均匀随机，命中与不命中各约一半
+auto run_size(size_t n) -> void {
+    auto sorted = mtl::vector<int>();
+    sorted.reserve_exact(n);
+    for (auto i = size_t{0}; i < n; ++i) {
+        sorted.unchecked_push_back(static_cast<int>(i * 2));
+    }
+    auto rng = std::mt19937(static_cast<unsigned>(n));
+    auto probes = mtl::vector<int>();
+    probes.reserve_exact(lookups);
+    for (auto i = size_t{0}; i < lookups; ++i) {
+        probes.unchecked_push_back(static_cast<int>(rng() % (n * 2)));
+    }
+    auto set = mtl::eytzinger_set<int>(sorted.begin(), sorted.end());
+
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "std::lower_bound %zu", n);
+    bench::run(buf, lookups, [&] {
+        auto sum = 0l;
+        for (auto k : probes) {
+            sum += *std::lower_bound(sorted.begin(), sorted.end(), k);
+        }
+        bench::do_not_optimize(sum);
+    });
+    std::snprintf(buf, sizeof(buf), "mtl::eytzinger_set %zu", n);
+    bench::run(buf, lookups, [&] {
+        auto sum = 0l;
+        for (auto k : probes) {
+            sum += *set.lower_bound(k);
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+// 可以通过第一个参数限制最大规模
+auto main(int argc, char *argv[]) -> int {
+    auto max_n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000'000ull;
+    for (auto n = size_t{1'000}; n <= max_n; n *= 10) {
+        run_size(n);
+    }
+}
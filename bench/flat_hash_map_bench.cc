@@ -0,0 +1,60 @@
+#include "bench.hpp"
+#include "container/flat_hash_map.hpp"
+#include "container/vector.hpp"
+#include <random>
+#include <unordered_map>
+
+// 随机 64 位键，查找时一半命中一半不命中
+auto make_keys(size_t n) -> mtl::vector<uint64_t> {
+    auto rng = std::mt19937_64(n);
+    auto keys = mtl::vector<uint64_t>();
+    keys.reserve_exact(n * 2);
+    for (auto i = size_t{0}; i < n * 2; ++i) {
+        keys.push_back(rng());
+    }
+    return keys;
+}
+
+template <typename Map>
+auto run_size(const char *name, size_t n) -> void {
+    auto keys = make_keys(n);
+    char buf[96];
+
+    std::snprintf(buf, sizeof(buf), "%s insert %zu", name, n);
+    bench::run(buf, n, [&] {
+        auto m = Map();
+        for (auto i = size_t{0}; i < n; ++i) {
+            m[keys[i]] = i;
+        }
+        bench::do_not_optimize(m.size());
+    });
+
+    auto m = Map();
+    for (auto i = size_t{0}; i < n; ++i) {
+        m[keys[i]] = i;
+    }
+    std::snprintf(buf, sizeof(buf), "%s find %zu", name, n);
+    bench::run(buf, n * 2, [&] {
+        auto hit = size_t{0};
+        for (auto k : keys) {
+            hit += m.find(k) != m.end();
+        }
+        bench::do_not_optimize(hit);
+    });
+
+    std::snprintf(buf, sizeof(buf), "%s erase %zu", name, n);
+    bench::run(buf, n, [&] {
+        auto c = m;
+        for (auto i = size_t{0}; i < n; ++i) {
+            c.erase(keys[i]);
+        }
+        bench::do_not_optimize(c.size());
+    });
+}
+
+auto main() -> int {
+    for (auto n : {size_t{1'000}, size_t{100'000}, size_t{1'000'000}, size_t{10'000'000}}) {
+        run_size<std::unordered_map<uint64_t, uint64_t>>("std::unordered_map", n);
+        run_size<mtl::flat_hash_map<uint64_t, uint64_t>>("mtl::flat_hash_map", n);
+    }
+}
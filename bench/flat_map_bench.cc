@@ -0,0 +1,68 @@
+#include "bench.hpp"
+#include "container/flat_map.hpp"
+#include <algorithm>
+#include <map>
+#include <random>
+
+constexpr size_t n = 100'000;
+constexpr size_t lookups = 1'000'000;
+
+auto make_pairs() -> mtl::vector<mtl::pair<int, int>> {
+    auto rng = std::mt19937(42);
+    auto v = mtl::vector<mtl::pair<int, int>>();
+    for (auto i = size_t{0}; i < n; ++i) {
+        v.push_back({static_cast<int>(rng()), static_cast<int>(i)});
+    }
+    return v;
+}
+
+auto main() -> int {
+    auto pairs = make_pairs();
+    auto probes = mtl::vector<int>();
+    auto rng = std::mt19937(7);
+    for (auto i = size_t{0}; i < lookups; ++i) {
+        probes.push_back(pairs[rng() % n].first);
+    }
+
+    bench::run("std::map insert range", n, [&] {
+        auto m = std::map<int, int>();
+        for (auto &p : pairs) {
+            m.insert({p.first, p.second});
+        }
+        bench::do_not_optimize(m.size());
+    });
+    bench::run("mtl::flat_map insert range", n, [&] {
+        auto m = mtl::flat_map<int, int>();
+        m.insert(pairs.begin(), pairs.end());
+        bench::do_not_optimize(m.size());
+    });
+
+    auto sm = std::map<int, int>();
+    for (auto &p : pairs) {
+        sm.insert({p.first, p.second});
+    }
+    auto fm = mtl::flat_map<int, int>(pairs.begin(), pairs.end());
+
+    bench::run("std::map find", lookups, [&] {
+        auto sum = 0l;
+        for (auto k : probes) {
+            sum += sm.find(k)->second;
+        }
+        bench::do_not_optimize(sum);
+    });
+    bench::run("mtl::flat_map find", lookups, [&] {
+        auto sum = 0l;
+        for (auto k : probes) {
+            sum += fm.find(k)->second;
+        }
+        bench::do_not_optimize(sum);
+    });
+    bench::run("std::lower_bound on keys", lookups, [&] {
+        auto sum = 0l;
+        auto &keys = fm.keys();
+        for (auto k : probes) {
+            sum += std::lower_bound(keys.begin(), keys.end(), k) - keys.begin();
+        }
+        bench::do_not_optimize(sum);
+    });
+}
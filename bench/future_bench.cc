@@ -0,0 +1,77 @@
+#include "bench.hpp"
+#include "concurrency/future.hpp"
+#include <future>
+#include <thread>
+#include <vector>
+
+constexpr size_t n = 1'000'000;
+constexpr size_t rounds = 100'000;
+
+// 往返延迟：主线程设置第 i 个请求，对端线程等到后设置第 i 个应答，主线程再等到应答。
+// 每轮包含两次跨线程的唤醒，future 与 promise 预先创建，不计入分配
+template <template <typename> typename Promise, template <typename> typename Future>
+auto ping_pong() -> void {
+    auto req = std::vector<Promise<int>>(rounds);
+    auto rep = std::vector<Promise<int>>(rounds);
+    auto req_f = std::vector<Future<int>>();
+    auto rep_f = std::vector<Future<int>>();
+    for (auto i = size_t{0}; i < rounds; ++i) {
+        req_f.push_back(req[i].get_future());
+        rep_f.push_back(rep[i].get_future());
+    }
+    auto peer = std::thread([&] {
+        for (auto i = size_t{0}; i < rounds; ++i) {
+            rep[i].set_value(req_f[i].get() + 1);
+        }
+    });
+    auto sum = 0;
+    for (auto i = size_t{0}; i < rounds; ++i) {
+        req[i].set_value(static_cast<int>(i));
+        sum += rep_f[i].get();
+    }
+    peer.join();
+    bench::do_not_optimize(sum);
+}
+
+auto main() -> int {
+    // 单线程：创建共享状态、设置、取出，主要是分配与原子操作的开销
+    bench::run("std::promise set + get", n, [] {
+        for (auto i = size_t{0}; i < n; ++i) {
+            auto p = std::promise<int>();
+            auto f = p.get_future();
+            p.set_value(static_cast<int>(i));
+            bench::do_not_optimize(f.get());
+        }
+    });
+    bench::run("mtl::promise set + get", n, [] {
+        for (auto i = size_t{0}; i < n; ++i) {
+            auto p = mtl::promise<int>();
+            auto f = p.get_future();
+            p.set_value(static_cast<int>(i));
+            bench::do_not_optimize(f.get());
+        }
+    });
+
+    // 续延：std::future 没有 then，对照组是在 get 之后直接调用
+    bench::run("std::promise set + get + call x3", n, [] {
+        for (auto i = size_t{0}; i < n; ++i) {
+            auto p = std::promise<int>();
+            auto f = p.get_future();
+            p.set_value(static_cast<int>(i));
+            auto f1 = [](int x) { return x + 1; };
+            bench::do_not_optimize(f1(f1(f1(f.get()))));
+        }
+    });
+    bench::run("mtl::promise then x3 + set + get", n, [] {
+        for (auto i = size_t{0}; i < n; ++i) {
+            auto p = mtl::promise<int>();
+            auto f1 = [](int x) { return x + 1; };
+            auto f = p.get_future().then(f1).then(f1).then(f1);
+            p.set_value(static_cast<int>(i));
+            bench::do_not_optimize(f.get());
+        }
+    });
+
+    bench::run("std::future round trip", rounds, [] { ping_pong<std::promise, std::future>(); });
+    bench::run("mtl::future round trip", rounds, [] { ping_pong<mtl::promise, mtl::future>(); });
+}
@@ -0,0 +1,168 @@
+#include "bench.hpp"
+#include "concurrency/hazard_pointer.hpp"
+#include "utility/shared_ptr.hpp"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr int list_size = 32;
+constexpr size_t lookups_per_thread = 200'000;
+
+// 链表的节点只会被唯一的写者替换：先在旧节点的 next 上做删除标记，再从前驱摘下，最后退休。
+// 读者交替使用两个危险指针逐个保护节点，读到带标记的 next 说明节点已被删除，从头重新查找
+struct hp_node : mtl::hazard_pointer_obj_base<hp_node> {
+    hp_node(int k, long long v) : key(k), value(v) {}
+
+    int key;
+    long long value;
+    std::atomic<hp_node *> next{nullptr};
+};
+
+auto is_marked(hp_node *p) -> bool { return reinterpret_cast<uintptr_t>(p) & 1; }
+
+auto mark(hp_node *p) -> hp_node * { return reinterpret_cast<hp_node *>(reinterpret_cast<uintptr_t>(p) | 1); }
+
+struct hp_list {
+    hp_list() {
+        for (auto k = list_size - 1; k >= 0; --k) {
+            auto n = new hp_node(k, k);
+            n->next.store(head.load());
+            head.store(n);
+        }
+    }
+
+    ~hp_list() {
+        for (auto n = head.load(); n;) {
+            delete std::exchange(n, n->next.load());
+        }
+    }
+
+    auto find(int key) -> long long {
+        auto h0 = mtl::make_hazard_pointer();
+        auto h1 = mtl::make_hazard_pointer();
+    retry:
+        auto cur = h1.protect(head);
+        while (cur) {
+            auto next = h0.protect(cur->next);
+            if (is_marked(next)) {
+                goto retry;
+            }
+            if (cur->key == key) {
+                return cur->value;
+            }
+            h0.swap(h1);
+            cur = next;
+        }
+        return -1;
+    }
+
+    auto replace(int key) -> void {
+        auto link = &head;
+        auto cur = head.load();
+        while (cur->key != key) {
+            link = &cur->next;
+            cur = cur->next.load();
+        }
+        auto n = new hp_node(key, cur->value + 1);
+        auto next = cur->next.load();
+        n->next.store(next);
+        cur->next.store(mark(next));
+        link->store(n);
+        cur->retire();
+    }
+
+    std::atomic<hp_node *> head{nullptr};
+};
+
+// 对照组：每个 next 都是 atomic_shared_ptr，读者沿途复制 shared_ptr
+struct sp_node {
+    sp_node(int k, long long v) : key(k), value(v) {}
+
+    int key;
+    long long value;
+    mtl::atomic_shared_ptr<sp_node> next;
+};
+
+struct sp_list {
+    sp_list() {
+        for (auto k = list_size - 1; k >= 0; --k) {
+            auto n = mtl::shared_ptr<sp_node>(new sp_node(k, k));
+            n->next.store(head.load());
+            head.store(n);
+        }
+    }
+
+    ~sp_list() {
+        // 逐个断开，避免长链表递归析构
+        auto n = head.exchange(mtl::shared_ptr<sp_node>());
+        while (n) {
+            n = n->next.exchange(mtl::shared_ptr<sp_node>());
+        }
+    }
+
+    auto find(int key) -> long long {
+        for (auto cur = head.load(); cur; cur = cur->next.load()) {
+            if (cur->key == key) {
+                return cur->value;
+            }
+        }
+        return -1;
+    }
+
+    auto replace(int key) -> void {
+        auto link = &head;
+        auto cur = head.load();
+        while (cur->key != key) {
+            link = &cur->next;
+            cur = cur->next.load();
+        }
+        auto n = mtl::shared_ptr<sp_node>(new sp_node(key, cur->value + 1));
+        n->next.store(cur->next.load());
+        link->store(n);
+    }
+
+    mtl::atomic_shared_ptr<sp_node> head;
+};
+
+// threads 个读者各自查找 lookups_per_thread 次，平均每次经过 list_size / 2 个节点；
+// 一个写者每 50us 替换一个随机节点。报告平均每次查找的耗时
+template <typename List>
+auto readers(const char *name, size_t threads) -> void {
+    auto label = std::string(name) + " readers=" + std::to_string(threads);
+    auto list = List();
+    bench::run(label.c_str(), lookups_per_thread * threads, [&] {
+        auto stop = std::atomic<bool>(false);
+        auto writer = std::thread([&] {
+            auto rng = std::mt19937(7);
+            while (!stop.load(std::memory_order_relaxed)) {
+                list.replace(static_cast<int>(rng() % list_size));
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        });
+        auto ts = std::vector<std::thread>();
+        for (auto t = size_t{0}; t < threads; ++t) {
+            ts.emplace_back([&] {
+                auto sum = 0LL;
+                for (auto i = size_t{0}; i < lookups_per_thread; ++i) {
+                    sum += list.find(static_cast<int>(i % list_size));
+                }
+                bench::do_not_optimize(sum);
+            });
+        }
+        for (auto &t : ts) {
+            t.join();
+        }
+        stop = true;
+        writer.join();
+    });
+}
+
+auto main() -> int {
+    for (auto threads = size_t{1}; threads <= 4; threads *= 2) {
+        readers<sp_list>("mtl::atomic_shared_ptr list", threads);
+        readers<hp_list>("mtl::hazard_pointer list", threads);
+    }
+    mtl::hazard_pointer_default_domain().cleanup();
+}
@@ -0,0 +1,73 @@
+#include "bench.hpp"
+#include "utility/intrusive_ptr.hpp"
+#include "utility/shared_ptr.hpp"
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+constexpr size_t n = 10'000'000;
+constexpr size_t objects = 1'000'000;
+
+struct shared_node {
+    long long value;
+};
+
+struct atomic_node : mtl::intrusive_ref_counter<atomic_node> {
+    long long value;
+};
+
+struct plain_node : mtl::intrusive_ref_counter<plain_node, mtl::thread_unsafe_counter> {
+    long long value;
+};
+
+// 复制并销毁同一个指针，对象始终在缓存中，只测量计数的增减
+template <typename Ptr>
+auto copy_destroy(const char *name, Ptr p) -> void {
+    bench::run(name, n, [&] {
+        for (auto i = size_t{0}; i < n; ++i) {
+            auto q = p;
+            bench::do_not_optimize(q);
+        }
+    });
+}
+
+// 按随机顺序访问大量对象：复制指针、读取对象、销毁副本。
+// shared_ptr 的计数在单独的控制块中，每个对象需要访问两条缓存行
+template <typename Ptr, typename Make>
+auto scattered(const char *name, Make make) -> void {
+    auto ps = std::vector<Ptr>();
+    for (auto i = size_t{0}; i < objects; ++i) {
+        ps.push_back(make(static_cast<long long>(i)));
+    }
+    std::shuffle(ps.begin(), ps.end(), std::mt19937(42));
+    bench::run(name, objects, [&] {
+        auto sum = 0LL;
+        for (auto &p : ps) {
+            auto q = p;
+            sum += q->value;
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+auto main() -> int {
+    // 与实际的多线程程序一致，保证 std::shared_ptr 使用原子操作
+    auto idle = std::thread([] {});
+    idle.join();
+
+    std::printf("sizeof: mtl::shared_ptr %zu, mtl::intrusive_ptr %zu\n", sizeof(mtl::shared_ptr<shared_node>), sizeof(mtl::intrusive_ptr<atomic_node>));
+    copy_destroy("std::shared_ptr copy+destroy", std::make_shared<shared_node>());
+    copy_destroy("mtl::shared_ptr copy+destroy", mtl::shared_ptr<shared_node>(new shared_node{}));
+    copy_destroy("mtl::intrusive_ptr atomic copy+destroy", mtl::make_intrusive<atomic_node>());
+    copy_destroy("mtl::intrusive_ptr unsafe copy+destroy", mtl::make_intrusive<plain_node>());
+
+    scattered<std::shared_ptr<shared_node>>("std::shared_ptr scattered", [](long long v) { return std::shared_ptr<shared_node>(new shared_node{v}); });
+    scattered<mtl::shared_ptr<shared_node>>("mtl::shared_ptr scattered", [](long long v) { return mtl::shared_ptr<shared_node>(new shared_node{v}); });
+    scattered<mtl::intrusive_ptr<atomic_node>>("mtl::intrusive_ptr atomic scattered", [](long long v) {
+        auto p = mtl::make_intrusive<atomic_node>();
+        p->value = v;
+        return p;
+    });
+}
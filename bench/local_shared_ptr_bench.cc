@@ -0,0 +1,57 @@
+#include "bench.hpp"
+#include "utility/local_shared_ptr.hpp"
+#include "utility/shared_ptr.hpp"
+#include <memory>
+#include <thread>
+#include <vector>
+
+constexpr size_t n = 10'000'000;
+constexpr size_t nodes = 1'000;
+
+struct node {
+    int value;
+};
+
+// 复制并销毁：单线程内反复复制同一个指针，只测量引用计数的增减
+template <typename Ptr>
+auto copy_destroy(const char *name, Ptr p) -> void {
+    bench::run(name, n, [&] {
+        for (auto i = size_t{0}; i < n; ++i) {
+            auto q = p;
+            bench::do_not_optimize(q);
+        }
+    });
+}
+
+// 树形结构中常见的用法：若干容器各自持有同一批节点，遍历时按值传递
+template <typename Ptr, typename Make>
+auto fan_out(const char *name, Make make) -> void {
+    auto src = std::vector<Ptr>();
+    for (auto i = size_t{0}; i < nodes; ++i) {
+        src.push_back(make(static_cast<int>(i)));
+    }
+    bench::run(name, n, [&] {
+        auto sum = 0LL;
+        for (auto r = size_t{0}; r < n / nodes; ++r) {
+            auto copy = src;
+            for (auto &p : copy) {
+                sum += p->value;
+            }
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+auto main() -> int {
+    // 与实际的多线程程序一致，保证 std::shared_ptr 使用原子操作
+    auto idle = std::thread([] {});
+    idle.join();
+
+    copy_destroy("std::shared_ptr copy+destroy", std::make_shared<node>());
+    copy_destroy("mtl::shared_ptr copy+destroy", mtl::shared_ptr<node>(new node{}));
+    copy_destroy("mtl::local_shared_ptr copy+destroy", mtl::make_local_shared<node>());
+
+    fan_out<std::shared_ptr<node>>("std::shared_ptr vector copy", [](int v) { return std::make_shared<node>(v); });
+    fan_out<mtl::shared_ptr<node>>("mtl::shared_ptr vector copy", [](int v) { return mtl::shared_ptr<node>(new node{v}); });
+    fan_out<mtl::local_shared_ptr<node>>("mtl::local_shared_ptr vector copy", [](int v) { return mtl::make_local_shared<node>(v); });
+}
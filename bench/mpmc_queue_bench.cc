@@ -0,0 +1,122 @@
+#include "bench.hpp"
+#include "concurrency/mpmc_queue.hpp"
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+constexpr size_t total = 2'000'000;
+
+// 对照组：互斥锁保护的 deque
+template <typename T>
+class locked_deque {
+  public:
+    auto try_push(T v) -> bool {
+        auto lock = std::lock_guard(m_mut);
+        if (m_q.size() == 1024) {
+            return false;
+        }
+        m_q.push_back(v);
+        return true;
+    }
+
+    auto try_pop(T &out) -> bool {
+        auto lock = std::lock_guard(m_mut);
+        if (m_q.empty()) {
+            return false;
+        }
+        out = m_q.front();
+        m_q.pop_front();
+        return true;
+    }
+
+  private:
+    std::mutex m_mut;
+    std::deque<T> m_q;
+};
+
+// threads 个线程一半入队一半出队（单线程时交替进行），共搬运 total 个元素
+template <typename Q>
+auto run_threads(Q &q, size_t threads) -> void {
+    if (threads == 1) {
+        auto v = size_t{0};
+        for (auto i = size_t{0}; i < total; ++i) {
+            q.try_push(i);
+            q.try_pop(v);
+        }
+        bench::do_not_optimize(v);
+        return;
+    }
+    auto producers = threads / 2;
+    auto consumers = threads - producers;
+    auto pool = std::vector<std::thread>();
+    for (auto p = size_t{0}; p < producers; ++p) {
+        pool.emplace_back([&, p] {
+            auto n = total / producers + (p < total % producers);
+            for (auto i = size_t{0}; i < n; ++i) {
+                while (!q.try_push(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto c = size_t{0}; c < consumers; ++c) {
+        pool.emplace_back([&, c] {
+            auto n = total / consumers + (c < total % consumers);
+            auto v = size_t{0};
+            for (auto i = size_t{0}; i < n; ++i) {
+                while (!q.try_pop(v)) {
+                    std::this_thread::yield();
+                }
+            }
+            bench::do_not_optimize(v);
+        });
+    }
+    for (auto &t : pool) {
+        t.join();
+    }
+}
+
+// 阻塞版本：push / pop 在满 / 空时休眠
+auto run_blocking(mtl::mpmc_queue<size_t> &q, size_t threads) -> void {
+    auto producers = std::max<size_t>(threads / 2, 1);
+    auto consumers = std::max<size_t>(threads - producers, 1);
+    auto pool = std::vector<std::thread>();
+    for (auto p = size_t{0}; p < producers; ++p) {
+        pool.emplace_back([&, p] {
+            auto n = total / producers + (p < total % producers);
+            for (auto i = size_t{0}; i < n; ++i) {
+                q.push(i);
+            }
+        });
+    }
+    for (auto c = size_t{0}; c < consumers; ++c) {
+        pool.emplace_back([&, c] {
+            auto n = total / consumers + (c < total % consumers);
+            auto v = size_t{0};
+            for (auto i = size_t{0}; i < n; ++i) {
+                v = q.pop();
+            }
+            bench::do_not_optimize(v);
+        });
+    }
+    for (auto &t : pool) {
+        t.join();
+    }
+}
+
+auto main() -> int {
+    char buf[96];
+    for (auto threads : {size_t{1}, size_t{2}, size_t{4}, size_t{8}, size_t{16}, size_t{32}, size_t{64}}) {
+        auto d = locked_deque<size_t>();
+        std::snprintf(buf, sizeof(buf), "mutex + std::deque %zu threads", threads);
+        bench::run(buf, total, [&] { run_threads(d, threads); });
+
+        auto q = mtl::mpmc_queue<size_t>(1024);
+        std::snprintf(buf, sizeof(buf), "mtl::mpmc_queue %zu threads", threads);
+        bench::run(buf, total, [&] { run_threads(q, threads); });
+
+        std::snprintf(buf, sizeof(buf), "mtl::mpmc_queue push/pop %zu threads", threads);
+        bench::run(buf, total, [&] { run_blocking(q, threads); });
+    }
+}
@@ -0,0 +1,117 @@
+#include "bench.hpp"
+#include "concurrency/mutex.hpp"
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr size_t n = 10'000'000;
+constexpr size_t contended_ops = 2'000'000;
+
+// 无竞争：单线程反复加锁、解锁
+template <typename Mutex>
+auto uncontended(const char *name) -> void {
+    auto m = Mutex();
+    auto count = size_t{0};
+    bench::run(name, n, [&] {
+        for (auto i = size_t{0}; i < n; ++i) {
+            auto lock = std::lock_guard(m);
+            ++count;
+        }
+    });
+    bench::do_not_optimize(count);
+}
+
+// 有竞争：threads 个线程共执行 contended_ops 次加锁、自增、解锁，报告平均每次的耗时
+template <typename Mutex>
+auto contended(const char *name, size_t threads) -> void {
+    auto label = std::string(name) + " threads=" + std::to_string(threads);
+    auto m = Mutex();
+    auto count = size_t{0};
+    bench::run(label.c_str(), contended_ops, [&] {
+        auto ts = std::vector<std::thread>();
+        for (auto t = size_t{0}; t < threads; ++t) {
+            ts.emplace_back([&] {
+                for (auto i = size_t{0}; i < contended_ops / threads; ++i) {
+                    auto lock = std::lock_guard(m);
+                    ++count;
+                }
+            });
+        }
+        for (auto &t : ts) {
+            t.join();
+        }
+    });
+    bench::do_not_optimize(count);
+}
+
+struct quote {
+    double bid, ask;
+    long long seq;
+};
+
+auto main() -> int {
+    std::printf("sizeof: std::mutex %zu, mtl::spin_mutex %zu, mtl::futex_mutex %zu\n", sizeof(std::mutex), sizeof(mtl::spin_mutex), sizeof(mtl::futex_mutex));
+
+    // glibc 在进程只有一个线程时跳过互斥锁的原子操作，先启动一个空闲线程，与实际的多线程程序一致
+    auto idle_stop = std::atomic<bool>(false);
+    auto idle = std::thread([&] {
+        while (!idle_stop.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    uncontended<std::mutex>("std::mutex uncontended");
+    uncontended<mtl::spin_mutex>("mtl::spin_mutex uncontended");
+    uncontended<mtl::futex_mutex>("mtl::futex_mutex uncontended");
+    idle_stop = true;
+    idle.join();
+
+    auto hw = std::max<size_t>(std::thread::hardware_concurrency(), 4);
+    for (auto threads = size_t{2}; threads <= hw; threads *= 2) {
+        contended<std::mutex>("std::mutex contended", threads);
+        contended<mtl::spin_mutex>("mtl::spin_mutex contended", threads);
+        contended<mtl::futex_mutex>("mtl::futex_mutex contended", threads);
+    }
+
+    // 读多写少：一个写者每 100us 更新一次，读者读取整个结构体
+    auto stop = std::atomic<bool>(false);
+    {
+        auto m = std::mutex();
+        auto q = quote{};
+        auto writer = std::thread([&] {
+            for (auto i = 0LL; !stop.load(std::memory_order_relaxed); ++i) {
+                {
+                    auto lock = std::lock_guard(m);
+                    q = quote{1.0 * i, 1.0 * i + 1, i};
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        });
+        bench::run("std::mutex read 24B struct", n, [&] {
+            for (auto i = size_t{0}; i < n; ++i) {
+                auto lock = std::lock_guard(m);
+                bench::do_not_optimize(q.seq);
+            }
+        });
+        stop = true;
+        writer.join();
+    }
+    stop = false;
+    {
+        auto sl = mtl::seqlock<quote>();
+        auto writer = std::thread([&] {
+            for (auto i = 0LL; !stop.load(std::memory_order_relaxed); ++i) {
+                sl.store(quote{1.0 * i, 1.0 * i + 1, i});
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        });
+        bench::run("mtl::seqlock read 24B struct", n, [&] {
+            for (auto i = size_t{0}; i < n; ++i) {
+                bench::do_not_optimize(sl.load().seq);
+            }
+        });
+        stop = true;
+        writer.join();
+    }
+}
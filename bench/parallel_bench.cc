@@ -0,0 +1,69 @@
+#include "bench.hpp"
+#include "concurrency/parallel.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 强扩展测试：问题规模固定，线程数从 1 翻倍到硬件并发数，对照组为标准库的串行算法。
+// 规模从 1e5 开始每次乘 10，默认到 1e7；命令行参数给出最大规模，例如 1e9 个 int 需要约 8GB 内存（排序、划分另需等大的缓冲区）
+auto main(int argc, char **argv) -> int {
+    auto max_n = argc > 1 ? static_cast<size_t>(std::strtod(argv[1], nullptr)) : size_t{10'000'000};
+    auto hw = std::max(1u, std::thread::hardware_concurrency());
+
+    for (auto n = size_t{100'000}; n <= max_n; n *= 10) {
+        auto src = std::vector<int>(n);
+        auto rng = std::mt19937(42);
+        for (auto &x : src) {
+            x = static_cast<int>(rng() >> 1);
+        }
+        auto v = src;
+        // 扫描的累加类型与输入的元素类型相同，用 long long 输入避免溢出
+        auto wide = std::vector<long long>(src.begin(), src.end());
+        auto out = std::vector<long long>(n);
+        auto name = [&](const char *what, size_t threads) {
+            static auto buf = std::string();
+            buf = std::string(what) + " n=" + std::to_string(n);
+            if (threads != 0) {
+                buf += " threads=" + std::to_string(threads);
+            }
+            return buf.c_str();
+        };
+
+        bench::run(name("std::transform", 0), n, [&] { std::transform(src.begin(), src.end(), out.begin(), [](int x) { return x * 3LL + 1; }); });
+        bench::run(name("std::reduce", 0), n, [&] { bench::do_not_optimize(std::reduce(src.begin(), src.end(), 0LL)); });
+        bench::run(name("std::inclusive_scan", 0), n, [&] { std::inclusive_scan(wide.begin(), wide.end(), out.begin()); });
+        bench::run(name("std::sort", 0), n, [&] {
+            v = src;
+            std::sort(v.begin(), v.end());
+        });
+        bench::run(name("std::stable_partition", 0), n, [&] {
+            v = src;
+            std::stable_partition(v.begin(), v.end(), [](int x) { return x % 3 == 0; });
+        });
+
+        for (auto threads = 1u;; threads = std::min(threads * 2, hw)) {
+            auto pool = mtl::thread_pool(threads);
+            auto ex = mtl::par::pool_executor(pool);
+            bench::run(name("mtl::par::for_each", threads), n, [&] { mtl::par::for_each(ex, out.begin(), out.end(), [](long long &x) { x ^= x >> 3; }); });
+            bench::run(name("mtl::par::transform", threads), n, [&] { mtl::par::transform(ex, src.begin(), src.end(), out.begin(), [](int x) { return x * 3LL + 1; }); });
+            bench::run(name("mtl::par::reduce", threads), n, [&] { bench::do_not_optimize(mtl::par::reduce(ex, src.begin(), src.end(), 0LL)); });
+            bench::run(name("mtl::par::inclusive_scan", threads), n, [&] { mtl::par::inclusive_scan(ex, wide.begin(), wide.end(), out.begin()); });
+            // 排序与划分原地修改，每轮先恢复输入，复制的耗时计入结果，与对照组一致
+            bench::run(name("mtl::par::sort", threads), n, [&] {
+                v = src;
+                mtl::par::sort(ex, v.begin(), v.end());
+            });
+            bench::run(name("mtl::par::partition", threads), n, [&] {
+                v = src;
+                mtl::par::partition(ex, v.begin(), v.end(), [](int x) { return x % 3 == 0; });
+            });
+            if (threads == hw) {
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,36 @@
+#include "bench.hpp"
+#include "utility/pool_allocator.hpp"
+#include <cstdlib>
+#include <vector>
+
+struct node {
+    node *next;
+    size_t val[5];
+};
+
+constexpr size_t rounds = 100;
+constexpr size_t live = 10000;
+
+// 批量分配 live 个对象后全部释放，重复 rounds 次
+template <typename Alloc, typename Free>
+auto alloc_free(Alloc &&alloc, Free &&free) {
+    auto ptrs = std::vector<node *>(live);
+    return [=]() mutable {
+        for (auto r = size_t{0}; r < rounds; ++r) {
+            for (auto &p : ptrs) {
+                p = alloc();
+                bench::do_not_optimize(p);
+            }
+            for (auto p : ptrs) {
+                free(p);
+            }
+        }
+    };
+}
+
+auto main() -> int {
+    auto pool = mtl::pool_allocator<node>();
+    bench::run("malloc/free", rounds * live, alloc_free([] { return static_cast<node *>(std::malloc(sizeof(node))); }, [](node *p) { std::free(p); }));
+    bench::run("mtl::allocator", rounds * live, alloc_free([] { return mtl::allocator<node>().allocate(1); }, [](node *p) { mtl::allocator<node>().deallocate(p, 1); }));
+    bench::run("mtl::pool_allocator", rounds * live, alloc_free([&] { return pool.allocate(1); }, [&](node *p) { pool.deallocate(p, 1); }));
+}
@@ -0,0 +1,137 @@
+#include "bench.hpp"
+#include "concurrency/hazard_pointer.hpp"
+#include "concurrency/rcu.hpp"
+#include "utility/shared_ptr.hpp"
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr size_t routes = 4096;
+constexpr size_t lookups_per_thread = 2'000'000;
+
+// 路由表：目的地址的低位到下一跳
+struct table {
+    explicit table(uint32_t version) {
+        for (auto i = size_t{0}; i < routes; ++i) {
+            hops[i] = static_cast<uint32_t>(i) ^ version;
+        }
+    }
+
+    uint32_t hops[routes];
+};
+
+struct rcu_table : table, mtl::rcu_obj_base<rcu_table> {
+    using table::table;
+};
+
+struct hp_table : table, mtl::hazard_pointer_obj_base<hp_table> {
+    using table::table;
+};
+
+struct rcu_holder {
+    rcu_holder() : p(new rcu_table(0)) {}
+
+    ~rcu_holder() {
+        p.load()->retire();
+        mtl::rcu_barrier();
+    }
+
+    auto swap(uint32_t v) -> void { p.exchange(new rcu_table(v))->retire(); }
+
+    auto lookup(uint32_t addr) -> uint32_t {
+        auto r = mtl::rcu_reader();
+        return p.load(std::memory_order_acquire)->hops[addr % routes];
+    }
+
+    std::atomic<rcu_table *> p;
+};
+
+struct hp_holder {
+    hp_holder() : p(new hp_table(0)) {}
+
+    ~hp_holder() {
+        p.load()->retire();
+        mtl::hazard_pointer_default_domain().cleanup();
+    }
+
+    auto swap(uint32_t v) -> void { p.exchange(new hp_table(v))->retire(); }
+
+    auto lookup(uint32_t addr) -> uint32_t {
+        auto h = mtl::make_hazard_pointer();
+        return h.protect(p)->hops[addr % routes];
+    }
+
+    std::atomic<hp_table *> p;
+};
+
+struct atomic_shared_holder {
+    auto swap(uint32_t v) -> void { p.store(mtl::shared_ptr<table>(new table(v))); }
+
+    auto lookup(uint32_t addr) -> uint32_t { return p.load()->hops[addr % routes]; }
+
+    mtl::atomic_shared_ptr<table> p{mtl::shared_ptr<table>(new table(0))};
+};
+
+struct rwlock_holder {
+    ~rwlock_holder() { delete p; }
+
+    auto swap(uint32_t v) -> void {
+        auto n = new table(v);
+        {
+            auto lock = std::unique_lock(m);
+            std::swap(p, n);
+        }
+        delete n;
+    }
+
+    auto lookup(uint32_t addr) -> uint32_t {
+        auto lock = std::shared_lock(m);
+        return p->hops[addr % routes];
+    }
+
+    std::shared_mutex m;
+    table *p{new table(0)};
+};
+
+// threads 个读者各自查找 lookups_per_thread 次，一个写者每 1ms 换一张新表。报告平均每次查找的耗时
+template <typename Holder>
+auto lookups(const char *name, size_t threads) -> void {
+    auto label = std::string(name) + " readers=" + std::to_string(threads);
+    auto h = Holder();
+    bench::run(label.c_str(), lookups_per_thread * threads, [&] {
+        auto stop = std::atomic<bool>(false);
+        auto writer = std::thread([&] {
+            for (auto v = 1u; !stop.load(std::memory_order_relaxed); ++v) {
+                h.swap(v);
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+        auto ts = std::vector<std::thread>();
+        for (auto t = size_t{0}; t < threads; ++t) {
+            ts.emplace_back([&, t] {
+                auto sum = 0u;
+                auto addr = static_cast<uint32_t>(t * 7919);
+                for (auto i = size_t{0}; i < lookups_per_thread; ++i) {
+                    addr = addr * 1664525u + 1013904223u;
+                    sum += h.lookup(addr >> 8);
+                }
+                bench::do_not_optimize(sum);
+            });
+        }
+        for (auto &t : ts) {
+            t.join();
+        }
+        stop = true;
+        writer.join();
+    });
+}
+
+auto main() -> int {
+    for (auto threads = size_t{1}; threads <= 4; threads *= 2) {
+        lookups<rwlock_holder>("std::shared_mutex", threads);
+        lookups<atomic_shared_holder>("mtl::atomic_shared_ptr", threads);
+        lookups<hp_holder>("mtl::hazard_pointer", threads);
+        lookups<rcu_holder>("mtl::rcu", threads);
+    }
+}
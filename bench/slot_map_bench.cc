@@ -0,0 +1,72 @@
+#include "bench.hpp"
+#include "container/slot_map.hpp"
+#include "container/vector.hpp"
+#include <memory>
+#include <random>
+
+constexpr size_t entities = 100'000;
+constexpr size_t n = 10'000'000;
+
+struct entity {
+    float x, y, z;
+    int hp;
+};
+
+// 通过 weak_ptr 观察实体：每次查找都要 lock() 并增减引用计数
+auto weak_lookup() -> void {
+    auto owners = mtl::vector<std::shared_ptr<entity>>();
+    auto handles = mtl::vector<std::weak_ptr<entity>>();
+    for (auto i = size_t{0}; i < entities; ++i) {
+        owners.push_back(std::make_shared<entity>(1, 2, 3, static_cast<int>(i)));
+        handles.push_back(owners.back());
+    }
+    auto rng = std::mt19937(1);
+    bench::run("std::weak_ptr lock", n, [&] {
+        auto sum = 0ll;
+        for (auto i = size_t{0}; i < n; ++i) {
+            if (auto p = handles[rng() % entities].lock()) {
+                sum += p->hp;
+            }
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+auto slot_lookup() -> void {
+    auto m = mtl::slot_map<entity>();
+    auto handles = mtl::vector<mtl::slot_key>();
+    for (auto i = size_t{0}; i < entities; ++i) {
+        handles.push_back(m.insert({1, 2, 3, static_cast<int>(i)}));
+    }
+    auto rng = std::mt19937(1);
+    bench::run("mtl::slot_map find", n, [&] {
+        auto sum = 0ll;
+        for (auto i = size_t{0}; i < n; ++i) {
+            if (auto p = m.find(handles[rng() % entities])) {
+                sum += p->hp;
+            }
+        }
+        bench::do_not_optimize(sum);
+    });
+    bench::run("mtl::slot_map iterate", entities * 100, [&] {
+        auto sum = 0ll;
+        for (auto r = 0; r < 100; ++r) {
+            for (auto &e : m) {
+                sum += e.hp;
+            }
+        }
+        bench::do_not_optimize(sum);
+    });
+    bench::run("mtl::slot_map erase + insert", entities, [&] {
+        for (auto i = size_t{0}; i < entities; ++i) {
+            auto &k = handles[i];
+            m.erase(k);
+            k = m.insert({0, 0, 0, 0});
+        }
+    });
+}
+
+auto main() -> int {
+    weak_lookup();
+    slot_lookup();
+}
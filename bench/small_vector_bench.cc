@@ -0,0 +1,37 @@
+#include "bench.hpp"
+#include "container/small_vector.hpp"
+#include "container/vector.hpp"
+#include <vector>
+
+constexpr size_t n = 1'000'000;
+
+// 每次构造一个只有几个元素的短列表，模拟逐请求的临时列表
+template <typename Vec>
+auto short_lists() {
+    for (auto i = size_t{0}; i < n; ++i) {
+        auto v = Vec();
+        for (auto j = 0; j < 5; ++j) {
+            v.push_back(static_cast<int>(i) + j);
+        }
+        bench::do_not_optimize(v.data());
+    }
+}
+
+// 移动短列表
+template <typename Vec>
+auto move_lists() {
+    auto v = Vec{1, 2, 3, 4, 5};
+    for (auto i = size_t{0}; i < n; ++i) {
+        auto w = std::move(v);
+        v = std::move(w);
+        bench::do_not_optimize(v.data());
+    }
+}
+
+auto main() -> int {
+    bench::run("std::vector<int> 5 push_back", n, short_lists<std::vector<int>>);
+    bench::run("mtl::vector<int> 5 push_back", n, short_lists<mtl::vector<int>>);
+    bench::run("mtl::small_vector<int, 6> 5 push_back", n, short_lists<mtl::small_vector<int, 6>>);
+    bench::run("std::vector<int> move", n, move_lists<std::vector<int>>);
+    bench::run("mtl::small_vector<int, 6> move", n, move_lists<mtl::small_vector<int, 6>>);
+}
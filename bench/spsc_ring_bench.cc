@@ -0,0 +1,128 @@
+#include "bench.hpp"
+#include "concurrency/spsc_ring.hpp"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+constexpr size_t n = 10'000'000;
+constexpr size_t rounds = 100'000;
+
+// 对照组：互斥锁保护的 deque
+template <typename T>
+class locked_deque {
+  public:
+    auto try_push(T v) -> bool {
+        auto lock = std::lock_guard(m_mut);
+        m_q.push_back(v);
+        return true;
+    }
+
+    auto try_pop(T &out) -> bool {
+        auto lock = std::lock_guard(m_mut);
+        if (m_q.empty()) {
+            return false;
+        }
+        out = m_q.front();
+        m_q.pop_front();
+        return true;
+    }
+
+  private:
+    std::mutex m_mut;
+    std::deque<T> m_q;
+};
+
+// 吞吐：一个线程入队 n 个整数，另一个线程全部取出
+template <typename Q>
+auto throughput(Q &q) -> void {
+    auto producer = std::thread([&] {
+        for (auto i = size_t{0}; i < n; ++i) {
+            while (!q.try_push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    auto v = size_t{0};
+    for (auto i = size_t{0}; i < n; ++i) {
+        while (!q.try_pop(v)) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    bench::do_not_optimize(v);
+}
+
+// 批量吞吐：每次最多搬运 64 个
+auto batch_throughput(mtl::spsc_ring<size_t, 4096> &q) -> void {
+    auto producer = std::thread([&] {
+        size_t buf[64];
+        for (auto i = size_t{0}; i < n;) {
+            auto k = std::min<size_t>(64, n - i);
+            for (auto j = size_t{0}; j < k; ++j) {
+                buf[j] = i + j;
+            }
+            auto pushed = size_t{0};
+            while (pushed < k) {
+                auto m = q.try_push_n(buf + pushed, k - pushed);
+                if (m == 0) {
+                    std::this_thread::yield();
+                }
+                pushed += m;
+            }
+            i += k;
+        }
+    });
+    size_t buf[64];
+    for (auto got = size_t{0}; got < n;) {
+        auto m = q.try_pop_n(buf, 64);
+        if (m == 0) {
+            std::this_thread::yield();
+        }
+        got += m;
+    }
+    producer.join();
+    bench::do_not_optimize(buf[0]);
+}
+
+// 往返延迟：两个队列之间乒乓
+template <typename Q>
+auto round_trip(Q &ping, Q &pong) -> void {
+    auto echo = std::thread([&] {
+        auto v = size_t{0};
+        for (auto i = size_t{0}; i < rounds; ++i) {
+            while (!ping.try_pop(v)) {
+                std::this_thread::yield();
+            }
+            while (!pong.try_push(v)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    auto v = size_t{0};
+    for (auto i = size_t{0}; i < rounds; ++i) {
+        while (!ping.try_push(i)) {
+            std::this_thread::yield();
+        }
+        while (!pong.try_pop(v)) {
+            std::this_thread::yield();
+        }
+    }
+    echo.join();
+    bench::do_not_optimize(v);
+}
+
+auto main() -> int {
+    using ring = mtl::spsc_ring<size_t, 4096>;
+    auto r1 = std::make_unique<ring>();
+    auto r2 = std::make_unique<ring>();
+    auto d1 = locked_deque<size_t>();
+    auto d2 = locked_deque<size_t>();
+
+    bench::run("mutex + std::deque throughput", n, [&] { throughput(d1); });
+    bench::run("mtl::spsc_ring throughput", n, [&] { throughput(*r1); });
+    bench::run("mtl::spsc_ring try_push_n/try_pop_n", n, [&] { batch_throughput(*r1); });
+    bench::run("mutex + std::deque round trip", rounds, [&] { round_trip(d1, d2); });
+    bench::run("mtl::spsc_ring round trip", rounds, [&] { round_trip(*r1, *r2); });
+}
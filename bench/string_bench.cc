@@ -0,0 +1,65 @@
+#include "bench.hpp"
+#include "container/vector.hpp"
+#include "string/string.hpp"
+#include "utility/any.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+constexpr size_t n = 1'000'000;
+
+// 构造并拼接短字符串，全部落在 SSO 范围内
+template <typename Str>
+auto short_concat() {
+    for (auto i = size_t{0}; i < n; ++i) {
+        auto s = Str("key:");
+        s += static_cast<char>('a' + i % 26);
+        s.append("/value");
+        bench::do_not_optimize(s.data());
+    }
+}
+
+// 长文本中查找不存在的子串，比较整段扫描的速度
+template <typename Str>
+auto find_text() {
+    auto rng = std::mt19937(42);
+    auto text = Str();
+    for (auto i = 0; i < 64 * 1024; ++i) {
+        text.push_back(static_cast<char>('a' + rng() % 26));
+    }
+    bench::run(std::is_same_v<Str, std::string> ? "std::string find 64KB" : "mtl::string find 64KB", 64 * 1024 * 100, [&] {
+        for (auto i = 0; i < 100; ++i) {
+            bench::do_not_optimize(text.find("needle!"));
+        }
+    });
+}
+
+// 存放在 any 中：mtl::string 内联存放，std::string 需要堆分配
+template <typename Str>
+auto any_store() {
+    for (auto i = size_t{0}; i < n; ++i) {
+        auto a = mtl::any(Str("short"));
+        bench::do_not_optimize(a.has_value());
+    }
+}
+
+// 容器扩容时元素的搬移
+template <typename Str>
+auto vector_growth() {
+    auto v = mtl::vector<Str>();
+    for (auto i = size_t{0}; i < n; ++i) {
+        v.emplace_back("element");
+    }
+    bench::do_not_optimize(v.data());
+}
+
+auto main() -> int {
+    bench::run("std::string short concat", n, short_concat<std::string>);
+    bench::run("mtl::string short concat", n, short_concat<mtl::string>);
+    find_text<std::string>();
+    find_text<mtl::string>();
+    bench::run("mtl::any(std::string)", n, any_store<std::string>);
+    bench::run("mtl::any(mtl::string)", n, any_store<mtl::string>);
+    bench::run("mtl::vector<std::string> push", n, vector_growth<std::string>);
+    bench::run("mtl::vector<mtl::string> push", n, vector_growth<mtl::string>);
+}
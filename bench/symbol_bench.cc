@@ -0,0 +1,85 @@
+#include "bench.hpp"
+#include "container/flat_hash_map.hpp"
+#include "string/symbol.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+constexpr size_t tags = 4096;
+constexpr size_t n = 10'000'000;
+
+auto make_tags() -> std::vector<std::string> {
+    auto v = std::vector<std::string>();
+    for (auto i = size_t{0}; i < tags; ++i) {
+        v.push_back("service.request.tag_" + std::to_string(i));
+    }
+    return v;
+}
+
+auto main() -> int {
+    auto strs = make_tags();
+    auto syms = std::vector<mtl::symbol>();
+    for (auto &s : strs) {
+        syms.emplace_back(s);
+    }
+
+    bench::run("std::string ==", n, [&] {
+        auto eq = size_t{0};
+        for (auto i = size_t{0}; i < n; ++i) {
+            eq += strs[i % tags] == strs[(i * 7) % tags];
+        }
+        bench::do_not_optimize(eq);
+    });
+    bench::run("mtl::symbol ==", n, [&] {
+        auto eq = size_t{0};
+        for (auto i = size_t{0}; i < n; ++i) {
+            eq += syms[i % tags] == syms[(i * 7) % tags];
+        }
+        bench::do_not_optimize(eq);
+    });
+
+    bench::run("std::hash<std::string>", n, [&] {
+        auto h = size_t{0};
+        for (auto i = size_t{0}; i < n; ++i) {
+            h ^= std::hash<std::string>{}(strs[i % tags]);
+        }
+        bench::do_not_optimize(h);
+    });
+    bench::run("std::hash<mtl::symbol>", n, [&] {
+        auto h = size_t{0};
+        for (auto i = size_t{0}; i < n; ++i) {
+            h ^= std::hash<mtl::symbol>{}(syms[i % tags]);
+        }
+        bench::do_not_optimize(h);
+    });
+
+    auto smap = std::unordered_map<std::string, size_t>();
+    auto ymap = mtl::flat_hash_map<mtl::symbol, size_t>();
+    for (auto i = size_t{0}; i < tags; ++i) {
+        smap[strs[i]] = i;
+        ymap[syms[i]] = i;
+    }
+    bench::run("std::unordered_map<std::string> find", n, [&] {
+        auto sum = size_t{0};
+        for (auto i = size_t{0}; i < n; ++i) {
+            sum += smap.find(strs[(i * 13) % tags])->second;
+        }
+        bench::do_not_optimize(sum);
+    });
+    bench::run("mtl::flat_hash_map<mtl::symbol> find", n, [&] {
+        auto sum = size_t{0};
+        for (auto i = size_t{0}; i < n; ++i) {
+            sum += ymap.find(syms[(i * 13) % tags])->second;
+        }
+        bench::do_not_optimize(sum);
+    });
+
+    // 已驻留字符串的无锁查找路径
+    bench::run("mtl::symbol intern (hit)", tags * 100, [&] {
+        for (auto r = 0; r < 100; ++r) {
+            for (auto &s : strs) {
+                bench::do_not_optimize(mtl::symbol(s).id());
+            }
+        }
+    });
+}
@@ -0,0 +1,131 @@
+#include "bench.hpp"
+#include "concurrency/thread_pool.hpp"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+constexpr size_t tasks = 1'000'000;
+
+// 对照组：一个互斥锁保护的 std::function 队列，所有线程共享
+class locked_pool {
+  public:
+    explicit locked_pool(size_t threads) {
+        for (auto i = size_t{0}; i < threads; ++i) {
+            m_threads.emplace_back([this] {
+                for (;;) {
+                    auto lock = std::unique_lock(m_mut);
+                    m_cv.wait(lock, [this] { return m_stop || !m_q.empty(); });
+                    if (m_q.empty()) {
+                        return;
+                    }
+                    auto f = std::move(m_q.front());
+                    m_q.pop_front();
+                    lock.unlock();
+                    f();
+                }
+            });
+        }
+    }
+
+    ~locked_pool() {
+        {
+            auto lock = std::lock_guard(m_mut);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        for (auto &t : m_threads) {
+            t.join();
+        }
+    }
+
+    template <typename F>
+    auto execute(F &&f) -> void {
+        {
+            auto lock = std::lock_guard(m_mut);
+            m_q.emplace_back(std::forward<F>(f));
+        }
+        m_cv.notify_one();
+    }
+
+  private:
+    std::mutex m_mut;
+    std::condition_variable m_cv;
+    std::deque<std::function<void()>> m_q;
+    std::vector<std::thread> m_threads;
+    bool m_stop{false};
+};
+
+// 外部线程提交 tasks 个极小的任务，等待全部完成
+template <typename Pool>
+auto flat(Pool &pool) -> void {
+    auto done = std::atomic<size_t>(0);
+    for (auto i = size_t{0}; i < tasks; ++i) {
+        pool.execute([&done, i] {
+            bench::do_not_optimize(i * i);
+            done.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    while (done.load(std::memory_order_acquire) != tasks) {
+        std::this_thread::yield();
+    }
+}
+
+// 分治：每个任务提交两个子任务，共 tasks 个叶子，任务几乎都在工作线程内部产生
+auto fork_join(mtl::thread_pool &pool) -> void {
+    auto done = std::atomic<size_t>(0);
+    struct node {
+        mtl::thread_pool *pool;
+        std::atomic<size_t> *done;
+        size_t n;
+
+        auto operator()() const -> void {
+            if (n == 1) {
+                done->fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            pool->execute(node{pool, done, n / 2});
+            pool->execute(node{pool, done, n - n / 2});
+        }
+    };
+    pool.execute(node{&pool, &done, tasks});
+    while (done.load(std::memory_order_acquire) != tasks) {
+        std::this_thread::yield();
+    }
+}
+
+auto main() -> int {
+    auto hw = std::max(std::thread::hardware_concurrency(), 1u);
+    auto counts = std::vector<size_t>();
+    for (auto t = size_t{1}; t < hw; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(hw);
+
+    char buf[96];
+    for (auto threads : counts) {
+        {
+            auto pool = locked_pool(threads);
+            std::snprintf(buf, sizeof(buf), "mutex + std::function %zu threads", threads);
+            bench::run(buf, tasks, [&] { flat(pool); });
+        }
+        auto pool = mtl::thread_pool(threads, true);
+        std::snprintf(buf, sizeof(buf), "mtl::thread_pool execute %zu threads", threads);
+        bench::run(buf, tasks, [&] { flat(pool); });
+
+        std::snprintf(buf, sizeof(buf), "mtl::thread_pool fork-join %zu threads", threads);
+        bench::run(buf, tasks * 2 - 1, [&] { fork_join(pool); });
+
+        std::snprintf(buf, sizeof(buf), "mtl::thread_pool bulk_submit %zu threads", threads);
+        bench::run(buf, tasks, [&] { pool.bulk_submit(tasks, [](size_t i) { bench::do_not_optimize(i * i); }).get(); });
+
+        std::snprintf(buf, sizeof(buf), "mtl::thread_pool submit + get %zu threads", threads);
+        bench::run(buf, tasks / 10, [&] {
+            for (auto i = size_t{0}; i < tasks / 10; ++i) {
+                bench::do_not_optimize(pool.submit([i] { return i; }).get());
+            }
+        });
+    }
+}
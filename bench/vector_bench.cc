@@ -0,0 +1,47 @@
+#include "bench.hpp"
+#include "container/vector.hpp"
+#include "utility/shared_ptr.hpp"
+#include <vector>
+
+constexpr size_t n = 1'000'000;
+constexpr size_t inserts = 2'000;
+
+// 逐个 push_back，不预留容量
+template <typename Vec>
+auto push_back() {
+    auto v = Vec();
+    for (auto i = size_t{0}; i < n; ++i) {
+        v.push_back(static_cast<int>(i));
+    }
+    bench::do_not_optimize(v.data());
+}
+
+// 在头部插入，每次都要整体后移
+template <typename Vec>
+auto insert_front() {
+    auto v = Vec(inserts, 0);
+    for (auto i = size_t{0}; i < inserts; ++i) {
+        v.insert(v.begin(), static_cast<int>(i));
+    }
+    bench::do_not_optimize(v.data());
+}
+
+// 元素为 shared_ptr，扩容时 std::vector 需要逐个移动并析构
+template <typename Vec>
+auto realloc_shared() {
+    auto origin = mtl::shared_ptr<int>(new int(0));
+    auto v = Vec();
+    for (auto i = size_t{0}; i < n; ++i) {
+        v.push_back(origin);
+    }
+    bench::do_not_optimize(v.data());
+}
+
+auto main() -> int {
+    bench::run("std::vector<int> push_back", n, push_back<std::vector<int>>);
+    bench::run("mtl::vector<int> push_back", n, push_back<mtl::vector<int>>);
+    bench::run("std::vector<int> insert front", inserts, insert_front<std::vector<int>>);
+    bench::run("mtl::vector<int> insert front", inserts, insert_front<mtl::vector<int>>);
+    bench::run("std::vector<shared_ptr> push_back", n, realloc_shared<std::vector<mtl::shared_ptr<int>>>);
+    bench::run("mtl::vector<shared_ptr> push_back", n, realloc_shared<mtl::vector<mtl::shared_ptr<int>>>);
+}
@@ -0,0 +1,218 @@
+/*
+    并发库的公共设施，与标准无关
+*/
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace mtl {
+    // 按缓存行对齐可以避免不同线程写入的变量落在同一缓存行上（伪共享）
+    inline constexpr size_t cache_line_size = 64;
+
+    // 自旋等待时提示处理器降低功耗，并让出同一物理核上的超线程
+    inline auto cpu_relax() noexcept -> void {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    // 指数退避：前几次等待时 pause 的次数逐次翻倍，之后每次让出时间片，避免在线程数多于核数时空转
+    class backoff {
+        static constexpr unsigned spin_limit = 6;
+
+      public:
+        auto pause() noexcept -> void {
+            if (m_count < spin_limit) {
+                for (auto i = 0u; i < (1u << m_count); ++i) {
+                    cpu_relax();
+                }
+                ++m_count;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+        auto reset() noexcept -> void { m_count = 0; }
+
+      public:
+        unsigned m_count{0};
+    };
+} // namespace mtl
+
+// futex
+namespace mtl {
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free);
+
+    // 当 a 的值等于 expected 时阻塞，直到被 futex_wake_* 唤醒；可能虚假唤醒，调用者需要循环检查条件。
+    // Linux 上直接使用进程私有的 futex 系统调用，等待者只占用这 4 个字节；其他平台退化为 std::atomic::wait
+    inline auto futex_wait(std::atomic<uint32_t> &a, uint32_t expected) noexcept -> void {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&a), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+        a.wait(expected, std::memory_order_relaxed);
+#endif
+    }
+
+    inline auto futex_wake_one(std::atomic<uint32_t> &a) noexcept -> void {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&a), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+        a.notify_one();
+#endif
+    }
+
+    inline auto futex_wake_all(std::atomic<uint32_t> &a) noexcept -> void {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&a), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#else
+        a.notify_all();
+#endif
+    }
+} // namespace mtl
+
+// executor
+namespace mtl {
+    // 只需提供 execute(f) 的执行器，例如 thread_pool。协程的 schedule 与 future 的 then 都通过它转移执行
+    template <typename E>
+    concept _executor = requires(E &e, void (*f)()) { e.execute(f); };
+} // namespace mtl
+
+// slot list
+namespace mtl {
+    // 只追加的槽位链表，例如危险指针的记录、RCU 读者的槽位。槽位不再使用时标记为空闲供复用，链表析构时才释放，
+    // 因此其他线程可以不加锁地遍历。Slot 需要提供 std::atomic<bool> m_active{true} 与 Slot *m_next
+    template <typename Slot>
+    class _slot_list {
+      public:
+        _slot_list() noexcept = default;
+
+        _slot_list(const _slot_list &) = delete;
+
+        auto operator=(const _slot_list &) -> _slot_list & = delete;
+
+        ~_slot_list() {
+            for (auto s = m_head.load(std::memory_order_acquire); s;) {
+                delete std::exchange(s, s->m_next);
+            }
+        }
+
+      public:
+        // 优先复用空闲的槽位，没有时分配一个新的压入链表头部
+        auto acquire() -> Slot * {
+            for (auto s = head(); s; s = s->m_next) {
+                if (!s->m_active.load(std::memory_order_relaxed) && !s->m_active.exchange(true, std::memory_order_acquire)) {
+                    return s;
+                }
+            }
+            auto s = new Slot();
+            s->m_next = m_head.load(std::memory_order_relaxed);
+            while (!m_head.compare_exchange_weak(s->m_next, s, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+            m_size.fetch_add(1, std::memory_order_relaxed);
+            return s;
+        }
+
+        static auto release(Slot *s) noexcept -> void { s->m_active.store(false, std::memory_order_release); }
+
+        auto head() const noexcept -> Slot * { return m_head.load(std::memory_order_acquire); }
+
+        // 已分配的槽位数，包括空闲的
+        auto size() const noexcept -> size_t { return m_size.load(std::memory_order_relaxed); }
+
+      public:
+        std::atomic<Slot *> m_head{nullptr};
+        std::atomic<size_t> m_size{0};
+    };
+} // namespace mtl
+
+// thread state
+namespace mtl {
+    // 平凡析构的线程本地状态，线程退出后（例如其他 thread_local 对象析构时）依然可以访问。
+    // 通过 _thread_state_enroll 登记后，线程退出时先标记 m_dead，再调用 S::on_thread_exit()
+    template <typename S>
+    struct _thread_state : S {
+        bool m_registered;
+        bool m_dead;
+    };
+
+    template <typename S>
+    inline thread_local _thread_state<S> _this_thread_state{};
+
+    template <typename S>
+    struct _thread_state_guard {
+        ~_thread_state_guard() {
+            auto &t = _this_thread_state<S>;
+            t.m_dead = true;
+            t.on_thread_exit();
+        }
+    };
+
+    // 线程已退出时返回 false，此时不会再调用 on_thread_exit
+    template <typename S>
+    auto _thread_state_enroll() noexcept -> bool {
+        static_assert(std::is_trivially_destructible_v<_thread_state<S>>);
+        auto &t = _this_thread_state<S>;
+        if (t.m_dead) [[unlikely]] {
+            return false;
+        }
+        if (!t.m_registered) {
+            // 局部 thread_local 在首次执行到声明时构造（GCC 不会因为取地址而构造变量模板的 thread_local 实例）
+            thread_local auto guard = _thread_state_guard<S>();
+            t.m_registered = true;
+        }
+        return true;
+    }
+} // namespace mtl
+
+// retire base
+namespace mtl {
+    // 退休时把删除器保存在对象内部的基类，无需额外分配。Node 为域的退休链表节点，提供 void (*m_reclaim)(Node *)；
+    // T 为派生类，m_reclaim 取出删除器 d 并调用 d(T *)
+    template <typename Node, typename T, typename D>
+    class _retire_base : private Node {
+      protected:
+        _retire_base() noexcept = default;
+
+        // 复制对象时不复制退休状态
+        _retire_base(const _retire_base &) noexcept {}
+
+        _retire_base(_retire_base &&) noexcept {}
+
+        auto operator=(const _retire_base &) noexcept -> _retire_base & { return *this; }
+
+        auto operator=(_retire_base &&) noexcept -> _retire_base & { return *this; }
+
+        ~_retire_base() = default;
+
+        // 保存删除器，返回交给域的退休节点
+        auto bind(D d) noexcept -> Node * {
+            ::new (static_cast<void *>(m_deleter)) D(std::move(d));
+            this->m_reclaim = [](Node *r) {
+                auto self = static_cast<_retire_base *>(r);
+                auto &del = *std::launder(reinterpret_cast<D *>(self->m_deleter));
+                auto d = std::move(del);
+                del.~D();
+                d(static_cast<T *>(self));
+            };
+            return this;
+        }
+
+      private:
+        alignas(D) unsigned char m_deleter[sizeof(D)];
+    };
+} // namespace mtl
@@ -0,0 +1,498 @@
+/*
+    https://timsong-cpp.github.io/cppwp/n4861/futures
+    then / when_all / when_any：https://wg21.link/n4538
+*/
+#pragma once
+#include "common.hpp"
+#include "container/vector.hpp"
+#include "coroutine/frame_pool.hpp"
+#include "utility/tuple.hpp"
+#include "utility/variant.hpp"
+#include <atomic>
+#include <exception>
+#include <utility>
+
+namespace mtl {
+    // promise 析构时仍未设置结果
+    struct broken_promise : public std::exception {};
+
+    // future 不持有共享状态，或 promise 重复设置结果
+    struct future_error : public std::exception {};
+
+    template <typename T>
+    class future;
+
+    template <typename T>
+    class promise;
+} // namespace mtl
+
+// shared state
+namespace mtl {
+    // 就绪时被调用的回调，以侵入式单链表挂在共享状态上，回调节点由挂载者提供，不额外分配
+    struct _future_callback {
+        void (*m_run)(_future_callback *) noexcept;
+        _future_callback *m_next;
+    };
+
+    // 回调链表的结束标记：状态已就绪，之后挂载的回调直接执行
+    inline constinit auto _future_closed = _future_callback{nullptr, nullptr};
+
+    // 与结果类型无关的部分：引用计数、就绪标志与回调链表。
+    // 共享状态与协程帧一样按大小等级从 _frame_pool 分配，派生的状态（then、when_all 的状态）通过虚析构函数以正确的大小释放
+    struct _future_state_base : _frame_allocated {
+        // m_ready 的取值
+        static constexpr uint32_t pending = 0;
+        static constexpr uint32_t waiting = 1; // 未就绪且有线程阻塞在 futex 上
+        static constexpr uint32_t ready = 2;
+
+        _future_state_base() noexcept = default;
+
+        _future_state_base(const _future_state_base &) = delete;
+
+        virtual ~_future_state_base() = default;
+
+        auto add_ref() noexcept -> void { m_refs.fetch_add(1, std::memory_order_relaxed); }
+
+        auto release() noexcept -> void {
+            if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                delete this;
+            }
+        }
+
+        auto is_ready() const noexcept -> bool { return m_ready.load(std::memory_order_acquire) == ready; }
+
+        // 先标记有等待者再睡眠，发布者只在有等待者时才进行 futex 唤醒的系统调用
+        auto wait() noexcept -> void {
+            auto s = m_ready.load(std::memory_order_acquire);
+            while (s != ready) {
+                if (s == pending && !m_ready.compare_exchange_weak(s, waiting, std::memory_order_acquire)) {
+                    continue;
+                }
+                futex_wait(m_ready, waiting);
+                s = m_ready.load(std::memory_order_acquire);
+            }
+        }
+
+        // 就绪后挂载的回调在当前线程立即执行
+        auto attach(_future_callback *c) noexcept -> void {
+            auto head = m_callbacks.load(std::memory_order_acquire);
+            do {
+                if (head == &_future_closed) {
+                    c->m_run(c);
+                    return;
+                }
+                c->m_next = head;
+            } while (!m_callbacks.compare_exchange_weak(head, c, std::memory_order_release, std::memory_order_acquire));
+        }
+
+        // 结果写入之后调用：唤醒等待者，再依次执行已挂载的回调。调用者需持有引用，保证执行期间状态存活
+        auto publish() noexcept -> void {
+            if (m_ready.exchange(ready, std::memory_order_acq_rel) == waiting) {
+                futex_wake_all(m_ready);
+            }
+            for (auto c = m_callbacks.exchange(&_future_closed, std::memory_order_acq_rel); c != nullptr;) {
+                auto next = c->m_next; // 回调可能释放节点
+                c->m_run(c);
+                c = next;
+            }
+        }
+
+        std::atomic<uint32_t> m_refs{2}; // promise 与 future 各持有一个引用
+        std::atomic<uint32_t> m_ready{pending};
+        std::atomic<_future_callback *> m_callbacks{nullptr};
+    };
+
+    struct _future_void {};
+
+    // void 以空类型存放，引用以指针的形式存放
+    template <typename T>
+    using _future_value_t = std::conditional_t<std::is_void_v<T>, _future_void, std::conditional_t<std::is_reference_v<T>, std::remove_reference_t<T> *, T>>;
+
+    // future 与 promise 共享的状态，一次分配，引用计数嵌在对象内。
+    // 结果是值或异常二者之一，存放在 variant 中；未就绪时 variant 为空
+    template <typename T>
+    struct _future_state : _future_state_base {
+        template <typename... Args>
+        auto set_value(Args &&...args) -> void {
+            if constexpr (std::is_reference_v<T>) {
+                m_result.template emplace<0>(std::addressof(args)...);
+            } else {
+                m_result.template emplace<0>(std::forward<Args>(args)...);
+            }
+            publish();
+        }
+
+        auto set_exception(std::exception_ptr e) noexcept -> void {
+            m_result.template emplace<1>(std::move(e));
+            publish();
+        }
+
+        auto has_exception() const noexcept -> bool { return m_result.index() == 1; }
+
+        auto exception() const noexcept -> std::exception_ptr { return get<1>(m_result); }
+
+        // 调用者保证已就绪
+        auto take() -> T {
+            if (has_exception()) {
+                std::rethrow_exception(get<1>(m_result));
+            }
+            if constexpr (std::is_reference_v<T>) {
+                return static_cast<T>(*get<0>(m_result));
+            } else if constexpr (!std::is_void_v<T>) {
+                return std::move(get<0>(m_result));
+            }
+        }
+
+        variant<_future_value_t<T>, std::exception_ptr> m_result;
+    };
+} // namespace mtl
+
+// continuation
+namespace mtl {
+    template <typename T, typename F>
+    struct _future_then_result {
+        using type = std::invoke_result_t<F, T &&>;
+    };
+
+    template <typename F>
+    struct _future_then_result<void, F> {
+        using type = std::invoke_result_t<F>;
+    };
+
+    // then(f) 得到的 future 的结果类型：f 以源 future 的值为参数的返回值
+    template <typename T, typename F>
+    using _future_then_result_t = typename _future_then_result<T, F>::type;
+
+    // then 的状态：本身是结果 future 的共享状态，同时作为回调节点挂在源状态上，整个续延只有这一次分配。
+    // E 为 void 时在使源状态就绪的线程上执行 f，否则提交给执行器执行
+    template <typename T, typename F, typename E>
+    struct _future_then final : _future_state<_future_then_result_t<T, F>>, _future_callback {
+        using result_type = _future_then_result_t<T, F>;
+
+        _future_then(_future_state<T> *src, F &&f, E *ex) : _future_callback{&run, nullptr}, m_src(src), m_f(std::move(f)), m_ex(ex) {}
+
+        static auto run(_future_callback *c) noexcept -> void {
+            auto self = static_cast<_future_then *>(c);
+            if constexpr (std::is_void_v<E>) {
+                self->invoke();
+            } else {
+                self->m_ex->execute([self]() noexcept { self->invoke(); });
+            }
+        }
+
+        // 源状态带着异常时不调用 f，异常直接传递给结果
+        auto invoke() noexcept -> void {
+            auto src = std::exchange(m_src, nullptr);
+            try {
+                if (src->has_exception()) {
+                    this->set_exception(src->exception());
+                } else if constexpr (std::is_void_v<T> && std::is_void_v<result_type>) {
+                    m_f();
+                    this->set_value();
+                } else if constexpr (std::is_void_v<T>) {
+                    this->set_value(m_f());
+                } else if constexpr (std::is_void_v<result_type>) {
+                    m_f(src->take());
+                    this->set_value();
+                } else {
+                    this->set_value(m_f(src->take()));
+                }
+            } catch (...) {
+                this->set_exception(std::current_exception());
+            }
+            src->release();
+            this->release(); // 回调持有的引用
+        }
+
+        _future_state<T> *m_src;
+        F m_f;
+        E *m_ex;
+    };
+} // namespace mtl
+
+// future
+namespace mtl {
+    template <typename T>
+    class future {
+        template <typename>
+        friend class promise;
+
+        template <typename, typename, typename>
+        friend struct _future_then;
+
+      public:
+        future() noexcept = default;
+
+        future(future &&f) noexcept : m_state(std::exchange(f.m_state, nullptr)) {}
+
+        auto operator=(future &&f) noexcept -> future & {
+            future(std::move(f)).swap(*this);
+            return *this;
+        }
+
+        ~future() {
+            if (m_state) {
+                m_state->release();
+            }
+        }
+
+        // 接管 s 的一个引用
+        explicit future(_future_state<T> *s) noexcept : m_state(s) {}
+
+      public:
+        auto valid() const noexcept -> bool { return m_state != nullptr; }
+
+        auto is_ready() const -> bool { return state().is_ready(); }
+
+        auto wait() const -> void { state().wait(); }
+
+        // 阻塞直到就绪，取出结果后 future 不再持有共享状态
+        auto get() -> T {
+            state().wait();
+            auto s = std::exchange(m_state, nullptr);
+            struct guard {
+                _future_state<T> *s;
+                ~guard() { s->release(); }
+            } g{s};
+            return s->take();
+        }
+
+        // 就绪后在使它就绪的线程上（已就绪则在当前线程上）以结果调用 f，返回持有 f 的返回值的 future。
+        // 本 future 带着异常时不调用 f，异常传递给返回的 future。调用后本 future 不再持有共享状态
+        template <typename F>
+        auto then(F &&f) -> future<_future_then_result_t<T, std::decay_t<F>>> {
+            return chain<void>(nullptr, std::forward<F>(f));
+        }
+
+        // 同上，f 提交给执行器 ex 执行
+        template <_executor E, typename F>
+        auto then(E &ex, F &&f) -> future<_future_then_result_t<T, std::decay_t<F>>> {
+            return chain<E>(&ex, std::forward<F>(f));
+        }
+
+        auto swap(future &f) noexcept -> void { std::swap(m_state, f.m_state); }
+
+      private:
+        auto state() const -> _future_state<T> & {
+            if (m_state == nullptr) {
+                throw future_error();
+            }
+            return *m_state;
+        }
+
+        // 续延状态接管本 future 对源状态的引用，自身的两个引用分别属于返回的 future 与挂载的回调
+        template <typename E, typename F>
+        auto chain(E *ex, F &&f) -> future<_future_then_result_t<T, std::decay_t<F>>> {
+            auto src = &state();
+            auto next = new _future_then<T, std::decay_t<F>, E>(src, std::decay_t<F>(std::forward<F>(f)), ex);
+            m_state = nullptr;
+            auto res = future<_future_then_result_t<T, std::decay_t<F>>>(next);
+            src->attach(next);
+            return res;
+        }
+
+      public:
+        _future_state<T> *m_state{nullptr};
+    };
+} // namespace mtl
+
+// promise
+namespace mtl {
+    template <typename T>
+    class promise {
+      public:
+        promise() : m_state(new _future_state<T>()) {}
+
+        promise(promise &&p) noexcept : m_state(std::exchange(p.m_state, nullptr)), m_retrieved(p.m_retrieved) {}
+
+        auto operator=(promise &&p) noexcept -> promise & {
+            promise(std::move(p)).swap(*this);
+            return *this;
+        }
+
+        ~promise() {
+            if (m_state == nullptr) {
+                return;
+            }
+            if (!m_state->is_ready()) {
+                m_state->set_exception(std::make_exception_ptr(broken_promise()));
+            }
+            if (!m_retrieved) {
+                m_state->release(); // future 从未取出，由 promise 释放它的引用
+            }
+            m_state->release();
+        }
+
+      public:
+        auto get_future() -> future<T> {
+            if (m_state == nullptr || m_retrieved) {
+                throw future_error();
+            }
+            m_retrieved = true;
+            return future<T>(m_state);
+        }
+
+        template <typename... Args>
+        auto set_value(Args &&...args) -> void {
+            check();
+            m_state->set_value(std::forward<Args>(args)...);
+        }
+
+        auto set_exception(std::exception_ptr e) -> void {
+            check();
+            m_state->set_exception(std::move(e));
+        }
+
+        auto swap(promise &p) noexcept -> void {
+            std::swap(m_state, p.m_state);
+            std::swap(m_retrieved, p.m_retrieved);
+        }
+
+      private:
+        auto check() const -> void {
+            if (m_state == nullptr || m_state->is_ready()) {
+                throw future_error();
+            }
+        }
+
+      public:
+        _future_state<T> *m_state;
+        bool m_retrieved{false};
+    };
+
+    template <typename T>
+    auto make_ready_future(T &&v) -> future<std::decay_t<T>> {
+        auto p = promise<std::decay_t<T>>();
+        p.set_value(std::forward<T>(v));
+        return p.get_future();
+    }
+
+    inline auto make_ready_future() -> future<void> {
+        auto p = promise<void>();
+        p.set_value();
+        return p.get_future();
+    }
+
+    template <typename T>
+    auto make_exceptional_future(std::exception_ptr e) -> future<T> {
+        auto p = promise<T>();
+        p.set_exception(std::move(e));
+        return p.get_future();
+    }
+} // namespace mtl
+
+// when_all / when_any
+namespace mtl {
+    template <typename Seq>
+    struct when_any_result {
+        size_t index;
+        Seq futures;
+    };
+
+    // 组合器的状态：每个输入一个回调节点，每个未执行的回调持有一个引用，状态活到最后一个输入就绪为止。
+    // Any 为 false 时最后一个就绪的输入使结果就绪，否则第一个就绪的输入使结果就绪
+    template <typename Seq, bool Any>
+    struct _future_when final : _future_state<std::conditional_t<Any, when_any_result<Seq>, Seq>> {
+        struct node : _future_callback {
+            _future_when *m_owner;
+            size_t m_index;
+        };
+
+        _future_when(Seq &&inputs, size_t n) : m_inputs(std::move(inputs)), m_nodes(n), m_left(n) {
+            this->m_refs.store(static_cast<uint32_t>(n + 1), std::memory_order_relaxed);
+        }
+
+        static auto run(_future_callback *c) noexcept -> void {
+            auto n = static_cast<node *>(c);
+            auto self = n->m_owner;
+            if constexpr (Any) {
+                if (!self->m_done.exchange(true, std::memory_order_acq_rel)) {
+                    self->set_value(when_any_result<Seq>{n->m_index, std::move(self->m_inputs)});
+                }
+            } else if (self->m_left.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                self->set_value(std::move(self->m_inputs));
+            }
+            self->release();
+        }
+
+        // 挂载时回调可能立即执行并移走输入，所以先取出全部输入的状态
+        auto start(_future_state_base **srcs) -> void {
+            for (auto i = size_t{0}; i < m_nodes.size(); ++i) {
+                m_nodes[i].m_run = &run;
+                m_nodes[i].m_owner = this;
+                m_nodes[i].m_index = i;
+            }
+            for (auto i = size_t{0}; i < m_nodes.size(); ++i) {
+                srcs[i]->attach(&m_nodes[i]);
+            }
+        }
+
+        Seq m_inputs;
+        vector<node> m_nodes;
+        std::atomic<size_t> m_left;
+        std::atomic<bool> m_done{false};
+    };
+
+    template <bool Any, typename Seq, typename R = std::conditional_t<Any, when_any_result<Seq>, Seq>>
+    auto _when(Seq &&inputs, _future_state_base **srcs, size_t n) -> future<R> {
+        for (auto i = size_t{0}; i < n; ++i) {
+            if (srcs[i] == nullptr) {
+                throw future_error();
+            }
+        }
+        if (n == 0) {
+            if constexpr (Any) {
+                return make_ready_future(when_any_result<Seq>{size_t(-1), std::move(inputs)});
+            } else {
+                return make_ready_future(std::move(inputs));
+            }
+        }
+        auto s = new _future_when<Seq, Any>(std::move(inputs), n);
+        auto res = future<R>(s);
+        s->start(srcs);
+        return res;
+    }
+
+    // 所有输入就绪后就绪，结果为就绪的输入本身，调用者从中逐个 get
+    template <std::forward_iterator It, typename T = typename std::iter_value_t<It>>
+    auto when_all(It first, It last) -> future<vector<T>> {
+        auto inputs = vector<T>(std::make_move_iterator(first), std::make_move_iterator(last));
+        auto srcs = vector<_future_state_base *>(inputs.size());
+        for (auto i = size_t{0}; i < inputs.size(); ++i) {
+            srcs[i] = inputs[i].m_state;
+        }
+        return _when<false>(std::move(inputs), srcs.data(), srcs.size());
+    }
+
+    template <typename... Ts>
+    auto when_all(future<Ts> &&...fs) -> future<tuple<future<Ts>...>> {
+        _future_state_base *srcs[] = {fs.m_state..., nullptr};
+        return _when<false>(tuple<future<Ts>...>(std::move(fs)...), srcs, sizeof...(Ts));
+    }
+
+    // 任一输入就绪后就绪，结果为就绪的输入的下标与全部输入
+    template <std::forward_iterator It, typename T = typename std::iter_value_t<It>>
+    auto when_any(It first, It last) -> future<when_any_result<vector<T>>> {
+        auto inputs = vector<T>(std::make_move_iterator(first), std::make_move_iterator(last));
+        auto srcs = vector<_future_state_base *>(inputs.size());
+        for (auto i = size_t{0}; i < inputs.size(); ++i) {
+            srcs[i] = inputs[i].m_state;
+        }
+        return _when<true>(std::move(inputs), srcs.data(), srcs.size());
+    }
+
+    template <typename... Ts>
+    auto when_any(future<Ts> &&...fs) -> future<when_any_result<tuple<future<Ts>...>>> {
+        _future_state_base *srcs[] = {fs.m_state..., nullptr};
+        return _when<true>(tuple<future<Ts>...>(std::move(fs)...), srcs, sizeof...(Ts));
+    }
+} // namespace mtl
+
+// trivially relocatable
+namespace mtl {
+    template <typename T>
+    struct is_trivially_relocatable<future<T>> : std::true_type {};
+
+    template <typename T>
+    struct is_trivially_relocatable<promise<T>> : std::true_type {};
+} // namespace mtl
@@ -0,0 +1,359 @@
+/*
+    危险指针：无锁数据结构的安全内存回收
+    https://www.open-std.org/jtc1/sc22/wg21/docs/papers/2023/p2530r3.pdf
+    Maged M. Michael, Hazard Pointers: Safe Memory Reclamation for Lock-Free Objects
+*/
+#pragma once
+#include "common.hpp"
+#include "container/vector.hpp"
+#include "utility/unique_ptr.hpp"
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+namespace mtl {
+    class hazard_pointer_domain;
+
+    class hazard_pointer;
+
+    auto hazard_pointer_default_domain() noexcept -> hazard_pointer_domain &;
+} // namespace mtl
+
+// storage
+namespace mtl {
+    // 每个 hazard_pointer 独占一条记录，记录保存在域的 _slot_list 中。
+    // 按缓存行对齐，读者发布保护时不会与其他读者争用缓存行
+    struct alignas(cache_line_size) _hazard_record {
+        std::atomic<const void *> m_ptr{nullptr};
+        std::atomic<bool> m_active{true};
+        _hazard_record *m_next{nullptr};
+    };
+
+    // 退休对象的公共部分，通过 m_next 串成退休链表
+    struct _hazard_retired {
+        _hazard_retired *m_next{nullptr};
+        const void *m_key{nullptr}; // 读者保护的地址，即完整对象的地址
+        void (*m_reclaim)(_hazard_retired *){nullptr};
+    };
+
+    // 线程在某个域中的本地状态：退休链表与空闲记录缓存
+    struct _hazard_local {
+        static constexpr size_t record_cache = 8;
+
+        hazard_pointer_domain *m_domain{nullptr};
+        _hazard_retired *m_retired{nullptr};
+        size_t m_retired_count{0};
+        _hazard_record *m_records[record_cache]{};
+        size_t m_record_count{0};
+    };
+
+    // 每个线程最多同时在 max_domains 个域中持有本地状态，超出后直接使用域的共享链表
+    struct _hazard_thread {
+        static constexpr size_t max_domains = 4;
+
+        // 线程退出时将本地状态交还给各个域
+        auto on_thread_exit() noexcept -> void;
+
+        _hazard_local m_locals[max_domains];
+    };
+
+    // 返回本线程在域 d 中的本地状态，线程已退出或同时使用的域过多时返回 nullptr
+    inline auto _hazard_local_of(hazard_pointer_domain *d, bool create = true) noexcept -> _hazard_local * {
+        auto &t = _this_thread_state<_hazard_thread>;
+        if (t.m_dead) [[unlikely]] {
+            return nullptr;
+        }
+        for (auto &l : t.m_locals) {
+            if (l.m_domain == d) [[likely]] {
+                return &l;
+            }
+        }
+        if (!create) {
+            return nullptr;
+        }
+        _thread_state_enroll<_hazard_thread>();
+        for (auto &l : t.m_locals) {
+            if (l.m_domain == nullptr) {
+                l = _hazard_local{.m_domain = d};
+                return &l;
+            }
+        }
+        return nullptr;
+    }
+} // namespace mtl
+
+// hazard_pointer_domain
+namespace mtl {
+    // 危险指针的域：保存所有危险指针记录与跨线程的退休对象。
+    // 对象退休时先放入本线程的退休链表，数量超过 2 * 记录数 + scan_base 时才扫描一次全部记录，
+    // 每次扫描至少回收一半，因此每次退休的摊还代价为 O(1)。
+    // 析构时不能再有线程持有本域的危险指针，其他使用过本域的线程必须已经退出
+    class hazard_pointer_domain {
+        static constexpr size_t scan_base = 64;
+
+      public:
+        hazard_pointer_domain() noexcept = default;
+
+        hazard_pointer_domain(const hazard_pointer_domain &) = delete;
+
+        auto operator=(const hazard_pointer_domain &) -> hazard_pointer_domain & = delete;
+
+        ~hazard_pointer_domain() {
+            // 回收对象的删除器可能再退休其他对象，直到两个链表都为空
+            while (true) {
+                auto list = m_shared.exchange(nullptr, std::memory_order_acquire);
+                if (auto l = _hazard_local_of(this, false)) {
+                    list = concat(l->m_retired, list);
+                    *l = _hazard_local{}; // 缓存的记录随后一起释放
+                }
+                if (list == nullptr) {
+                    break;
+                }
+                while (list) {
+                    auto next = list->m_next;
+                    list->m_reclaim(list);
+                    list = next;
+                }
+            }
+        }
+
+      public:
+        // 取得一条记录，优先使用本线程缓存的空闲记录
+        auto acquire() -> _hazard_record * {
+            if (auto l = _hazard_local_of(this); l && l->m_record_count) [[likely]] {
+                return l->m_records[--l->m_record_count];
+            }
+            return m_records.acquire();
+        }
+
+        auto release(_hazard_record *r) noexcept -> void {
+            r->m_ptr.store(nullptr, std::memory_order_release);
+            if (auto l = _hazard_local_of(this); l && l->m_record_count < _hazard_local::record_cache) [[likely]] {
+                l->m_records[l->m_record_count++] = r;
+                return;
+            }
+            m_records.release(r);
+        }
+
+        auto retire(_hazard_retired *o) noexcept -> void {
+            auto l = _hazard_local_of(this);
+            if (l == nullptr) [[unlikely]] {
+                push_shared(o, o, 1);
+                if (m_shared_count.load(std::memory_order_relaxed) >= threshold()) {
+                    m_shared_count.store(0, std::memory_order_relaxed);
+                    reclaim(m_shared.exchange(nullptr, std::memory_order_acquire), nullptr);
+                }
+                return;
+            }
+            o->m_next = l->m_retired;
+            l->m_retired = o;
+            if (++l->m_retired_count >= threshold()) [[unlikely]] {
+                cleanup();
+            }
+        }
+
+        // 立即扫描本线程与共享的退休对象，回收没有被保护的对象
+        auto cleanup() noexcept -> void {
+            auto list = m_shared.exchange(nullptr, std::memory_order_acquire);
+            m_shared_count.store(0, std::memory_order_relaxed);
+            auto l = _hazard_local_of(this, false);
+            if (l) {
+                list = concat(std::exchange(l->m_retired, nullptr), list);
+                l->m_retired_count = 0;
+            }
+            reclaim(list, l);
+        }
+
+        // 线程退出：归还缓存的记录，回收一次本地退休对象，剩下的交给共享链表
+        auto detach(_hazard_local &l) noexcept -> void {
+            for (auto i = size_t{0}; i < l.m_record_count; ++i) {
+                m_records.release(l.m_records[i]);
+            }
+            auto list = std::exchange(l.m_retired, nullptr);
+            l = _hazard_local{};
+            reclaim(list, nullptr);
+        }
+
+      private:
+        auto threshold() const noexcept -> size_t { return 2 * m_records.size() + scan_base; }
+
+        auto push_shared(_hazard_retired *first, _hazard_retired *last, size_t n) noexcept -> void {
+            last->m_next = m_shared.load(std::memory_order_relaxed);
+            while (!m_shared.compare_exchange_weak(last->m_next, first, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+            m_shared_count.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        // 回收 list 中没有被任何记录保护的对象，其余放回 l 的本地链表（l 为空时放回共享链表）
+        auto reclaim(_hazard_retired *list, _hazard_local *l) noexcept -> void {
+            if (list == nullptr) {
+                return;
+            }
+            // 与 hazard_pointer::try_protect 中的栅栏配对：读者要么看到对象已被移除，要么它的保护对这里可见
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto hazards = vector<const void *>();
+            hazards.reserve(m_records.size());
+            for (auto r = m_records.head(); r; r = r->m_next) {
+                if (auto p = r->m_ptr.load(std::memory_order_acquire)) {
+                    hazards.push_back(p);
+                }
+            }
+            std::sort(hazards.begin(), hazards.end());
+
+            auto kept = static_cast<_hazard_retired *>(nullptr);
+            auto kept_last = kept;
+            auto kept_count = size_t{0};
+            auto dead = static_cast<_hazard_retired *>(nullptr);
+            while (list) {
+                auto o = std::exchange(list, list->m_next);
+                if (std::binary_search(hazards.begin(), hazards.end(), o->m_key)) {
+                    o->m_next = kept;
+                    kept = o;
+                    kept_last = kept_last ? kept_last : o;
+                    ++kept_count;
+                } else {
+                    o->m_next = dead;
+                    dead = o;
+                }
+            }
+            // 先放回仍被保护的对象，删除器中再次退休对象时本地链表处于一致状态
+            if (kept) {
+                if (l) {
+                    kept_last->m_next = l->m_retired;
+                    l->m_retired = kept;
+                    l->m_retired_count += kept_count;
+                } else {
+                    push_shared(kept, kept_last, kept_count);
+                }
+            }
+            while (dead) {
+                auto next = dead->m_next;
+                dead->m_reclaim(dead);
+                dead = next;
+            }
+        }
+
+        static auto concat(_hazard_retired *a, _hazard_retired *b) noexcept -> _hazard_retired * {
+            if (a == nullptr) {
+                return b;
+            }
+            auto last = a;
+            while (last->m_next) {
+                last = last->m_next;
+            }
+            last->m_next = b;
+            return a;
+        }
+
+      public:
+        _slot_list<_hazard_record> m_records;
+        std::atomic<_hazard_retired *> m_shared{nullptr}; // 线程退出或没有本地状态时留下的退休对象
+        std::atomic<size_t> m_shared_count{0};
+    };
+
+    inline auto hazard_pointer_default_domain() noexcept -> hazard_pointer_domain & {
+        static auto domain = hazard_pointer_domain();
+        return domain;
+    }
+
+    // 调用前线程已标记为退出，回收时删除器再退休的对象直接进入共享链表
+    inline auto _hazard_thread::on_thread_exit() noexcept -> void {
+        for (auto &l : m_locals) {
+            if (l.m_domain) {
+                l.m_domain->detach(l);
+            }
+        }
+    }
+} // namespace mtl
+
+// hazard_pointer_obj_base
+namespace mtl {
+    // 可以被危险指针保护的对象的基类，T 为派生类。
+    // retire 之后对象不再可达，等到没有危险指针保护它时由删除器 d 销毁；删除器保存在对象内部，无需额外分配
+    template <typename T, typename D = default_delete<T>>
+    class hazard_pointer_obj_base : public _retire_base<_hazard_retired, T, D> {
+      public:
+        auto retire(D d = D(), hazard_pointer_domain &domain = hazard_pointer_default_domain()) noexcept -> void {
+            auto o = this->bind(std::move(d));
+            o->m_key = static_cast<const T *>(this);
+            domain.retire(o);
+        }
+
+      protected:
+        hazard_pointer_obj_base() noexcept = default;
+
+        ~hazard_pointer_obj_base() = default;
+    };
+} // namespace mtl
+
+// hazard_pointer
+namespace mtl {
+    // 单个危险指针，移动语义。默认构造的危险指针为空，需要通过 make_hazard_pointer 取得。
+    // 保护期间被保护的对象即使已经退休也不会被回收
+    class hazard_pointer {
+      public:
+        hazard_pointer() noexcept = default;
+
+        hazard_pointer(hazard_pointer &&h) noexcept : m_record(std::exchange(h.m_record, nullptr)), m_domain(std::exchange(h.m_domain, nullptr)) {}
+
+        auto operator=(hazard_pointer &&h) noexcept -> hazard_pointer & {
+            hazard_pointer(std::move(h)).swap(*this);
+            return *this;
+        }
+
+        ~hazard_pointer() {
+            if (m_record) {
+                m_domain->release(m_record);
+            }
+        }
+
+      public:
+        auto empty() const noexcept -> bool { return m_record == nullptr; }
+
+        // 读取 src 并保护读到的指针，直到 src 在保护发布之后依然指向同一对象
+        template <typename T>
+        auto protect(const std::atomic<T *> &src) noexcept -> T * {
+            auto p = src.load(std::memory_order_relaxed);
+            while (!try_protect(p, src)) {
+            }
+            return p;
+        }
+
+        // 保护 ptr，并检查 src 是否依然等于 ptr；失败时 ptr 更新为 src 的当前值，且不保护任何对象
+        template <typename T>
+        auto try_protect(T *&ptr, const std::atomic<T *> &src) noexcept -> bool {
+            auto p = ptr;
+            reset_protection(p);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            ptr = src.load(std::memory_order_acquire);
+            if (p != ptr) {
+                reset_protection();
+                return false;
+            }
+            return true;
+        }
+
+        template <typename T>
+        auto reset_protection(const T *ptr) noexcept -> void { m_record->m_ptr.store(ptr, std::memory_order_release); }
+
+        auto reset_protection(std::nullptr_t = nullptr) noexcept -> void { m_record->m_ptr.store(nullptr, std::memory_order_release); }
+
+        auto swap(hazard_pointer &h) noexcept -> void {
+            std::swap(m_record, h.m_record);
+            std::swap(m_domain, h.m_domain);
+        }
+
+      public:
+        _hazard_record *m_record{nullptr};
+        hazard_pointer_domain *m_domain{nullptr};
+    };
+
+    inline auto make_hazard_pointer(hazard_pointer_domain &domain = hazard_pointer_default_domain()) -> hazard_pointer {
+        auto h = hazard_pointer();
+        h.m_record = domain.acquire();
+        h.m_domain = &domain;
+        return h;
+    }
+
+    inline auto swap(hazard_pointer &lhs, hazard_pointer &rhs) noexcept -> void { lhs.swap(rhs); }
+} // namespace mtl
@@ -0,0 +1,258 @@
+/*
+    有界多生产者多消费者队列
+    https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+*/
+#pragma once
+#include "common.hpp"
+#include "utility/memory.hpp"
+#include "utility/optional.hpp"
+#include <atomic>
+#include <bit>
+#include <stdexcept>
+#include <type_traits>
+
+// mpmc queue
+namespace mtl {
+    // 每个单元有一个序号 seq：seq == pos 表示第 pos 次入队可以写入，seq == pos + 1 表示第 pos 次出队可以读取，
+    // 出队后 seq 设为 pos + 容量，供下一轮入队使用。线程通过 CAS 推进入队 / 出队下标来认领单元。
+    // 每个单元独占缓存行，相邻单元上的生产者和消费者互不干扰。
+    //
+    // push / pop 为阻塞版本：直接用 fetch_add 认领单元，再通过 std::atomic::wait 等待单元就绪。
+    // 非阻塞操作释放单元时，只有存在阻塞等待者才调用 notify_all。
+    template <typename T, typename Alloc = allocator<T>>
+    class mpmc_queue {
+        // 出队时单元已被认领，移动抛出异常后无法退回，单元的序号不再推进，绕回到该单元的生产者会永远等待
+        static_assert(std::is_nothrow_move_constructible_v<T>, "mpmc_queue 要求 T 的移动构造不抛出异常");
+
+        struct alignas(cache_line_size) cell {
+            std::atomic<size_t> seq;
+            alignas(T) std::byte data[sizeof(T)];
+        };
+
+        using cell_alloc = allocator_traits<Alloc>::template rebind_alloc<cell>;
+        using cell_traits = allocator_traits<cell_alloc>;
+
+      public:
+        using value_type = T;
+        using size_type = size_t;
+        using allocator_type = Alloc;
+
+        // 构造
+      public:
+        // 容量向上取整为 2 的幂
+        explicit mpmc_queue(size_type capacity, const Alloc &a = Alloc()) : m_alloc(a) {
+            if (capacity == 0 || capacity > (size_type{1} << (sizeof(size_type) * 8 - 2))) {
+                throw std::invalid_argument("mpmc_queue capacity");
+            }
+            m_mask = std::bit_ceil(std::max<size_type>(capacity, 2)) - 1;
+            m_cells = cell_traits::allocate(m_alloc, m_mask + 1);
+            for (auto i = size_type{0}; i <= m_mask; ++i) {
+                new (m_cells + i) cell;
+                m_cells[i].seq.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        mpmc_queue(const mpmc_queue &) = delete;
+
+        auto operator=(const mpmc_queue &) -> mpmc_queue & = delete;
+
+        ~mpmc_queue() {
+            auto head = m_deq.load(std::memory_order_relaxed);
+            auto tail = m_enq.load(std::memory_order_relaxed);
+            for (; head != tail; ++head) {
+                std::destroy_at(slot(at(head)));
+            }
+            for (auto i = size_type{0}; i <= m_mask; ++i) {
+                m_cells[i].~cell();
+            }
+            cell_traits::deallocate(m_alloc, m_cells, m_mask + 1);
+        }
+
+        // 入队
+      public:
+        template <typename... Args>
+        auto try_emplace(Args &&...args) -> bool {
+            auto pos = m_enq.load(std::memory_order_relaxed);
+            for (;;) {
+                auto &c = at(pos);
+                auto dif = static_cast<ptrdiff_t>(c.seq.load(std::memory_order_acquire) - pos);
+                if (dif == 0) {
+                    if (m_enq.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        construct(c, pos, std::forward<Args>(args)...);
+                        return true;
+                    }
+                } else if (dif < 0) {
+                    return false; // 满
+                } else {
+                    pos = m_enq.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        auto try_push(const T &value) -> bool { return try_emplace(value); }
+
+        auto try_push(T &&value) -> bool { return try_emplace(std::move(value)); }
+
+        // 队列满时阻塞
+        template <typename... Args>
+        auto emplace(Args &&...args) -> void {
+            auto pos = m_enq.fetch_add(1, std::memory_order_relaxed);
+            auto &c = at(pos);
+            wait_for(c, pos);
+            construct(c, pos, std::forward<Args>(args)...);
+        }
+
+        auto push(const T &value) -> void { emplace(value); }
+
+        auto push(T &&value) -> void { emplace(std::move(value)); }
+
+        // 出队
+      public:
+        auto try_pop(T &out) -> bool {
+            auto pos = m_deq.load(std::memory_order_relaxed);
+            for (;;) {
+                auto &c = at(pos);
+                auto dif = static_cast<ptrdiff_t>(c.seq.load(std::memory_order_acquire) - (pos + 1));
+                if (dif == 0) {
+                    if (m_deq.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        consume(c, pos, out);
+                        return true;
+                    }
+                } else if (dif < 0) {
+                    return false; // 空
+                } else {
+                    pos = m_deq.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        auto try_pop() -> optional<T> {
+            auto ret = optional<T>();
+            auto pos = m_deq.load(std::memory_order_relaxed);
+            for (;;) {
+                auto &c = at(pos);
+                auto dif = static_cast<ptrdiff_t>(c.seq.load(std::memory_order_acquire) - (pos + 1));
+                if (dif == 0) {
+                    if (m_deq.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        ret.emplace(std::move(*slot(c)));
+                        release(c, pos);
+                        return ret;
+                    }
+                } else if (dif < 0) {
+                    return ret;
+                } else {
+                    pos = m_deq.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // 队列空时阻塞
+        auto pop() -> T {
+            auto pos = m_deq.fetch_add(1, std::memory_order_relaxed);
+            auto &c = at(pos);
+            wait_for(c, pos + 1);
+            auto ret = T(std::move(*slot(c)));
+            release(c, pos);
+            return ret;
+        }
+
+        // 一次认领连续的至多 n 个已就绪单元并移动到 out，返回实际出队的个数
+        template <typename OutIt>
+        auto try_pop_n(OutIt out, size_type n) -> size_type {
+            auto pos = m_deq.load(std::memory_order_relaxed);
+            for (;;) {
+                auto k = size_type{0};
+                while (k < n && k <= m_mask && at(pos + k).seq.load(std::memory_order_acquire) == pos + k + 1) {
+                    ++k;
+                }
+                if (k == 0) {
+                    auto dif = static_cast<ptrdiff_t>(at(pos).seq.load(std::memory_order_acquire) - (pos + 1));
+                    if (dif < 0) {
+                        return 0;
+                    }
+                    pos = m_deq.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (m_deq.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) {
+                    for (auto i = size_type{0}; i < k; ++i, ++out) {
+                        consume(at(pos + i), pos + i, *out);
+                    }
+                    return k;
+                }
+            }
+        }
+
+        // observer
+      public:
+        auto capacity() const noexcept -> size_type { return m_mask + 1; }
+
+        // 并发修改时只是近似值，阻塞出队认领了尚未入队的单元时可能为负，此时返回 0
+        auto size() const noexcept -> size_type {
+            auto tail = m_enq.load(std::memory_order_relaxed);
+            auto head = m_deq.load(std::memory_order_relaxed);
+            auto dif = static_cast<ptrdiff_t>(tail - head);
+            return dif < 0 ? 0 : std::min(static_cast<size_type>(dif), capacity());
+        }
+
+        auto empty() const noexcept -> bool { return size() == 0; }
+
+        // 内部实现
+      private:
+        auto at(size_type pos) const noexcept -> cell & { return m_cells[pos & m_mask]; }
+
+        static auto slot(cell &c) noexcept -> T * { return std::launder(reinterpret_cast<T *>(c.data)); }
+
+        // 单元已被认领，无法退回，构造或移动抛出异常时直接终止
+        template <typename... Args>
+        auto construct(cell &c, size_type pos, Args &&...args) noexcept -> void {
+            std::construct_at(slot(c), std::forward<Args>(args)...);
+            publish(c, pos + 1);
+        }
+
+        template <typename Out>
+        auto consume(cell &c, size_type pos, Out &out) noexcept -> void {
+            out = std::move(*slot(c));
+            release(c, pos);
+        }
+
+        auto release(cell &c, size_type pos) noexcept -> void {
+            std::destroy_at(slot(c));
+            publish(c, pos + m_mask + 1);
+        }
+
+        // 与 wait_for 中的 fetch_add 构成 Dekker 式同步：要么等待者看到新序号，要么这里看到等待者
+        auto publish(cell &c, size_type seq) noexcept -> void {
+            c.seq.store(seq, std::memory_order_seq_cst);
+            if (m_waiters.load(std::memory_order_seq_cst) != 0) [[unlikely]] {
+                c.seq.notify_all();
+            }
+        }
+
+        auto wait_for(cell &c, size_type seq) noexcept -> void {
+            // 先短暂自旋，仍未就绪再休眠
+            auto cur = c.seq.load(std::memory_order_acquire);
+            for (auto i = 0; cur != seq && i < 64; ++i) {
+                cpu_relax();
+                cur = c.seq.load(std::memory_order_acquire);
+            }
+            if (cur == seq) {
+                return;
+            }
+            m_waiters.fetch_add(1, std::memory_order_seq_cst);
+            while ((cur = c.seq.load(std::memory_order_seq_cst)) != seq) {
+                c.seq.wait(cur, std::memory_order_acquire);
+            }
+            m_waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+      public:
+        // 只读的部分
+        cell *m_cells;
+        size_type m_mask;
+        [[no_unique_address]] cell_alloc m_alloc;
+        // 三个计数器各占一个缓存行
+        alignas(cache_line_size) std::atomic<size_type> m_enq{0};
+        alignas(cache_line_size) std::atomic<size_type> m_deq{0};
+        alignas(cache_line_size) std::atomic<uint32_t> m_waiters{0};
+    };
+} // namespace mtl
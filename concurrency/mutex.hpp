@@ -0,0 +1,199 @@
+/*
+    互斥锁与顺序锁
+    https://timsong-cpp.github.io/cppwp/n4861/thread.req.lockable
+    futex 互斥锁：Ulrich Drepper, Futexes Are Tricky, https://akkadia.org/drepper/futex.pdf
+    顺序锁：Hans-J. Boehm, Can Seqlocks Get Along With Programming Language Memory Models?
+*/
+#pragma once
+#include "common.hpp"
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+// spin_mutex
+namespace mtl {
+    // 自旋锁，只占 1 字节。先只读地等待锁被释放再尝试交换（test-and-test-and-set），
+    // 等待时不反复写入缓存行；等待稍久后让出时间片。适合临界区极短且很少竞争的场景。
+    // 满足 Lockable，可以与 std::lock_guard、std::unique_lock 一起使用
+    class spin_mutex {
+      public:
+        spin_mutex() noexcept = default;
+
+        spin_mutex(const spin_mutex &) = delete;
+
+        auto operator=(const spin_mutex &) -> spin_mutex & = delete;
+
+      public:
+        auto lock() noexcept -> void {
+            while (m_locked.exchange(true, std::memory_order_acquire)) {
+                auto b = backoff();
+                while (m_locked.load(std::memory_order_relaxed)) {
+                    b.pause();
+                }
+            }
+        }
+
+        auto try_lock() noexcept -> bool { return !m_locked.load(std::memory_order_relaxed) && !m_locked.exchange(true, std::memory_order_acquire); }
+
+        auto unlock() noexcept -> void { m_locked.store(false, std::memory_order_release); }
+
+      public:
+        std::atomic<bool> m_locked{false};
+    };
+} // namespace mtl
+
+// futex_mutex
+namespace mtl {
+    // 自适应互斥锁，只占 4 字节。无竞争时加锁、解锁各一次原子操作；有竞争时先自旋一小段时间，
+    // 仍未获得再在 futex 上睡眠。状态中记录是否有睡眠者，解锁时只在有睡眠者时才进行唤醒的系统调用。
+    // 满足 Lockable
+    class futex_mutex {
+        static constexpr uint32_t unlocked = 0;
+        static constexpr uint32_t locked = 1;
+        static constexpr uint32_t contended = 2; // 已加锁，且可能有线程在 futex 上睡眠
+
+        static constexpr int spin_limit = 100;
+
+      public:
+        futex_mutex() noexcept = default;
+
+        futex_mutex(const futex_mutex &) = delete;
+
+        auto operator=(const futex_mutex &) -> futex_mutex & = delete;
+
+      public:
+        auto lock() noexcept -> void {
+            auto s = unlocked;
+            if (!m_state.compare_exchange_strong(s, locked, std::memory_order_acquire, std::memory_order_relaxed)) [[unlikely]] {
+                lock_slow(s);
+            }
+        }
+
+        auto try_lock() noexcept -> bool {
+            auto s = unlocked;
+            return m_state.compare_exchange_strong(s, locked, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        auto unlock() noexcept -> void {
+            if (m_state.exchange(unlocked, std::memory_order_release) == contended) [[unlikely]] {
+                futex_wake_one(m_state);
+            }
+        }
+
+      private:
+        auto lock_slow(uint32_t s) noexcept -> void {
+            // 锁很快被释放时，自旋比睡眠再被唤醒便宜得多；已有睡眠者时不再自旋
+            for (auto i = 0; i < spin_limit && s == locked; ++i) {
+                cpu_relax();
+                s = m_state.load(std::memory_order_relaxed);
+                if (s == unlocked && m_state.compare_exchange_weak(s, locked, std::memory_order_acquire, std::memory_order_relaxed)) {
+                    return;
+                }
+            }
+            // 以 contended 状态获得锁：无法确定是否还有其他睡眠者，解锁时必须唤醒一次
+            while (m_state.exchange(contended, std::memory_order_acquire) != unlocked) {
+                futex_wait(m_state, contended);
+            }
+        }
+
+      public:
+        std::atomic<uint32_t> m_state{unlocked};
+    };
+} // namespace mtl
+
+// seqlock
+namespace mtl {
+    // 顺序锁：读多写少的小结构体。读者不写任何共享内存，只在读取前后比较版本号，读到写入中途的数据时重试；
+    // 写者之间互斥，写入时版本号为奇数。
+    // 数据按 8 字节拆成若干 relaxed 原子字存放，读者与写者并发访问时没有数据竞争
+    template <typename T>
+        requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+    class seqlock {
+        static constexpr size_t word_count = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+      public:
+        seqlock() noexcept : seqlock(T()) {}
+
+        explicit seqlock(const T &v) noexcept { write(v); }
+
+        seqlock(const seqlock &) = delete;
+
+        auto operator=(const seqlock &) -> seqlock & = delete;
+
+      public:
+        auto load() const noexcept -> T {
+            auto b = backoff();
+            for (;;) {
+                auto s0 = m_seq.load(std::memory_order_acquire);
+                if ((s0 & 1) == 0) {
+                    auto v = read();
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (m_seq.load(std::memory_order_relaxed) == s0) {
+                        return v;
+                    }
+                }
+                b.pause();
+            }
+        }
+
+        auto store(const T &v) noexcept -> void {
+            auto s = begin_write();
+            write(v);
+            m_seq.store(s + 2, std::memory_order_release);
+        }
+
+        // 在写锁内以当前值调用 f(T &)，再写回修改后的值
+        template <typename F>
+        auto update(F &&f) -> void {
+            auto s = begin_write();
+            auto v = read();
+            try {
+                f(v);
+            } catch (...) {
+                m_seq.store(s + 2, std::memory_order_release);
+                throw;
+            }
+            write(v);
+            m_seq.store(s + 2, std::memory_order_release);
+        }
+
+      private:
+        // 把版本号从偶数 s 改为奇数，返回 s
+        auto begin_write() noexcept -> uint64_t {
+            auto b = backoff();
+            auto s = m_seq.load(std::memory_order_relaxed);
+            for (;;) {
+                if ((s & 1) == 0 && m_seq.compare_exchange_weak(s, s + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                    break;
+                }
+                b.pause();
+                s = m_seq.load(std::memory_order_relaxed);
+            }
+            // 数据的写入不能被重排到版本号变为奇数之前
+            std::atomic_thread_fence(std::memory_order_release);
+            return s;
+        }
+
+        auto read() const noexcept -> T {
+            uint64_t words[word_count];
+            for (auto i = size_t{0}; i < word_count; ++i) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+            auto v = T();
+            std::memcpy(&v, words, sizeof(T));
+            return v;
+        }
+
+        auto write(const T &v) noexcept -> void {
+            uint64_t words[word_count]{};
+            std::memcpy(words, &v, sizeof(T));
+            for (auto i = size_t{0}; i < word_count; ++i) {
+                m_words[i].store(words[i], std::memory_order_relaxed);
+            }
+        }
+
+      public:
+        std::atomic<uint64_t> m_seq{0};
+        std::atomic<uint64_t> m_words[word_count];
+    };
+} // namespace mtl
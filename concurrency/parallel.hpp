@@ -0,0 +1,473 @@
+/*
+    连续范围上的并行算法
+    https://timsong-cpp.github.io/cppwp/n4861/algorithms.parallel
+    样本排序：https://en.wikipedia.org/wiki/Samplesort
+*/
+#pragma once
+#include "thread_pool.hpp"
+#include "container/vector.hpp"
+#include "utility/functional.hpp"
+#include "utility/memory.hpp"
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+// executor
+namespace mtl::par {
+    // 执行器把 bulk_run(n, f) 的 n 个单元 f(0) ... f(n - 1) 并发执行完再返回，concurrency() 为可并行的线程数。
+    // 算法的可调用对象作为模板参数内联，只有跨过执行器边界时才以 function_ref 的形式擦除类型，不复制、不分配。
+    template <typename E>
+    concept executor = requires(E &e, size_t n, function_ref<void(size_t)> f) {
+        { e.concurrency() } -> std::convertible_to<size_t>;
+        e.bulk_run(n, f);
+    };
+
+    // 在调用线程上顺序执行
+    class inline_executor {
+      public:
+        auto concurrency() const noexcept -> size_t { return 1; }
+
+        auto bulk_run(size_t n, function_ref<void(size_t)> f) const -> void {
+            for (auto i = size_t{0}; i < n; ++i) {
+                f(i);
+            }
+        }
+    };
+
+    // 把单元分给线程池的工作线程和调用线程，参与者通过 fetch_add 领取下一个单元，先做完的线程多做。
+    // 调用线程做完自己能领到的单元后收回还没开始的辅助任务，只等待已经进入 work() 的参与者，
+    // 工作线程繁忙时不会被排队中的辅助任务拖住。迟到的辅助任务什么也不做，共享状态由引用计数释放。
+    // 调用线程是同一线程池的工作线程时，等待期间协助执行池中的任务，因此可以在任务中嵌套调用并行算法。
+    // 与标准库带执行策略的算法一致，单元抛出异常时调用 std::terminate。
+    class pool_executor {
+        struct shared {
+            auto work() noexcept -> void {
+                for (auto i = m_next.fetch_add(1, std::memory_order_relaxed); i < m_n; i = m_next.fetch_add(1, std::memory_order_relaxed)) {
+                    m_f(i);
+                }
+            }
+
+            // 辅助任务开始时领取一个名额，名额已被调用线程收回时返回 false
+            auto enter() noexcept -> bool {
+                auto p = m_pending.load(std::memory_order_relaxed);
+                while (p != 0 && !m_pending.compare_exchange_weak(p, p - 1, std::memory_order_relaxed)) {
+                }
+                return p != 0;
+            }
+
+            auto release() noexcept -> void {
+                if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    delete this;
+                }
+            }
+
+            function_ref<void(size_t)> m_f;
+            size_t m_n;
+            std::atomic<size_t> m_next;
+            // 还没开始的辅助任务数
+            std::atomic<size_t> m_pending;
+            // 还没开始或正在 work() 中的辅助任务数
+            std::atomic<size_t> m_active;
+            std::atomic<size_t> m_refs;
+        };
+
+      public:
+        explicit pool_executor(thread_pool &pool) noexcept : m_pool(&pool) {}
+
+      public:
+        auto concurrency() const noexcept -> size_t { return m_pool->size(); }
+
+        auto bulk_run(size_t n, function_ref<void(size_t)> f) const -> void {
+            if (n <= 1) {
+                if (n == 1) {
+                    f(0);
+                }
+                return;
+            }
+            auto helpers = std::min(m_pool->size(), n - 1);
+            auto s = new shared{f, n, {0}, {helpers}, {helpers}, {helpers + 1}};
+            for (auto i = size_t{0}; i < helpers; ++i) {
+                m_pool->execute([s] {
+                    if (s->enter()) {
+                        s->work();
+                        s->m_active.fetch_sub(1, std::memory_order_release);
+                    }
+                    s->release();
+                });
+            }
+            s->work();
+            // 单元已经全部领完，收回还没开始的辅助任务，只需等待其他参与者做完手上的单元
+            s->m_active.fetch_sub(s->m_pending.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+            auto self = thread_pool::current() == m_pool;
+            auto b = backoff();
+            while (s->m_active.load(std::memory_order_acquire) != 0) {
+                if (self && m_pool->try_run_one()) {
+                    b.reset();
+                } else {
+                    b.pause();
+                }
+            }
+            s->release();
+        }
+
+      public:
+        thread_pool *m_pool;
+    };
+
+    // 进程内共享的线程池，第一次使用时创建，线程数为硬件并发数
+    inline auto default_pool() -> thread_pool & {
+        static auto pool = thread_pool();
+        return pool;
+    }
+
+    inline auto default_executor() -> pool_executor { return pool_executor(default_pool()); }
+} // namespace mtl::par
+
+// chunking
+namespace mtl::par {
+    // 元素少于它时不再切分，切分的收益抵不过调度开销
+    inline constexpr size_t _min_grain = 2048;
+
+    // 自适应分块：每个参与者反复领取「剩余元素数 / (2 × 参与者数)」个元素（不少于 _min_grain）。
+    // 开始时块大，调度次数少；接近结束时块变小，负载不均的尾部被摊开，各线程几乎同时完成。
+    template <typename E, typename F>
+    auto _for_ranges(E &ex, size_t n, F &&f) -> void {
+        auto p = static_cast<size_t>(ex.concurrency());
+        if (p <= 1 || n <= _min_grain) {
+            if (n != 0) {
+                f(size_t{0}, n);
+            }
+            return;
+        }
+        auto next = std::atomic<size_t>(0);
+        ex.bulk_run(p, [&](size_t) {
+            for (auto cur = next.load(std::memory_order_relaxed); cur < n;) {
+                auto end = std::min(n, cur + std::max(_min_grain, (n - cur) / (2 * p)));
+                if (next.compare_exchange_weak(cur, end, std::memory_order_relaxed)) {
+                    f(cur, end);
+                    cur = next.load(std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    // 固定分块的块数：归约、扫描、排序需要按块保存中间结果，块数取参与者数的 4 倍以便负载均衡
+    template <typename E>
+    auto _block_count(E &ex, size_t n) -> size_t {
+        return std::clamp<size_t>(n / _min_grain, 1, static_cast<size_t>(ex.concurrency()) * 4);
+    }
+
+    // [0, n) 均分为 blocks 块，对第 k 块调用 f(k, begin, end)
+    template <typename E, typename F>
+    auto _for_blocks(E &ex, size_t n, size_t blocks, F &&f) -> void {
+        ex.bulk_run(blocks, [&](size_t k) { f(k, n * k / blocks, n * (k + 1) / blocks); });
+    }
+
+    // 未初始化的临时缓冲区：排序、划分时元素先移动到这里再移动回去，归约、扫描时存放每块的中间结果。
+    // 由使用者负责构造和销毁其中的元素
+    template <typename T>
+    class _buffer {
+      public:
+        explicit _buffer(size_t n) : m_data(allocator<T>().allocate(n)), m_size(n) {}
+
+        _buffer(const _buffer &) = delete;
+
+        ~_buffer() { allocator<T>().deallocate(m_data, m_size); }
+
+        T *m_data;
+        size_t m_size;
+    };
+
+    // 按下标归约：每块先求部分和，再按块的顺序合并，结果与线程调度无关
+    template <typename E, typename T, typename R, typename G>
+    auto _reduce(E &ex, size_t n, T init, R &red, G &&get) -> T {
+        auto blocks = _block_count(ex, n);
+        if (blocks == 1) {
+            for (auto i = size_t{0}; i < n; ++i) {
+                init = red(std::move(init), get(i));
+            }
+            return init;
+        }
+        auto partial = _buffer<T>(blocks);
+        _for_blocks(ex, n, blocks, [&](size_t k, size_t b, size_t e) {
+            auto acc = T(get(b));
+            for (auto i = b + 1; i < e; ++i) {
+                acc = red(std::move(acc), get(i));
+            }
+            std::construct_at(partial.m_data + k, std::move(acc));
+        });
+        for (auto k = size_t{0}; k < blocks; ++k) {
+            init = red(std::move(init), std::move(partial.m_data[k]));
+        }
+        std::destroy(partial.m_data, partial.m_data + blocks);
+        return init;
+    }
+} // namespace mtl::par
+
+// for_each / transform
+namespace mtl::par {
+    template <executor E, std::contiguous_iterator It, typename F>
+    auto for_each(E &&ex, It first, It last, F f) -> void {
+        auto p = std::to_address(first);
+        _for_ranges(ex, static_cast<size_t>(last - first), [&](size_t b, size_t e) {
+            for (auto i = b; i < e; ++i) {
+                f(p[i]);
+            }
+        });
+    }
+
+    template <std::contiguous_iterator It, typename F>
+    auto for_each(It first, It last, F f) -> void {
+        for_each(default_executor(), first, last, std::move(f));
+    }
+
+    template <executor E, std::contiguous_iterator It, std::contiguous_iterator Out, typename F>
+    auto transform(E &&ex, It first, It last, Out d_first, F op) -> Out {
+        auto n = static_cast<size_t>(last - first);
+        auto p = std::to_address(first);
+        auto out = std::to_address(d_first);
+        _for_ranges(ex, n, [&](size_t b, size_t e) {
+            for (auto i = b; i < e; ++i) {
+                out[i] = op(p[i]);
+            }
+        });
+        return d_first + static_cast<std::iter_difference_t<Out>>(n);
+    }
+
+    template <std::contiguous_iterator It, std::contiguous_iterator Out, typename F>
+    auto transform(It first, It last, Out d_first, F op) -> Out {
+        return transform(default_executor(), first, last, d_first, std::move(op));
+    }
+
+    template <executor E, std::contiguous_iterator It1, std::contiguous_iterator It2, std::contiguous_iterator Out, typename F>
+    auto transform(E &&ex, It1 first1, It1 last1, It2 first2, Out d_first, F op) -> Out {
+        auto n = static_cast<size_t>(last1 - first1);
+        auto p1 = std::to_address(first1);
+        auto p2 = std::to_address(first2);
+        auto out = std::to_address(d_first);
+        _for_ranges(ex, n, [&](size_t b, size_t e) {
+            for (auto i = b; i < e; ++i) {
+                out[i] = op(p1[i], p2[i]);
+            }
+        });
+        return d_first + static_cast<std::iter_difference_t<Out>>(n);
+    }
+
+    template <std::contiguous_iterator It1, std::contiguous_iterator It2, std::contiguous_iterator Out, typename F>
+    auto transform(It1 first1, It1 last1, It2 first2, Out d_first, F op) -> Out {
+        return transform(default_executor(), first1, last1, first2, d_first, std::move(op));
+    }
+} // namespace mtl::par
+
+// reduce / transform_reduce
+namespace mtl::par {
+    // op 需要满足结合律；各块的部分和按下标顺序合并，不要求交换律
+    template <executor E, std::contiguous_iterator It, typename T = std::iter_value_t<It>, typename Op = std::plus<>>
+    auto reduce(E &&ex, It first, It last, T init = T(), Op op = Op()) -> T {
+        auto p = std::to_address(first);
+        return _reduce(ex, static_cast<size_t>(last - first), std::move(init), op, [&](size_t i) -> decltype(auto) { return p[i]; });
+    }
+
+    template <std::contiguous_iterator It, typename T = std::iter_value_t<It>, typename Op = std::plus<>>
+    auto reduce(It first, It last, T init = T(), Op op = Op()) -> T {
+        return reduce(default_executor(), first, last, std::move(init), std::move(op));
+    }
+
+    template <executor E, std::contiguous_iterator It, typename T, typename R, typename F>
+    auto transform_reduce(E &&ex, It first, It last, T init, R red, F tr) -> T {
+        auto p = std::to_address(first);
+        return _reduce(ex, static_cast<size_t>(last - first), std::move(init), red, [&](size_t i) { return tr(p[i]); });
+    }
+
+    template <std::contiguous_iterator It, typename T, typename R, typename F>
+    auto transform_reduce(It first, It last, T init, R red, F tr) -> T {
+        return transform_reduce(default_executor(), first, last, std::move(init), std::move(red), std::move(tr));
+    }
+
+    // 默认为内积
+    template <executor E, std::contiguous_iterator It1, std::contiguous_iterator It2, typename T, typename R = std::plus<>, typename F = std::multiplies<>>
+    auto transform_reduce(E &&ex, It1 first1, It1 last1, It2 first2, T init, R red = R(), F tr = F()) -> T {
+        auto p1 = std::to_address(first1);
+        auto p2 = std::to_address(first2);
+        return _reduce(ex, static_cast<size_t>(last1 - first1), std::move(init), red, [&](size_t i) { return tr(p1[i], p2[i]); });
+    }
+
+    template <std::contiguous_iterator It1, std::contiguous_iterator It2, typename T, typename R = std::plus<>, typename F = std::multiplies<>>
+    auto transform_reduce(It1 first1, It1 last1, It2 first2, T init, R red = R(), F tr = F()) -> T {
+        return transform_reduce(default_executor(), first1, last1, first2, std::move(init), std::move(red), std::move(tr));
+    }
+} // namespace mtl::par
+
+// inclusive_scan
+namespace mtl::par {
+    // 三趟：并行求每块的和；顺序求各块的前缀；并行地在每块内带着前缀扫描。op 需要满足结合律。
+    // 输出可以与输入重合。
+    template <executor E, std::contiguous_iterator It, std::contiguous_iterator Out, typename Op = std::plus<>>
+    auto inclusive_scan(E &&ex, It first, It last, Out d_first, Op op = Op()) -> Out {
+        using T = std::iter_value_t<It>;
+        auto n = static_cast<size_t>(last - first);
+        auto p = std::to_address(first);
+        auto out = std::to_address(d_first);
+        // 扫描 [b, e)，prefix 为之前所有元素的和，为空表示从头开始
+        auto scan = [&](size_t b, size_t e, const T *prefix) {
+            auto acc = prefix ? T(op(*prefix, p[b])) : T(p[b]);
+            out[b] = acc;
+            for (auto i = b + 1; i < e; ++i) {
+                acc = op(std::move(acc), p[i]);
+                out[i] = acc;
+            }
+        };
+        auto blocks = _block_count(ex, n);
+        if (blocks == 1) {
+            if (n != 0) {
+                scan(0, n, nullptr);
+            }
+            return d_first + static_cast<std::iter_difference_t<Out>>(n);
+        }
+        // sums[k] 先是第 k 块的和，再原地改为前 k + 1 块的和
+        auto sums = _buffer<T>(blocks);
+        _for_blocks(ex, n, blocks, [&](size_t k, size_t b, size_t e) {
+            auto acc = T(p[b]);
+            for (auto i = b + 1; i < e; ++i) {
+                acc = op(std::move(acc), p[i]);
+            }
+            std::construct_at(sums.m_data + k, std::move(acc));
+        });
+        for (auto k = size_t{1}; k < blocks; ++k) {
+            sums.m_data[k] = op(sums.m_data[k - 1], std::move(sums.m_data[k]));
+        }
+        _for_blocks(ex, n, blocks, [&](size_t k, size_t b, size_t e) { scan(b, e, k == 0 ? nullptr : sums.m_data + k - 1); });
+        std::destroy(sums.m_data, sums.m_data + blocks);
+        return d_first + static_cast<std::iter_difference_t<Out>>(n);
+    }
+
+    template <std::contiguous_iterator It, std::contiguous_iterator Out, typename Op = std::plus<>>
+    auto inclusive_scan(It first, It last, Out d_first, Op op = Op()) -> Out {
+        return inclusive_scan(default_executor(), first, last, d_first, std::move(op));
+    }
+} // namespace mtl::par
+
+// sort
+namespace mtl::par {
+    // 样本排序：
+    // 1. 等距抽取 桶数 × 32 个样本排序，取分位点作为桶的分隔元素；
+    // 2. 并行统计每块中落入每个桶的元素个数，求前缀得到每块每桶的写入位置；
+    // 3. 并行地把元素移动到缓冲区中所属的桶；
+    // 4. 并行地排序每个桶，并移动回原位置。
+    // 每个元素只移动两次，所有趟都是并行的；大量重复元素会落入同一个桶，此时退化为较少的并行度。不稳定。
+    template <executor E, std::contiguous_iterator It, typename Comp = std::less<>>
+    auto sort(E &&ex, It first, It last, Comp comp = Comp()) -> void {
+        using T = std::iter_value_t<It>;
+        constexpr size_t oversample = 32;
+
+        auto n = static_cast<size_t>(last - first);
+        auto p = std::to_address(first);
+        auto buckets = _block_count(ex, n / 8);
+        if (buckets == 1 || ex.concurrency() == 1) {
+            std::sort(p, p + n, comp);
+            return;
+        }
+
+        auto samples = vector<T>();
+        samples.reserve(buckets * oversample);
+        for (auto s = size_t{0}; s < buckets * oversample; ++s) {
+            samples.push_back(p[(2 * s + 1) * n / (2 * buckets * oversample)]);
+        }
+        std::sort(samples.begin(), samples.end(), comp);
+        auto splitters = vector<T>();
+        splitters.reserve(buckets - 1);
+        for (auto j = size_t{1}; j < buckets; ++j) {
+            splitters.push_back(std::move(samples[j * oversample]));
+        }
+        auto bucket_of = [&](const T &x) {
+            return static_cast<size_t>(std::upper_bound(splitters.begin(), splitters.end(), x, comp) - splitters.begin());
+        };
+
+        // offsets[k * buckets + j]：第 k 块中属于桶 j 的元素在缓冲区中的起始位置
+        auto blocks = buckets;
+        auto offsets = vector<size_t>(blocks * buckets);
+        _for_blocks(ex, n, blocks, [&](size_t k, size_t b, size_t e) {
+            auto cnt = offsets.data() + k * buckets;
+            for (auto i = b; i < e; ++i) {
+                ++cnt[bucket_of(p[i])];
+            }
+        });
+        auto starts = vector<size_t>(buckets + 1);
+        for (auto j = size_t{0}, pos = size_t{0}; j < buckets; ++j) {
+            starts[j] = pos;
+            for (auto k = size_t{0}; k < blocks; ++k) {
+                auto c = offsets[k * buckets + j];
+                offsets[k * buckets + j] = pos;
+                pos += c;
+            }
+        }
+        starts[buckets] = n;
+
+        auto buf = _buffer<T>(n);
+        _for_blocks(ex, n, blocks, [&](size_t k, size_t b, size_t e) {
+            auto pos = offsets.data() + k * buckets;
+            for (auto i = b; i < e; ++i) {
+                std::construct_at(buf.m_data + pos[bucket_of(p[i])]++, std::move(p[i]));
+            }
+        });
+        ex.bulk_run(buckets, [&](size_t j) {
+            auto b = buf.m_data + starts[j];
+            auto e = buf.m_data + starts[j + 1];
+            std::sort(b, e, comp);
+            std::move(b, e, p + starts[j]);
+            std::destroy(b, e);
+        });
+    }
+
+    template <std::contiguous_iterator It, typename Comp = std::less<>>
+    auto sort(It first, It last, Comp comp = Comp()) -> void {
+        sort(default_executor(), first, last, std::move(comp));
+    }
+} // namespace mtl::par
+
+// partition
+namespace mtl::par {
+    // 稳定划分：并行统计每块满足 pred 的个数，求前缀后并行地把元素移动到缓冲区中的最终位置，再并行地移动回来。
+    // 返回第二组的起始位置。pred 对每个元素调用两次。
+    template <executor E, std::contiguous_iterator It, typename Pred>
+    auto partition(E &&ex, It first, It last, Pred pred) -> It {
+        using T = std::iter_value_t<It>;
+        auto n = static_cast<size_t>(last - first);
+        auto p = std::to_address(first);
+        auto blocks = _block_count(ex, n);
+        if (blocks == 1 || ex.concurrency() == 1) {
+            return std::stable_partition(first, last, pred);
+        }
+
+        auto hits = vector<size_t>(blocks);
+        _for_blocks(ex, n, blocks, [&](size_t k, size_t b, size_t e) {
+            auto c = size_t{0};
+            for (auto i = b; i < e; ++i) {
+                c += static_cast<bool>(pred(p[i]));
+            }
+            hits[k] = c;
+        });
+        auto total = std::accumulate(hits.begin(), hits.end(), size_t{0});
+
+        auto buf = _buffer<T>(n);
+        _for_blocks(ex, n, blocks, [&](size_t k, size_t b, size_t e) {
+            // 本块之前的块中满足 pred 的个数
+            auto before = std::accumulate(hits.begin(), hits.begin() + static_cast<ptrdiff_t>(k), size_t{0});
+            auto yes = before;
+            auto no = total + (b - before);
+            for (auto i = b; i < e; ++i) {
+                std::construct_at(buf.m_data + (pred(p[i]) ? yes++ : no++), std::move(p[i]));
+            }
+        });
+        _for_blocks(ex, n, blocks, [&](size_t, size_t b, size_t e) {
+            std::move(buf.m_data + b, buf.m_data + e, p + b);
+            std::destroy(buf.m_data + b, buf.m_data + e);
+        });
+        return first + static_cast<std::iter_difference_t<It>>(total);
+    }
+
+    template <std::contiguous_iterator It, typename Pred>
+    auto partition(It first, It last, Pred pred) -> It {
+        return partition(default_executor(), first, last, std::move(pred));
+    }
+} // namespace mtl::par
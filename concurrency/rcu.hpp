@@ -0,0 +1,260 @@
+/*
+    基于纪元的 RCU（read-copy-update）内存回收
+    https://www.open-std.org/jtc1/sc22/wg21/docs/papers/2023/p2545r4.pdf
+    Paul E. McKenney, Is Parallel Programming Hard, And, If So, What Can You Do About It?, 第 9.5 节
+*/
+#pragma once
+#include "common.hpp"
+#include "utility/unique_ptr.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace mtl {
+    class rcu_domain;
+
+    auto rcu_default_domain() noexcept -> rcu_domain &;
+} // namespace mtl
+
+// storage
+namespace mtl {
+    // 每个读者线程独占一个槽位：高位为进入读临界区时的全局纪元，低 nest_bits 位为嵌套深度，0 表示不在临界区内。
+    // 槽位保存在域的 _slot_list 中，线程退出后供其他线程复用。按缓存行对齐，读者之间不会争用缓存行
+    struct alignas(cache_line_size) _rcu_slot {
+        static constexpr unsigned nest_bits = 16;
+        static constexpr uint64_t nest_mask = (uint64_t{1} << nest_bits) - 1;
+
+        std::atomic<uint64_t> m_word{0};
+        std::atomic<bool> m_active{true};
+        _rcu_slot *m_next{nullptr};
+    };
+
+    // 退休对象的公共部分，通过 m_next 串成待回收链表
+    struct _rcu_retired {
+        _rcu_retired *m_next{nullptr};
+        void (*m_reclaim)(_rcu_retired *){nullptr};
+    };
+
+    struct _rcu_thread {
+        // 线程退出时归还槽位
+        auto on_thread_exit() noexcept -> void {
+            if (auto s = std::exchange(m_slot, nullptr)) {
+                _slot_list<_rcu_slot>::release(s);
+            }
+        }
+
+        _rcu_slot *m_slot;
+    };
+} // namespace mtl
+
+// rcu_domain
+namespace mtl {
+    // RCU 域，只有 rcu_default_domain() 一个实例，读者线程可以直接缓存自己的槽位。
+    // 读者：进入最外层临界区时把当前纪元写入自己的槽位并执行一次栅栏，退出时清零，不写任何共享变量。
+    // 写者：synchronize() 推进纪元，等待所有在推进之前进入临界区的读者退出（一个宽限期）。
+    // 退休的对象由后台回收线程攒成一批，每批只等待一个宽限期后统一释放。
+    // 满足 Lockable，lock / unlock 即进入 / 退出读临界区，可以嵌套；临界区内不能调用 synchronize 或 barrier
+    class rcu_domain {
+        friend auto rcu_default_domain() noexcept -> rcu_domain &;
+
+        // 待回收对象达到 batch 个时立即唤醒回收线程，否则最多等待 period
+        static constexpr size_t batch = 64;
+        static constexpr auto period = std::chrono::milliseconds(10);
+
+        rcu_domain() noexcept = default;
+
+      public:
+        rcu_domain(const rcu_domain &) = delete;
+
+        auto operator=(const rcu_domain &) -> rcu_domain & = delete;
+
+        ~rcu_domain() {
+            if (m_reclaimer.joinable()) {
+                {
+                    auto lock = std::lock_guard(m_mut);
+                    m_stop = true;
+                }
+                m_cv.notify_one();
+                m_reclaimer.join();
+            }
+            barrier();
+        }
+
+        // 读者
+      public:
+        auto lock() noexcept -> void {
+            auto s = _this_thread_state<_rcu_thread>.m_slot;
+            if (s == nullptr) [[unlikely]] {
+                s = enroll();
+            }
+            auto w = s->m_word.load(std::memory_order_relaxed);
+            if (w == 0) [[likely]] {
+                // 获取语义读取纪元：读到推进后的纪元时，写者推进之前的修改对本临界区可见
+                s->m_word.store(m_epoch.load(std::memory_order_acquire) << _rcu_slot::nest_bits | 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            } else {
+                s->m_word.store(w + 1, std::memory_order_relaxed);
+            }
+        }
+
+        auto try_lock() noexcept -> bool {
+            lock();
+            return true;
+        }
+
+        auto unlock() noexcept -> void {
+            auto s = _this_thread_state<_rcu_thread>.m_slot;
+            auto w = s->m_word.load(std::memory_order_relaxed);
+            s->m_word.store((w & _rcu_slot::nest_mask) == 1 ? 0 : w - 1, std::memory_order_release);
+        }
+
+        // 写者
+      public:
+        // 等待一个宽限期：调用之前开始的读临界区全部结束
+        auto synchronize() noexcept -> void {
+            auto e = m_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+            // 与读者进入临界区时的栅栏配对：读者要么在槽位中可见，要么能看到调用之前的全部修改
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            for (auto s = m_slots.head(); s; s = s->m_next) {
+                auto b = backoff();
+                for (auto w = s->m_word.load(std::memory_order_acquire); w != 0 && (w >> _rcu_slot::nest_bits) < e; w = s->m_word.load(std::memory_order_acquire)) {
+                    b.pause();
+                }
+            }
+        }
+
+        // 交给后台回收线程，在一个宽限期之后调用 o->m_reclaim
+        auto retire(_rcu_retired *o) noexcept -> void {
+            std::call_once(m_started, [this] { m_reclaimer = std::thread([this] { run(); }); });
+            o->m_next = m_pending.load(std::memory_order_relaxed);
+            while (!m_pending.compare_exchange_weak(o->m_next, o, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+            if (m_pending_count.fetch_add(1, std::memory_order_relaxed) + 1 == batch) {
+                m_cv.notify_one();
+            }
+        }
+
+        // 等待调用之前退休的对象全部被回收
+        auto barrier() noexcept -> void {
+            auto lock = std::lock_guard(m_reclaim_mut);
+            while (reclaim_pending()) {
+            }
+        }
+
+      private:
+        auto enroll() noexcept -> _rcu_slot * {
+            auto s = m_slots.acquire();
+            _this_thread_state<_rcu_thread>.m_slot = s;
+            _thread_state_enroll<_rcu_thread>();
+            return s;
+        }
+
+        // 取出当前全部待回收对象，等待一个宽限期后释放，没有对象时返回 false。调用者持有 m_reclaim_mut
+        auto reclaim_pending() noexcept -> bool {
+            auto list = m_pending.exchange(nullptr, std::memory_order_acquire);
+            if (list == nullptr) {
+                return false;
+            }
+            m_pending_count.store(0, std::memory_order_relaxed);
+            synchronize();
+            while (list) {
+                auto next = list->m_next;
+                list->m_reclaim(list);
+                list = next;
+            }
+            return true;
+        }
+
+        auto run() -> void {
+            auto lock = std::unique_lock(m_mut);
+            while (!m_stop) {
+                m_cv.wait_for(lock, period, [this] { return m_stop || m_pending_count.load(std::memory_order_relaxed) >= batch; });
+                lock.unlock();
+                {
+                    auto reclaim = std::lock_guard(m_reclaim_mut);
+                    reclaim_pending();
+                }
+                lock.lock();
+            }
+        }
+
+      public:
+        std::atomic<uint64_t> m_epoch{1};
+        _slot_list<_rcu_slot> m_slots;
+        std::atomic<_rcu_retired *> m_pending{nullptr};
+        std::atomic<size_t> m_pending_count{0};
+
+        std::mutex m_reclaim_mut; // 同一时间只有一个线程在回收，barrier 借此等待进行中的一批
+        std::mutex m_mut;
+        std::condition_variable m_cv;
+        bool m_stop{false};
+        std::once_flag m_started;
+        std::thread m_reclaimer;
+    };
+
+    inline auto rcu_default_domain() noexcept -> rcu_domain & {
+        static auto domain = rcu_domain();
+        return domain;
+    }
+
+    inline auto rcu_synchronize(rcu_domain &domain = rcu_default_domain()) noexcept -> void { domain.synchronize(); }
+
+    inline auto rcu_barrier(rcu_domain &domain = rcu_default_domain()) noexcept -> void { domain.barrier(); }
+} // namespace mtl
+
+// rcu_reader
+namespace mtl {
+    // 读临界区的作用域守卫
+    class rcu_reader {
+      public:
+        explicit rcu_reader(rcu_domain &domain = rcu_default_domain()) noexcept : m_domain(&domain) { m_domain->lock(); }
+
+        rcu_reader(const rcu_reader &) = delete;
+
+        auto operator=(const rcu_reader &) -> rcu_reader & = delete;
+
+        ~rcu_reader() { m_domain->unlock(); }
+
+      public:
+        rcu_domain *m_domain;
+    };
+} // namespace mtl
+
+// rcu_obj_base / rcu_retire
+namespace mtl {
+    // 可以通过 RCU 回收的对象的基类，T 为派生类。删除器保存在对象内部，退休时无需额外分配
+    template <typename T, typename D = default_delete<T>>
+    class rcu_obj_base : public _retire_base<_rcu_retired, T, D> {
+      public:
+        auto retire(D d = D(), rcu_domain &domain = rcu_default_domain()) noexcept -> void { domain.retire(this->bind(std::move(d))); }
+
+      protected:
+        rcu_obj_base() noexcept = default;
+
+        ~rcu_obj_base() = default;
+    };
+
+    // 不继承 rcu_obj_base 的对象退休时需要分配一个节点保存指针与删除器
+    template <typename T, typename D>
+    struct _rcu_retired_ptr final : _rcu_retired {
+        _rcu_retired_ptr(T *p, D d) : m_ptr(p), m_del(std::move(d)) {
+            m_reclaim = [](_rcu_retired *r) {
+                auto self = static_cast<_rcu_retired_ptr *>(r);
+                self->m_del(self->m_ptr);
+                delete self;
+            };
+        }
+
+        T *m_ptr;
+        D m_del;
+    };
+
+    // 一个宽限期之后由后台回收线程调用 d(p)
+    template <typename T, typename D = default_delete<T>>
+    auto rcu_retire(T *p, D d = D(), rcu_domain &domain = rcu_default_domain()) -> void {
+        domain.retire(new _rcu_retired_ptr<T, D>(p, std::move(d)));
+    }
+} // namespace mtl
@@ -0,0 +1,214 @@
+/*
+    单生产者单消费者环形队列
+    https://rigtorp.se/ringbuffer/
+*/
+#pragma once
+#include "common.hpp"
+#include "utility/optional.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <new>
+
+// spsc ring
+namespace mtl {
+    // 只允许一个线程入队、一个线程出队。
+    // 读写下标单调递增，对 Capacity 取模得到位置。生产者和消费者各自缓存对方的下标，
+    // 只有缓存显示队列已满（空）时才读取对方的原子变量，稳态下两个线程不会争用同一缓存行。
+    template <typename T, size_t Capacity>
+        requires(std::has_single_bit(Capacity))
+    class spsc_ring {
+        static constexpr size_t mask = Capacity - 1;
+
+        struct cell {
+            alignas(T) std::byte data[sizeof(T)];
+        };
+
+      public:
+        using value_type = T;
+        using size_type = size_t;
+
+        // 构造
+      public:
+        spsc_ring() = default;
+
+        spsc_ring(const spsc_ring &) = delete;
+
+        auto operator=(const spsc_ring &) -> spsc_ring & = delete;
+
+        ~spsc_ring() {
+            auto head = m_head.load(std::memory_order_relaxed);
+            auto tail = m_tail.load(std::memory_order_relaxed);
+            for (; head != tail; ++head) {
+                std::destroy_at(slot(head));
+            }
+        }
+
+        // 生产者
+      public:
+        template <typename... Args>
+        auto try_emplace(Args &&...args) -> bool {
+            auto tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_head_cache == Capacity) {
+                m_head_cache = m_head.load(std::memory_order_acquire);
+                if (tail - m_head_cache == Capacity) {
+                    return false;
+                }
+            }
+            std::construct_at(slot(tail), std::forward<Args>(args)...);
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        auto try_push(const T &value) -> bool { return try_emplace(value); }
+
+        auto try_push(T &&value) -> bool { return try_emplace(std::move(value)); }
+
+        // 自旋直到有空位
+        template <typename... Args>
+        auto emplace(Args &&...args) -> void {
+            auto b = backoff();
+            while (!writable()) {
+                b.pause();
+            }
+            try_emplace(std::forward<Args>(args)...);
+        }
+
+        auto push(const T &value) -> void { emplace(value); }
+
+        auto push(T &&value) -> void { emplace(std::move(value)); }
+
+        // 从 first 开始移动至多 n 个元素入队，返回实际入队的个数；整批只发布一次尾下标
+        template <std::input_iterator It>
+        auto try_push_n(It first, size_type n) -> size_type {
+            auto tail = m_tail.load(std::memory_order_relaxed);
+            if (Capacity - (tail - m_head_cache) < n) {
+                m_head_cache = m_head.load(std::memory_order_acquire);
+            }
+            n = std::min(n, Capacity - (tail - m_head_cache));
+            auto i = size_type{0};
+            try {
+                for (; i < n; ++i, ++first) {
+                    std::construct_at(slot(tail + i), std::move(*first));
+                }
+            } catch (...) {
+                m_tail.store(tail + i, std::memory_order_release);
+                throw;
+            }
+            m_tail.store(tail + n, std::memory_order_release);
+            return n;
+        }
+
+        // 消费者
+      public:
+        // 队首元素，队列为空时返回 nullptr
+        auto front() noexcept -> T * {
+            auto head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tail_cache) {
+                m_tail_cache = m_tail.load(std::memory_order_acquire);
+                if (head == m_tail_cache) {
+                    return nullptr;
+                }
+            }
+            return slot(head);
+        }
+
+        // 调用者保证 front() 不为 nullptr
+        auto pop() noexcept -> void {
+            auto head = m_head.load(std::memory_order_relaxed);
+            std::destroy_at(slot(head));
+            m_head.store(head + 1, std::memory_order_release);
+        }
+
+        auto try_pop(T &out) -> bool {
+            auto p = front();
+            if (p == nullptr) {
+                return false;
+            }
+            out = std::move(*p);
+            pop();
+            return true;
+        }
+
+        auto try_pop() -> optional<T> {
+            auto p = front();
+            if (p == nullptr) {
+                return nullopt;
+            }
+            auto ret = optional<T>(std::move(*p));
+            pop();
+            return ret;
+        }
+
+        // 自旋直到有元素
+        auto pop_wait() -> T {
+            auto p = front();
+            for (auto b = backoff(); p == nullptr; p = front()) {
+                b.pause();
+            }
+            auto ret = T(std::move(*p));
+            pop();
+            return ret;
+        }
+
+        // 至多出队 n 个元素移动到 out，返回实际出队的个数；整批只发布一次头下标
+        template <typename OutIt>
+        auto try_pop_n(OutIt out, size_type n) -> size_type {
+            auto head = m_head.load(std::memory_order_relaxed);
+            if (m_tail_cache - head < n) {
+                m_tail_cache = m_tail.load(std::memory_order_acquire);
+            }
+            n = std::min(n, m_tail_cache - head);
+            auto i = size_type{0};
+            try {
+                for (; i < n; ++i, ++out) {
+                    auto p = slot(head + i);
+                    *out = std::move(*p);
+                    std::destroy_at(p);
+                }
+            } catch (...) {
+                // 已出队的元素已经析构，第 i 个仍留在队首
+                m_head.store(head + i, std::memory_order_release);
+                throw;
+            }
+            m_head.store(head + n, std::memory_order_release);
+            return n;
+        }
+
+        // observer
+      public:
+        static constexpr auto capacity() noexcept -> size_type { return Capacity; }
+
+        // 并发修改时只是近似值。先读 head 再读 tail：head 从不超过 tail 且两者单调增长，差值不会回绕；
+        // 两次读取之间两端都可能前进，结果不超过容量
+        auto size() const noexcept -> size_type {
+            auto head = m_head.load(std::memory_order_acquire);
+            auto tail = m_tail.load(std::memory_order_acquire);
+            return std::min(tail - head, Capacity);
+        }
+
+        auto empty() const noexcept -> bool { return size() == 0; }
+
+        // 内部实现
+      private:
+        auto slot(size_t i) noexcept -> T * { return std::launder(reinterpret_cast<T *>(m_cells[i & mask].data)); }
+
+        auto writable() noexcept -> bool {
+            auto tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_head_cache == Capacity) {
+                m_head_cache = m_head.load(std::memory_order_acquire);
+            }
+            return tail - m_head_cache != Capacity;
+        }
+
+      public:
+        // 生产者写入的缓存行
+        alignas(cache_line_size) std::atomic<size_t> m_tail{0};
+        size_t m_head_cache{0};
+        // 消费者写入的缓存行
+        alignas(cache_line_size) std::atomic<size_t> m_head{0};
+        size_t m_tail_cache{0};
+        alignas(cache_line_size) cell m_cells[Capacity];
+    };
+} // namespace mtl
@@ -0,0 +1,512 @@
+/*
+    工作窃取线程池
+    Chase-Lev 双端队列：https://www.dre.vanderbilt.edu/~schmidt/PDF/work-stealing-dequeue.pdf
+    C11 内存序版本：https://fzn.fr/readings/ppopp13.pdf
+*/
+#pragma once
+#include "common.hpp"
+#include "future.hpp"
+#include "container/vector.hpp"
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// task
+namespace mtl {
+    // 占满一个缓存行的任务：调用入口加上 56 字节的内联存储。
+    // 可平凡复制且放得下的可调用对象直接存放在任务中，入队出队都是按字节复制，不需要堆分配；
+    // 其他可调用对象在堆上分配，任务中只存放指针。
+    struct _task {
+        static constexpr size_t inline_size = cache_line_size - sizeof(void (*)(void *));
+
+        template <typename F>
+        static constexpr bool is_inline = std::is_trivially_copyable_v<F> && sizeof(F) <= inline_size && alignof(F) <= alignof(void *);
+
+        template <typename F>
+        static auto make(F &&f) -> _task {
+            using D = std::decay_t<F>;
+            auto t = _task();
+            if constexpr (is_inline<D>) {
+                new (t.m_buf) D(std::forward<F>(f));
+                t.m_invoke = [](void *p) noexcept { (*std::launder(reinterpret_cast<D *>(p)))(); };
+            } else {
+                auto box = new D(std::forward<F>(f));
+                std::memcpy(t.m_buf, &box, sizeof(box));
+                t.m_invoke = [](void *p) noexcept {
+                    auto box = static_cast<D *>(nullptr);
+                    std::memcpy(&box, p, sizeof(box));
+                    (*box)();
+                    delete box;
+                };
+            }
+            return t;
+        }
+
+        // 任务抛出的异常无法传递给任何人，直接终止（与 std::thread 一致）
+        auto operator()() noexcept -> void { m_invoke(m_buf); }
+
+        void (*m_invoke)(void *) noexcept;
+        alignas(void *) std::byte m_buf[inline_size];
+    };
+
+    static_assert(sizeof(_task) == cache_line_size && std::is_trivially_copyable_v<_task>);
+} // namespace mtl
+
+// work stealing deque
+namespace mtl {
+    // 所有者在底部压入、弹出，窃取者在顶部取走任务。
+    // 窃取者读取槽位时可能与所有者覆盖写入同一槽位并发（之后 CAS 失败而丢弃），因此槽位按 8 字节原子字读写。
+    // 数组写满时容量翻倍，旧数组可能仍在被窃取者读取，留到队列析构时释放。
+    class _work_deque {
+        struct cell {
+            static constexpr size_t words = sizeof(_task) / sizeof(uint64_t);
+            std::atomic<uint64_t> w[words];
+        };
+
+        struct array {
+            explicit array(int64_t n) : m_mask(n - 1), m_cells(new cell[static_cast<size_t>(n)]) {}
+
+            ~array() { delete[] m_cells; }
+
+            auto put(int64_t i, const _task &t) noexcept -> void {
+                uint64_t buf[cell::words];
+                std::memcpy(buf, &t, sizeof(t));
+                auto &c = m_cells[i & m_mask];
+                for (auto k = size_t{0}; k < cell::words; ++k) {
+                    c.w[k].store(buf[k], std::memory_order_relaxed);
+                }
+            }
+
+            auto get(int64_t i) const noexcept -> _task {
+                uint64_t buf[cell::words];
+                auto &c = m_cells[i & m_mask];
+                for (auto k = size_t{0}; k < cell::words; ++k) {
+                    buf[k] = c.w[k].load(std::memory_order_relaxed);
+                }
+                auto t = _task();
+                std::memcpy(&t, buf, sizeof(t));
+                return t;
+            }
+
+            int64_t m_mask;
+            cell *m_cells;
+        };
+
+      public:
+        explicit _work_deque(int64_t capacity = 256) : m_array(new array(capacity)) {}
+
+        _work_deque(const _work_deque &) = delete;
+
+        auto operator=(const _work_deque &) -> _work_deque & = delete;
+
+        ~_work_deque() {
+            delete m_array.load(std::memory_order_relaxed);
+            for (auto a : m_retired) {
+                delete a;
+            }
+        }
+
+      public:
+        // 仅所有者调用
+        auto push(const _task &t) -> void {
+            auto b = m_bottom.load(std::memory_order_relaxed);
+            auto top = m_top.load(std::memory_order_acquire);
+            auto a = m_array.load(std::memory_order_relaxed);
+            if (b - top > a->m_mask) {
+                a = grow(a, top, b);
+            }
+            a->put(b, t);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        // 仅所有者调用，后进先出
+        auto pop(_task &out) noexcept -> bool {
+            auto b = m_bottom.load(std::memory_order_relaxed) - 1;
+            auto a = m_array.load(std::memory_order_relaxed);
+            m_bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto top = m_top.load(std::memory_order_relaxed);
+            if (top > b) {
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+            out = a->get(b);
+            if (top == b) {
+                // 只剩最后一个，与窃取者竞争
+                auto won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        // 任意线程调用，先进先出
+        auto steal(_task &out) noexcept -> bool {
+            auto top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto b = m_bottom.load(std::memory_order_acquire);
+            if (top >= b) {
+                return false;
+            }
+            auto t = m_array.load(std::memory_order_acquire)->get(top);
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return false;
+            }
+            out = t;
+            return true;
+        }
+
+        // 并发修改时只是近似值
+        auto size() const noexcept -> size_t {
+            auto b = m_bottom.load(std::memory_order_relaxed);
+            auto top = m_top.load(std::memory_order_relaxed);
+            return b > top ? static_cast<size_t>(b - top) : 0;
+        }
+
+      private:
+        auto grow(array *a, int64_t top, int64_t b) -> array * {
+            auto n = new array((a->m_mask + 1) * 2);
+            for (auto i = top; i < b; ++i) {
+                n->put(i, a->get(i));
+            }
+            m_retired.push_back(a);
+            m_array.store(n, std::memory_order_release);
+            return n;
+        }
+
+      public:
+        alignas(cache_line_size) std::atomic<int64_t> m_top{0};
+        alignas(cache_line_size) std::atomic<int64_t> m_bottom{0};
+        std::atomic<array *> m_array;
+        vector<array *> m_retired; // 仅所有者访问
+    };
+} // namespace mtl
+
+// inject queue
+namespace mtl {
+    // 外部线程提交任务的入口：互斥锁保护的环形缓冲区，写满时容量翻倍，提交者从不阻塞等待工作线程。
+    // 工作线程先读取原子的计数，队列为空时不加锁。
+    class _inject_queue {
+      public:
+        auto push(const _task &t) -> void {
+            auto lock = std::lock_guard(m_mut);
+            if (m_count == m_ring.size()) {
+                grow();
+            }
+            m_ring[(m_head + m_count) & (m_ring.size() - 1)] = t;
+            m_size.store(++m_count, std::memory_order_relaxed);
+        }
+
+        auto try_pop(_task &out) -> bool {
+            if (m_size.load(std::memory_order_relaxed) == 0) {
+                return false;
+            }
+            auto lock = std::lock_guard(m_mut);
+            if (m_count == 0) {
+                return false;
+            }
+            out = m_ring[m_head];
+            m_head = (m_head + 1) & (m_ring.size() - 1);
+            m_size.store(--m_count, std::memory_order_relaxed);
+            return true;
+        }
+
+      private:
+        auto grow() -> void {
+            auto ring = vector<_task>(m_ring.size() * 2);
+            for (auto i = size_t{0}; i < m_count; ++i) {
+                ring[i] = m_ring[(m_head + i) & (m_ring.size() - 1)];
+            }
+            m_ring.swap(ring);
+            m_head = 0;
+        }
+
+      public:
+        std::mutex m_mut;
+        vector<_task> m_ring = vector<_task>(256);
+        size_t m_head{0};
+        size_t m_count{0};
+        std::atomic<size_t> m_size{0};
+    };
+} // namespace mtl
+
+// thread pool
+namespace mtl {
+    // 每个工作线程有一个 _work_deque，工作线程内提交的任务压入自己的队列，外部线程提交的任务进入共享的注入队列。
+    // 工作线程依次尝试：自己的队列（后进先出，缓存友好）、注入队列、随机选择的其他线程的队列（先进先出）。
+    // 都取不到任务时先退避自旋一段时间，再通过 std::atomic::wait 休眠；提交任务时只在有线程休眠时才唤醒。
+    class thread_pool {
+        struct alignas(cache_line_size) worker {
+            _work_deque m_deque;
+            thread_pool *m_pool;
+            size_t m_index;
+            uint64_t m_rng;
+            std::thread m_thread;
+        };
+
+        static constexpr int idle_spins = 64;
+
+      public:
+        // pin_threads 为 true 时把第 i 个工作线程绑定到进程可用的第 i 个 CPU（仅 Linux）
+        explicit thread_pool(size_t threads = std::max(std::thread::hardware_concurrency(), 1u), bool pin_threads = false)
+            : m_workers(new worker[std::max<size_t>(threads, 1)]), m_size(std::max<size_t>(threads, 1)) {
+            for (auto i = size_t{0}; i < m_size; ++i) {
+                m_workers[i].m_pool = this;
+                m_workers[i].m_index = i;
+                m_workers[i].m_rng = (i + 1) * 0x9e3779b97f4a7c15ull;
+            }
+            try {
+                for (auto i = size_t{0}; i < m_size; ++i) {
+                    m_workers[i].m_thread = std::thread([this, i] { run(m_workers[i]); });
+                    if (pin_threads) {
+                        pin(m_workers[i].m_thread, i);
+                    }
+                }
+            } catch (...) {
+                shutdown();
+                throw;
+            }
+        }
+
+        thread_pool(const thread_pool &) = delete;
+
+        auto operator=(const thread_pool &) -> thread_pool & = delete;
+
+        // 执行完所有已提交的任务后返回
+        ~thread_pool() { shutdown(); }
+
+        // 提交
+      public:
+        // 不关心结果的任务，f 抛出异常时终止程序
+        template <typename F>
+        auto execute(F &&f) -> void {
+            push(_task::make(std::forward<F>(f)));
+        }
+
+        // 返回的 future 持有 f 的返回值或抛出的异常
+        template <typename F>
+        auto submit(F &&f) -> future<std::invoke_result_t<std::decay_t<F> &>> {
+            using R = std::invoke_result_t<std::decay_t<F> &>;
+            auto p = promise<R>();
+            auto fut = p.get_future();
+            // 任务接管 promise 的引用，可平凡复制的 f 连同状态指针一起内联存放
+            auto s = std::exchange(p.m_state, nullptr);
+            execute([f = std::decay_t<F>(std::forward<F>(f)), s]() mutable noexcept {
+                try {
+                    if constexpr (std::is_void_v<R>) {
+                        f();
+                        s->set_value();
+                    } else {
+                        s->set_value(f());
+                    }
+                } catch (...) {
+                    s->set_exception(std::current_exception());
+                }
+                s->release();
+            });
+            return fut;
+        }
+
+        // 对 [0, n) 中的每个 i 调用 f(i)。下标按块划分成约 4 倍线程数的任务，全部完成后 future 就绪，
+        // 多个调用抛出异常时 future 持有第一个。
+        template <typename F>
+        auto bulk_submit(size_t n, F &&f) -> future<void> {
+            struct bulk {
+                bulk(F &&fn, size_t n) : f(std::forward<F>(fn)), remaining(n) {}
+
+                std::decay_t<F> f;
+                std::atomic<size_t> remaining;
+                std::atomic<bool> failed{false};
+                std::exception_ptr error;
+                promise<void> p;
+            };
+
+            auto chunks = std::min(n, m_size * 4);
+            if (chunks == 0) {
+                auto p = promise<void>();
+                p.set_value();
+                return p.get_future();
+            }
+            auto b = new bulk(std::forward<F>(f), chunks);
+            auto fut = b->p.get_future();
+            auto grain = n / chunks;
+            auto extra = n % chunks;
+            for (auto c = size_t{0}, beg = size_t{0}; c < chunks; ++c) {
+                auto end = beg + grain + (c < extra);
+                execute([b, beg, end]() noexcept {
+                    try {
+                        for (auto i = beg; i < end; ++i) {
+                            b->f(i);
+                        }
+                    } catch (...) {
+                        if (!b->failed.exchange(true, std::memory_order_relaxed)) {
+                            b->error = std::current_exception();
+                        }
+                    }
+                    if (b->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        if (b->error) {
+                            b->p.set_exception(b->error);
+                        } else {
+                            b->p.set_value();
+                        }
+                        delete b;
+                    }
+                });
+                beg = end;
+            }
+            return fut;
+        }
+
+        // 在调用线程上执行一个待执行的任务，没有任务时返回 false。
+        // 在工作线程中等待其他任务时可以用它协助执行，避免所有工作线程都阻塞。
+        auto try_run_one() -> bool {
+            auto t = _task();
+            auto self = t_worker != nullptr && t_worker->m_pool == this ? t_worker : nullptr;
+            if (!find(self, t)) {
+                return false;
+            }
+            t();
+            return true;
+        }
+
+        // observer
+      public:
+        auto size() const noexcept -> size_t { return m_size; }
+
+        // 当前线程所属的线程池，不是工作线程时返回 nullptr
+        static auto current() noexcept -> thread_pool * { return t_worker ? t_worker->m_pool : nullptr; }
+
+        // 当前工作线程在所属线程池中的编号，不是工作线程时返回 -1
+        static auto current_index() noexcept -> size_t { return t_worker ? t_worker->m_index : static_cast<size_t>(-1); }
+
+        // 内部实现
+      private:
+        auto push(const _task &t) -> void {
+            if (t_worker != nullptr && t_worker->m_pool == this) {
+                t_worker->m_deque.push(t);
+            } else {
+                m_inject.push(t);
+            }
+            // 与 run 中休眠前的检查构成 Dekker 式同步：要么休眠者看到新任务，要么这里看到休眠者
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_sleepers.load(std::memory_order_relaxed) != 0) {
+                m_signal.fetch_add(1, std::memory_order_release);
+                m_signal.notify_one();
+            }
+        }
+
+        auto find(worker *self, _task &out) -> bool {
+            if (self != nullptr && self->m_deque.pop(out)) {
+                return true;
+            }
+            if (m_inject.try_pop(out)) {
+                return true;
+            }
+            // 从随机位置开始依次尝试窃取
+            auto start = self != nullptr ? static_cast<size_t>(next_random(self->m_rng) % m_size) : size_t{0};
+            for (auto k = size_t{0}; k < m_size; ++k) {
+                auto &victim = m_workers[(start + k) % m_size];
+                if (&victim != self && victim.m_deque.steal(out)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        auto run(worker &self) -> void {
+            t_worker = &self;
+            auto t = _task();
+            auto b = backoff();
+            for (auto idle = 0;;) {
+                if (find(&self, t)) {
+                    t();
+                    idle = 0;
+                    b.reset();
+                    continue;
+                }
+                if (++idle < idle_spins) {
+                    b.pause();
+                    continue;
+                }
+                auto sig = m_signal.load(std::memory_order_acquire);
+                m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (find(&self, t)) {
+                    m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+                    t();
+                    idle = 0;
+                    b.reset();
+                    continue;
+                }
+                if (m_stop.load(std::memory_order_acquire)) {
+                    m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+                    break;
+                }
+                m_signal.wait(sig, std::memory_order_acquire);
+                m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+            }
+            t_worker = nullptr;
+        }
+
+        // 工作线程在所有队列都为空时才退出，因此已提交的任务（包括任务中再提交的任务）都会执行
+        auto shutdown() noexcept -> void {
+            m_stop.store(true, std::memory_order_seq_cst);
+            m_signal.fetch_add(1, std::memory_order_release);
+            m_signal.notify_all();
+            for (auto i = size_t{0}; i < m_size; ++i) {
+                if (m_workers[i].m_thread.joinable()) {
+                    m_workers[i].m_thread.join();
+                }
+            }
+            delete[] m_workers;
+            m_workers = nullptr;
+        }
+
+        static auto next_random(uint64_t &s) noexcept -> uint64_t {
+            s ^= s << 13;
+            s ^= s >> 7;
+            s ^= s << 17;
+            return s;
+        }
+
+        // 绑定到进程允许运行的第 i 个 CPU（按序号取模）
+        static auto pin([[maybe_unused]] std::thread &t, [[maybe_unused]] size_t i) noexcept -> void {
+#if defined(__linux__)
+            auto allowed = cpu_set_t();
+            if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+                return;
+            }
+            auto count = static_cast<size_t>(CPU_COUNT(&allowed));
+            if (count == 0) {
+                return;
+            }
+            auto k = i % count;
+            for (auto cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &allowed) && k-- == 0) {
+                    auto set = cpu_set_t();
+                    CPU_ZERO(&set);
+                    CPU_SET(cpu, &set);
+                    pthread_setaffinity_np(t.native_handle(), sizeof(set), &set);
+                    return;
+                }
+            }
+#endif
+        }
+
+      public:
+        worker *m_workers;
+        size_t m_size;
+        _inject_queue m_inject;
+        alignas(cache_line_size) std::atomic<uint32_t> m_signal{0};
+        std::atomic<uint32_t> m_sleepers{0};
+        std::atomic<bool> m_stop{false};
+
+        static inline thread_local worker *t_worker = nullptr;
+    };
+} // namespace mtl
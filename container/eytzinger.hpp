@@ -0,0 +1,283 @@
+/*
+    Eytzinger（BFS）布局的静态查找表
+    https://en.algorithmica.org/hpc/data-structures/binary-search/
+    https://arxiv.org/abs/1509.05053
+*/
+#pragma once
+#include "flat_common.hpp"
+#include "vector.hpp"
+#include "utility/pair.hpp"
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <stdexcept>
+
+// eytzinger 布局
+namespace mtl {
+    // 结点 k（从 1 开始）的左右孩子为 2k、2k+1，同一层的结点在内存中相邻，
+    // 查找时前几层始终在缓存中，更深的层可以提前预取
+    template <typename T>
+    struct _eytzinger {
+        // 一个缓存行能容纳的元素个数，至少预取到孙子一层（4k ~ 4k+3）
+        static constexpr size_t prefetch_stride = std::max<size_t>(4, std::bit_floor(std::max<size_t>(64 / sizeof(T), 1)));
+
+        static auto prefetch(const T *p) noexcept -> void {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(p);
+#endif
+        }
+
+        // 计算 BFS 下标 1..n 对应的有序下标：按中序遍历依次访问结点
+        static auto inorder_ranks(size_t n) -> vector<size_t> {
+            auto ranks = vector<size_t>(n + 1);
+            if (n == 0) {
+                return ranks;
+            }
+            auto k = size_t{1};
+            while (2 * k <= n) {
+                k *= 2;
+            }
+            for (auto i = size_t{0}; i < n; ++i) {
+                ranks[k] = i;
+                if (2 * k + 1 <= n) {
+                    // 右子树的最左结点
+                    k = 2 * k + 1;
+                    while (2 * k <= n) {
+                        k *= 2;
+                    }
+                } else {
+                    // 沿右孩子向上，直到当前结点是某个结点的左孩子
+                    k >>= std::countr_one(k) + 1;
+                }
+            }
+            return ranks;
+        }
+
+        // 无分支下降：每层只计算 k = 2k + (b[k] < key)。
+        // 循环结束时 k 的二进制为「路径 + 1 + 若干个 1」，去掉末尾连续的 1 和一个 0 得到第一个不小于 key 的结点，0 表示不存在
+        template <typename Key, typename Comp>
+        static auto lower_bound(const T *b, size_t n, const Key &key, Comp &comp) -> size_t {
+            auto k = size_t{1};
+            while (k <= n) {
+                prefetch(b + k * prefetch_stride);
+                k = 2 * k + (comp(b[k], key) ? 1 : 0);
+            }
+            return k >> (std::countr_one(k) + 1);
+        }
+    };
+} // namespace mtl
+
+// eytzinger set
+namespace mtl {
+    // 从有序区间一次性构建的只读集合。下标 0 处存放一个不参与查找的占位元素，使结点编号从 1 开始。
+    // 迭代顺序为 BFS 顺序而非有序顺序。
+    template <typename T, typename Compare = std::less<T>>
+    class eytzinger_set {
+        using layout = _eytzinger<T>;
+
+        template <typename Key>
+        using key_arg = _key_arg<_transparent_compare<Compare>>::template type<Key, T>;
+
+      public:
+        using key_type = T;
+        using value_type = T;
+        using key_compare = Compare;
+        using size_type = size_t;
+        using const_iterator = const T *;
+        using iterator = const_iterator;
+
+        // 构造
+      public:
+        eytzinger_set() = default;
+
+        // [first, last) 必须已按 comp 排序，重复元素只保留一个
+        template <std::input_iterator It>
+        eytzinger_set(It first, It last, const Compare &comp = Compare()) : m_comp(comp) {
+            auto sorted = vector<T>(first, last);
+            sorted.erase(std::unique(sorted.begin(), sorted.end(), [&](const T &a, const T &b) { return !m_comp(a, b); }), sorted.end());
+            build(sorted);
+        }
+
+        eytzinger_set(std::initializer_list<T> lst, const Compare &comp = Compare()) : eytzinger_set(lst.begin(), lst.end(), comp) {}
+
+        // iterator
+      public:
+        auto begin() const noexcept -> const_iterator { return m_data.begin() + (m_data.empty() ? 0 : 1); }
+
+        auto end() const noexcept -> const_iterator { return m_data.end(); }
+
+        // capacity
+      public:
+        [[nodiscard]] auto empty() const noexcept -> bool { return size() == 0; }
+
+        auto size() const noexcept -> size_type { return m_data.empty() ? 0 : m_data.size() - 1; }
+
+        // lookup
+      public:
+        // 第一个不小于 key 的元素，不存在时返回 end()
+        template <typename Key = T>
+        auto lower_bound(const key_arg<Key> &key) const -> const_iterator {
+            auto k = layout::lower_bound(m_data.data(), size(), key, m_comp);
+            return k ? m_data.data() + k : end();
+        }
+
+        template <typename Key = T>
+        auto find(const key_arg<Key> &key) const -> const_iterator {
+            auto it = lower_bound(key);
+            return it != end() && !m_comp(key, *it) ? it : end();
+        }
+
+        template <typename Key = T>
+        auto contains(const key_arg<Key> &key) const -> bool {
+            return find(key) != end();
+        }
+
+        template <typename Key = T>
+        auto count(const key_arg<Key> &key) const -> size_type {
+            return contains(key) ? 1 : 0;
+        }
+
+        auto key_comp() const -> key_compare { return m_comp; }
+
+        // 内部实现
+      private:
+        auto build(const vector<T> &sorted) -> void {
+            auto n = sorted.size();
+            if (n == 0) {
+                return;
+            }
+            auto ranks = layout::inorder_ranks(n);
+            m_data.reserve_exact(n + 1);
+            m_data.unchecked_push_back(sorted[0]);
+            for (auto k = size_t{1}; k <= n; ++k) {
+                m_data.unchecked_push_back(sorted[ranks[k]]);
+            }
+        }
+
+      public:
+        vector<T> m_data;
+        [[no_unique_address]] Compare m_comp;
+    };
+} // namespace mtl
+
+// eytzinger map
+namespace mtl {
+    // 键按 eytzinger 布局存放，值放在按相同下标排列的并行数组中，查找只触碰键数组
+    template <typename K, typename V, typename Compare = std::less<K>>
+    class eytzinger_map {
+        using layout = _eytzinger<K>;
+
+        template <typename Key>
+        using key_arg = _key_arg<_transparent_compare<Compare>>::template type<Key, K>;
+
+      public:
+        using key_type = K;
+        using mapped_type = V;
+        using key_compare = Compare;
+        using size_type = size_t;
+
+        // 构造
+      public:
+        eytzinger_map() = default;
+
+        // [first, last) 的元素为 pair<K, V>，必须已按键排序，重复的键保留第一个
+        template <std::input_iterator It>
+        eytzinger_map(It first, It last, const Compare &comp = Compare()) : m_comp(comp) {
+            auto keys = vector<K>();
+            auto values = vector<V>();
+            for (; first != last; ++first) {
+                auto &&e = *first;
+                if (keys.empty() || m_comp(keys.back(), e.first)) {
+                    keys.push_back(std::forward<decltype(e)>(e).first);
+                    values.push_back(std::forward<decltype(e)>(e).second);
+                }
+            }
+            build(keys, values);
+        }
+
+        eytzinger_map(std::initializer_list<pair<K, V>> lst, const Compare &comp = Compare()) : eytzinger_map(lst.begin(), lst.end(), comp) {}
+
+        // 键和值按下标一一对应，keys 必须已排序且无重复
+        eytzinger_map(sorted_unique_t, const vector<K> &keys, const vector<V> &values, const Compare &comp = Compare()) : m_comp(comp) {
+            if (keys.size() != values.size()) {
+                throw std::invalid_argument("eytzinger_map");
+            }
+            build(keys, values);
+        }
+
+        // capacity
+      public:
+        [[nodiscard]] auto empty() const noexcept -> bool { return size() == 0; }
+
+        auto size() const noexcept -> size_type { return m_keys.empty() ? 0 : m_keys.size() - 1; }
+
+        // lookup
+      public:
+        // 返回值的指针，不存在时返回 nullptr
+        template <typename Key = K>
+        auto find(const key_arg<Key> &key) const -> const V * {
+            auto k = find_index(key);
+            return k ? m_values.data() + k : nullptr;
+        }
+
+        template <typename Key = K>
+        auto contains(const key_arg<Key> &key) const -> bool {
+            return find_index(key) != 0;
+        }
+
+        template <typename Key = K>
+        auto at(const key_arg<Key> &key) const -> const V & {
+            auto k = find_index(key);
+            if (k == 0) {
+                throw std::out_of_range("eytzinger_map");
+            }
+            return m_values[k];
+        }
+
+        // 第一个键不小于 key 的元素，不存在时两个指针均为 nullptr
+        template <typename Key = K>
+        auto lower_bound(const key_arg<Key> &key) const -> pair<const K *, const V *> {
+            auto k = layout::lower_bound(m_keys.data(), size(), key, m_comp);
+            if (k == 0) {
+                return {nullptr, nullptr};
+            }
+            return {m_keys.data() + k, m_values.data() + k};
+        }
+
+        auto key_comp() const -> key_compare { return m_comp; }
+
+        // BFS 顺序的键和值数组，下标 0 为占位元素
+        auto keys() const noexcept -> const vector<K> & { return m_keys; }
+
+        auto values() const noexcept -> const vector<V> & { return m_values; }
+
+        // 内部实现
+      private:
+        template <typename Key>
+        auto find_index(const Key &key) const -> size_t {
+            auto k = layout::lower_bound(m_keys.data(), size(), key, m_comp);
+            return k && !m_comp(key, m_keys[k]) ? k : 0;
+        }
+
+        auto build(const vector<K> &keys, const vector<V> &values) -> void {
+            auto n = keys.size();
+            if (n == 0) {
+                return;
+            }
+            auto ranks = layout::inorder_ranks(n);
+            m_keys.reserve_exact(n + 1);
+            m_values.reserve_exact(n + 1);
+            m_keys.unchecked_push_back(keys[0]);
+            m_values.unchecked_push_back(values[0]);
+            for (auto k = size_t{1}; k <= n; ++k) {
+                m_keys.unchecked_push_back(keys[ranks[k]]);
+                m_values.unchecked_push_back(values[ranks[k]]);
+            }
+        }
+
+      public:
+        vector<K> m_keys;
+        vector<V> m_values;
+        [[no_unique_address]] Compare m_comp;
+    };
+} // namespace mtl
@@ -0,0 +1,68 @@
+/*
+    扁平容器共用的查找工具
+    https://en.algorithmica.org/hpc/data-structures/binary-search/
+*/
+#pragma once
+#include <iterator>
+
+// 查找参数
+namespace mtl {
+    template <typename Compare>
+    concept _transparent_compare = requires { typename Compare::is_transparent; };
+
+    // 比较（或哈希）透明时查找参数类型为 Key（可推导），否则固定为 K（不可推导，Key 取默认值 K），
+    // 这样非透明时 find(1) 之类的调用依然会先把参数转换为 K
+    template <bool Transparent>
+    struct _key_arg {
+        template <typename Key, typename K>
+        using type = Key;
+    };
+
+    template <>
+    struct _key_arg<false> {
+        template <typename Key, typename K>
+        using type = K;
+    };
+} // namespace mtl
+
+// sorted unique
+namespace mtl {
+    // 标记输入已按比较器排序且无重复
+    struct sorted_unique_t {
+        explicit sorted_unique_t() = default;
+    };
+
+    inline constexpr auto sorted_unique = sorted_unique_t{};
+} // namespace mtl
+
+// 无分支二分查找
+namespace mtl {
+    // 每轮只根据比较结果选择区间起点（编译为 cmov），循环次数只取决于长度，不会因分支预测失败而停顿
+    template <std::random_access_iterator It, typename Key, typename Comp>
+    constexpr auto _branchless_lower_bound(It first, It last, const Key &key, Comp &comp) -> It {
+        auto len = last - first;
+        if (len == 0) {
+            return first;
+        }
+        while (len > 1) {
+            auto half = len / 2;
+            first += comp(first[half - 1], key) ? half : 0;
+            len -= half;
+        }
+        return first + (comp(*first, key) ? 1 : 0);
+    }
+
+    template <std::random_access_iterator It, typename Key, typename Comp>
+    constexpr auto _branchless_upper_bound(It first, It last, const Key &key, Comp &comp) -> It {
+        auto len = last - first;
+        if (len == 0) {
+            return first;
+        }
+        while (len > 1) {
+            auto half = len / 2;
+            first += comp(key, first[half - 1]) ? 0 : half;
+            len -= half;
+        }
+        return first + (comp(key, *first) ? 0 : 1);
+    }
+} // namespace mtl
@@ -0,0 +1,819 @@
+/*
+    SwissTable 风格的开放寻址哈希表
+    https://abseil.io/about/design/swisstables
+    https://www.youtube.com/watch?v=ncHmEUmJZf4
+*/
+#pragma once
+#include "flat_common.hpp"
+#include "utility/memory.hpp"
+#include "utility/pair.hpp"
+#include "utility/tuple.hpp"
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// 控制字节
+namespace mtl {
+    // 每个槽位对应一个控制字节：最高位为 1 表示非满（空、已删除、哨兵），否则低 7 位保存哈希值的 H2 部分
+    enum class _ctrl_t : int8_t {
+        empty = -128,   // 0b10000000
+        deleted = -2,   // 0b11111110
+        sentinel = -1,  // 0b11111111
+    };
+
+    // 空表共享的控制字节，使空表的查找无需特判
+    alignas(16) inline constexpr _ctrl_t _empty_group[16] = {
+        _ctrl_t::sentinel, _ctrl_t::empty, _ctrl_t::empty, _ctrl_t::empty, _ctrl_t::empty, _ctrl_t::empty, _ctrl_t::empty, _ctrl_t::empty,
+        _ctrl_t::empty,    _ctrl_t::empty, _ctrl_t::empty, _ctrl_t::empty, _ctrl_t::empty, _ctrl_t::empty, _ctrl_t::empty, _ctrl_t::empty,
+    };
+
+    constexpr auto _is_full(_ctrl_t c) noexcept -> bool { return static_cast<int8_t>(c) >= 0; }
+
+    constexpr auto _is_empty_or_deleted(_ctrl_t c) noexcept -> bool { return static_cast<int8_t>(c) < static_cast<int8_t>(_ctrl_t::sentinel); }
+
+    // 组内匹配结果，第 i 位为 1 表示组内第 i 个控制字节匹配
+    class _bitmask {
+      public:
+        constexpr explicit _bitmask(uint32_t mask) noexcept : m_mask(mask) {}
+
+        constexpr explicit operator bool() const noexcept { return m_mask != 0; }
+
+        constexpr auto lowest() const noexcept -> uint32_t { return static_cast<uint32_t>(std::countr_zero(m_mask)); }
+
+        constexpr auto trailing_zeros() const noexcept -> uint32_t { return static_cast<uint32_t>(std::countr_zero(m_mask)); }
+
+        // 16 位宽度内的前导零
+        constexpr auto leading_zeros() const noexcept -> uint32_t { return static_cast<uint32_t>(std::countl_zero(m_mask)) - 16; }
+
+        // 依次遍历为 1 的位
+        constexpr auto begin() const noexcept -> _bitmask { return *this; }
+
+        constexpr auto end() const noexcept -> _bitmask { return _bitmask(0); }
+
+        constexpr auto operator*() const noexcept -> uint32_t { return lowest(); }
+
+        constexpr auto operator++() noexcept -> _bitmask & {
+            m_mask &= m_mask - 1;
+            return *this;
+        }
+
+        constexpr auto operator==(const _bitmask &) const noexcept -> bool = default;
+
+      public:
+        uint32_t m_mask;
+    };
+
+    // 一次读取 16 个控制字节并行比较。支持 SSE2 时使用单条 pcmpeqb + pmovmskb，否则逐字节比较
+    class _group {
+      public:
+        static constexpr size_t width = 16;
+
+#ifdef __SSE2__
+        explicit _group(const _ctrl_t *pos) noexcept : m_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos))) {}
+
+        auto match(int8_t h2) const noexcept -> _bitmask { return _bitmask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl)))); }
+
+        auto match_empty() const noexcept -> _bitmask { return match(static_cast<int8_t>(_ctrl_t::empty)); }
+
+        // 空和已删除的控制字节都小于哨兵
+        auto match_empty_or_deleted() const noexcept -> _bitmask {
+            auto s = _mm_set1_epi8(static_cast<char>(_ctrl_t::sentinel));
+            return _bitmask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(s, m_ctrl))));
+        }
+
+        auto count_leading_empty_or_deleted() const noexcept -> uint32_t {
+            return static_cast<uint32_t>(std::countr_one(match_empty_or_deleted().m_mask));
+        }
+
+      public:
+        __m128i m_ctrl;
+#else
+        explicit _group(const _ctrl_t *pos) noexcept { std::memcpy(m_ctrl, pos, width); }
+
+        auto match(int8_t h2) const noexcept -> _bitmask {
+            return match_if([h2](_ctrl_t c) { return static_cast<int8_t>(c) == h2; });
+        }
+
+        auto match_empty() const noexcept -> _bitmask {
+            return match_if([](_ctrl_t c) { return c == _ctrl_t::empty; });
+        }
+
+        auto match_empty_or_deleted() const noexcept -> _bitmask { return match_if(_is_empty_or_deleted); }
+
+        auto count_leading_empty_or_deleted() const noexcept -> uint32_t {
+            return static_cast<uint32_t>(std::countr_one(match_empty_or_deleted().m_mask));
+        }
+
+      private:
+        template <typename Pred>
+        auto match_if(Pred pred) const noexcept -> _bitmask {
+            auto mask = uint32_t{0};
+            for (auto i = size_t{0}; i < width; ++i) {
+                mask |= static_cast<uint32_t>(pred(m_ctrl[i])) << i;
+            }
+            return _bitmask(mask);
+        }
+
+      public:
+        _ctrl_t m_ctrl[width];
+#endif
+    };
+
+    // 对用户哈希值再做一次混合，避免 std::hash<int> 这类恒等哈希导致 H1/H2 分布不均
+    constexpr auto _hash_mix(size_t h) noexcept -> size_t {
+        constexpr auto k = uint64_t{0x9E3779B97F4A7C15};
+#ifdef __SIZEOF_INT128__
+        auto m = static_cast<unsigned __int128>(h) * k;
+        return static_cast<size_t>(static_cast<uint64_t>(m) ^ static_cast<uint64_t>(m >> 64));
+#else
+        h ^= h >> 32;
+        h *= k;
+        return h ^ (h >> 29);
+#endif
+    }
+
+    // 二次探测：每次跳过的组数递增，容量为 2 的幂减 1 时可以覆盖全部组
+    class _probe_seq {
+      public:
+        _probe_seq(size_t hash, size_t mask) noexcept : m_mask(mask), m_offset(hash & mask) {}
+
+        auto offset() const noexcept -> size_t { return m_offset; }
+
+        auto offset(size_t i) const noexcept -> size_t { return (m_offset + i) & m_mask; }
+
+        auto next() noexcept -> void {
+            m_index += _group::width;
+            m_offset = (m_offset + m_index) & m_mask;
+        }
+
+      public:
+        size_t m_mask;
+        size_t m_offset;
+        size_t m_index{0};
+    };
+} // namespace mtl
+
+// flat hash map
+namespace mtl {
+    template <typename Hash, typename Eq>
+    concept _transparent_hash = requires {
+        typename Hash::is_transparent;
+        typename Eq::is_transparent;
+    };
+
+    // 槽位直接存放 pair<const K, V>，控制字节和槽位位于同一块内存中：
+    //   [ctrl: capacity + 1 + 15 字节（哨兵以及前 15 个控制字节的镜像）][padding][slots: capacity 个]
+    // 容量总是 2^k - 1，最大负载因子 7/8。插入和删除不会使其他元素的引用失效，但扩容会。
+    template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>, typename Alloc = allocator<pair<const K, V>>>
+    class flat_hash_map {
+      public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = pair<const K, V>;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using hasher = Hash;
+        using key_equal = Eq;
+        using allocator_type = Alloc;
+        using reference = value_type &;
+        using const_reference = const value_type &;
+
+      private:
+        using alloc_traits = allocator_traits<Alloc>;
+
+        // 以槽位对齐为单位申请内存
+        struct alignas(value_type) _unit {
+            std::byte m_bytes[alignof(value_type)];
+        };
+        using unit_alloc = alloc_traits::template rebind_alloc<_unit>;
+        using unit_traits = allocator_traits<unit_alloc>;
+
+        static constexpr size_t cloned = _group::width - 1;
+
+        template <typename Key>
+        using key_arg = _key_arg<_transparent_hash<Hash, Eq>>::template type<Key, K>;
+
+      public:
+        template <bool Const>
+        class _iterator {
+            friend class flat_hash_map;
+
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = flat_hash_map::value_type;
+            using difference_type = ptrdiff_t;
+            using reference = std::conditional_t<Const, const value_type &, value_type &>;
+            using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+
+          public:
+            _iterator() noexcept = default;
+
+            _iterator(const _ctrl_t *ctrl, value_type *slot) noexcept : m_ctrl(ctrl), m_slot(slot) {}
+
+            // iterator 可以隐式转换为 const_iterator
+            template <bool C = Const>
+                requires C
+            _iterator(const _iterator<false> &it) noexcept : m_ctrl(it.m_ctrl), m_slot(it.m_slot) {}
+
+          public:
+            auto operator*() const noexcept -> reference { return *m_slot; }
+
+            auto operator->() const noexcept -> pointer { return m_slot; }
+
+            auto operator++() noexcept -> _iterator & {
+                ++m_ctrl;
+                ++m_slot;
+                skip_empty_or_deleted();
+                return *this;
+            }
+
+            auto operator++(int) noexcept -> _iterator {
+                auto tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            friend auto operator==(const _iterator &lhs, const _iterator &rhs) noexcept -> bool { return lhs.m_ctrl == rhs.m_ctrl; }
+
+          private:
+            // 哨兵字节不属于“空或已删除”，因此一定会在表尾停下
+            auto skip_empty_or_deleted() noexcept -> void {
+                while (_is_empty_or_deleted(*m_ctrl)) {
+                    auto shift = _group(m_ctrl).count_leading_empty_or_deleted();
+                    m_ctrl += shift;
+                    m_slot += shift;
+                }
+            }
+
+          public:
+            const _ctrl_t *m_ctrl{nullptr};
+            value_type *m_slot{nullptr};
+        };
+
+        using iterator = _iterator<false>;
+        using const_iterator = _iterator<true>;
+
+        // 构造
+      public:
+        flat_hash_map() noexcept(noexcept(Hash()) && noexcept(Eq()) && noexcept(Alloc())) = default;
+
+        explicit flat_hash_map(size_type n, const Hash &h = Hash(), const Eq &eq = Eq(), const Alloc &a = Alloc())
+            : m_hash(h), m_eq(eq), m_alloc(a) {
+            reserve(n);
+        }
+
+        explicit flat_hash_map(const Alloc &a) : m_alloc(a) {}
+
+        template <std::input_iterator It>
+        flat_hash_map(It first, It last, size_type n = 0, const Hash &h = Hash(), const Eq &eq = Eq(), const Alloc &a = Alloc())
+            : flat_hash_map(n, h, eq, a) {
+            insert(first, last);
+        }
+
+        flat_hash_map(std::initializer_list<value_type> lst, size_type n = 0, const Hash &h = Hash(), const Eq &eq = Eq(), const Alloc &a = Alloc())
+            : flat_hash_map(lst.begin(), lst.end(), n, h, eq, a) {}
+
+        flat_hash_map(const flat_hash_map &m)
+            : flat_hash_map(m, alloc_traits::select_on_container_copy_construction(m.m_alloc)) {}
+
+        // 委托给只设置函数对象与分配器的构造函数，逐个插入时抛出异常由析构函数释放已插入的元素与存储
+        flat_hash_map(const flat_hash_map &m, const Alloc &a) : flat_hash_map(0, m.m_hash, m.m_eq, a) {
+            reserve(m.size());
+            for (auto &v : m) {
+                auto idx = prepare_insert(hash_of(v.first));
+                construct_at_index(idx, v);
+            }
+        }
+
+        flat_hash_map(flat_hash_map &&m) noexcept
+            : m_hash(std::move(m.m_hash)), m_eq(std::move(m.m_eq)), m_alloc(std::move(m.m_alloc)) { steal(m); }
+
+        flat_hash_map(flat_hash_map &&m, const Alloc &a) : flat_hash_map(0, m.m_hash, m.m_eq, a) {
+            if (alloc_traits::is_always_equal::value || m_alloc == m.m_alloc) {
+                steal(m);
+            } else {
+                reserve(m.size());
+                for (auto &v : m) {
+                    auto idx = prepare_insert(hash_of(v.first));
+                    construct_at_index(idx, std::move(const_cast<K &>(v.first)), std::move(v.second));
+                }
+                m.clear();
+            }
+        }
+
+        ~flat_hash_map() { release(); }
+
+        // assignment
+      public:
+        auto operator=(const flat_hash_map &m) -> flat_hash_map & {
+            if (this != &m) {
+                auto tmp = flat_hash_map(m, alloc_traits::propagate_on_container_copy_assignment::value ? m.m_alloc : m_alloc);
+                swap_storage(tmp);
+                m_hash = m.m_hash;
+                m_eq = m.m_eq;
+                if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                    std::swap(m_alloc, tmp.m_alloc);
+                }
+            }
+            return *this;
+        }
+
+        auto operator=(flat_hash_map &&m) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                                   alloc_traits::is_always_equal::value) -> flat_hash_map & {
+            if (this == &m) {
+                return *this;
+            }
+            if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                release();
+                m_alloc = std::move(m.m_alloc);
+                steal(m);
+            } else if (alloc_traits::is_always_equal::value || m_alloc == m.m_alloc) {
+                release();
+                steal(m);
+            } else {
+                // 用 m 的函数对象重新插入元素，之后才取走它们
+                auto tmp = flat_hash_map(std::move(m), m_alloc);
+                swap_storage(tmp);
+            }
+            m_hash = std::move(m.m_hash);
+            m_eq = std::move(m.m_eq);
+            return *this;
+        }
+
+        auto operator=(std::initializer_list<value_type> lst) -> flat_hash_map & {
+            clear();
+            insert(lst.begin(), lst.end());
+            return *this;
+        }
+
+        auto get_allocator() const noexcept -> allocator_type { return m_alloc; }
+
+        auto hash_function() const -> hasher { return m_hash; }
+
+        auto key_eq() const -> key_equal { return m_eq; }
+
+        // iterator
+      public:
+        auto begin() noexcept -> iterator {
+            auto it = iterator(m_ctrl, m_slots);
+            it.skip_empty_or_deleted();
+            return it;
+        }
+
+        auto begin() const noexcept -> const_iterator { return const_cast<flat_hash_map *>(this)->begin(); }
+
+        auto end() noexcept -> iterator { return iterator(m_ctrl + m_capacity, m_slots + m_capacity); }
+
+        auto end() const noexcept -> const_iterator { return const_cast<flat_hash_map *>(this)->end(); }
+
+        auto cbegin() const noexcept -> const_iterator { return begin(); }
+
+        auto cend() const noexcept -> const_iterator { return end(); }
+
+        // capacity
+      public:
+        [[nodiscard]] auto empty() const noexcept -> bool { return m_size == 0; }
+
+        auto size() const noexcept -> size_type { return m_size; }
+
+        auto max_size() const noexcept -> size_type { return unit_traits::max_size(unit_alloc(m_alloc)) / 2; }
+
+        auto capacity() const noexcept -> size_type { return m_capacity; }
+
+        auto load_factor() const noexcept -> float { return m_capacity ? static_cast<float>(m_size) / static_cast<float>(m_capacity) : 0.0f; }
+
+        static constexpr auto max_load_factor() noexcept -> float { return 7.0f / 8.0f; }
+
+        // 保证插入 n 个元素之前不会扩容
+        auto reserve(size_type n) -> void {
+            if (n > m_size + m_growth_left) {
+                resize(normalize_capacity(growth_to_capacity(n)));
+            }
+        }
+
+        // 容量调整为能容纳 max(n, size()) 个元素的最小值，同时清除所有墓碑
+        auto rehash(size_type n) -> void {
+            auto cap = normalize_capacity(std::max(n, growth_to_capacity(m_size)));
+            if (n == 0 && m_size == 0) {
+                release();
+            } else if (cap != m_capacity || m_growth_left != capacity_to_growth(m_capacity) - m_size) {
+                resize(cap);
+            }
+        }
+
+        // lookup
+      public:
+        template <typename Key = K>
+        auto find(const key_arg<Key> &key) -> iterator {
+            auto idx = find_index(key, hash_of(key));
+            return idx == m_capacity ? end() : iterator_at(idx);
+        }
+
+        template <typename Key = K>
+        auto find(const key_arg<Key> &key) const -> const_iterator {
+            return const_cast<flat_hash_map *>(this)->find(key);
+        }
+
+        template <typename Key = K>
+        auto contains(const key_arg<Key> &key) const -> bool {
+            return find_index(key, hash_of(key)) != m_capacity;
+        }
+
+        template <typename Key = K>
+        auto count(const key_arg<Key> &key) const -> size_type {
+            return contains(key) ? 1 : 0;
+        }
+
+        template <typename Key = K>
+        auto at(const key_arg<Key> &key) -> V & {
+            auto idx = find_index(key, hash_of(key));
+            if (idx == m_capacity) {
+                throw std::out_of_range("flat_hash_map");
+            }
+            return m_slots[idx].second;
+        }
+
+        template <typename Key = K>
+        auto at(const key_arg<Key> &key) const -> const V & {
+            return const_cast<flat_hash_map *>(this)->at(key);
+        }
+
+        auto operator[](const K &key) -> V & { return try_emplace(key).first->second; }
+
+        auto operator[](K &&key) -> V & { return try_emplace(std::move(key)).first->second; }
+
+        // modifier
+      public:
+        auto insert(const value_type &v) -> pair<iterator, bool> { return try_emplace(v.first, v.second); }
+
+        auto insert(value_type &&v) -> pair<iterator, bool> { return try_emplace(std::move(const_cast<K &>(v.first)), std::move(v.second)); }
+
+        template <typename P>
+            requires std::is_constructible_v<value_type, P &&>
+        auto insert(P &&v) -> pair<iterator, bool> {
+            return emplace(std::forward<P>(v));
+        }
+
+        template <std::input_iterator It>
+        auto insert(It first, It last) -> void {
+            if constexpr (std::forward_iterator<It>) {
+                reserve(m_size + static_cast<size_type>(std::distance(first, last)));
+            }
+            for (; first != last; ++first) {
+                emplace(*first);
+            }
+        }
+
+        auto insert(std::initializer_list<value_type> lst) -> void { insert(lst.begin(), lst.end()); }
+
+        template <typename M>
+        auto insert_or_assign(const K &key, M &&m) -> pair<iterator, bool> {
+            auto ret = try_emplace(key, std::forward<M>(m));
+            if (!ret.second) {
+                ret.first->second = std::forward<M>(m);
+            }
+            return ret;
+        }
+
+        template <typename M>
+        auto insert_or_assign(K &&key, M &&m) -> pair<iterator, bool> {
+            auto ret = try_emplace(std::move(key), std::forward<M>(m));
+            if (!ret.second) {
+                ret.first->second = std::forward<M>(m);
+            }
+            return ret;
+        }
+
+        // 无法从参数中直接取得键时，先构造临时元素再查找
+        template <typename... Args>
+        auto emplace(Args &&...args) -> pair<iterator, bool> {
+            if constexpr (sizeof...(Args) == 2 && std::is_same_v<std::remove_cvref_t<nth_type_t<0, Args...>>, K>) {
+                return try_emplace(std::forward<Args>(args)...);
+            } else if constexpr (sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, value_type> && ...)) {
+                return insert(std::forward<Args>(args)...);
+            } else {
+                auto tmp = pair<K, V>(std::forward<Args>(args)...);
+                return try_emplace(std::move(tmp.first), std::move(tmp.second));
+            }
+        }
+
+        template <typename... Args>
+        auto try_emplace(const K &key, Args &&...args) -> pair<iterator, bool> {
+            return try_emplace_impl(key, std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        auto try_emplace(K &&key, Args &&...args) -> pair<iterator, bool> {
+            return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+        }
+
+        auto erase(const_iterator pos) -> iterator {
+            auto idx = static_cast<size_type>(pos.m_slot - m_slots);
+            erase_at(idx);
+            auto it = iterator_at(idx);
+            it.skip_empty_or_deleted();
+            return it;
+        }
+
+        auto erase(iterator pos) -> iterator { return erase(const_iterator(pos)); }
+
+        auto erase(const_iterator first, const_iterator last) -> iterator {
+            while (first != last) {
+                first = erase(first);
+            }
+            return iterator_at(static_cast<size_type>(last.m_slot - m_slots));
+        }
+
+        template <typename Key = K>
+        auto erase(const key_arg<Key> &key) -> size_type {
+            auto idx = find_index(key, hash_of(key));
+            if (idx == m_capacity) {
+                return 0;
+            }
+            erase_at(idx);
+            return 1;
+        }
+
+        // 保留容量
+        auto clear() noexcept -> void {
+            if (m_capacity == 0) {
+                return;
+            }
+            destroy_slots();
+            reset_ctrl();
+            m_size = 0;
+            m_growth_left = capacity_to_growth(m_capacity);
+        }
+
+        auto swap(flat_hash_map &m) noexcept -> void {
+            std::swap(m_hash, m.m_hash);
+            std::swap(m_eq, m.m_eq);
+            if constexpr (alloc_traits::propagate_on_container_swap::value) {
+                std::swap(m_alloc, m.m_alloc);
+            }
+            swap_storage(m);
+        }
+
+        // 内部实现
+      private:
+        // 容量规整为 2^k - 1
+        static constexpr auto normalize_capacity(size_type n) noexcept -> size_type {
+            return n ? ~size_type{0} >> std::countl_zero(n) : 1;
+        }
+
+        static constexpr auto capacity_to_growth(size_type cap) noexcept -> size_type { return cap - cap / 8; }
+
+        static constexpr auto growth_to_capacity(size_type growth) noexcept -> size_type {
+            return growth + static_cast<size_type>((static_cast<int64_t>(growth) - 1) / 7);
+        }
+
+        static constexpr auto slot_offset(size_type cap) noexcept -> size_type {
+            return (cap + 1 + cloned + alignof(value_type) - 1) / alignof(value_type) * alignof(value_type);
+        }
+
+        static constexpr auto alloc_units(size_type cap) noexcept -> size_type {
+            return (slot_offset(cap) + cap * sizeof(value_type) + sizeof(_unit) - 1) / sizeof(_unit);
+        }
+
+        static auto h1(size_t hash) noexcept -> size_t { return hash >> 7; }
+
+        static auto h2(size_t hash) noexcept -> int8_t { return static_cast<int8_t>(hash & 0x7F); }
+
+        template <typename Key>
+        auto hash_of(const Key &key) const -> size_t { return _hash_mix(m_hash(key)); }
+
+        auto iterator_at(size_type idx) noexcept -> iterator { return iterator(m_ctrl + idx, m_slots + idx); }
+
+        // 设置控制字节，同时维护表尾的镜像，使任意位置开始的组读取都不越界
+        auto set_ctrl(size_type idx, _ctrl_t c) noexcept -> void {
+            m_ctrl[idx] = c;
+            m_ctrl[((idx - cloned) & m_capacity) + (cloned & m_capacity)] = c;
+        }
+
+        auto reset_ctrl() noexcept -> void {
+            std::memset(m_ctrl, static_cast<int>(_ctrl_t::empty), m_capacity + 1 + cloned);
+            m_ctrl[m_capacity] = _ctrl_t::sentinel;
+        }
+
+        template <typename Key>
+        auto find_index(const Key &key, size_t hash) const -> size_type {
+            auto seq = _probe_seq(h1(hash), m_capacity);
+            while (true) {
+                auto g = _group(m_ctrl + seq.offset());
+                for (auto i : g.match(h2(hash))) {
+                    auto idx = seq.offset(i);
+                    if (m_eq(m_slots[idx].first, key)) [[likely]] {
+                        return idx;
+                    }
+                }
+                if (g.match_empty()) [[likely]] {
+                    return m_capacity;
+                }
+                seq.next();
+            }
+        }
+
+        auto find_first_non_full(size_t hash) const noexcept -> size_type {
+            auto seq = _probe_seq(h1(hash), m_capacity);
+            while (true) {
+                auto g = _group(m_ctrl + seq.offset());
+                if (auto mask = g.match_empty_or_deleted()) {
+                    return seq.offset(mask.lowest());
+                }
+                seq.next();
+            }
+        }
+
+        // 找到插入位置并写入控制字节，调用者随后在该槽位构造元素
+        auto prepare_insert(size_t hash) -> size_type {
+            auto idx = find_first_non_full(hash);
+            if (m_growth_left == 0 && m_ctrl[idx] != _ctrl_t::deleted) [[unlikely]] {
+                rehash_and_grow();
+                idx = find_first_non_full(hash);
+            }
+            m_growth_left -= (m_ctrl[idx] == _ctrl_t::empty);
+            set_ctrl(idx, static_cast<_ctrl_t>(h2(hash)));
+            ++m_size;
+            return idx;
+        }
+
+        // 构造失败时撤销 prepare_insert
+        template <typename... Args>
+        auto construct_at_index(size_type idx, Args &&...args) -> void {
+            try {
+                alloc_traits::construct(m_alloc, m_slots + idx, std::forward<Args>(args)...);
+            } catch (...) {
+                --m_size;
+                ++m_growth_left;
+                set_ctrl(idx, _ctrl_t::empty);
+                throw;
+            }
+        }
+
+        template <typename Key, typename... Args>
+        auto try_emplace_impl(Key &&key, Args &&...args) -> pair<iterator, bool> {
+            auto hash = hash_of(key);
+            if (auto idx = find_index(key, hash); idx != m_capacity) {
+                return {iterator_at(idx), false};
+            }
+            auto idx = prepare_insert(hash);
+            construct_at_index(idx, piecewise_construct, mtl::forward_as_tuple(std::forward<Key>(key)), mtl::forward_as_tuple(std::forward<Args>(args)...));
+            return {iterator_at(idx), true};
+        }
+
+        // 若删除位置所在的连续满槽不足一组，则任何探测序列都不会越过它，可以直接标记为空而不留墓碑
+        auto erase_at(size_type idx) -> void {
+            alloc_traits::destroy(m_alloc, m_slots + idx);
+            --m_size;
+            auto before = (idx - _group::width) & m_capacity;
+            auto empty_after = _group(m_ctrl + idx).match_empty();
+            auto empty_before = _group(m_ctrl + before).match_empty();
+            auto was_never_full = empty_before && empty_after && (empty_after.trailing_zeros() + empty_before.leading_zeros()) < _group::width;
+            set_ctrl(idx, was_never_full ? _ctrl_t::empty : _ctrl_t::deleted);
+            m_growth_left += was_never_full;
+        }
+
+        // 墓碑较多时原容量重建即可，否则容量翻倍
+        auto rehash_and_grow() -> void {
+            if (m_capacity > _group::width && m_size * 32 <= m_capacity * 25) {
+                resize(m_capacity);
+            } else {
+                resize(m_capacity * 2 + 1);
+            }
+        }
+
+        // 将 src 处的元素搬到 dst。键为 const，非平凡重定位时只能去掉 const 移动后立即销毁源对象
+        auto transfer(value_type *dst, value_type *src) -> void {
+            if constexpr (is_trivially_relocatable_v<value_type>) {
+                std::memcpy(static_cast<void *>(dst), static_cast<const void *>(src), sizeof(value_type));
+            } else {
+                alloc_traits::construct(m_alloc, dst, std::move(const_cast<K &>(src->first)), std::move(src->second));
+                alloc_traits::destroy(m_alloc, src);
+            }
+        }
+
+        auto resize(size_type new_cap) -> void {
+            auto ua = unit_alloc(m_alloc);
+            auto mem = mtl::to_address(unit_traits::allocate(ua, alloc_units(new_cap)));
+            auto old_ctrl = m_ctrl;
+            auto old_slots = m_slots;
+            auto old_cap = m_capacity;
+
+            m_ctrl = reinterpret_cast<_ctrl_t *>(mem);
+            m_slots = reinterpret_cast<value_type *>(reinterpret_cast<std::byte *>(mem) + slot_offset(new_cap));
+            m_capacity = new_cap;
+            reset_ctrl();
+            m_growth_left = capacity_to_growth(new_cap) - m_size;
+
+            for (auto i = size_type{0}; i < old_cap; ++i) {
+                if (_is_full(old_ctrl[i])) {
+                    auto hash = hash_of(old_slots[i].first);
+                    auto idx = find_first_non_full(hash);
+                    set_ctrl(idx, static_cast<_ctrl_t>(h2(hash)));
+                    transfer(m_slots + idx, old_slots + i);
+                }
+            }
+            if (old_cap) {
+                unit_traits::deallocate(ua, reinterpret_cast<_unit *>(old_ctrl), alloc_units(old_cap));
+            }
+        }
+
+        auto destroy_slots() noexcept -> void {
+            if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                for (auto i = size_type{0}; i < m_capacity; ++i) {
+                    if (_is_full(m_ctrl[i])) {
+                        alloc_traits::destroy(m_alloc, m_slots + i);
+                    }
+                }
+            }
+        }
+
+        auto release() noexcept -> void {
+            if (m_capacity == 0) {
+                return;
+            }
+            destroy_slots();
+            auto ua = unit_alloc(m_alloc);
+            unit_traits::deallocate(ua, reinterpret_cast<_unit *>(m_ctrl), alloc_units(m_capacity));
+            m_ctrl = const_cast<_ctrl_t *>(_empty_group);
+            m_slots = nullptr;
+            m_size = m_capacity = m_growth_left = 0;
+        }
+
+        auto steal(flat_hash_map &m) noexcept -> void {
+            m_ctrl = std::exchange(m.m_ctrl, const_cast<_ctrl_t *>(_empty_group));
+            m_slots = std::exchange(m.m_slots, nullptr);
+            m_size = std::exchange(m.m_size, 0);
+            m_capacity = std::exchange(m.m_capacity, 0);
+            m_growth_left = std::exchange(m.m_growth_left, 0);
+        }
+
+        auto swap_storage(flat_hash_map &m) noexcept -> void {
+            std::swap(m_ctrl, m.m_ctrl);
+            std::swap(m_slots, m.m_slots);
+            std::swap(m_size, m.m_size);
+            std::swap(m_capacity, m.m_capacity);
+            std::swap(m_growth_left, m.m_growth_left);
+        }
+
+      public:
+        // 空表指向只读的 _empty_group，容量为 0 时不会写入控制字节
+        _ctrl_t *m_ctrl{const_cast<_ctrl_t *>(_empty_group)};
+        value_type *m_slots{nullptr};
+        size_type m_size{0};
+        size_type m_capacity{0};
+        size_type m_growth_left{0};
+        [[no_unique_address]] Hash m_hash;
+        [[no_unique_address]] Eq m_eq;
+        [[no_unique_address]] Alloc m_alloc;
+    };
+} // namespace mtl
+
+// relational operator
+namespace mtl {
+    template <typename K, typename V, typename Hash, typename Eq, typename Alloc>
+    auto operator==(const flat_hash_map<K, V, Hash, Eq, Alloc> &lhs, const flat_hash_map<K, V, Hash, Eq, Alloc> &rhs) -> bool {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (auto &v : lhs) {
+            auto it = rhs.find(v.first);
+            if (it == rhs.end() || !(it->second == v.second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace mtl
+
+// specialized algorithm
+namespace mtl {
+    template <typename K, typename V, typename Hash, typename Eq, typename Alloc>
+    auto swap(flat_hash_map<K, V, Hash, Eq, Alloc> &lhs, flat_hash_map<K, V, Hash, Eq, Alloc> &rhs) noexcept -> void { lhs.swap(rhs); }
+
+    template <typename K, typename V, typename Hash, typename Eq, typename Alloc, typename Pred>
+    auto erase_if(flat_hash_map<K, V, Hash, Eq, Alloc> &m, Pred pred) -> size_t {
+        auto n = m.size();
+        for (auto it = m.begin(); it != m.end();) {
+            if (pred(*it)) {
+                it = m.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return n - m.size();
+    }
+} // namespace mtl
+
+// trivially relocatable
+namespace mtl {
+    template <typename K, typename V, typename Hash, typename Eq, typename Alloc>
+    struct is_trivially_relocatable<flat_hash_map<K, V, Hash, Eq, Alloc>>
+        : public std::bool_constant<is_trivially_relocatable_v<Hash> && is_trivially_relocatable_v<Eq> && is_trivially_relocatable_v<Alloc>> {};
+} // namespace mtl
@@ -0,0 +1,583 @@
+/*
+    https://eel.is/c++draft/flat.map
+    https://www.open-std.org/jtc1/sc22/wg21/docs/papers/2022/p0429r9.pdf
+*/
+#pragma once
+#include "flat_common.hpp"
+#include "vector.hpp"
+#include "utility/pair.hpp"
+#include <algorithm>
+#include <compare>
+#include <functional>
+#include <initializer_list>
+#include <numeric>
+#include <stdexcept>
+
+// flat map
+namespace mtl {
+    // 键和值分别存放在两个有序的连续容器中，查找只扫描键数组。
+    // 迭代器解引用得到 pair<const K &, V &> 代理对象。插入、删除会使所有迭代器失效。
+    template <typename K, typename V, typename Compare = std::less<K>, typename KeyContainer = vector<K>, typename MappedContainer = vector<V>>
+    class flat_map {
+        static_assert(std::is_same_v<K, typename KeyContainer::value_type>);
+        static_assert(std::is_same_v<V, typename MappedContainer::value_type>);
+
+      public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = pair<K, V>;
+        using key_compare = Compare;
+        using reference = pair<const K &, V &>;
+        using const_reference = pair<const K &, const V &>;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using key_container_type = KeyContainer;
+        using mapped_container_type = MappedContainer;
+
+        class value_compare {
+            friend class flat_map;
+
+          public:
+            auto operator()(const_reference lhs, const_reference rhs) const -> bool { return m_comp(lhs.first, rhs.first); }
+
+          private:
+            value_compare(const Compare &c) : m_comp(c) {}
+
+          public:
+            [[no_unique_address]] Compare m_comp;
+        };
+
+        struct containers {
+            KeyContainer keys;
+            MappedContainer values;
+        };
+
+      private:
+        template <typename Key>
+        using key_arg = _key_arg<_transparent_compare<Compare>>::template type<Key, K>;
+
+      public:
+        template <bool Const>
+        class _iterator {
+            friend class flat_map;
+
+            using key_iter = KeyContainer::const_iterator;
+            using value_iter = std::conditional_t<Const, typename MappedContainer::const_iterator, typename MappedContainer::iterator>;
+
+          public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = flat_map::value_type;
+            using difference_type = ptrdiff_t;
+            using reference = std::conditional_t<Const, flat_map::const_reference, flat_map::reference>;
+
+            // operator-> 返回的代理，使 it->first 可用
+            struct pointer {
+                auto operator->() noexcept -> reference * { return &m_ref; }
+
+                reference m_ref;
+            };
+
+          public:
+            _iterator() = default;
+
+            _iterator(key_iter k, value_iter v) : m_key(k), m_value(v) {}
+
+            template <bool C = Const>
+                requires C
+            _iterator(const _iterator<false> &it) : m_key(it.m_key), m_value(it.m_value) {}
+
+          public:
+            auto operator*() const -> reference { return reference(*m_key, *m_value); }
+
+            auto operator->() const -> pointer { return pointer{**this}; }
+
+            auto operator[](difference_type n) const -> reference { return *(*this + n); }
+
+            auto operator++() -> _iterator & {
+                ++m_key;
+                ++m_value;
+                return *this;
+            }
+
+            auto operator++(int) -> _iterator {
+                auto tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            auto operator--() -> _iterator & {
+                --m_key;
+                --m_value;
+                return *this;
+            }
+
+            auto operator--(int) -> _iterator {
+                auto tmp = *this;
+                --*this;
+                return tmp;
+            }
+
+            auto operator+=(difference_type n) -> _iterator & {
+                m_key += n;
+                m_value += n;
+                return *this;
+            }
+
+            auto operator-=(difference_type n) -> _iterator & { return *this += -n; }
+
+            friend auto operator+(_iterator it, difference_type n) -> _iterator { return it += n; }
+
+            friend auto operator+(difference_type n, _iterator it) -> _iterator { return it += n; }
+
+            friend auto operator-(_iterator it, difference_type n) -> _iterator { return it -= n; }
+
+            friend auto operator-(const _iterator &lhs, const _iterator &rhs) -> difference_type { return lhs.m_key - rhs.m_key; }
+
+            friend auto operator==(const _iterator &lhs, const _iterator &rhs) -> bool { return lhs.m_key == rhs.m_key; }
+
+            friend auto operator<=>(const _iterator &lhs, const _iterator &rhs) { return lhs.m_key <=> rhs.m_key; }
+
+          public:
+            key_iter m_key{};
+            value_iter m_value{};
+        };
+
+        using iterator = _iterator<false>;
+        using const_iterator = _iterator<true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        // 构造
+      public:
+        flat_map() = default;
+
+        explicit flat_map(const Compare &comp) : m_comp(comp) {}
+
+        // 键和值按下标一一对应，构造时排序并去重（重复的键保留第一个）
+        flat_map(KeyContainer keys, MappedContainer values, const Compare &comp = Compare())
+            : m_keys(std::move(keys)), m_values(std::move(values)), m_comp(comp) {
+            if (m_keys.size() != m_values.size()) {
+                throw std::invalid_argument("flat_map");
+            }
+            sort_unique(m_keys, m_values);
+        }
+
+        // 调用者保证已排序且无重复
+        flat_map(sorted_unique_t, KeyContainer keys, MappedContainer values, const Compare &comp = Compare())
+            : m_keys(std::move(keys)), m_values(std::move(values)), m_comp(comp) {}
+
+        template <std::input_iterator It>
+        flat_map(It first, It last, const Compare &comp = Compare()) : m_comp(comp) {
+            insert(first, last);
+        }
+
+        template <std::input_iterator It>
+        flat_map(sorted_unique_t, It first, It last, const Compare &comp = Compare()) : m_comp(comp) {
+            insert(sorted_unique, first, last);
+        }
+
+        flat_map(std::initializer_list<value_type> lst, const Compare &comp = Compare()) : flat_map(lst.begin(), lst.end(), comp) {}
+
+        flat_map(sorted_unique_t, std::initializer_list<value_type> lst, const Compare &comp = Compare())
+            : flat_map(sorted_unique, lst.begin(), lst.end(), comp) {}
+
+        auto operator=(std::initializer_list<value_type> lst) -> flat_map & {
+            clear();
+            insert(lst);
+            return *this;
+        }
+
+        // iterator
+      public:
+        auto begin() noexcept -> iterator { return iterator(m_keys.cbegin(), m_values.begin()); }
+
+        auto begin() const noexcept -> const_iterator { return const_iterator(m_keys.cbegin(), m_values.cbegin()); }
+
+        auto end() noexcept -> iterator { return iterator(m_keys.cend(), m_values.end()); }
+
+        auto end() const noexcept -> const_iterator { return const_iterator(m_keys.cend(), m_values.cend()); }
+
+        auto rbegin() noexcept -> reverse_iterator { return reverse_iterator(end()); }
+
+        auto rbegin() const noexcept -> const_reverse_iterator { return const_reverse_iterator(end()); }
+
+        auto rend() noexcept -> reverse_iterator { return reverse_iterator(begin()); }
+
+        auto rend() const noexcept -> const_reverse_iterator { return const_reverse_iterator(begin()); }
+
+        auto cbegin() const noexcept -> const_iterator { return begin(); }
+
+        auto cend() const noexcept -> const_iterator { return end(); }
+
+        // capacity
+      public:
+        [[nodiscard]] auto empty() const noexcept -> bool { return m_keys.empty(); }
+
+        auto size() const noexcept -> size_type { return m_keys.size(); }
+
+        auto max_size() const noexcept -> size_type { return std::min<size_type>(m_keys.max_size(), m_values.max_size()); }
+
+        auto reserve(size_type n) -> void
+            requires requires(KeyContainer &k, MappedContainer &v) {
+                k.reserve(n);
+                v.reserve(n);
+            }
+        {
+            m_keys.reserve(n);
+            m_values.reserve(n);
+        }
+
+        // element access
+      public:
+        auto operator[](const K &key) -> V & { return try_emplace(key).first->second; }
+
+        auto operator[](K &&key) -> V & { return try_emplace(std::move(key)).first->second; }
+
+        template <typename Key = K>
+        auto at(const key_arg<Key> &key) -> V & {
+            auto idx = find_index(key);
+            if (idx == size()) {
+                throw std::out_of_range("flat_map");
+            }
+            return m_values[idx];
+        }
+
+        template <typename Key = K>
+        auto at(const key_arg<Key> &key) const -> const V & {
+            return const_cast<flat_map *>(this)->at(key);
+        }
+
+        // lookup
+      public:
+        template <typename Key = K>
+        auto find(const key_arg<Key> &key) -> iterator {
+            return iter_at(find_index(key));
+        }
+
+        template <typename Key = K>
+        auto find(const key_arg<Key> &key) const -> const_iterator {
+            return const_cast<flat_map *>(this)->find(key);
+        }
+
+        template <typename Key = K>
+        auto contains(const key_arg<Key> &key) const -> bool {
+            return find_index(key) != size();
+        }
+
+        template <typename Key = K>
+        auto count(const key_arg<Key> &key) const -> size_type {
+            return contains(key) ? 1 : 0;
+        }
+
+        template <typename Key = K>
+        auto lower_bound(const key_arg<Key> &key) -> iterator {
+            return iter_at(lower_index(key));
+        }
+
+        template <typename Key = K>
+        auto lower_bound(const key_arg<Key> &key) const -> const_iterator {
+            return const_cast<flat_map *>(this)->lower_bound(key);
+        }
+
+        template <typename Key = K>
+        auto upper_bound(const key_arg<Key> &key) -> iterator {
+            return iter_at(static_cast<size_type>(_branchless_upper_bound(m_keys.begin(), m_keys.end(), key, m_comp) - m_keys.begin()));
+        }
+
+        template <typename Key = K>
+        auto upper_bound(const key_arg<Key> &key) const -> const_iterator {
+            return const_cast<flat_map *>(this)->upper_bound(key);
+        }
+
+        template <typename Key = K>
+        auto equal_range(const key_arg<Key> &key) -> pair<iterator, iterator> {
+            auto idx = lower_index(key);
+            auto found = idx != size() && !m_comp(key, m_keys[idx]);
+            return {iter_at(idx), iter_at(idx + found)};
+        }
+
+        template <typename Key = K>
+        auto equal_range(const key_arg<Key> &key) const -> pair<const_iterator, const_iterator> {
+            auto [f, l] = const_cast<flat_map *>(this)->equal_range(key);
+            return {f, l};
+        }
+
+        // modifier
+      public:
+        template <typename... Args>
+        auto emplace(Args &&...args) -> pair<iterator, bool> {
+            auto tmp = value_type(std::forward<Args>(args)...);
+            return try_emplace(std::move(tmp.first), std::move(tmp.second));
+        }
+
+        auto insert(const value_type &v) -> pair<iterator, bool> { return try_emplace(v.first, v.second); }
+
+        auto insert(value_type &&v) -> pair<iterator, bool> { return try_emplace(std::move(v.first), std::move(v.second)); }
+
+        // 先排序新元素，再和已有元素归并一次
+        template <std::input_iterator It>
+        auto insert(It first, It last) -> void {
+            bulk_insert(first, last, false);
+        }
+
+        // 输入已排序且无重复，跳过排序直接归并
+        template <std::input_iterator It>
+        auto insert(sorted_unique_t, It first, It last) -> void {
+            bulk_insert(first, last, true);
+        }
+
+        auto insert(std::initializer_list<value_type> lst) -> void { insert(lst.begin(), lst.end()); }
+
+        auto insert(sorted_unique_t, std::initializer_list<value_type> lst) -> void { insert(sorted_unique, lst.begin(), lst.end()); }
+
+        template <typename... Args>
+        auto try_emplace(const K &key, Args &&...args) -> pair<iterator, bool> {
+            return try_emplace_impl(key, std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        auto try_emplace(K &&key, Args &&...args) -> pair<iterator, bool> {
+            return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+        }
+
+        template <typename M>
+        auto insert_or_assign(const K &key, M &&m) -> pair<iterator, bool> {
+            auto ret = try_emplace(key, std::forward<M>(m));
+            if (!ret.second) {
+                ret.first->second = std::forward<M>(m);
+            }
+            return ret;
+        }
+
+        template <typename M>
+        auto insert_or_assign(K &&key, M &&m) -> pair<iterator, bool> {
+            auto ret = try_emplace(std::move(key), std::forward<M>(m));
+            if (!ret.second) {
+                ret.first->second = std::forward<M>(m);
+            }
+            return ret;
+        }
+
+        auto erase(iterator pos) -> iterator { return erase(const_iterator(pos)); }
+
+        auto erase(const_iterator pos) -> iterator {
+            auto idx = static_cast<size_type>(pos - cbegin());
+            m_keys.erase(m_keys.begin() + idx);
+            m_values.erase(m_values.begin() + idx);
+            return iter_at(idx);
+        }
+
+        auto erase(const_iterator first, const_iterator last) -> iterator {
+            auto f = static_cast<size_type>(first - cbegin());
+            auto l = static_cast<size_type>(last - cbegin());
+            m_keys.erase(m_keys.begin() + f, m_keys.begin() + l);
+            m_values.erase(m_values.begin() + f, m_values.begin() + l);
+            return iter_at(f);
+        }
+
+        template <typename Key = K>
+        auto erase(const key_arg<Key> &key) -> size_type {
+            auto idx = find_index(key);
+            if (idx == size()) {
+                return 0;
+            }
+            erase(cbegin() + idx);
+            return 1;
+        }
+
+        auto clear() noexcept -> void {
+            m_keys.clear();
+            m_values.clear();
+        }
+
+        auto swap(flat_map &m) noexcept -> void {
+            std::ranges::swap(m_keys, m.m_keys);
+            std::ranges::swap(m_values, m.m_values);
+            std::ranges::swap(m_comp, m.m_comp);
+        }
+
+        // 取出底层容器，之后 *this 为空
+        auto extract() && -> containers {
+            auto ret = containers{std::move(m_keys), std::move(m_values)};
+            clear();
+            return ret;
+        }
+
+        // 调用者保证 keys 已排序且无重复
+        auto replace(KeyContainer &&keys, MappedContainer &&values) -> void {
+            m_keys = std::move(keys);
+            m_values = std::move(values);
+        }
+
+        // observer
+      public:
+        auto key_comp() const -> key_compare { return m_comp; }
+
+        auto value_comp() const -> value_compare { return value_compare(m_comp); }
+
+        auto keys() const noexcept -> const KeyContainer & { return m_keys; }
+
+        auto values() const noexcept -> const MappedContainer & { return m_values; }
+
+        // 内部实现
+      private:
+        auto iter_at(size_type idx) -> iterator { return iterator(m_keys.cbegin() + idx, m_values.begin() + idx); }
+
+        template <typename Key>
+        auto lower_index(const Key &key) const -> size_type {
+            return static_cast<size_type>(_branchless_lower_bound(m_keys.begin(), m_keys.end(), key, m_comp) - m_keys.begin());
+        }
+
+        // 找不到时返回 size()
+        template <typename Key>
+        auto find_index(const Key &key) const -> size_type {
+            auto idx = lower_index(key);
+            return idx != size() && !m_comp(key, m_keys[idx]) ? idx : size();
+        }
+
+        template <typename Key, typename... Args>
+        auto try_emplace_impl(Key &&key, Args &&...args) -> pair<iterator, bool> {
+            auto idx = lower_index(key);
+            if (idx != size() && !m_comp(key, m_keys[idx])) {
+                return {iter_at(idx), false};
+            }
+            m_keys.emplace(m_keys.begin() + idx, std::forward<Key>(key));
+            try {
+                m_values.emplace(m_values.begin() + idx, std::forward<Args>(args)...);
+            } catch (...) {
+                m_keys.erase(m_keys.begin() + idx);
+                throw;
+            }
+            return {iter_at(idx), true};
+        }
+
+        // 按键稳定排序（借助下标排列，两个容器同步移动），相等的键保留第一个
+        auto sort_unique(KeyContainer &keys, MappedContainer &values) -> void {
+            auto strictly_sorted = std::adjacent_find(keys.begin(), keys.end(), [&](const K &a, const K &b) { return !m_comp(a, b); }) == keys.end();
+            if (strictly_sorted) {
+                return;
+            }
+            auto perm = vector<size_type>(keys.size());
+            std::iota(perm.begin(), perm.end(), size_type{0});
+            std::stable_sort(perm.begin(), perm.end(), [&](size_type a, size_type b) { return m_comp(keys[a], keys[b]); });
+            auto sk = KeyContainer();
+            auto sv = MappedContainer();
+            for (auto i : perm) {
+                if (sk.empty() || m_comp(sk.back(), keys[i])) {
+                    sk.push_back(std::move(keys[i]));
+                    sv.push_back(std::move(values[i]));
+                }
+            }
+            keys = std::move(sk);
+            values = std::move(sv);
+        }
+
+        template <typename It>
+        auto bulk_insert(It first, It last, bool sorted) -> void {
+            auto nk = KeyContainer();
+            auto nv = MappedContainer();
+            for (; first != last; ++first) {
+                auto &&e = *first;
+                nk.push_back(std::forward<decltype(e)>(e).first);
+                nv.push_back(std::forward<decltype(e)>(e).second);
+            }
+            if (nk.empty()) {
+                return;
+            }
+            if (!sorted) {
+                sort_unique(nk, nv);
+            }
+            // 新元素全部大于已有元素时直接追加
+            if (m_keys.empty() || m_comp(m_keys.back(), nk.front())) {
+                m_keys.insert(m_keys.end(), std::make_move_iterator(nk.begin()), std::make_move_iterator(nk.end()));
+                m_values.insert(m_values.end(), std::make_move_iterator(nv.begin()), std::make_move_iterator(nv.end()));
+                return;
+            }
+            // 归并到新容器中，键相等时保留已有元素
+            auto mk = KeyContainer();
+            auto mv = MappedContainer();
+            if constexpr (requires { mk.reserve(size_type{}); mv.reserve(size_type{}); }) {
+                mk.reserve(m_keys.size() + nk.size());
+                mv.reserve(m_keys.size() + nk.size());
+            }
+            auto i = size_type{0};
+            auto j = size_type{0};
+            while (i < m_keys.size() && j < nk.size()) {
+                if (m_comp(nk[j], m_keys[i])) {
+                    mk.push_back(std::move(nk[j]));
+                    mv.push_back(std::move(nv[j]));
+                    ++j;
+                } else {
+                    j += !m_comp(m_keys[i], nk[j]);
+                    mk.push_back(std::move(m_keys[i]));
+                    mv.push_back(std::move(m_values[i]));
+                    ++i;
+                }
+            }
+            for (; i < m_keys.size(); ++i) {
+                mk.push_back(std::move(m_keys[i]));
+                mv.push_back(std::move(m_values[i]));
+            }
+            for (; j < nk.size(); ++j) {
+                mk.push_back(std::move(nk[j]));
+                mv.push_back(std::move(nv[j]));
+            }
+            m_keys = std::move(mk);
+            m_values = std::move(mv);
+        }
+
+      public:
+        KeyContainer m_keys;
+        MappedContainer m_values;
+        [[no_unique_address]] Compare m_comp;
+    };
+} // namespace mtl
+
+// relational operator
+namespace mtl {
+    template <typename K, typename V, typename C, typename KC, typename MC>
+    auto operator==(const flat_map<K, V, C, KC, MC> &lhs, const flat_map<K, V, C, KC, MC> &rhs) -> bool {
+        return std::ranges::equal(lhs.keys(), rhs.keys()) && std::ranges::equal(lhs.values(), rhs.values());
+    }
+
+    template <typename K, typename V, typename C, typename KC, typename MC>
+    auto operator<=>(const flat_map<K, V, C, KC, MC> &lhs, const flat_map<K, V, C, KC, MC> &rhs)
+        -> std::common_comparison_category_t<synth_three_way_result<K, K>, synth_three_way_result<V, V>> {
+        auto n = std::min(lhs.size(), rhs.size());
+        for (auto i = size_t{0}; i < n; ++i) {
+            if (auto c = synth_three_way(lhs.keys()[i], rhs.keys()[i]); c != 0) {
+                return c;
+            }
+            if (auto c = synth_three_way(lhs.values()[i], rhs.values()[i]); c != 0) {
+                return c;
+            }
+        }
+        return lhs.size() <=> rhs.size();
+    }
+} // namespace mtl
+
+// specialized algorithm
+namespace mtl {
+    template <typename K, typename V, typename C, typename KC, typename MC>
+    auto swap(flat_map<K, V, C, KC, MC> &lhs, flat_map<K, V, C, KC, MC> &rhs) noexcept -> void { lhs.swap(rhs); }
+
+    template <typename K, typename V, typename C, typename KC, typename MC, typename Pred>
+    auto erase_if(flat_map<K, V, C, KC, MC> &m, Pred pred) -> size_t {
+        auto c = std::move(m).extract();
+        auto j = size_t{0};
+        for (auto i = size_t{0}; i < c.keys.size(); ++i) {
+            if (!pred(typename flat_map<K, V, C, KC, MC>::const_reference(c.keys[i], c.values[i]))) {
+                if (i != j) {
+                    c.keys[j] = std::move(c.keys[i]);
+                    c.values[j] = std::move(c.values[i]);
+                }
+                ++j;
+            }
+        }
+        auto n = c.keys.size() - j;
+        c.keys.erase(c.keys.begin() + j, c.keys.end());
+        c.values.erase(c.values.begin() + j, c.values.end());
+        m.replace(std::move(c.keys), std::move(c.values));
+        return n;
+    }
+} // namespace mtl
@@ -0,0 +1,266 @@
+/*
+    https://eel.is/c++draft/flat.set
+    https://www.open-std.org/jtc1/sc22/wg21/docs/papers/2022/p1222r4.pdf
+*/
+#pragma once
+#include "flat_common.hpp"
+#include "vector.hpp"
+#include "utility/pair.hpp"
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+
+// flat set
+namespace mtl {
+    // 元素存放在一个有序的连续容器中。插入、删除会使所有迭代器失效。
+    template <typename K, typename Compare = std::less<K>, typename KeyContainer = vector<K>>
+    class flat_set {
+        static_assert(std::is_same_v<K, typename KeyContainer::value_type>);
+
+      public:
+        using key_type = K;
+        using value_type = K;
+        using key_compare = Compare;
+        using value_compare = Compare;
+        using reference = K &;
+        using const_reference = const K &;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using iterator = KeyContainer::const_iterator;
+        using const_iterator = KeyContainer::const_iterator;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using container_type = KeyContainer;
+
+      private:
+        template <typename Key>
+        using key_arg = _key_arg<_transparent_compare<Compare>>::template type<Key, K>;
+
+        // 构造
+      public:
+        flat_set() = default;
+
+        explicit flat_set(const Compare &comp) : m_comp(comp) {}
+
+        // 构造时排序并去重
+        explicit flat_set(KeyContainer keys, const Compare &comp = Compare()) : m_keys(std::move(keys)), m_comp(comp) { sort_unique(m_keys); }
+
+        // 调用者保证已排序且无重复
+        flat_set(sorted_unique_t, KeyContainer keys, const Compare &comp = Compare()) : m_keys(std::move(keys)), m_comp(comp) {}
+
+        template <std::input_iterator It>
+        flat_set(It first, It last, const Compare &comp = Compare()) : m_comp(comp) {
+            insert(first, last);
+        }
+
+        template <std::input_iterator It>
+        flat_set(sorted_unique_t, It first, It last, const Compare &comp = Compare()) : m_keys(first, last), m_comp(comp) {}
+
+        flat_set(std::initializer_list<K> lst, const Compare &comp = Compare()) : flat_set(lst.begin(), lst.end(), comp) {}
+
+        flat_set(sorted_unique_t, std::initializer_list<K> lst, const Compare &comp = Compare()) : flat_set(sorted_unique, lst.begin(), lst.end(), comp) {}
+
+        auto operator=(std::initializer_list<K> lst) -> flat_set & {
+            clear();
+            insert(lst);
+            return *this;
+        }
+
+        // iterator
+      public:
+        auto begin() const noexcept -> const_iterator { return m_keys.cbegin(); }
+
+        auto end() const noexcept -> const_iterator { return m_keys.cend(); }
+
+        auto rbegin() const noexcept -> const_reverse_iterator { return const_reverse_iterator(end()); }
+
+        auto rend() const noexcept -> const_reverse_iterator { return const_reverse_iterator(begin()); }
+
+        auto cbegin() const noexcept -> const_iterator { return begin(); }
+
+        auto cend() const noexcept -> const_iterator { return end(); }
+
+        // capacity
+      public:
+        [[nodiscard]] auto empty() const noexcept -> bool { return m_keys.empty(); }
+
+        auto size() const noexcept -> size_type { return m_keys.size(); }
+
+        auto max_size() const noexcept -> size_type { return m_keys.max_size(); }
+
+        auto reserve(size_type n) -> void
+            requires requires(KeyContainer &k) { k.reserve(n); }
+        {
+            m_keys.reserve(n);
+        }
+
+        // lookup
+      public:
+        template <typename Key = K>
+        auto find(const key_arg<Key> &key) const -> const_iterator {
+            auto it = lower_bound(key);
+            return it != end() && !m_comp(key, *it) ? it : end();
+        }
+
+        template <typename Key = K>
+        auto contains(const key_arg<Key> &key) const -> bool {
+            return find(key) != end();
+        }
+
+        template <typename Key = K>
+        auto count(const key_arg<Key> &key) const -> size_type {
+            return contains(key) ? 1 : 0;
+        }
+
+        template <typename Key = K>
+        auto lower_bound(const key_arg<Key> &key) const -> const_iterator {
+            return _branchless_lower_bound(m_keys.begin(), m_keys.end(), key, m_comp);
+        }
+
+        template <typename Key = K>
+        auto upper_bound(const key_arg<Key> &key) const -> const_iterator {
+            return _branchless_upper_bound(m_keys.begin(), m_keys.end(), key, m_comp);
+        }
+
+        template <typename Key = K>
+        auto equal_range(const key_arg<Key> &key) const -> pair<const_iterator, const_iterator> {
+            auto it = lower_bound(key);
+            return {it, it != end() && !m_comp(key, *it) ? it + 1 : it};
+        }
+
+        // modifier
+      public:
+        template <typename... Args>
+        auto emplace(Args &&...args) -> pair<iterator, bool> {
+            return insert(K(std::forward<Args>(args)...));
+        }
+
+        auto insert(const K &key) -> pair<iterator, bool> { return insert_impl(key); }
+
+        auto insert(K &&key) -> pair<iterator, bool> { return insert_impl(std::move(key)); }
+
+        // 新元素追加到尾部后排序，再和已有元素原地归并、去重
+        template <std::input_iterator It>
+        auto insert(It first, It last) -> void {
+            bulk_insert(first, last, false);
+        }
+
+        template <std::input_iterator It>
+        auto insert(sorted_unique_t, It first, It last) -> void {
+            bulk_insert(first, last, true);
+        }
+
+        auto insert(std::initializer_list<K> lst) -> void { insert(lst.begin(), lst.end()); }
+
+        auto insert(sorted_unique_t, std::initializer_list<K> lst) -> void { insert(sorted_unique, lst.begin(), lst.end()); }
+
+        auto erase(const_iterator pos) -> iterator { return m_keys.erase(pos); }
+
+        auto erase(const_iterator first, const_iterator last) -> iterator { return m_keys.erase(first, last); }
+
+        template <typename Key = K>
+        auto erase(const key_arg<Key> &key) -> size_type {
+            auto it = find(key);
+            if (it == end()) {
+                return 0;
+            }
+            m_keys.erase(it);
+            return 1;
+        }
+
+        auto clear() noexcept -> void { m_keys.clear(); }
+
+        auto swap(flat_set &s) noexcept -> void {
+            std::ranges::swap(m_keys, s.m_keys);
+            std::ranges::swap(m_comp, s.m_comp);
+        }
+
+        // 取出底层容器，之后 *this 为空
+        auto extract() && -> container_type {
+            auto ret = std::move(m_keys);
+            clear();
+            return ret;
+        }
+
+        // 调用者保证 keys 已排序且无重复
+        auto replace(KeyContainer &&keys) -> void { m_keys = std::move(keys); }
+
+        // observer
+      public:
+        auto key_comp() const -> key_compare { return m_comp; }
+
+        auto value_comp() const -> value_compare { return m_comp; }
+
+        // 内部实现
+      private:
+        template <typename Key>
+        auto insert_impl(Key &&key) -> pair<iterator, bool> {
+            auto it = lower_bound(key);
+            if (it != end() && !m_comp(key, *it)) {
+                return {it, false};
+            }
+            return {m_keys.insert(it, std::forward<Key>(key)), true};
+        }
+
+        // 相等的元素保留第一个
+        auto unique_from(typename KeyContainer::iterator first) -> void {
+            auto it = std::unique(first, m_keys.end(), [&](const K &a, const K &b) { return !m_comp(a, b); });
+            m_keys.erase(it, m_keys.end());
+        }
+
+        auto sort_unique(KeyContainer &keys) -> void {
+            std::stable_sort(keys.begin(), keys.end(), m_comp);
+            keys.erase(std::unique(keys.begin(), keys.end(), [&](const K &a, const K &b) { return !m_comp(a, b); }), keys.end());
+        }
+
+        template <typename It>
+        auto bulk_insert(It first, It last, bool sorted) -> void {
+            auto old_size = m_keys.size();
+            m_keys.insert(m_keys.end(), first, last);
+            auto mid = m_keys.begin() + old_size;
+            if (!sorted) {
+                std::stable_sort(mid, m_keys.end(), m_comp);
+            }
+            // 新元素全部大于已有元素时无需归并
+            if (old_size != 0 && mid != m_keys.end() && !m_comp(*(mid - 1), *mid)) {
+                std::inplace_merge(m_keys.begin(), mid, m_keys.end(), m_comp);
+                unique_from(m_keys.begin());
+            } else if (!sorted) {
+                unique_from(mid);
+            }
+        }
+
+      public:
+        KeyContainer m_keys;
+        [[no_unique_address]] Compare m_comp;
+    };
+} // namespace mtl
+
+// relational operator
+namespace mtl {
+    template <typename K, typename C, typename KC>
+    auto operator==(const flat_set<K, C, KC> &lhs, const flat_set<K, C, KC> &rhs) -> bool {
+        return std::ranges::equal(lhs, rhs);
+    }
+
+    template <typename K, typename C, typename KC>
+    auto operator<=>(const flat_set<K, C, KC> &lhs, const flat_set<K, C, KC> &rhs) {
+        return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), synth_three_way);
+    }
+} // namespace mtl
+
+// specialized algorithm
+namespace mtl {
+    template <typename K, typename C, typename KC>
+    auto swap(flat_set<K, C, KC> &lhs, flat_set<K, C, KC> &rhs) noexcept -> void { lhs.swap(rhs); }
+
+    template <typename K, typename C, typename KC, typename Pred>
+    auto erase_if(flat_set<K, C, KC> &s, Pred pred) -> size_t {
+        auto keys = std::move(s).extract();
+        auto it = std::remove_if(keys.begin(), keys.end(), pred);
+        auto n = static_cast<size_t>(keys.end() - it);
+        keys.erase(it, keys.end());
+        s.replace(std::move(keys));
+        return n;
+    }
+} // namespace mtl
@@ -0,0 +1,269 @@
+/*
+    https://www.open-std.org/jtc1/sc22/wg21/docs/papers/2017/p0661r0.pdf
+*/
+#pragma once
+#include "vector.hpp"
+#include "utility/optional.hpp"
+#include <functional>
+#include <stdexcept>
+
+// slot key
+namespace mtl {
+    // slot_map 的句柄：槽位下标和代数，可以无损地转换为一个 64 位整数
+    struct slot_key {
+        uint32_t index{static_cast<uint32_t>(-1)};
+        uint32_t generation{0};
+
+        static constexpr auto from_integer(uint64_t v) noexcept -> slot_key {
+            return {static_cast<uint32_t>(v), static_cast<uint32_t>(v >> 32)};
+        }
+
+        constexpr auto to_integer() const noexcept -> uint64_t { return static_cast<uint64_t>(generation) << 32 | index; }
+
+        constexpr auto operator==(const slot_key &) const noexcept -> bool = default;
+    };
+} // namespace mtl
+
+// slot map
+namespace mtl {
+    // 值紧密存放在 m_values 中，句柄经过槽位数组间接找到值：
+    // 槽位保存值的下标和代数，删除时代数加一，旧句柄随之失效；空闲槽位通过 index 串成链表复用。
+    // 删除时把最后一个值移到空位，因此插入、删除、查找都是 O(1)，迭代顺序不固定。
+    template <typename T, typename Alloc = allocator<T>>
+    class slot_map {
+        struct slot {
+            uint32_t index; // 占用时为值的下标，空闲时为下一个空闲槽位
+            uint32_t generation;
+        };
+
+        using alloc_traits = allocator_traits<Alloc>;
+        using slot_alloc = alloc_traits::template rebind_alloc<slot>;
+        using index_alloc = alloc_traits::template rebind_alloc<uint32_t>;
+
+        static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+
+      public:
+        using key_type = slot_key;
+        using value_type = T;
+        using allocator_type = Alloc;
+        using size_type = size_t;
+        using reference = T &;
+        using const_reference = const T &;
+        using iterator = vector<T, Alloc>::iterator;
+        using const_iterator = vector<T, Alloc>::const_iterator;
+
+        // 构造
+      public:
+        slot_map() = default;
+
+        explicit slot_map(const Alloc &a) : m_values(a), m_owners(index_alloc(a)), m_slots(slot_alloc(a)) {}
+
+        // iterator
+      public:
+        auto begin() noexcept -> iterator { return m_values.begin(); }
+
+        auto begin() const noexcept -> const_iterator { return m_values.begin(); }
+
+        auto end() noexcept -> iterator { return m_values.end(); }
+
+        auto end() const noexcept -> const_iterator { return m_values.end(); }
+
+        auto cbegin() const noexcept -> const_iterator { return begin(); }
+
+        auto cend() const noexcept -> const_iterator { return end(); }
+
+        // 迭代器所指元素的句柄
+        auto key_of(const_iterator it) const noexcept -> key_type {
+            auto s = m_owners[static_cast<size_t>(it - m_values.begin())];
+            return {s, m_slots[s].generation};
+        }
+
+        // capacity
+      public:
+        [[nodiscard]] auto empty() const noexcept -> bool { return m_values.empty(); }
+
+        auto size() const noexcept -> size_type { return m_values.size(); }
+
+        auto max_size() const noexcept -> size_type { return std::min<size_type>(m_values.max_size(), npos - 1); }
+
+        auto capacity() const noexcept -> size_type { return m_values.capacity(); }
+
+        auto reserve(size_type n) -> void {
+            m_values.reserve(n);
+            m_owners.reserve(n);
+            m_slots.reserve(n);
+        }
+
+        // lookup
+      public:
+        auto contains(key_type k) const noexcept -> bool { return k.index < m_slots.size() && m_slots[k.index].generation == k.generation; }
+
+        // 句柄失效时返回 nullptr
+        auto find(key_type k) noexcept -> T * { return contains(k) ? m_values.data() + m_slots[k.index].index : nullptr; }
+
+        auto find(key_type k) const noexcept -> const T * { return contains(k) ? m_values.data() + m_slots[k.index].index : nullptr; }
+
+        auto at(key_type k) -> T & {
+            if (!contains(k)) {
+                throw std::out_of_range("slot_map::at");
+            }
+            return m_values[m_slots[k.index].index];
+        }
+
+        auto at(key_type k) const -> const T & {
+            if (!contains(k)) {
+                throw std::out_of_range("slot_map::at");
+            }
+            return m_values[m_slots[k.index].index];
+        }
+
+        // 调用者保证句柄有效
+        auto operator[](key_type k) noexcept -> T & { return m_values[m_slots[k.index].index]; }
+
+        auto operator[](key_type k) const noexcept -> const T & { return m_values[m_slots[k.index].index]; }
+
+        // modifier
+      public:
+        auto insert(const T &value) -> key_type { return emplace(value); }
+
+        auto insert(T &&value) -> key_type { return emplace(std::move(value)); }
+
+        template <typename... Args>
+        auto emplace(Args &&...args) -> key_type {
+            if (size() >= max_size()) {
+                throw std::length_error("slot_map");
+            }
+            // 任何一步抛出异常时撤销之前的修改
+            auto pos = static_cast<uint32_t>(m_values.size());
+            m_owners.push_back(npos);
+            try {
+                m_values.emplace_back(std::forward<Args>(args)...);
+            } catch (...) {
+                m_owners.pop_back();
+                throw;
+            }
+            auto s = m_free;
+            if (s != npos) {
+                m_free = m_slots[s].index;
+            } else {
+                s = static_cast<uint32_t>(m_slots.size());
+                try {
+                    m_slots.push_back({0, 0});
+                } catch (...) {
+                    m_values.pop_back();
+                    m_owners.pop_back();
+                    throw;
+                }
+            }
+            m_owners[pos] = s;
+            m_slots[s].index = pos;
+            return {s, m_slots[s].generation};
+        }
+
+        // 返回删除的元素个数
+        auto erase(key_type k) -> size_type {
+            if (!contains(k)) {
+                return 0;
+            }
+            erase_at(m_slots[k.index].index);
+            return 1;
+        }
+
+        // 删除后最后一个元素移到 it 处，返回的迭代器指向它
+        auto erase(const_iterator it) -> iterator {
+            auto pos = static_cast<uint32_t>(it - m_values.begin());
+            erase_at(pos);
+            return m_values.begin() + pos;
+        }
+
+        // 取出元素并使句柄失效
+        auto pop(key_type k) -> optional<T>
+            requires std::is_move_constructible_v<T>
+        {
+            if (!contains(k)) {
+                return nullopt;
+            }
+            auto pos = m_slots[k.index].index;
+            auto ret = optional<T>(std::move(m_values[pos]));
+            erase_at(pos);
+            return ret;
+        }
+
+        // 所有句柄失效，槽位全部回到空闲链表
+        auto clear() noexcept -> void {
+            for (auto s : m_owners) {
+                ++m_slots[s].generation;
+            }
+            m_values.clear();
+            m_owners.clear();
+            m_free = npos;
+            for (auto i = m_slots.size(); i-- > 0;) {
+                m_slots[i].index = m_free;
+                m_free = static_cast<uint32_t>(i);
+            }
+        }
+
+        auto swap(slot_map &m) noexcept -> void {
+            m_values.swap(m.m_values);
+            m_owners.swap(m.m_owners);
+            m_slots.swap(m.m_slots);
+            std::swap(m_free, m.m_free);
+        }
+
+        // 内部实现
+      private:
+        auto erase_at(uint32_t pos) -> void {
+            auto s = m_owners[pos];
+            auto last = static_cast<uint32_t>(m_values.size() - 1);
+            if (pos != last) {
+                m_values[pos] = std::move(m_values[last]);
+                m_owners[pos] = m_owners[last];
+                m_slots[m_owners[pos]].index = pos;
+            }
+            m_values.pop_back();
+            m_owners.pop_back();
+            ++m_slots[s].generation;
+            m_slots[s].index = m_free;
+            m_free = s;
+        }
+
+      public:
+        vector<T, Alloc> m_values;
+        vector<uint32_t, index_alloc> m_owners; // 与 m_values 一一对应，值所在的槽位
+        vector<slot, slot_alloc> m_slots;
+        uint32_t m_free{npos}; // 空闲链表头
+    };
+} // namespace mtl
+
+// specialized algorithm
+namespace mtl {
+    template <typename T, typename Alloc>
+    auto swap(slot_map<T, Alloc> &lhs, slot_map<T, Alloc> &rhs) noexcept -> void { lhs.swap(rhs); }
+
+    template <typename T, typename Alloc, typename Pred>
+    auto erase_if(slot_map<T, Alloc> &m, Pred pred) -> size_t {
+        auto n = m.size();
+        for (auto it = m.begin(); it != m.end();) {
+            if (pred(*it)) {
+                it = m.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return n - m.size();
+    }
+} // namespace mtl
+
+// hash
+namespace std {
+    template <>
+    struct hash<mtl::slot_key> {
+        auto operator()(const mtl::slot_key &k) const noexcept -> size_t { return std::hash<uint64_t>{}(k.to_integer()); }
+    };
+} // namespace std
+
+// trivially relocatable
+namespace mtl {
+    template <typename T, typename Alloc>
+    struct is_trivially_relocatable<slot_map<T, Alloc>> : public std::bool_constant<is_trivially_relocatable_v<Alloc>> {};
+} // namespace mtl
@@ -0,0 +1,585 @@
+/*
+    https://llvm.org/docs/ProgrammersManual.html#llvm-adt-smallvector-h
+    https://www.boost.org/doc/libs/release/doc/html/container/non_standard_containers.html#container.non_standard_containers.small_vector
+*/
+#pragma once
+#include "utility/memory.hpp"
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+// small vector
+namespace mtl {
+    // 默认内联容量：使整个对象恰好占满一个缓存行（三个指针之外的空间全部用于内联元素）
+    template <typename T>
+    inline constexpr size_t small_vector_default_inline = std::max<size_t>((64 - 3 * sizeof(T *)) / sizeof(T), 1);
+
+    // 前 N 个元素存放在对象内部的缓冲区中，超出后整体搬到分配器申请的堆内存上。
+    // 内联模式下 m_begin 指向对象自身，因此 small_vector 本身不可平凡重定位，
+    // 移动和交换时只搬移元素：可平凡重定位的元素一次 memcpy，堆模式直接交换指针。
+    template <typename T, size_t N = small_vector_default_inline<T>, typename Alloc = allocator<T>>
+    class small_vector {
+        static_assert(N > 0, "use mtl::vector for zero inline capacity");
+
+        using alloc_traits = allocator_traits<Alloc>;
+
+      public:
+        using value_type = T;
+        using allocator_type = Alloc;
+        using pointer = alloc_traits::pointer;
+        using const_pointer = alloc_traits::const_pointer;
+        using reference = T &;
+        using const_reference = const T &;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using iterator = T *;
+        using const_iterator = const T *;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        static constexpr size_type inline_capacity = N;
+
+        // 构造
+      public:
+        small_vector() noexcept(noexcept(Alloc())) = default;
+
+        explicit small_vector(const Alloc &a) noexcept : m_alloc(a) {}
+
+        // 以下构造函数都委托给 small_vector(a)，函数体抛出异常时由析构函数销毁已构造的元素并释放堆内存
+        explicit small_vector(size_type n, const Alloc &a = Alloc()) : small_vector(a) {
+            reserve_exact(n);
+            m_end = mtl::uninitialized_value_construct_n(m_begin, n);
+        }
+
+        small_vector(size_type n, const T &value, const Alloc &a = Alloc()) : small_vector(a) {
+            reserve_exact(n);
+            m_end = mtl::uninitialized_fill_n(m_begin, n, value);
+        }
+
+        template <std::input_iterator It>
+        small_vector(It first, It last, const Alloc &a = Alloc()) : small_vector(a) {
+            assign(first, last);
+        }
+
+        small_vector(std::initializer_list<T> lst, const Alloc &a = Alloc()) : small_vector(lst.begin(), lst.end(), a) {}
+
+        small_vector(const small_vector &v) : small_vector(v, alloc_traits::select_on_container_copy_construction(v.m_alloc)) {}
+
+        small_vector(const small_vector &v, const Alloc &a) : small_vector(a) {
+            reserve_exact(v.size());
+            m_end = mtl::uninitialized_copy(v.m_begin, v.m_end, m_begin);
+        }
+
+        small_vector(small_vector &&v) noexcept(_nothrow_relocate) : m_alloc(std::move(v.m_alloc)) { take(v, true); }
+
+        small_vector(small_vector &&v, const Alloc &a) : small_vector(a) { take(v, alloc_traits::is_always_equal::value || m_alloc == v.m_alloc); }
+
+        ~small_vector() { release(); }
+
+        // assignment
+      public:
+        auto operator=(const small_vector &v) -> small_vector & {
+            if (this == &v) {
+                return *this;
+            }
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                if (!alloc_traits::is_always_equal::value && m_alloc != v.m_alloc) {
+                    release();
+                }
+                m_alloc = v.m_alloc;
+            }
+            assign(v.m_begin, v.m_end);
+            return *this;
+        }
+
+        // 源对象在堆上且分配器允许时接管堆内存，否则搬移元素
+        auto operator=(small_vector &&v) noexcept(_nothrow_relocate && (alloc_traits::propagate_on_container_move_assignment::value ||
+                                                                          alloc_traits::is_always_equal::value)) -> small_vector & {
+            if (this == &v) {
+                return *this;
+            }
+            release();
+            if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                m_alloc = std::move(v.m_alloc);
+                take(v, true);
+            } else {
+                take(v, alloc_traits::is_always_equal::value || m_alloc == v.m_alloc);
+            }
+            return *this;
+        }
+
+        auto operator=(std::initializer_list<T> lst) -> small_vector & {
+            assign(lst.begin(), lst.end());
+            return *this;
+        }
+
+        template <std::input_iterator It>
+        auto assign(It first, It last) -> void {
+            if constexpr (std::forward_iterator<It>) {
+                auto n = static_cast<size_type>(std::distance(first, last));
+                if (n > capacity()) {
+                    clear();
+                    auto [p, count] = allocate(recommend(n));
+                    adopt(p, count, 0);
+                    m_end = mtl::uninitialized_copy(first, last, m_begin);
+                    return;
+                }
+                auto mid = first;
+                std::advance(mid, std::min(n, size()));
+                auto cur = std::copy(first, mid, m_begin);
+                if (n > size()) {
+                    m_end = mtl::uninitialized_copy(mid, last, m_end);
+                } else {
+                    destroy_tail(cur);
+                }
+            } else {
+                clear();
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+            }
+        }
+
+        auto assign(size_type n, const T &value) -> void {
+            if (n > capacity()) {
+                auto tmp = T(value); // value 可能引用容器内的元素
+                clear();
+                auto [p, count] = allocate(recommend(n));
+                adopt(p, count, 0);
+                m_end = mtl::uninitialized_fill_n(m_begin, n, tmp);
+                return;
+            }
+            std::fill(m_begin, m_begin + std::min(n, size()), value);
+            if (n > size()) {
+                mtl::uninitialized_fill(m_end, m_begin + n, value);
+                m_end = m_begin + n;
+            } else {
+                destroy_tail(m_begin + n);
+            }
+        }
+
+        auto assign(std::initializer_list<T> lst) -> void { assign(lst.begin(), lst.end()); }
+
+        auto get_allocator() const noexcept -> allocator_type { return m_alloc; }
+
+        // iterator
+      public:
+        auto begin() noexcept -> iterator { return m_begin; }
+
+        auto begin() const noexcept -> const_iterator { return m_begin; }
+
+        auto end() noexcept -> iterator { return m_end; }
+
+        auto end() const noexcept -> const_iterator { return m_end; }
+
+        auto rbegin() noexcept -> reverse_iterator { return reverse_iterator(end()); }
+
+        auto rbegin() const noexcept -> const_reverse_iterator { return const_reverse_iterator(end()); }
+
+        auto rend() noexcept -> reverse_iterator { return reverse_iterator(begin()); }
+
+        auto rend() const noexcept -> const_reverse_iterator { return const_reverse_iterator(begin()); }
+
+        auto cbegin() const noexcept -> const_iterator { return begin(); }
+
+        auto cend() const noexcept -> const_iterator { return end(); }
+
+        auto crbegin() const noexcept -> const_reverse_iterator { return rbegin(); }
+
+        auto crend() const noexcept -> const_reverse_iterator { return rend(); }
+
+        // capacity
+      public:
+        [[nodiscard]] auto empty() const noexcept -> bool { return m_begin == m_end; }
+
+        auto size() const noexcept -> size_type { return static_cast<size_type>(m_end - m_begin); }
+
+        auto max_size() const noexcept -> size_type { return alloc_traits::max_size(m_alloc); }
+
+        auto capacity() const noexcept -> size_type { return static_cast<size_type>(m_cap - m_begin); }
+
+        // 元素是否存放在内联缓冲区中
+        auto is_inline() const noexcept -> bool { return m_begin == inline_data(); }
+
+        auto reserve(size_type n) -> void {
+            if (n > capacity()) {
+                reallocate(recommend(n));
+            }
+        }
+
+        auto reserve_exact(size_type n) -> void {
+            if (n > max_size()) {
+                throw std::length_error("small_vector");
+            }
+            if (n > capacity()) {
+                reallocate(n);
+            }
+        }
+
+        // 元素数量不超过 N 时回到内联缓冲区
+        auto shrink_to_fit() -> void {
+            if (is_inline() || capacity() == size()) {
+                return;
+            }
+            if (size() <= N) {
+                auto p = m_begin;
+                auto cap = capacity();
+                auto n = size();
+                mtl::_relocate_if_noexcept(p, m_end, inline_data());
+                alloc_traits::deallocate(m_alloc, p, cap);
+                reset_inline();
+                m_end = m_begin + n;
+            } else {
+                reallocate(size());
+            }
+        }
+
+        // element access
+      public:
+        auto operator[](size_type i) -> reference { return m_begin[i]; }
+
+        auto operator[](size_type i) const -> const_reference { return m_begin[i]; }
+
+        auto at(size_type i) -> reference {
+            if (i >= size()) {
+                throw std::out_of_range("small_vector");
+            }
+            return m_begin[i];
+        }
+
+        auto at(size_type i) const -> const_reference {
+            if (i >= size()) {
+                throw std::out_of_range("small_vector");
+            }
+            return m_begin[i];
+        }
+
+        auto front() -> reference { return *m_begin; }
+
+        auto front() const -> const_reference { return *m_begin; }
+
+        auto back() -> reference { return *(m_end - 1); }
+
+        auto back() const -> const_reference { return *(m_end - 1); }
+
+        auto data() noexcept -> T * { return m_begin; }
+
+        auto data() const noexcept -> const T * { return m_begin; }
+
+        // modifier
+      public:
+        template <typename... Args>
+        auto emplace_back(Args &&...args) -> reference {
+            if (m_end != m_cap) [[likely]] {
+                alloc_traits::construct(m_alloc, m_end, std::forward<Args>(args)...);
+                return *m_end++;
+            }
+            return realloc_emplace(size(), std::forward<Args>(args)...);
+        }
+
+        auto push_back(const T &value) -> void { emplace_back(value); }
+
+        auto push_back(T &&value) -> void { emplace_back(std::move(value)); }
+
+        auto pop_back() -> void { alloc_traits::destroy(m_alloc, --m_end); }
+
+        template <typename... Args>
+        auto emplace(const_iterator pos, Args &&...args) -> iterator {
+            auto idx = static_cast<size_type>(pos - m_begin);
+            if (m_end == m_cap) {
+                realloc_emplace(idx, std::forward<Args>(args)...);
+                return m_begin + idx;
+            }
+            if (idx == size()) {
+                emplace_back(std::forward<Args>(args)...);
+                return m_begin + idx;
+            }
+            // args 可能引用容器内的元素，先构造临时对象
+            auto tmp = T(std::forward<Args>(args)...);
+            insert_gap(idx, 1, [&](T *gap) { alloc_traits::construct(m_alloc, gap, std::move(tmp)); });
+            return m_begin + idx;
+        }
+
+        auto insert(const_iterator pos, const T &value) -> iterator { return emplace(pos, value); }
+
+        auto insert(const_iterator pos, T &&value) -> iterator { return emplace(pos, std::move(value)); }
+
+        auto insert(const_iterator pos, size_type n, const T &value) -> iterator {
+            auto idx = static_cast<size_type>(pos - m_begin);
+            if (n == 0) {
+                return m_begin + idx;
+            }
+            auto tmp = T(value);
+            insert_gap(idx, n, [&](T *gap) { mtl::uninitialized_fill_n(gap, n, tmp); });
+            return m_begin + idx;
+        }
+
+        template <std::input_iterator It>
+        auto insert(const_iterator pos, It first, It last) -> iterator {
+            auto idx = static_cast<size_type>(pos - m_begin);
+            if constexpr (std::forward_iterator<It>) {
+                auto n = static_cast<size_type>(std::distance(first, last));
+                if (n != 0) {
+                    insert_gap(idx, n, [&](T *gap) { mtl::uninitialized_copy(first, last, gap); });
+                }
+            } else {
+                auto old_size = size();
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+                std::rotate(m_begin + idx, m_begin + old_size, m_end);
+            }
+            return m_begin + idx;
+        }
+
+        auto insert(const_iterator pos, std::initializer_list<T> lst) -> iterator { return insert(pos, lst.begin(), lst.end()); }
+
+        auto erase(const_iterator pos) -> iterator { return erase(pos, pos + 1); }
+
+        auto erase(const_iterator first, const_iterator last) -> iterator {
+            auto f = m_begin + (first - m_begin);
+            auto l = m_begin + (last - m_begin);
+            if (f == l) {
+                return f;
+            }
+            if constexpr (is_trivially_relocatable_v<T>) {
+                mtl::destroy(f, l);
+                mtl::uninitialized_relocate(l, m_end, f);
+                m_end -= (l - f);
+            } else {
+                destroy_tail(std::move(l, m_end, f));
+            }
+            return f;
+        }
+
+        auto clear() noexcept -> void { destroy_tail(m_begin); }
+
+        auto resize(size_type n) -> void {
+            if (n > size()) {
+                reserve(n);
+                mtl::uninitialized_value_construct(m_end, m_begin + n);
+                m_end = m_begin + n;
+            } else {
+                destroy_tail(m_begin + n);
+            }
+        }
+
+        auto resize(size_type n, const T &value) -> void {
+            if (n > size()) {
+                if (n > capacity()) {
+                    auto tmp = T(value); // value 可能引用容器内的元素
+                    reserve(n);
+                    mtl::uninitialized_fill(m_end, m_begin + n, tmp);
+                } else {
+                    mtl::uninitialized_fill(m_end, m_begin + n, value);
+                }
+                m_end = m_begin + n;
+            } else {
+                destroy_tail(m_begin + n);
+            }
+        }
+
+        // 双方都在堆上时只交换指针；内联的一方把元素搬到另一方的内联缓冲区
+        auto swap(small_vector &v) noexcept(_nothrow_relocate) -> void {
+            if (this == &v) {
+                return;
+            }
+            if constexpr (alloc_traits::propagate_on_container_swap::value) {
+                std::swap(m_alloc, v.m_alloc);
+            }
+            if (!is_inline() && !v.is_inline()) {
+                std::swap(m_begin, v.m_begin);
+                std::swap(m_end, v.m_end);
+                std::swap(m_cap, v.m_cap);
+            } else if (is_inline() && v.is_inline()) {
+                auto &small = size() < v.size() ? *this : v;
+                auto &large = size() < v.size() ? v : *this;
+                auto n = small.size();
+                std::swap_ranges(small.m_begin, small.m_end, large.m_begin);
+                small.m_end = mtl::uninitialized_relocate(large.m_begin + n, large.m_end, small.m_end);
+                large.m_end = large.m_begin + n;
+            } else {
+                auto &in = is_inline() ? *this : v;
+                auto &heap = is_inline() ? v : *this;
+                auto p = heap.m_begin;
+                auto e = heap.m_end;
+                auto c = heap.m_cap;
+                heap.reset_inline();
+                heap.m_end = mtl::uninitialized_relocate(in.m_begin, in.m_end, heap.m_begin);
+                in.m_begin = p;
+                in.m_end = e;
+                in.m_cap = c;
+            }
+        }
+
+        // 内部实现
+      private:
+        static constexpr bool _nothrow_relocate = is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>;
+
+        auto inline_data() noexcept -> T * { return reinterpret_cast<T *>(m_inline); }
+
+        auto inline_data() const noexcept -> const T * { return reinterpret_cast<const T *>(m_inline); }
+
+        auto reset_inline() noexcept -> void {
+            m_begin = m_end = inline_data();
+            m_cap = m_begin + N;
+        }
+
+        auto recommend(size_type n) const -> size_type {
+            auto ms = max_size();
+            if (n > ms) {
+                throw std::length_error("small_vector");
+            }
+            auto cap = capacity();
+            if (cap >= ms / 2) {
+                return ms;
+            }
+            return std::max(n, cap * 2);
+        }
+
+        auto allocate(size_type n) -> allocation_result<T *> {
+            auto [p, count] = alloc_traits::allocate_at_least(m_alloc, n);
+            return {mtl::to_address(p), count};
+        }
+
+        // 换用新的堆内存 p（元素已由调用者搬好），释放旧的堆内存
+        auto adopt(T *p, size_type count, size_type n) noexcept -> void {
+            if (!is_inline()) {
+                alloc_traits::deallocate(m_alloc, m_begin, capacity());
+            }
+            m_begin = p;
+            m_end = p + n;
+            m_cap = p + count;
+        }
+
+        auto release() noexcept -> void {
+            mtl::destroy(m_begin, m_end);
+            if (!is_inline()) {
+                alloc_traits::deallocate(m_alloc, m_begin, capacity());
+            }
+            reset_inline();
+        }
+
+        // 从 v 取得全部元素，v 随后为空。调用前 *this 必须为空的内联状态，can_steal 表示可以直接接管 v 的堆内存
+        auto take(small_vector &v, bool can_steal) -> void {
+            if (!v.is_inline() && can_steal) {
+                m_begin = v.m_begin;
+                m_end = v.m_end;
+                m_cap = v.m_cap;
+                v.reset_inline();
+                return;
+            }
+            if constexpr (is_trivially_relocatable_v<T> && sizeof(m_inline) <= 64) {
+                // 内联缓冲区不超过一个缓存行时整块拷贝，长度为常量，编译器可以展开为几条 mov
+                if (v.is_inline()) {
+                    std::memcpy(m_inline, v.m_inline, sizeof(m_inline));
+                    m_end = m_begin + v.size();
+                    v.m_end = v.m_begin;
+                    return;
+                }
+            }
+            reserve_exact(v.size());
+            m_end = mtl::_relocate_if_noexcept(v.m_begin, v.m_end, m_begin);
+            v.m_end = v.m_begin;
+        }
+
+        auto destroy_tail(T *new_end) noexcept -> void {
+            mtl::destroy(new_end, m_end);
+            m_end = new_end;
+        }
+
+        auto reallocate(size_type n) -> void {
+            auto [p, count] = allocate(n);
+            auto old_size = size();
+            try {
+                mtl::_relocate_if_noexcept(m_begin, m_end, p);
+            } catch (...) {
+                alloc_traits::deallocate(m_alloc, p, count);
+                throw;
+            }
+            adopt(p, count, old_size);
+        }
+
+        template <typename... Args>
+        auto realloc_emplace(size_type idx, Args &&...args) -> reference {
+            insert_gap(idx, 1, [&](T *gap) { alloc_traits::construct(m_alloc, gap, std::forward<Args>(args)...); });
+            return m_begin[idx];
+        }
+
+        // 在 idx 处空出 n 个未初始化的位置，交给 fill 构造
+        template <typename F>
+        auto insert_gap(size_type idx, size_type n, F &&fill) -> void {
+            if (n > static_cast<size_type>(m_cap - m_end)) {
+                // 先在新内存中构造（fill 可能引用旧元素），再搬移两侧的旧元素
+                auto [p, count] = allocate(recommend(size() + n));
+                auto old_size = size();
+                try {
+                    mtl::_relocate_with_gap(m_begin, m_end, p, idx, n, fill);
+                } catch (...) {
+                    alloc_traits::deallocate(m_alloc, p, count);
+                    throw;
+                }
+                adopt(p, count, old_size + n);
+            } else if constexpr (_nothrow_relocate) {
+                auto pos = m_begin + idx;
+                mtl::uninitialized_relocate_backward(pos, m_end, m_end + n);
+                try {
+                    fill(pos);
+                } catch (...) {
+                    mtl::uninitialized_relocate(pos + n, m_end + n, pos);
+                    throw;
+                }
+                m_end += n;
+            } else {
+                auto old_end = m_end;
+                fill(old_end);
+                m_end += n;
+                std::rotate(m_begin + idx, old_end, m_end);
+            }
+        }
+
+      public:
+        T *m_begin{inline_data()};
+        T *m_end{m_begin};
+        T *m_cap{m_begin + N};
+        [[no_unique_address]] Alloc m_alloc;
+        alignas(T) std::byte m_inline[N * sizeof(T)];
+    };
+} // namespace mtl
+
+// relational operator
+namespace mtl {
+    template <typename T, size_t N, typename Alloc>
+    auto operator==(const small_vector<T, N, Alloc> &lhs, const small_vector<T, N, Alloc> &rhs) -> bool {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <typename T, size_t N, typename Alloc>
+    auto operator<=>(const small_vector<T, N, Alloc> &lhs, const small_vector<T, N, Alloc> &rhs) {
+        return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), synth_three_way);
+    }
+} // namespace mtl
+
+// specialized algorithm
+namespace mtl {
+    template <typename T, size_t N, typename Alloc>
+    auto swap(small_vector<T, N, Alloc> &lhs, small_vector<T, N, Alloc> &rhs) noexcept(noexcept(lhs.swap(rhs))) -> void { lhs.swap(rhs); }
+
+    template <typename T, size_t N, typename Alloc, typename U>
+    auto erase(small_vector<T, N, Alloc> &v, const U &value) -> size_t {
+        auto it = std::remove(v.begin(), v.end(), value);
+        auto n = static_cast<size_t>(v.end() - it);
+        v.erase(it, v.end());
+        return n;
+    }
+
+    template <typename T, size_t N, typename Alloc, typename Pred>
+    auto erase_if(small_vector<T, N, Alloc> &v, Pred pred) -> size_t {
+        auto it = std::remove_if(v.begin(), v.end(), pred);
+        auto n = static_cast<size_t>(v.end() - it);
+        v.erase(it, v.end());
+        return n;
+    }
+} // namespace mtl
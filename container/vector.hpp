@@ -0,0 +1,583 @@
+/*
+    https://timsong-cpp.github.io/cppwp/n4861/vector
+*/
+#pragma once
+#include "utility/memory.hpp"
+#include <algorithm>
+#include <initializer_list>
+#include <ratio>
+#include <stdexcept>
+#include <utility>
+
+// vector
+namespace mtl {
+    // GrowthFactor 为扩容倍数（std::ratio），扩容时实际容量以分配器 allocate_at_least 返回的数量为准。
+    // 可平凡重定位的元素在扩容、插入、删除时整体 memmove，不调用移动构造和析构。
+    template <typename T, typename Alloc = allocator<T>, typename GrowthFactor = std::ratio<2>>
+    class vector {
+        static_assert(GrowthFactor::num > GrowthFactor::den, "growth factor must be greater than 1");
+
+        using alloc_traits = allocator_traits<Alloc>;
+
+        // 首次分配至少占满一个缓存行（以函数形式给出，允许以不完整类型实例化 vector<T>）
+        static constexpr auto min_capacity() -> size_t { return std::max<size_t>(64 / sizeof(T), 1); }
+
+      public:
+        using value_type = T;
+        using allocator_type = Alloc;
+        using pointer = alloc_traits::pointer;
+        using const_pointer = alloc_traits::const_pointer;
+        using reference = T &;
+        using const_reference = const T &;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using iterator = T *;
+        using const_iterator = const T *;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        // 构造
+      public:
+        constexpr vector() noexcept(noexcept(Alloc())) = default;
+
+        constexpr explicit vector(const Alloc &a) noexcept : m_alloc(a) {}
+
+        // 以下构造函数都委托给 vector(a)：委托的构造函数完成后对象即已构造，
+        // 函数体中元素构造抛出异常时析构函数会销毁已构造的元素并释放内存
+        constexpr explicit vector(size_type n, const Alloc &a = Alloc()) : vector(a) {
+            init_storage(n);
+            mtl::uninitialized_value_construct_n(m_begin, n);
+            m_end = m_begin + n;
+        }
+
+        constexpr vector(size_type n, const T &value, const Alloc &a = Alloc()) : vector(a) {
+            init_storage(n);
+            mtl::uninitialized_fill_n(m_begin, n, value);
+            m_end = m_begin + n;
+        }
+
+        template <std::input_iterator It>
+        constexpr vector(It first, It last, const Alloc &a = Alloc()) : vector(a) {
+            if constexpr (std::forward_iterator<It>) {
+                auto n = static_cast<size_type>(std::distance(first, last));
+                init_storage(n);
+                m_end = mtl::uninitialized_copy(first, last, m_begin);
+            } else {
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+            }
+        }
+
+        constexpr vector(std::initializer_list<T> lst, const Alloc &a = Alloc()) : vector(lst.begin(), lst.end(), a) {}
+
+        constexpr vector(const vector &v) : vector(v, alloc_traits::select_on_container_copy_construction(v.m_alloc)) {}
+
+        constexpr vector(const vector &v, const Alloc &a) : vector(a) {
+            init_storage(v.size());
+            m_end = mtl::uninitialized_copy(v.m_begin, v.m_end, m_begin);
+        }
+
+        constexpr vector(vector &&v) noexcept : m_alloc(std::move(v.m_alloc)) { steal(v); }
+
+        constexpr vector(vector &&v, const Alloc &a) : vector(a) {
+            if (alloc_traits::is_always_equal::value || m_alloc == v.m_alloc) {
+                steal(v);
+            } else {
+                init_storage(v.size());
+                m_end = mtl::uninitialized_move(v.m_begin, v.m_end, m_begin);
+            }
+        }
+
+        constexpr ~vector() { release(); }
+
+        // assignment
+      public:
+        constexpr auto operator=(const vector &v) -> vector & {
+            if (this == &v) {
+                return *this;
+            }
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                if (!alloc_traits::is_always_equal::value && m_alloc != v.m_alloc) {
+                    release();
+                }
+                m_alloc = v.m_alloc;
+            }
+            assign(v.m_begin, v.m_end);
+            return *this;
+        }
+
+        // 分配器相等或随容器传播时直接接管内存，否则只能逐个移动元素
+        constexpr auto operator=(vector &&v) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                                      alloc_traits::is_always_equal::value) -> vector & {
+            if (this == &v) {
+                return *this;
+            }
+            if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                release();
+                m_alloc = std::move(v.m_alloc);
+                steal(v);
+            } else if (alloc_traits::is_always_equal::value || m_alloc == v.m_alloc) {
+                release();
+                steal(v);
+            } else {
+                assign(std::make_move_iterator(v.m_begin), std::make_move_iterator(v.m_end));
+                v.clear();
+            }
+            return *this;
+        }
+
+        constexpr auto operator=(std::initializer_list<T> lst) -> vector & {
+            assign(lst.begin(), lst.end());
+            return *this;
+        }
+
+        template <std::input_iterator It>
+        constexpr auto assign(It first, It last) -> void {
+            if constexpr (std::forward_iterator<It>) {
+                auto n = static_cast<size_type>(std::distance(first, last));
+                if (n > capacity()) {
+                    auto v = vector(first, last, m_alloc);
+                    swap_storage(v);
+                    return;
+                }
+                auto mid = first;
+                std::advance(mid, std::min(n, size()));
+                auto cur = std::copy(first, mid, m_begin);
+                if (n > size()) {
+                    m_end = mtl::uninitialized_copy(mid, last, m_end);
+                } else {
+                    destroy_tail(cur);
+                }
+            } else {
+                clear();
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+            }
+        }
+
+        constexpr auto assign(size_type n, const T &value) -> void {
+            if (n > capacity()) {
+                auto v = vector(n, value, m_alloc);
+                swap_storage(v);
+                return;
+            }
+            std::fill(m_begin, m_begin + std::min(n, size()), value);
+            if (n > size()) {
+                mtl::uninitialized_fill(m_end, m_begin + n, value);
+                m_end = m_begin + n;
+            } else {
+                destroy_tail(m_begin + n);
+            }
+        }
+
+        constexpr auto assign(std::initializer_list<T> lst) -> void { assign(lst.begin(), lst.end()); }
+
+        constexpr auto get_allocator() const noexcept -> allocator_type { return m_alloc; }
+
+        // iterator
+      public:
+        constexpr auto begin() noexcept -> iterator { return m_begin; }
+
+        constexpr auto begin() const noexcept -> const_iterator { return m_begin; }
+
+        constexpr auto end() noexcept -> iterator { return m_end; }
+
+        constexpr auto end() const noexcept -> const_iterator { return m_end; }
+
+        constexpr auto rbegin() noexcept -> reverse_iterator { return reverse_iterator(end()); }
+
+        constexpr auto rbegin() const noexcept -> const_reverse_iterator { return const_reverse_iterator(end()); }
+
+        constexpr auto rend() noexcept -> reverse_iterator { return reverse_iterator(begin()); }
+
+        constexpr auto rend() const noexcept -> const_reverse_iterator { return const_reverse_iterator(begin()); }
+
+        constexpr auto cbegin() const noexcept -> const_iterator { return begin(); }
+
+        constexpr auto cend() const noexcept -> const_iterator { return end(); }
+
+        constexpr auto crbegin() const noexcept -> const_reverse_iterator { return rbegin(); }
+
+        constexpr auto crend() const noexcept -> const_reverse_iterator { return rend(); }
+
+        // capacity
+      public:
+        [[nodiscard]] constexpr auto empty() const noexcept -> bool { return m_begin == m_end; }
+
+        constexpr auto size() const noexcept -> size_type { return static_cast<size_type>(m_end - m_begin); }
+
+        constexpr auto max_size() const noexcept -> size_type { return alloc_traits::max_size(m_alloc); }
+
+        constexpr auto capacity() const noexcept -> size_type { return static_cast<size_type>(m_cap - m_begin); }
+
+        // 按增长策略扩容，容量可能大于 n
+        constexpr auto reserve(size_type n) -> void {
+            if (n > capacity()) {
+                reallocate(recommend(n));
+            }
+        }
+
+        // 只申请 n 个元素（分配器额外给出的空间依然会被使用）
+        constexpr auto reserve_exact(size_type n) -> void {
+            if (n > max_size()) {
+                throw std::length_error("vector");
+            }
+            if (n > capacity()) {
+                reallocate(n);
+            }
+        }
+
+        constexpr auto shrink_to_fit() -> void {
+            if (capacity() > size()) {
+                if (empty()) {
+                    release();
+                } else {
+                    reallocate(size());
+                }
+            }
+        }
+
+        // element access
+      public:
+        constexpr auto operator[](size_type i) -> reference { return m_begin[i]; }
+
+        constexpr auto operator[](size_type i) const -> const_reference { return m_begin[i]; }
+
+        constexpr auto at(size_type i) -> reference {
+            if (i >= size()) {
+                throw std::out_of_range("vector");
+            }
+            return m_begin[i];
+        }
+
+        constexpr auto at(size_type i) const -> const_reference {
+            if (i >= size()) {
+                throw std::out_of_range("vector");
+            }
+            return m_begin[i];
+        }
+
+        constexpr auto front() -> reference { return *m_begin; }
+
+        constexpr auto front() const -> const_reference { return *m_begin; }
+
+        constexpr auto back() -> reference { return *(m_end - 1); }
+
+        constexpr auto back() const -> const_reference { return *(m_end - 1); }
+
+        constexpr auto data() noexcept -> T * { return m_begin; }
+
+        constexpr auto data() const noexcept -> const T * { return m_begin; }
+
+        // modifier
+      public:
+        template <typename... Args>
+        constexpr auto emplace_back(Args &&...args) -> reference {
+            if (m_end != m_cap) [[likely]] {
+                return unchecked_emplace_back(std::forward<Args>(args)...);
+            }
+            return realloc_emplace(size(), std::forward<Args>(args)...);
+        }
+
+        constexpr auto push_back(const T &value) -> void { emplace_back(value); }
+
+        constexpr auto push_back(T &&value) -> void { emplace_back(std::move(value)); }
+
+        // 调用者保证 size() < capacity()，用于预先 reserve 后的热循环
+        template <typename... Args>
+        constexpr auto unchecked_emplace_back(Args &&...args) -> reference {
+            alloc_traits::construct(m_alloc, m_end, std::forward<Args>(args)...);
+            return *m_end++;
+        }
+
+        constexpr auto unchecked_push_back(const T &value) -> void { unchecked_emplace_back(value); }
+
+        constexpr auto unchecked_push_back(T &&value) -> void { unchecked_emplace_back(std::move(value)); }
+
+        constexpr auto pop_back() -> void { alloc_traits::destroy(m_alloc, --m_end); }
+
+        template <typename... Args>
+        constexpr auto emplace(const_iterator pos, Args &&...args) -> iterator {
+            auto idx = static_cast<size_type>(pos - m_begin);
+            if (m_end == m_cap) {
+                realloc_emplace(idx, std::forward<Args>(args)...);
+                return m_begin + idx;
+            }
+            if (idx == size()) {
+                unchecked_emplace_back(std::forward<Args>(args)...);
+                return m_begin + idx;
+            }
+            // args 可能引用容器内的元素，先构造临时对象
+            auto tmp = T(std::forward<Args>(args)...);
+            insert_gap(idx, 1, [&](T *gap) { alloc_traits::construct(m_alloc, gap, std::move(tmp)); });
+            return m_begin + idx;
+        }
+
+        constexpr auto insert(const_iterator pos, const T &value) -> iterator { return emplace(pos, value); }
+
+        constexpr auto insert(const_iterator pos, T &&value) -> iterator { return emplace(pos, std::move(value)); }
+
+        constexpr auto insert(const_iterator pos, size_type n, const T &value) -> iterator {
+            auto idx = static_cast<size_type>(pos - m_begin);
+            if (n == 0) {
+                return m_begin + idx;
+            }
+            auto tmp = T(value);
+            insert_gap(idx, n, [&](T *gap) { mtl::uninitialized_fill_n(gap, n, tmp); });
+            return m_begin + idx;
+        }
+
+        template <std::input_iterator It>
+        constexpr auto insert(const_iterator pos, It first, It last) -> iterator {
+            auto idx = static_cast<size_type>(pos - m_begin);
+            if constexpr (std::forward_iterator<It>) {
+                auto n = static_cast<size_type>(std::distance(first, last));
+                if (n != 0) {
+                    insert_gap(idx, n, [&](T *gap) { mtl::uninitialized_copy(first, last, gap); });
+                }
+            } else {
+                auto old_size = size();
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+                std::rotate(m_begin + idx, m_begin + old_size, m_end);
+            }
+            return m_begin + idx;
+        }
+
+        constexpr auto insert(const_iterator pos, std::initializer_list<T> lst) -> iterator { return insert(pos, lst.begin(), lst.end()); }
+
+        constexpr auto erase(const_iterator pos) -> iterator { return erase(pos, pos + 1); }
+
+        constexpr auto erase(const_iterator first, const_iterator last) -> iterator {
+            auto f = m_begin + (first - m_begin);
+            auto l = m_begin + (last - m_begin);
+            if (f == l) {
+                return f;
+            }
+            if constexpr (is_trivially_relocatable_v<T>) {
+                // 先销毁被删除的元素，再把尾部整体搬过来
+                mtl::destroy(f, l);
+                mtl::uninitialized_relocate(l, m_end, f);
+                m_end -= (l - f);
+            } else {
+                destroy_tail(std::move(l, m_end, f));
+            }
+            return f;
+        }
+
+        constexpr auto clear() noexcept -> void { destroy_tail(m_begin); }
+
+        constexpr auto resize(size_type n) -> void {
+            if (n > size()) {
+                reserve(n);
+                mtl::uninitialized_value_construct(m_end, m_begin + n);
+                m_end = m_begin + n;
+            } else {
+                destroy_tail(m_begin + n);
+            }
+        }
+
+        constexpr auto resize(size_type n, const T &value) -> void {
+            if (n > size()) {
+                if (n > capacity()) {
+                    auto tmp = T(value); // value 可能引用容器内的元素
+                    reserve(n);
+                    mtl::uninitialized_fill(m_end, m_begin + n, tmp);
+                } else {
+                    mtl::uninitialized_fill(m_end, m_begin + n, value);
+                }
+                m_end = m_begin + n;
+            } else {
+                destroy_tail(m_begin + n);
+            }
+        }
+
+        // 新增元素只做默认初始化，平凡类型不会被清零，调用者随后自行写入
+        constexpr auto resize_for_overwrite(size_type n) -> void {
+            if (n > size()) {
+                reserve(n);
+                mtl::uninitialized_default_construct(m_end, m_begin + n);
+                m_end = m_begin + n;
+            } else {
+                destroy_tail(m_begin + n);
+            }
+        }
+
+        constexpr auto swap(vector &v) noexcept -> void {
+            if constexpr (alloc_traits::propagate_on_container_swap::value) {
+                std::swap(m_alloc, v.m_alloc);
+            }
+            swap_storage(v);
+        }
+
+        // 内部实现
+      private:
+        // 按增长倍数计算新容量
+        constexpr auto recommend(size_type n) const -> size_type {
+            auto ms = max_size();
+            if (n > ms) {
+                throw std::length_error("vector");
+            }
+            auto cap = capacity();
+            if (cap >= ms / GrowthFactor::num * GrowthFactor::den) {
+                return ms;
+            }
+            return std::max({n, cap * GrowthFactor::num / GrowthFactor::den, min_capacity()});
+        }
+
+        constexpr auto allocate(size_type n) -> allocation_result<T *> {
+            auto [p, count] = alloc_traits::allocate_at_least(m_alloc, n);
+            return {mtl::to_address(p), count};
+        }
+
+        constexpr auto init_storage(size_type n) -> void {
+            if (n > max_size()) {
+                throw std::length_error("vector");
+            }
+            if (n != 0) {
+                auto [p, count] = allocate(n);
+                m_begin = m_end = p;
+                m_cap = p + count;
+            }
+        }
+
+        constexpr auto release() noexcept -> void {
+            if (m_begin) {
+                mtl::destroy(m_begin, m_end);
+                alloc_traits::deallocate(m_alloc, m_begin, capacity());
+                m_begin = m_end = m_cap = nullptr;
+            }
+        }
+
+        constexpr auto steal(vector &v) noexcept -> void {
+            m_begin = std::exchange(v.m_begin, nullptr);
+            m_end = std::exchange(v.m_end, nullptr);
+            m_cap = std::exchange(v.m_cap, nullptr);
+        }
+
+        constexpr auto swap_storage(vector &v) noexcept -> void {
+            std::swap(m_begin, v.m_begin);
+            std::swap(m_end, v.m_end);
+            std::swap(m_cap, v.m_cap);
+        }
+
+        constexpr auto destroy_tail(T *new_end) noexcept -> void {
+            mtl::destroy(new_end, m_end);
+            m_end = new_end;
+        }
+
+        constexpr auto reallocate(size_type n) -> void {
+            auto [p, count] = allocate(n);
+            auto old_size = size();
+            try {
+                mtl::_relocate_if_noexcept(m_begin, m_end, p);
+            } catch (...) {
+                alloc_traits::deallocate(m_alloc, p, count);
+                throw;
+            }
+            if (m_begin) {
+                alloc_traits::deallocate(m_alloc, m_begin, capacity());
+            }
+            m_begin = p;
+            m_end = p + old_size;
+            m_cap = p + count;
+        }
+
+        template <typename... Args>
+        constexpr auto realloc_emplace(size_type idx, Args &&...args) -> reference {
+            insert_gap(idx, 1, [&](T *gap) { alloc_traits::construct(m_alloc, gap, std::forward<Args>(args)...); });
+            return m_begin[idx];
+        }
+
+        // 在 idx 处空出 n 个未初始化的位置，交给 fill 构造
+        template <typename F>
+        constexpr auto insert_gap(size_type idx, size_type n, F &&fill) -> void {
+            if (n > static_cast<size_type>(m_cap - m_end)) {
+                auto [p, count] = allocate(recommend(size() + n));
+                auto old_size = size();
+                try {
+                    mtl::_relocate_with_gap(m_begin, m_end, p, idx, n, fill);
+                } catch (...) {
+                    alloc_traits::deallocate(m_alloc, p, count);
+                    throw;
+                }
+                if (m_begin) {
+                    alloc_traits::deallocate(m_alloc, m_begin, capacity());
+                }
+                m_begin = p;
+                m_end = p + old_size + n;
+                m_cap = p + count;
+            } else if constexpr (is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>) {
+                // 尾部整体后移，失败时再移回
+                auto pos = m_begin + idx;
+                mtl::uninitialized_relocate_backward(pos, m_end, m_end + n);
+                try {
+                    fill(pos);
+                } catch (...) {
+                    mtl::uninitialized_relocate(pos + n, m_end + n, pos);
+                    throw;
+                }
+                m_end += n;
+            } else {
+                // 先在尾部构造，再旋转到目标位置
+                auto old_end = m_end;
+                fill(old_end);
+                m_end += n;
+                std::rotate(m_begin + idx, old_end, m_end);
+            }
+        }
+
+      public:
+        T *m_begin{nullptr};
+        T *m_end{nullptr};
+        T *m_cap{nullptr};
+        [[no_unique_address]] Alloc m_alloc;
+    };
+
+    template <std::input_iterator It, typename Alloc = allocator<std::iter_value_t<It>>>
+    vector(It, It, Alloc = Alloc()) -> vector<std::iter_value_t<It>, Alloc>;
+} // namespace mtl
+
+// relational operator
+namespace mtl {
+    template <typename T, typename Alloc, typename G>
+    constexpr auto operator==(const vector<T, Alloc, G> &lhs, const vector<T, Alloc, G> &rhs) -> bool {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <typename T, typename Alloc, typename G>
+    constexpr auto operator<=>(const vector<T, Alloc, G> &lhs, const vector<T, Alloc, G> &rhs) {
+        return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), synth_three_way);
+    }
+} // namespace mtl
+
+// specialized algorithm
+namespace mtl {
+    template <typename T, typename Alloc, typename G>
+    constexpr auto swap(vector<T, Alloc, G> &lhs, vector<T, Alloc, G> &rhs) noexcept -> void { lhs.swap(rhs); }
+
+    template <typename T, typename Alloc, typename G, typename U>
+    constexpr auto erase(vector<T, Alloc, G> &v, const U &value) -> size_t {
+        auto it = std::remove(v.begin(), v.end(), value);
+        auto n = static_cast<size_t>(v.end() - it);
+        v.erase(it, v.end());
+        return n;
+    }
+
+    template <typename T, typename Alloc, typename G, typename Pred>
+    constexpr auto erase_if(vector<T, Alloc, G> &v, Pred pred) -> size_t {
+        auto it = std::remove_if(v.begin(), v.end(), pred);
+        auto n = static_cast<size_t>(v.end() - it);
+        v.erase(it, v.end());
+        return n;
+    }
+} // namespace mtl
+
+// trivially relocatable
+namespace mtl {
+    template <typename T, typename Alloc, typename G>
+    struct is_trivially_relocatable<vector<T, Alloc, G>> : public std::bool_constant<is_trivially_relocatable_v<Alloc>> {};
+} // namespace mtl
@@ -0,0 +1,58 @@
+/*
+    协程帧内存池
+    https://timsong-cpp.github.io/cppwp/n4861/dcl.fct.def.coroutine#9
+*/
+#pragma once
+#include "utility/pool_allocator.hpp"
+#include <array>
+#include <utility>
+
+namespace mtl {
+    // 协程帧的大小由编译器决定，按 64 字节划分大小等级，每个等级对应一个带线程缓存的固定大小内存池。
+    // 分配和释放都先访问当前线程的缓存，帧在其他线程上释放时进入那个线程的缓存，不需要加锁。
+    // 超过 max_size 的帧直接使用 ::operator new。
+    class _frame_pool {
+      public:
+        static constexpr size_t granularity = 64;
+        static constexpr size_t max_size = 1024;
+        static constexpr size_t class_count = max_size / granularity;
+
+      private:
+        static constexpr size_t align = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+        template <size_t I>
+        using resource = _pool_resource<(I + 1) * granularity, align, 64 * 1024>;
+
+        struct entry {
+            void *(*allocate)();
+            void (*deallocate)(void *) noexcept;
+        };
+
+        static constexpr auto table = []<size_t... I>(std::index_sequence<I...>) {
+            return std::array<entry, class_count>{entry{&resource<I>::allocate, &resource<I>::deallocate}...};
+        }(std::make_index_sequence<class_count>{});
+
+      public:
+        static auto allocate(size_t n) -> void * {
+            if (n > max_size) [[unlikely]] {
+                return ::operator new(n);
+            }
+            return table[(n - 1) / granularity].allocate();
+        }
+
+        static auto deallocate(void *p, size_t n) noexcept -> void {
+            if (n > max_size) [[unlikely]] {
+                ::operator delete(p, n);
+                return;
+            }
+            table[(n - 1) / granularity].deallocate(p);
+        }
+    };
+
+    // promise_type 继承它即可让协程帧从 _frame_pool 分配
+    struct _frame_allocated {
+        static auto operator new(size_t n) -> void * { return _frame_pool::allocate(n); }
+
+        static auto operator delete(void *p, size_t n) noexcept -> void { _frame_pool::deallocate(p, n); }
+    };
+} // namespace mtl
@@ -0,0 +1,120 @@
+/*
+    同步生成器
+    https://wg21.link/p2502
+*/
+#pragma once
+#include "frame_pool.hpp"
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <ranges>
+
+namespace mtl {
+    // 每次 co_yield 挂起协程，迭代器解引用得到被产出对象的引用，因此产出值不会被复制。
+    // 产出的临时对象存活到协程下一次恢复，迭代器自增前读取它是安全的。
+    // 单遍的输入范围，可以与标准库的 views 组合成流水线；协程帧从 _frame_pool 分配。
+    template <typename T>
+    class [[nodiscard]] generator : public std::ranges::view_interface<generator<T>> {
+        using value = std::remove_cvref_t<T>;
+        // generator<T&> 产出可修改的左值，其他情况产出 const 引用
+        using reference = std::conditional_t<std::is_lvalue_reference_v<T>, T, const value &>;
+        using pointer = std::add_pointer_t<reference>;
+
+      public:
+        struct promise_type : _frame_allocated {
+            auto get_return_object() noexcept -> generator { return generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+            auto initial_suspend() const noexcept -> std::suspend_always { return {}; }
+
+            auto final_suspend() const noexcept -> std::suspend_always { return {}; }
+
+            auto yield_value(reference v) noexcept -> std::suspend_always {
+                m_value = std::addressof(v);
+                return {};
+            }
+
+            auto return_void() const noexcept -> void {}
+
+            auto unhandled_exception() noexcept -> void { m_error = std::current_exception(); }
+
+            // 禁止在生成器中 co_await
+            template <typename U>
+            auto await_transform(U &&) -> std::suspend_never = delete;
+
+            pointer m_value{nullptr};
+            std::exception_ptr m_error;
+        };
+
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        class iterator {
+          public:
+            using value_type = value;
+            using difference_type = ptrdiff_t;
+
+          public:
+            iterator() noexcept = default;
+
+            explicit iterator(handle_type h) noexcept : m_handle(h) {}
+
+            iterator(iterator &&) noexcept = default;
+
+            auto operator=(iterator &&) noexcept -> iterator & = default;
+
+          public:
+            auto operator*() const noexcept -> reference { return static_cast<reference>(*m_handle.promise().m_value); }
+
+            auto operator++() -> iterator & {
+                resume(m_handle);
+                return *this;
+            }
+
+            auto operator++(int) -> void { ++*this; }
+
+            friend auto operator==(const iterator &it, std::default_sentinel_t) noexcept -> bool { return it.m_handle.done(); }
+
+          public:
+            handle_type m_handle;
+        };
+
+      public:
+        generator() noexcept = default;
+
+        generator(generator &&g) noexcept : m_handle(std::exchange(g.m_handle, nullptr)) {}
+
+        auto operator=(generator g) noexcept -> generator & {
+            std::swap(m_handle, g.m_handle);
+            return *this;
+        }
+
+        ~generator() {
+            if (m_handle) {
+                m_handle.destroy();
+            }
+        }
+
+      public:
+        // 只能调用一次
+        auto begin() -> iterator {
+            resume(m_handle);
+            return iterator(m_handle);
+        }
+
+        auto end() const noexcept -> std::default_sentinel_t { return {}; }
+
+      private:
+        explicit generator(handle_type h) noexcept : m_handle(h) {}
+
+        // 恢复到下一个 co_yield，协程抛出的异常在这里重新抛出
+        static auto resume(handle_type h) -> void {
+            h.resume();
+            if (h.promise().m_error) [[unlikely]] {
+                std::rethrow_exception(std::exchange(h.promise().m_error, nullptr));
+            }
+        }
+
+      public:
+        handle_type m_handle;
+    };
+} // namespace mtl
+
@@ -0,0 +1,297 @@
+/*
+    惰性协程任务
+    https://wg21.link/p1056
+    同步完成与调用栈深度：https://lewissbaker.github.io/2020/05/11/understanding_symmetric_transfer
+*/
+#pragma once
+#include "frame_pool.hpp"
+#include "concurrency/common.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+// task promise
+namespace mtl {
+    template <typename T>
+    class task;
+
+    struct _task_void {};
+
+    // 引用以指针的形式存放
+    template <typename T>
+    using _task_storage_t = std::conditional_t<std::is_void_v<T>, _task_void, std::conditional_t<std::is_reference_v<T>, std::remove_reference_t<T> *, T>>;
+
+    // 结果的就地存储。mtl::optional 把值放在堆上，这里用联合体直接放在协程帧（或调用者的栈）中
+    template <typename T>
+    struct _task_slot {
+        _task_slot() noexcept {}
+
+        _task_slot(const _task_slot &) = delete;
+
+        ~_task_slot() {
+            if (m_has_value) {
+                std::destroy_at(&m_value);
+            }
+        }
+
+        template <typename... Args>
+        auto emplace(Args &&...args) -> void {
+            std::construct_at(&m_value, std::forward<Args>(args)...);
+            m_has_value = true;
+        }
+
+        union {
+            T m_value;
+        };
+        bool m_has_value{false};
+    };
+
+    template <typename T>
+    struct _task_promise_base : _frame_allocated {
+        // 与等待者的 await_suspend 交换 m_ready：先到的一方只做标记，后到的一方负责继续执行等待者。
+        // 在 await_suspend 内同步结束时由等待者自己返回 false 继续，不嵌套 resume；没有等待者时返回调用 resume 的一方
+        struct final_awaiter {
+            auto await_ready() const noexcept -> bool { return false; }
+
+            template <typename P>
+            auto await_suspend(std::coroutine_handle<P> h) noexcept -> void {
+                auto &p = h.promise();
+                if (p.m_ready.exchange(true, std::memory_order_acq_rel)) {
+                    p.m_continuation.resume();
+                }
+            }
+
+            auto await_resume() const noexcept -> void {}
+        };
+
+        auto initial_suspend() const noexcept -> std::suspend_always { return {}; }
+
+        auto final_suspend() const noexcept -> final_awaiter { return {}; }
+
+        auto unhandled_exception() noexcept -> void { m_error = std::current_exception(); }
+
+        std::coroutine_handle<> m_continuation;
+        std::exception_ptr m_error;
+        std::atomic<bool> m_ready{false};
+    };
+
+    template <typename T>
+    struct _task_promise : _task_promise_base<T> {
+        auto get_return_object() noexcept -> task<T>;
+
+        template <typename U = T>
+            requires std::is_convertible_v<U &&, T>
+        auto return_value(U &&v) -> void {
+            if constexpr (std::is_reference_v<T>) {
+                m_value.emplace(std::addressof(v));
+            } else {
+                m_value.emplace(std::forward<U>(v));
+            }
+        }
+
+        // 取出结果，协程以异常结束时重新抛出
+        auto result() -> T {
+            if (this->m_error) {
+                std::rethrow_exception(this->m_error);
+            }
+            if constexpr (std::is_reference_v<T>) {
+                return static_cast<T>(*m_value.m_value);
+            } else {
+                return std::move(m_value.m_value);
+            }
+        }
+
+        _task_slot<_task_storage_t<T>> m_value;
+    };
+
+    template <>
+    struct _task_promise<void> : _task_promise_base<void> {
+        auto get_return_object() noexcept -> task<void>;
+
+        auto return_void() const noexcept -> void {}
+
+        auto result() const -> void {
+            if (m_error) {
+                std::rethrow_exception(m_error);
+            }
+        }
+    };
+} // namespace mtl
+
+// task
+namespace mtl {
+    // 创建时不执行，被 co_await 时才开始。
+    // 同步结束的 task 让 await_suspend 返回 false，等待者在原来的栈帧上继续，连续的 co_await 不依赖编译器的尾调用优化，栈深度不增长；
+    // 中途挂起（例如 schedule 到其他线程）的 task 结束时由恢复它的线程继续执行等待者。
+    // 结果就地存放在 promise 中，不额外分配；协程帧从 _frame_pool 分配。
+    template <typename T = void>
+    class [[nodiscard]] task {
+      public:
+        using promise_type = _task_promise<T>;
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        struct awaiter {
+            auto await_ready() const noexcept -> bool { return m_handle.done(); }
+
+            // 返回 true 表示 task 中途挂起，由它的 final_awaiter 继续执行等待者
+            auto await_suspend(std::coroutine_handle<> h) noexcept -> bool {
+                auto &p = m_handle.promise();
+                p.m_continuation = h;
+                m_handle.resume();
+                return !p.m_ready.exchange(true, std::memory_order_acq_rel);
+            }
+
+            auto await_resume() -> T { return m_handle.promise().result(); }
+
+            handle_type m_handle;
+        };
+
+      public:
+        task() noexcept = default;
+
+        explicit task(handle_type h) noexcept : m_handle(h) {}
+
+        task(task &&t) noexcept : m_handle(std::exchange(t.m_handle, nullptr)) {}
+
+        auto operator=(task &&t) noexcept -> task & {
+            task(std::move(t)).swap(*this);
+            return *this;
+        }
+
+        ~task() {
+            if (m_handle) {
+                m_handle.destroy();
+            }
+        }
+
+      public:
+        auto operator co_await() const noexcept -> awaiter { return {m_handle}; }
+
+        auto valid() const noexcept -> bool { return static_cast<bool>(m_handle); }
+
+        auto done() const noexcept -> bool { return m_handle.done(); }
+
+        auto swap(task &t) noexcept -> void { std::swap(m_handle, t.m_handle); }
+
+        // 放弃所有权，由调用者负责 destroy
+        auto release() noexcept -> handle_type { return std::exchange(m_handle, nullptr); }
+
+      public:
+        handle_type m_handle;
+    };
+
+    template <typename T>
+    auto _task_promise<T>::get_return_object() noexcept -> task<T> {
+        return task<T>(std::coroutine_handle<_task_promise>::from_promise(*this));
+    }
+
+    inline auto _task_promise<void>::get_return_object() noexcept -> task<void> {
+        return task<void>(std::coroutine_handle<_task_promise>::from_promise(*this));
+    }
+} // namespace mtl
+
+// scheduler
+namespace mtl {
+    // co_await schedule(ex) 挂起当前协程，交给执行器恢复，之后的代码在执行器的线程上运行。
+    // 执行器只需要提供 execute(f)，例如 thread_pool；协程句柄可平凡复制，提交给 thread_pool 时不需要堆分配。
+    template <_executor E>
+    auto schedule(E &ex) noexcept {
+        struct awaiter {
+            auto await_ready() const noexcept -> bool { return false; }
+
+            auto await_suspend(std::coroutine_handle<> h) -> void {
+                m_ex.execute([h] { h.resume(); });
+            }
+
+            auto await_resume() const noexcept -> void {}
+
+            E &m_ex;
+        };
+        return awaiter{ex};
+    }
+} // namespace mtl
+
+// sync wait
+namespace mtl {
+    // sync_wait 阻塞的线程与外层协程之间的完成信号，位于 sync_wait 的栈上
+    struct _sync_wait_signal {
+        std::mutex m_mut;
+        std::condition_variable m_cv;
+        bool m_done{false};
+    };
+
+    // 驱动 sync_wait 的外层协程，结束时通知阻塞的线程
+    struct _sync_wait_task {
+        struct promise_type : _frame_allocated {
+            struct final_awaiter {
+                auto await_ready() const noexcept -> bool { return false; }
+
+                // 持锁通知：等待者拿到锁之前看不到 m_done，解锁之后本线程不再访问它栈上的信号与协程帧
+                auto await_suspend(std::coroutine_handle<promise_type> h) const noexcept -> void {
+                    auto s = h.promise().m_signal;
+                    auto lock = std::lock_guard(s->m_mut);
+                    s->m_done = true;
+                    s->m_cv.notify_one();
+                }
+
+                auto await_resume() const noexcept -> void {}
+            };
+
+            auto get_return_object() noexcept -> _sync_wait_task { return {std::coroutine_handle<promise_type>::from_promise(*this)}; }
+
+            auto initial_suspend() const noexcept -> std::suspend_always { return {}; }
+
+            auto final_suspend() const noexcept -> final_awaiter { return {}; }
+
+            auto return_void() const noexcept -> void {}
+
+            auto unhandled_exception() const noexcept -> void { std::terminate(); }
+
+            _sync_wait_signal *m_signal;
+        };
+
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    template <typename T>
+    auto _sync_wait_run(task<T> &t, _task_slot<_task_storage_t<T>> &out, std::exception_ptr &error) -> _sync_wait_task {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await t;
+            } else if constexpr (std::is_reference_v<T>) {
+                out.emplace(std::addressof(co_await t));
+            } else {
+                out.emplace(co_await t);
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+
+    // 在当前线程启动 t 并阻塞到它结束（t 中途可能转移到其他线程），返回结果或重新抛出异常
+    template <typename T>
+    auto sync_wait(task<T> t) -> T {
+        auto out = _task_slot<_task_storage_t<T>>();
+        auto error = std::exception_ptr();
+        auto signal = _sync_wait_signal();
+        auto h = _sync_wait_run(t, out, error).m_handle;
+        h.promise().m_signal = &signal;
+        h.resume();
+        {
+            auto lock = std::unique_lock(signal.m_mut);
+            signal.m_cv.wait(lock, [&] { return signal.m_done; });
+        }
+        h.destroy();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        if constexpr (std::is_reference_v<T>) {
+            return static_cast<T>(*out.m_value);
+        } else if constexpr (!std::is_void_v<T>) {
+            return std::move(out.m_value);
+        }
+    }
+} // namespace mtl
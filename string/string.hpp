@@ -0,0 +1,1117 @@
+/*
+    https://timsong-cpp.github.io/cppwp/n4861/basic.string
+    https://www.open-std.org/jtc1/sc22/wg21/docs/papers/2021/p1072r10.html
+    http://0x80.pl/articles/simd-strfind.html
+*/
+#pragma once
+#include "utility/memory.hpp"
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstring>
+#include <initializer_list>
+#include <iosfwd>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// string find
+namespace mtl {
+    // 在 [h, h + n) 中查找 [s, s + m)，要求 2 <= m <= n。
+    // 单字节字符时每次比较 16 个位置的首尾字符，两者都命中的位置再比较中间部分。
+    template <typename CharT, typename Traits>
+    auto _string_search(const CharT *h, size_t n, const CharT *s, size_t m) noexcept -> size_t {
+        auto i = size_t{0};
+#if defined(__SSE2__)
+        if constexpr (sizeof(CharT) == 1 && std::is_same_v<Traits, std::char_traits<CharT>>) {
+            auto first = _mm_set1_epi8(static_cast<char>(s[0]));
+            auto last = _mm_set1_epi8(static_cast<char>(s[m - 1]));
+            for (; i + m - 1 + 16 <= n; i += 16) {
+                auto block_first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + i));
+                auto block_last = _mm_loadu_si128(reinterpret_cast<const __m128i *>(h + i + m - 1));
+                auto eq = _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last));
+                auto mask = static_cast<unsigned>(_mm_movemask_epi8(eq));
+                while (mask != 0) {
+                    auto bit = static_cast<size_t>(std::countr_zero(mask));
+                    if (std::memcmp(h + i + bit + 1, s + 1, m - 2) == 0) {
+                        return i + bit;
+                    }
+                    mask &= mask - 1;
+                }
+            }
+        }
+#endif
+        // 剩余位置：先用 Traits::find 定位首字符（单字节时为 memchr），再比较其余部分
+        for (auto end = h + n - m + 1; h + i < end;) {
+            auto p = Traits::find(h + i, static_cast<size_t>(end - (h + i)), s[0]);
+            if (p == nullptr) {
+                break;
+            }
+            if (Traits::compare(p + 1, s + 1, m - 1) == 0) {
+                return static_cast<size_t>(p - h);
+            }
+            i = static_cast<size_t>(p - h) + 1;
+        }
+        return static_cast<size_t>(-1);
+    }
+
+    // Traits 未给出 comparison_category 时为 weak_ordering
+    template <typename Traits>
+    struct _string_comparison_category {
+        using type = std::weak_ordering;
+    };
+
+    template <typename Traits>
+        requires requires { typename Traits::comparison_category; }
+    struct _string_comparison_category<Traits> {
+        using type = Traits::comparison_category;
+    };
+
+    template <typename Traits>
+    using _string_comparison_category_t = _string_comparison_category<Traits>::type;
+} // namespace mtl
+
+// basic string
+namespace mtl {
+    // 对象大小为三个指针（24 字节）。
+    // 长字符串：{ 数据指针, 长度, 容量 | 最高位标记 }；
+    // 短字符串：直接存放在对象内部，最多 23 个 char，最后一个字符单元存放「剩余容量」，字符串满时它恰好为 0，兼作结束符。
+    // 两种模式都不保存指向自身的指针，因此 basic_string 可平凡重定位（取决于分配器）。
+    template <typename CharT, typename Traits = std::char_traits<CharT>, typename Alloc = allocator<CharT>>
+    class basic_string {
+        static_assert(std::endian::native == std::endian::little, "basic_string layout requires little endian");
+        static_assert(std::is_trivial_v<CharT> && std::is_standard_layout_v<CharT> && sizeof(CharT) <= 4);
+        static_assert(std::is_same_v<CharT, typename Traits::char_type>);
+
+        using alloc_traits = allocator_traits<Alloc>;
+        using view_type = std::basic_string_view<CharT, Traits>;
+
+        template <typename T>
+        static constexpr bool view_like = std::is_convertible_v<const T &, view_type> && !std::is_convertible_v<const T &, const CharT *>;
+
+        static constexpr size_t short_units = 3 * sizeof(void *) / sizeof(CharT);
+        static constexpr size_t long_flag = size_t{1} << (sizeof(size_t) * 8 - 1);
+
+        struct _long {
+            CharT *data;
+            size_t size;
+            size_t cap; // 不含结束符，最高位为长字符串标记
+        };
+
+        struct _short {
+            CharT buf[short_units];
+        };
+
+        static_assert(sizeof(_long) == sizeof(_short));
+
+      public:
+        using traits_type = Traits;
+        using value_type = CharT;
+        using allocator_type = Alloc;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using reference = CharT &;
+        using const_reference = const CharT &;
+        using pointer = alloc_traits::pointer;
+        using const_pointer = alloc_traits::const_pointer;
+        using iterator = CharT *;
+        using const_iterator = const CharT *;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        static constexpr size_type npos = static_cast<size_type>(-1);
+
+        // 对象内能存放的最大字符数
+        static constexpr size_type short_capacity = short_units - 1;
+
+        // 构造
+      public:
+        basic_string() noexcept(noexcept(Alloc())) { set_short_size(0); }
+
+        explicit basic_string(const Alloc &a) noexcept : m_alloc(a) { set_short_size(0); }
+
+        basic_string(size_type n, CharT ch, const Alloc &a = Alloc()) : m_alloc(a) {
+            Traits::assign(init(n), n, ch);
+        }
+
+        basic_string(const CharT *s, size_type n, const Alloc &a = Alloc()) : m_alloc(a) { Traits::copy(init(n), s, n); }
+
+        basic_string(const CharT *s, const Alloc &a = Alloc()) : basic_string(s, Traits::length(s), a) {}
+
+        basic_string(std::nullptr_t) = delete;
+
+        basic_string(const basic_string &s, size_type pos, const Alloc &a = Alloc()) : basic_string(s, pos, npos, a) {}
+
+        basic_string(const basic_string &s, size_type pos, size_type n, const Alloc &a = Alloc())
+            : basic_string(s.view().substr(s.check_pos(pos, "basic_string")).substr(0, n), a) {}
+
+        template <std::input_iterator It>
+        basic_string(It first, It last, const Alloc &a = Alloc()) : m_alloc(a) {
+            if constexpr (std::forward_iterator<It>) {
+                auto n = static_cast<size_type>(std::distance(first, last));
+                std::copy(first, last, init(n));
+            } else {
+                set_short_size(0);
+                for (; first != last; ++first) {
+                    push_back(*first);
+                }
+            }
+        }
+
+        basic_string(std::initializer_list<CharT> lst, const Alloc &a = Alloc()) : basic_string(lst.begin(), lst.size(), a) {}
+
+        template <typename T>
+            requires view_like<T>
+        explicit basic_string(const T &t, const Alloc &a = Alloc()) : m_alloc(a) {
+            auto sv = view_type(t);
+            Traits::copy(init(sv.size()), sv.data(), sv.size());
+        }
+
+        template <typename T>
+            requires view_like<T>
+        basic_string(const T &t, size_type pos, size_type n, const Alloc &a = Alloc())
+            : basic_string(view_type(t).substr(pos, n), a) {}
+
+        basic_string(const basic_string &s) : basic_string(s, alloc_traits::select_on_container_copy_construction(s.m_alloc)) {}
+
+        basic_string(const basic_string &s, const Alloc &a) : m_alloc(a) { Traits::copy(init(s.size()), s.data(), s.size()); }
+
+        // 直接接管表示，s 变为空的短字符串
+        basic_string(basic_string &&s) noexcept : m_alloc(std::move(s.m_alloc)) { steal(s); }
+
+        basic_string(basic_string &&s, const Alloc &a) : m_alloc(a) {
+            if (alloc_traits::is_always_equal::value || m_alloc == s.m_alloc) {
+                steal(s);
+            } else {
+                Traits::copy(init(s.size()), s.data(), s.size());
+                s.clear();
+            }
+        }
+
+        ~basic_string() { release(); }
+
+        auto operator=(const basic_string &s) -> basic_string & {
+            if (this == &s) {
+                return *this;
+            }
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                if (!alloc_traits::is_always_equal::value && m_alloc != s.m_alloc) {
+                    release();
+                    set_short_size(0);
+                }
+                m_alloc = s.m_alloc;
+            }
+            return assign(s.data(), s.size());
+        }
+
+        // 分配器相等或随容器传播时直接接管内存，否则只能复制字符
+        auto operator=(basic_string &&s) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                                  alloc_traits::is_always_equal::value) -> basic_string & {
+            if (this == &s) {
+                return *this;
+            }
+            if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                release();
+                m_alloc = std::move(s.m_alloc);
+                steal(s);
+            } else if (alloc_traits::is_always_equal::value || m_alloc == s.m_alloc) {
+                release();
+                steal(s);
+            } else {
+                assign(s.data(), s.size());
+                s.clear();
+            }
+            return *this;
+        }
+
+        auto operator=(const CharT *s) -> basic_string & { return assign(s); }
+
+        auto operator=(CharT ch) -> basic_string & { return assign(1, ch); }
+
+        auto operator=(std::initializer_list<CharT> lst) -> basic_string & { return assign(lst.begin(), lst.size()); }
+
+        template <typename T>
+            requires view_like<T>
+        auto operator=(const T &t) -> basic_string & {
+            return assign(t);
+        }
+
+        auto operator=(std::nullptr_t) -> basic_string & = delete;
+
+        auto assign(const basic_string &s) -> basic_string & { return *this = s; }
+
+        auto assign(basic_string &&s) noexcept(noexcept(*this = std::move(s))) -> basic_string & { return *this = std::move(s); }
+
+        auto assign(const basic_string &s, size_type pos, size_type n = npos) -> basic_string & {
+            return assign(s.view().substr(s.check_pos(pos, "basic_string::assign"), n));
+        }
+
+        // s 可以指向自身的字符
+        auto assign(const CharT *s, size_type n) -> basic_string & {
+            if (n <= capacity()) {
+                auto p = data();
+                Traits::move(p, s, n);
+                set_size(n);
+            } else {
+                check_length(n, "basic_string::assign");
+                auto [p, cap] = allocate(recommend(n));
+                Traits::copy(p, s, n);
+                release();
+                set_long(p, n, cap);
+            }
+            return *this;
+        }
+
+        auto assign(const CharT *s) -> basic_string & { return assign(s, Traits::length(s)); }
+
+        auto assign(size_type n, CharT ch) -> basic_string & {
+            clear();
+            reserve(n);
+            Traits::assign(data(), n, ch);
+            set_size(n);
+            return *this;
+        }
+
+        template <std::input_iterator It>
+        auto assign(It first, It last) -> basic_string & {
+            return *this = basic_string(first, last, m_alloc);
+        }
+
+        auto assign(std::initializer_list<CharT> lst) -> basic_string & { return assign(lst.begin(), lst.size()); }
+
+        template <typename T>
+            requires view_like<T>
+        auto assign(const T &t) -> basic_string & {
+            auto sv = view_type(t);
+            return assign(sv.data(), sv.size());
+        }
+
+        template <typename T>
+            requires view_like<T>
+        auto assign(const T &t, size_type pos, size_type n = npos) -> basic_string & {
+            return assign(view_type(t).substr(pos, n));
+        }
+
+        auto get_allocator() const noexcept -> allocator_type { return m_alloc; }
+
+        // element access
+      public:
+        auto at(size_type pos) -> reference {
+            if (pos >= size()) {
+                throw std::out_of_range("basic_string::at");
+            }
+            return data()[pos];
+        }
+
+        auto at(size_type pos) const -> const_reference {
+            if (pos >= size()) {
+                throw std::out_of_range("basic_string::at");
+            }
+            return data()[pos];
+        }
+
+        auto operator[](size_type pos) noexcept -> reference { return data()[pos]; }
+
+        auto operator[](size_type pos) const noexcept -> const_reference { return data()[pos]; }
+
+        auto front() noexcept -> reference { return data()[0]; }
+
+        auto front() const noexcept -> const_reference { return data()[0]; }
+
+        auto back() noexcept -> reference { return data()[size() - 1]; }
+
+        auto back() const noexcept -> const_reference { return data()[size() - 1]; }
+
+        auto data() noexcept -> CharT * { return is_long() ? m_long.data : m_short.buf; }
+
+        auto data() const noexcept -> const CharT * { return is_long() ? m_long.data : m_short.buf; }
+
+        auto c_str() const noexcept -> const CharT * { return data(); }
+
+        operator view_type() const noexcept { return view(); }
+
+        // iterator
+      public:
+        auto begin() noexcept -> iterator { return data(); }
+
+        auto begin() const noexcept -> const_iterator { return data(); }
+
+        auto end() noexcept -> iterator { return data() + size(); }
+
+        auto end() const noexcept -> const_iterator { return data() + size(); }
+
+        auto rbegin() noexcept -> reverse_iterator { return reverse_iterator(end()); }
+
+        auto rbegin() const noexcept -> const_reverse_iterator { return const_reverse_iterator(end()); }
+
+        auto rend() noexcept -> reverse_iterator { return reverse_iterator(begin()); }
+
+        auto rend() const noexcept -> const_reverse_iterator { return const_reverse_iterator(begin()); }
+
+        auto cbegin() const noexcept -> const_iterator { return begin(); }
+
+        auto cend() const noexcept -> const_iterator { return end(); }
+
+        auto crbegin() const noexcept -> const_reverse_iterator { return rbegin(); }
+
+        auto crend() const noexcept -> const_reverse_iterator { return rend(); }
+
+        // capacity
+      public:
+        [[nodiscard]] auto empty() const noexcept -> bool { return size() == 0; }
+
+        auto size() const noexcept -> size_type { return is_long() ? m_long.size : short_capacity - static_cast<size_type>(m_short.buf[short_capacity]); }
+
+        auto length() const noexcept -> size_type { return size(); }
+
+        // 容量的最高位用作标记，另需一个单元存放结束符
+        auto max_size() const noexcept -> size_type { return std::min<size_type>(alloc_traits::max_size(m_alloc), long_flag) - 1; }
+
+        auto capacity() const noexcept -> size_type { return is_long() ? m_long.cap & ~long_flag : short_capacity; }
+
+        auto reserve(size_type n) -> void {
+            if (n > capacity()) {
+                check_length(n, "basic_string::reserve");
+                reallocate(n);
+            }
+        }
+
+        // 能放入对象内部时回到短字符串
+        auto shrink_to_fit() -> void {
+            if (!is_long()) {
+                return;
+            }
+            auto n = size();
+            if (n <= short_capacity) {
+                auto l = m_long;
+                Traits::copy(m_short.buf, l.data, n);
+                set_short_size(n);
+                alloc_traits::deallocate(m_alloc, l.data, (l.cap & ~long_flag) + 1);
+            } else if (n < capacity()) {
+                reallocate(n);
+            }
+        }
+
+        // modifier
+      public:
+        auto clear() noexcept -> void { set_size(0); }
+
+        auto insert(size_type pos, size_type n, CharT ch) -> basic_string & {
+            Traits::assign(replace_gap(pos, 0, n), n, ch);
+            return *this;
+        }
+
+        auto insert(size_type pos, const CharT *s) -> basic_string & { return insert(pos, s, Traits::length(s)); }
+
+        auto insert(size_type pos, const CharT *s, size_type n) -> basic_string & { return replace(pos, 0, s, n); }
+
+        auto insert(size_type pos, const basic_string &s) -> basic_string & { return insert(pos, s.data(), s.size()); }
+
+        auto insert(size_type pos, const basic_string &s, size_type spos, size_type n = npos) -> basic_string & {
+            return insert(pos, s.view().substr(s.check_pos(spos, "basic_string::insert"), n));
+        }
+
+        template <typename T>
+            requires view_like<T>
+        auto insert(size_type pos, const T &t) -> basic_string & {
+            auto sv = view_type(t);
+            return insert(pos, sv.data(), sv.size());
+        }
+
+        template <typename T>
+            requires view_like<T>
+        auto insert(size_type pos, const T &t, size_type spos, size_type n = npos) -> basic_string & {
+            return insert(pos, view_type(t).substr(spos, n));
+        }
+
+        auto insert(const_iterator it, CharT ch) -> iterator { return insert(it, 1, ch); }
+
+        auto insert(const_iterator it, size_type n, CharT ch) -> iterator {
+            auto pos = static_cast<size_type>(it - cbegin());
+            insert(pos, n, ch);
+            return begin() + pos;
+        }
+
+        template <std::input_iterator It>
+        auto insert(const_iterator it, It first, It last) -> iterator {
+            auto pos = static_cast<size_type>(it - cbegin());
+            auto s = basic_string(first, last, m_alloc);
+            insert(pos, s.data(), s.size());
+            return begin() + pos;
+        }
+
+        auto insert(const_iterator it, std::initializer_list<CharT> lst) -> iterator {
+            auto pos = static_cast<size_type>(it - cbegin());
+            insert(pos, lst.begin(), lst.size());
+            return begin() + pos;
+        }
+
+        auto erase(size_type pos = 0, size_type n = npos) -> basic_string & {
+            auto sz = size();
+            check_pos(pos, "basic_string::erase");
+            n = std::min(n, sz - pos);
+            auto p = data();
+            Traits::move(p + pos, p + pos + n, sz - pos - n);
+            set_size(sz - n);
+            return *this;
+        }
+
+        auto erase(const_iterator it) -> iterator {
+            auto pos = static_cast<size_type>(it - cbegin());
+            erase(pos, 1);
+            return begin() + pos;
+        }
+
+        auto erase(const_iterator first, const_iterator last) -> iterator {
+            auto pos = static_cast<size_type>(first - cbegin());
+            erase(pos, static_cast<size_type>(last - first));
+            return begin() + pos;
+        }
+
+        auto push_back(CharT ch) -> void {
+            auto sz = size();
+            if (sz == capacity()) {
+                check_length(sz + 1, "basic_string::push_back");
+                reallocate(recommend(sz + 1));
+            }
+            auto p = data();
+            Traits::assign(p[sz], ch);
+            set_size(sz + 1);
+        }
+
+        auto pop_back() noexcept -> void { set_size(size() - 1); }
+
+        // s 可以指向自身的字符：扩容时先复制 s 再释放旧内存
+        auto append(const CharT *s, size_type n) -> basic_string & {
+            auto sz = size();
+            if (n <= capacity() - sz) {
+                auto p = data();
+                Traits::copy(p + sz, s, n);
+                set_size(sz + n);
+            } else {
+                check_length(n, sz, "basic_string::append");
+                auto [p, cap] = allocate(recommend(sz + n));
+                Traits::copy(p, data(), sz);
+                Traits::copy(p + sz, s, n);
+                release();
+                set_long(p, sz + n, cap);
+            }
+            return *this;
+        }
+
+        auto append(const CharT *s) -> basic_string & { return append(s, Traits::length(s)); }
+
+        auto append(size_type n, CharT ch) -> basic_string & {
+            auto sz = size();
+            if (n > capacity() - sz) {
+                check_length(n, sz, "basic_string::append");
+                reallocate(recommend(sz + n));
+            }
+            Traits::assign(data() + sz, n, ch);
+            set_size(sz + n);
+            return *this;
+        }
+
+        auto append(const basic_string &s) -> basic_string & { return append(s.data(), s.size()); }
+
+        auto append(const basic_string &s, size_type pos, size_type n = npos) -> basic_string & {
+            return append(s.view().substr(s.check_pos(pos, "basic_string::append"), n));
+        }
+
+        template <std::input_iterator It>
+        auto append(It first, It last) -> basic_string & {
+            if constexpr (std::contiguous_iterator<It> && std::is_same_v<std::iter_value_t<It>, CharT>) {
+                return append(std::to_address(first), static_cast<size_type>(last - first));
+            } else if constexpr (std::forward_iterator<It>) {
+                auto n = static_cast<size_type>(std::distance(first, last));
+                reserve(size() + n);
+                auto sz = size();
+                std::copy(first, last, data() + sz);
+                set_size(sz + n);
+                return *this;
+            } else {
+                auto s = basic_string(first, last, m_alloc);
+                return append(s.data(), s.size());
+            }
+        }
+
+        auto append(std::initializer_list<CharT> lst) -> basic_string & { return append(lst.begin(), lst.size()); }
+
+        template <typename T>
+            requires view_like<T>
+        auto append(const T &t) -> basic_string & {
+            auto sv = view_type(t);
+            return append(sv.data(), sv.size());
+        }
+
+        template <typename T>
+            requires view_like<T>
+        auto append(const T &t, size_type pos, size_type n = npos) -> basic_string & {
+            return append(view_type(t).substr(pos, n));
+        }
+
+        auto operator+=(const basic_string &s) -> basic_string & { return append(s); }
+
+        auto operator+=(CharT ch) -> basic_string & {
+            push_back(ch);
+            return *this;
+        }
+
+        auto operator+=(const CharT *s) -> basic_string & { return append(s); }
+
+        auto operator+=(std::initializer_list<CharT> lst) -> basic_string & { return append(lst); }
+
+        template <typename T>
+            requires view_like<T>
+        auto operator+=(const T &t) -> basic_string & {
+            return append(t);
+        }
+
+        // s 可以指向自身的字符
+        auto replace(size_type pos, size_type n1, const CharT *s, size_type n2) -> basic_string & {
+            auto p = data();
+            if (std::less_equal<const CharT *>{}(p, s) && std::less<const CharT *>{}(s, p + size())) {
+                auto tmp = basic_string(s, n2, m_alloc);
+                Traits::copy(replace_gap(pos, n1, n2), tmp.data(), n2);
+            } else {
+                Traits::copy(replace_gap(pos, n1, n2), s, n2);
+            }
+            return *this;
+        }
+
+        auto replace(size_type pos, size_type n1, const CharT *s) -> basic_string & { return replace(pos, n1, s, Traits::length(s)); }
+
+        auto replace(size_type pos, size_type n1, const basic_string &s) -> basic_string & { return replace(pos, n1, s.data(), s.size()); }
+
+        auto replace(size_type pos, size_type n1, const basic_string &s, size_type spos, size_type n2 = npos) -> basic_string & {
+            return replace(pos, n1, s.view().substr(s.check_pos(spos, "basic_string::replace"), n2));
+        }
+
+        auto replace(size_type pos, size_type n1, size_type n2, CharT ch) -> basic_string & {
+            Traits::assign(replace_gap(pos, n1, n2), n2, ch);
+            return *this;
+        }
+
+        template <typename T>
+            requires view_like<T>
+        auto replace(size_type pos, size_type n1, const T &t) -> basic_string & {
+            auto sv = view_type(t);
+            return replace(pos, n1, sv.data(), sv.size());
+        }
+
+        template <typename T>
+            requires view_like<T>
+        auto replace(size_type pos, size_type n1, const T &t, size_type spos, size_type n2 = npos) -> basic_string & {
+            return replace(pos, n1, view_type(t).substr(spos, n2));
+        }
+
+        auto replace(const_iterator first, const_iterator last, const basic_string &s) -> basic_string & {
+            return replace(static_cast<size_type>(first - cbegin()), static_cast<size_type>(last - first), s);
+        }
+
+        auto replace(const_iterator first, const_iterator last, const CharT *s, size_type n) -> basic_string & {
+            return replace(static_cast<size_type>(first - cbegin()), static_cast<size_type>(last - first), s, n);
+        }
+
+        auto replace(const_iterator first, const_iterator last, const CharT *s) -> basic_string & {
+            return replace(static_cast<size_type>(first - cbegin()), static_cast<size_type>(last - first), s);
+        }
+
+        auto replace(const_iterator first, const_iterator last, size_type n, CharT ch) -> basic_string & {
+            return replace(static_cast<size_type>(first - cbegin()), static_cast<size_type>(last - first), n, ch);
+        }
+
+        template <std::input_iterator It>
+        auto replace(const_iterator first, const_iterator last, It first2, It last2) -> basic_string & {
+            auto s = basic_string(first2, last2, m_alloc);
+            return replace(first, last, s.data(), s.size());
+        }
+
+        auto replace(const_iterator first, const_iterator last, std::initializer_list<CharT> lst) -> basic_string & {
+            return replace(first, last, lst.begin(), lst.size());
+        }
+
+        template <typename T>
+            requires view_like<T>
+        auto replace(const_iterator first, const_iterator last, const T &t) -> basic_string & {
+            return replace(static_cast<size_type>(first - cbegin()), static_cast<size_type>(last - first), t);
+        }
+
+        auto copy(CharT *dest, size_type n, size_type pos = 0) const -> size_type {
+            auto sv = view().substr(check_pos(pos, "basic_string::copy"), n);
+            Traits::copy(dest, sv.data(), sv.size());
+            return sv.size();
+        }
+
+        auto resize(size_type n) -> void { resize(n, CharT()); }
+
+        auto resize(size_type n, CharT ch) -> void {
+            auto sz = size();
+            if (n > sz) {
+                append(n - sz, ch);
+            } else {
+                set_size(n);
+            }
+        }
+
+        // op(p, n) 向 [p, p + n) 写入内容并返回最终长度 r（r <= n）。新增部分不做初始化，[p + r, p + n) 的内容被丢弃。
+        template <typename Op>
+        auto resize_and_overwrite(size_type n, Op op) -> void {
+            if (n > capacity()) {
+                check_length(n, "basic_string::resize_and_overwrite");
+                reallocate(recommend(n));
+            }
+            auto r = static_cast<size_type>(std::move(op)(data(), n));
+            set_size(r);
+        }
+
+        auto swap(basic_string &s) noexcept -> void {
+            if constexpr (alloc_traits::propagate_on_container_swap::value) {
+                std::ranges::swap(m_alloc, s.m_alloc);
+            }
+            auto tmp = _short();
+            std::memcpy(&tmp, &m_short, sizeof(_short));
+            std::memcpy(&m_short, &s.m_short, sizeof(_short));
+            std::memcpy(&s.m_short, &tmp, sizeof(_short));
+        }
+
+        // search
+      public:
+        auto find(const basic_string &s, size_type pos = 0) const noexcept -> size_type { return find(s.data(), pos, s.size()); }
+
+        // 子串查找：单字节字符使用 SSE2 首尾字符过滤
+        auto find(const CharT *s, size_type pos, size_type n) const noexcept -> size_type {
+            auto sz = size();
+            if (pos > sz || n > sz - pos) {
+                return npos;
+            }
+            if (n == 0) {
+                return pos;
+            }
+            if (n == 1) {
+                return find(s[0], pos);
+            }
+            auto r = _string_search<CharT, Traits>(data() + pos, sz - pos, s, n);
+            return r == npos ? npos : r + pos;
+        }
+
+        auto find(const CharT *s, size_type pos = 0) const noexcept -> size_type { return find(s, pos, Traits::length(s)); }
+
+        auto find(CharT ch, size_type pos = 0) const noexcept -> size_type {
+            auto sz = size();
+            if (pos >= sz) {
+                return npos;
+            }
+            auto p = data();
+            auto r = Traits::find(p + pos, sz - pos, ch);
+            return r == nullptr ? npos : static_cast<size_type>(r - p);
+        }
+
+        template <typename T>
+            requires view_like<T>
+        auto find(const T &t, size_type pos = 0) const noexcept -> size_type {
+            auto sv = view_type(t);
+            return find(sv.data(), pos, sv.size());
+        }
+
+        auto rfind(const basic_string &s, size_type pos = npos) const noexcept -> size_type { return view().rfind(s.view(), pos); }
+
+        auto rfind(const CharT *s, size_type pos, size_type n) const noexcept -> size_type { return view().rfind(s, pos, n); }
+
+        auto rfind(const CharT *s, size_type pos = npos) const noexcept -> size_type { return view().rfind(s, pos); }
+
+        auto rfind(CharT ch, size_type pos = npos) const noexcept -> size_type { return view().rfind(ch, pos); }
+
+        template <typename T>
+            requires view_like<T>
+        auto rfind(const T &t, size_type pos = npos) const noexcept -> size_type {
+            return view().rfind(view_type(t), pos);
+        }
+
+        auto find_first_of(const basic_string &s, size_type pos = 0) const noexcept -> size_type { return view().find_first_of(s.view(), pos); }
+
+        auto find_first_of(const CharT *s, size_type pos, size_type n) const noexcept -> size_type { return view().find_first_of(s, pos, n); }
+
+        auto find_first_of(const CharT *s, size_type pos = 0) const noexcept -> size_type { return view().find_first_of(s, pos); }
+
+        auto find_first_of(CharT ch, size_type pos = 0) const noexcept -> size_type { return find(ch, pos); }
+
+        template <typename T>
+            requires view_like<T>
+        auto find_first_of(const T &t, size_type pos = 0) const noexcept -> size_type {
+            return view().find_first_of(view_type(t), pos);
+        }
+
+        auto find_last_of(const basic_string &s, size_type pos = npos) const noexcept -> size_type { return view().find_last_of(s.view(), pos); }
+
+        auto find_last_of(const CharT *s, size_type pos, size_type n) const noexcept -> size_type { return view().find_last_of(s, pos, n); }
+
+        auto find_last_of(const CharT *s, size_type pos = npos) const noexcept -> size_type { return view().find_last_of(s, pos); }
+
+        auto find_last_of(CharT ch, size_type pos = npos) const noexcept -> size_type { return rfind(ch, pos); }
+
+        template <typename T>
+            requires view_like<T>
+        auto find_last_of(const T &t, size_type pos = npos) const noexcept -> size_type {
+            return view().find_last_of(view_type(t), pos);
+        }
+
+        auto find_first_not_of(const basic_string &s, size_type pos = 0) const noexcept -> size_type {
+            return view().find_first_not_of(s.view(), pos);
+        }
+
+        auto find_first_not_of(const CharT *s, size_type pos, size_type n) const noexcept -> size_type {
+            return view().find_first_not_of(s, pos, n);
+        }
+
+        auto find_first_not_of(const CharT *s, size_type pos = 0) const noexcept -> size_type { return view().find_first_not_of(s, pos); }
+
+        auto find_first_not_of(CharT ch, size_type pos = 0) const noexcept -> size_type { return view().find_first_not_of(ch, pos); }
+
+        template <typename T>
+            requires view_like<T>
+        auto find_first_not_of(const T &t, size_type pos = 0) const noexcept -> size_type {
+            return view().find_first_not_of(view_type(t), pos);
+        }
+
+        auto find_last_not_of(const basic_string &s, size_type pos = npos) const noexcept -> size_type {
+            return view().find_last_not_of(s.view(), pos);
+        }
+
+        auto find_last_not_of(const CharT *s, size_type pos, size_type n) const noexcept -> size_type {
+            return view().find_last_not_of(s, pos, n);
+        }
+
+        auto find_last_not_of(const CharT *s, size_type pos = npos) const noexcept -> size_type { return view().find_last_not_of(s, pos); }
+
+        auto find_last_not_of(CharT ch, size_type pos = npos) const noexcept -> size_type { return view().find_last_not_of(ch, pos); }
+
+        template <typename T>
+            requires view_like<T>
+        auto find_last_not_of(const T &t, size_type pos = npos) const noexcept -> size_type {
+            return view().find_last_not_of(view_type(t), pos);
+        }
+
+        // operation
+      public:
+        // Traits::compare 对 char 即 memcmp，由 libc 按 SIMD 实现
+        auto compare(const basic_string &s) const noexcept -> int { return view().compare(s.view()); }
+
+        auto compare(size_type pos, size_type n, const basic_string &s) const -> int { return compare(pos, n, s.view()); }
+
+        auto compare(size_type pos1, size_type n1, const basic_string &s, size_type pos2, size_type n2 = npos) const -> int {
+            return compare(pos1, n1, s.view(), pos2, n2);
+        }
+
+        auto compare(const CharT *s) const -> int { return view().compare(s); }
+
+        auto compare(size_type pos, size_type n, const CharT *s) const -> int { return sub(pos, n).compare(s); }
+
+        auto compare(size_type pos, size_type n1, const CharT *s, size_type n2) const -> int { return sub(pos, n1).compare(view_type(s, n2)); }
+
+        template <typename T>
+            requires view_like<T>
+        auto compare(const T &t) const noexcept -> int {
+            return view().compare(view_type(t));
+        }
+
+        template <typename T>
+            requires view_like<T>
+        auto compare(size_type pos, size_type n, const T &t) const -> int {
+            return sub(pos, n).compare(view_type(t));
+        }
+
+        template <typename T>
+            requires view_like<T>
+        auto compare(size_type pos1, size_type n1, const T &t, size_type pos2, size_type n2 = npos) const -> int {
+            return sub(pos1, n1).compare(view_type(t).substr(pos2, n2));
+        }
+
+        auto starts_with(view_type sv) const noexcept -> bool { return view().starts_with(sv); }
+
+        auto starts_with(CharT ch) const noexcept -> bool { return !empty() && Traits::eq(front(), ch); }
+
+        auto starts_with(const CharT *s) const -> bool { return view().starts_with(s); }
+
+        auto ends_with(view_type sv) const noexcept -> bool { return view().ends_with(sv); }
+
+        auto ends_with(CharT ch) const noexcept -> bool { return !empty() && Traits::eq(back(), ch); }
+
+        auto ends_with(const CharT *s) const -> bool { return view().ends_with(s); }
+
+        auto contains(view_type sv) const noexcept -> bool { return find(sv.data(), 0, sv.size()) != npos; }
+
+        auto contains(CharT ch) const noexcept -> bool { return find(ch) != npos; }
+
+        auto contains(const CharT *s) const -> bool { return find(s) != npos; }
+
+        auto substr(size_type pos = 0, size_type n = npos) const -> basic_string { return basic_string(*this, pos, n); }
+
+        // 内部实现
+      private:
+        auto view() const noexcept -> view_type { return view_type(data(), size()); }
+
+        auto sub(size_type pos, size_type n) const -> view_type { return view().substr(check_pos(pos, "basic_string::compare"), n); }
+
+        auto is_long() const noexcept -> bool { return (reinterpret_cast<const unsigned char *>(&m_short)[sizeof(_short) - 1] & 0x80) != 0; }
+
+        auto set_short_size(size_type n) noexcept -> void {
+            Traits::assign(m_short.buf[n], CharT());
+            m_short.buf[short_capacity] = static_cast<CharT>(short_capacity - n);
+        }
+
+        auto set_long(CharT *p, size_type n, size_type cap) noexcept -> void {
+            m_long.data = p;
+            m_long.size = n;
+            m_long.cap = cap | long_flag;
+            Traits::assign(p[n], CharT());
+        }
+
+        auto set_size(size_type n) noexcept -> void {
+            if (is_long()) {
+                m_long.size = n;
+                Traits::assign(m_long.data[n], CharT());
+            } else {
+                set_short_size(n);
+            }
+        }
+
+        auto check_pos(size_type pos, const char *what) const -> size_type {
+            if (pos > size()) {
+                throw std::out_of_range(what);
+            }
+            return pos;
+        }
+
+        auto check_length(size_type n, const char *what) const -> void {
+            if (n > max_size()) {
+                throw std::length_error(what);
+            }
+        }
+
+        // 检查 n + sz 是否溢出
+        auto check_length(size_type n, size_type sz, const char *what) const -> void {
+            if (n > max_size() - sz) {
+                throw std::length_error(what);
+            }
+        }
+
+        // 扩容至少翻倍
+        auto recommend(size_type n) const noexcept -> size_type { return std::max(n, std::min(2 * capacity(), max_size())); }
+
+        // 分配能容纳 n 个字符和结束符的内存，返回指针和实际容量（不含结束符）
+        auto allocate(size_type n) -> allocation_result<CharT *, size_type> {
+            auto [p, count] = alloc_traits::allocate_at_least(m_alloc, n + 1);
+            return {p, std::min(count, long_flag) - 1};
+        }
+
+        auto release() noexcept -> void {
+            if (is_long()) {
+                alloc_traits::deallocate(m_alloc, m_long.data, (m_long.cap & ~long_flag) + 1);
+            }
+        }
+
+        // 转移到容量至少为 n 的新内存
+        auto reallocate(size_type n) -> void {
+            auto sz = size();
+            auto [p, cap] = allocate(n);
+            Traits::copy(p, data(), sz);
+            release();
+            set_long(p, sz, cap);
+        }
+
+        // 初始化为长度 n 的字符串并返回数据指针，内容由调用者写入
+        auto init(size_type n) -> CharT * {
+            if (n <= short_capacity) {
+                set_short_size(n);
+                return m_short.buf;
+            }
+            check_length(n, "basic_string");
+            auto [p, cap] = allocate(n);
+            set_long(p, n, cap);
+            return p;
+        }
+
+        auto steal(basic_string &s) noexcept -> void {
+            std::memcpy(&m_short, &s.m_short, sizeof(_short));
+            s.set_short_size(0);
+        }
+
+        // 把 [pos, pos + n1) 替换为 n2 个未初始化的字符，返回其起始位置
+        auto replace_gap(size_type pos, size_type n1, size_type n2) -> CharT * {
+            auto sz = size();
+            check_pos(pos, "basic_string::replace");
+            n1 = std::min(n1, sz - pos);
+            check_length(n2, sz - n1, "basic_string::replace");
+            auto new_size = sz - n1 + n2;
+            auto tail = sz - pos - n1;
+            if (new_size <= capacity()) {
+                auto p = data();
+                Traits::move(p + pos + n2, p + pos + n1, tail);
+                set_size(new_size);
+                return p + pos;
+            }
+            auto old = data();
+            auto [p, cap] = allocate(recommend(new_size));
+            Traits::copy(p, old, pos);
+            Traits::copy(p + pos + n2, old + pos + n1, tail);
+            release();
+            set_long(p, new_size, cap);
+            return p + pos;
+        }
+
+      public:
+        union {
+            _long m_long;
+            _short m_short;
+        };
+        [[no_unique_address]] Alloc m_alloc;
+    };
+
+    using string = basic_string<char>;
+    using wstring = basic_string<wchar_t>;
+    using u8string = basic_string<char8_t>;
+    using u16string = basic_string<char16_t>;
+    using u32string = basic_string<char32_t>;
+} // namespace mtl
+
+// concatenation
+namespace mtl {
+    template <typename C, typename T, typename A>
+    auto operator+(const basic_string<C, T, A> &lhs, const basic_string<C, T, A> &rhs) -> basic_string<C, T, A> {
+        auto s = basic_string<C, T, A>(allocator_traits<A>::select_on_container_copy_construction(lhs.get_allocator()));
+        s.reserve(lhs.size() + rhs.size());
+        s.append(lhs).append(rhs);
+        return s;
+    }
+
+    template <typename C, typename T, typename A>
+    auto operator+(basic_string<C, T, A> &&lhs, const basic_string<C, T, A> &rhs) -> basic_string<C, T, A> {
+        return std::move(lhs.append(rhs));
+    }
+
+    template <typename C, typename T, typename A>
+    auto operator+(const basic_string<C, T, A> &lhs, basic_string<C, T, A> &&rhs) -> basic_string<C, T, A> {
+        return std::move(rhs.insert(0, lhs));
+    }
+
+    template <typename C, typename T, typename A>
+    auto operator+(basic_string<C, T, A> &&lhs, basic_string<C, T, A> &&rhs) -> basic_string<C, T, A> {
+        return std::move(lhs.append(rhs));
+    }
+
+    template <typename C, typename T, typename A>
+    auto operator+(const basic_string<C, T, A> &lhs, const C *rhs) -> basic_string<C, T, A> {
+        auto s = lhs;
+        s.append(rhs);
+        return s;
+    }
+
+    template <typename C, typename T, typename A>
+    auto operator+(basic_string<C, T, A> &&lhs, const C *rhs) -> basic_string<C, T, A> {
+        return std::move(lhs.append(rhs));
+    }
+
+    template <typename C, typename T, typename A>
+    auto operator+(const C *lhs, const basic_string<C, T, A> &rhs) -> basic_string<C, T, A> {
+        auto s = basic_string<C, T, A>(lhs, rhs.get_allocator());
+        s.append(rhs);
+        return s;
+    }
+
+    template <typename C, typename T, typename A>
+    auto operator+(const C *lhs, basic_string<C, T, A> &&rhs) -> basic_string<C, T, A> {
+        return std::move(rhs.insert(0, lhs));
+    }
+
+    template <typename C, typename T, typename A>
+    auto operator+(const basic_string<C, T, A> &lhs, C rhs) -> basic_string<C, T, A> {
+        auto s = lhs;
+        s.push_back(rhs);
+        return s;
+    }
+
+    template <typename C, typename T, typename A>
+    auto operator+(basic_string<C, T, A> &&lhs, C rhs) -> basic_string<C, T, A> {
+        lhs.push_back(rhs);
+        return std::move(lhs);
+    }
+
+    template <typename C, typename T, typename A>
+    auto operator+(C lhs, const basic_string<C, T, A> &rhs) -> basic_string<C, T, A> {
+        auto s = basic_string<C, T, A>(1, lhs, rhs.get_allocator());
+        s.append(rhs);
+        return s;
+    }
+} // namespace mtl
+
+// relational operator
+namespace mtl {
+    // 先比较长度，相等时再 memcmp
+    template <typename C, typename T, typename A>
+    auto operator==(const basic_string<C, T, A> &lhs, const basic_string<C, T, A> &rhs) noexcept -> bool {
+        auto n = lhs.size();
+        return n == rhs.size() && T::compare(lhs.data(), rhs.data(), n) == 0;
+    }
+
+    template <typename C, typename T, typename A>
+    auto operator==(const basic_string<C, T, A> &lhs, const C *rhs) -> bool {
+        return lhs.compare(rhs) == 0;
+    }
+
+    template <typename C, typename T, typename A>
+    auto operator<=>(const basic_string<C, T, A> &lhs, const basic_string<C, T, A> &rhs) noexcept -> _string_comparison_category_t<T> {
+        return static_cast<_string_comparison_category_t<T>>(lhs.compare(rhs) <=> 0);
+    }
+
+    template <typename C, typename T, typename A>
+    auto operator<=>(const basic_string<C, T, A> &lhs, const C *rhs) -> _string_comparison_category_t<T> {
+        return static_cast<_string_comparison_category_t<T>>(lhs.compare(rhs) <=> 0);
+    }
+} // namespace mtl
+
+// specialized algorithm
+namespace mtl {
+    template <typename C, typename T, typename A>
+    auto swap(basic_string<C, T, A> &lhs, basic_string<C, T, A> &rhs) noexcept -> void { lhs.swap(rhs); }
+
+    template <typename C, typename T, typename A, typename U>
+    auto erase(basic_string<C, T, A> &s, const U &value) -> size_t {
+        auto it = std::remove(s.begin(), s.end(), value);
+        auto n = static_cast<size_t>(s.end() - it);
+        s.erase(it, s.end());
+        return n;
+    }
+
+    template <typename C, typename T, typename A, typename Pred>
+    auto erase_if(basic_string<C, T, A> &s, Pred pred) -> size_t {
+        auto it = std::remove_if(s.begin(), s.end(), pred);
+        auto n = static_cast<size_t>(s.end() - it);
+        s.erase(it, s.end());
+        return n;
+    }
+
+    template <typename C, typename T, typename A>
+    auto operator<<(std::basic_ostream<C, T> &os, const basic_string<C, T, A> &s) -> std::basic_ostream<C, T> & {
+        return os << std::basic_string_view<C, T>(s);
+    }
+} // namespace mtl
+
+// hash
+namespace std {
+    template <typename C, typename A>
+    struct hash<mtl::basic_string<C, std::char_traits<C>, A>> {
+        auto operator()(const mtl::basic_string<C, std::char_traits<C>, A> &s) const noexcept -> size_t {
+            return std::hash<std::basic_string_view<C>>{}(s);
+        }
+    };
+} // namespace std
+
+// trivially relocatable
+namespace mtl {
+    template <typename C, typename T, typename A>
+    struct is_trivially_relocatable<basic_string<C, T, A>> : public std::bool_constant<is_trivially_relocatable_v<A>> {};
+} // namespace mtl
@@ -0,0 +1,266 @@
+/*
+    驻留字符串（string interning）
+    https://en.wikipedia.org/wiki/String_interning
+*/
+#pragma once
+#include "utility/memory_resource.hpp"
+#include "utility/optional.hpp"
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+
+// symbol table
+namespace mtl {
+    // 驻留的字符串，data 以 '\0' 结尾
+    struct _symbol_entry {
+        const char *data;
+        size_t size;
+        size_t hash;
+    };
+
+    // 全局驻留表，按哈希值分片。
+    // 每个分片持有一个 arena，字符串、条目数组和索引都从中分配，进程结束前从不释放，因此读取无需任何同步。
+    // 查找已驻留的字符串只读取原子的索引槽（无锁）；插入时才加分片的锁。
+    // 驻留表本身也不析构，静态或 thread_local 对象析构时依然可以使用 symbol。
+    class _symbol_table {
+      public:
+        static constexpr size_t shard_bits = 4;
+        static constexpr size_t shard_count = size_t{1} << shard_bits;
+        // id 的低 shard_bits 位为分片号，其余为分片内的下标
+        static constexpr size_t max_local = size_t{1} << (32 - shard_bits);
+        static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+
+      private:
+        // 条目按指数增长的段存放：第 s 段容纳 first_segment << s 个条目，段一旦分配就不再移动
+        static constexpr size_t first_segment_bits = 6;
+        static constexpr size_t first_segment = size_t{1} << first_segment_bits;
+        static constexpr size_t segment_count = 32 - shard_bits - first_segment_bits + 1;
+
+        // 开放寻址索引，槽中存放「哈希高 32 位 << 32 | 下标 + 1」，0 表示空槽。
+        // 扩容时整体替换为新索引，旧索引留在 arena 中，正在读取旧索引的线程不受影响。
+        struct index {
+            size_t mask;
+            std::atomic<uint64_t> *slots;
+        };
+
+        struct alignas(64) shard {
+            std::atomic<index *> m_index{nullptr};
+            std::atomic<_symbol_entry *> m_segments[segment_count]{};
+            uint32_t m_size{0};
+            std::mutex m_mut;
+            monotonic_buffer_resource m_arena{size_t{64} * 1024};
+        };
+
+      public:
+        static auto instance() -> _symbol_table & {
+            static auto *table = new _symbol_table();
+            return *table;
+        }
+
+        static auto hash_of(std::string_view sv) noexcept -> size_t { return std::hash<std::string_view>{}(sv); }
+
+        // 无锁查找，未驻留时返回 npos
+        auto find(std::string_view sv, size_t hash) const noexcept -> uint32_t {
+            if (sv.empty()) {
+                return 0;
+            }
+            auto &sh = m_shards[shard_of(hash)];
+            auto local = find_local(sh.m_index.load(std::memory_order_acquire), sv, hash);
+            return local == npos ? npos : make_id(hash, local);
+        }
+
+        auto intern(std::string_view sv, size_t hash) -> uint32_t {
+            if (sv.empty()) {
+                return 0;
+            }
+            if (auto id = find(sv, hash); id != npos) [[likely]] {
+                return id;
+            }
+            auto &sh = m_shards[shard_of(hash)];
+            auto lock = std::lock_guard(sh.m_mut);
+            // 加锁期间可能已被其他线程插入
+            auto idx = sh.m_index.load(std::memory_order_relaxed);
+            if (auto local = find_local(idx, sv, hash); local != npos) {
+                return make_id(hash, local);
+            }
+            auto local = append(sh, sv, hash);
+            if ((static_cast<size_t>(sh.m_size) + 1) * 2 > idx->mask + 1) {
+                idx = grow(sh, idx);
+            } else {
+                insert_slot(idx, hash, local);
+            }
+            return make_id(hash, local);
+        }
+
+        auto entry(uint32_t id) const noexcept -> const _symbol_entry & {
+            auto &sh = m_shards[id & (shard_count - 1)];
+            auto i = static_cast<size_t>(id >> shard_bits) + first_segment;
+            auto seg = static_cast<size_t>(std::bit_width(i)) - 1 - first_segment_bits;
+            return sh.m_segments[seg].load(std::memory_order_acquire)[i - (first_segment << seg)];
+        }
+
+        // 内部实现
+      private:
+        // 空字符串固定为分片 0 的第一个条目，即 id 0，它不进入索引
+        _symbol_table() {
+            for (auto &sh : m_shards) {
+                sh.m_index.store(make_index(sh, 1024), std::memory_order_relaxed);
+            }
+            append(m_shards[0], {}, hash_of({}));
+        }
+
+        static auto shard_of(size_t hash) noexcept -> size_t { return hash >> (sizeof(size_t) * 8 - shard_bits); }
+
+        static auto tag_of(size_t hash) noexcept -> uint64_t { return static_cast<uint64_t>(hash >> (sizeof(size_t) * 8 - 32)); }
+
+        static auto make_id(size_t hash, uint32_t local) noexcept -> uint32_t {
+            return static_cast<uint32_t>(local << shard_bits | shard_of(hash));
+        }
+
+        auto find_local(const index *idx, std::string_view sv, size_t hash) const noexcept -> uint32_t {
+            auto tag = tag_of(hash);
+            for (auto i = hash & idx->mask;; i = (i + 1) & idx->mask) {
+                auto v = idx->slots[i].load(std::memory_order_acquire);
+                if (v == 0) {
+                    return npos;
+                }
+                if ((v >> 32) == tag) {
+                    auto local = static_cast<uint32_t>(v) - 1;
+                    auto &e = entry(static_cast<uint32_t>(local << shard_bits | shard_of(hash)));
+                    if (e.size == sv.size() && (sv.empty() || std::memcmp(e.data, sv.data(), sv.size()) == 0)) {
+                        return local;
+                    }
+                }
+            }
+        }
+
+        static auto make_index(shard &sh, size_t n) -> index * {
+            auto slots = static_cast<std::atomic<uint64_t> *>(sh.m_arena.allocate(n * sizeof(std::atomic<uint64_t>), alignof(std::atomic<uint64_t>)));
+            for (auto i = size_t{0}; i < n; ++i) {
+                new (slots + i) std::atomic<uint64_t>(0);
+            }
+            return new (sh.m_arena.allocate(sizeof(index), alignof(index))) index{n - 1, slots};
+        }
+
+        static auto insert_slot(index *idx, size_t hash, uint32_t local) noexcept -> void {
+            auto i = hash & idx->mask;
+            while (idx->slots[i].load(std::memory_order_relaxed) != 0) {
+                i = (i + 1) & idx->mask;
+            }
+            idx->slots[i].store(tag_of(hash) << 32 | (static_cast<uint64_t>(local) + 1), std::memory_order_release);
+        }
+
+        // 复制字符串并追加条目，返回分片内下标；条目在发布到索引之前已写完
+        auto append(shard &sh, std::string_view sv, size_t hash) -> uint32_t {
+            auto local = static_cast<size_t>(sh.m_size);
+            if (local >= max_local) {
+                throw std::length_error("symbol table");
+            }
+            auto i = local + first_segment;
+            auto seg = static_cast<size_t>(std::bit_width(i)) - 1 - first_segment_bits;
+            auto entries = sh.m_segments[seg].load(std::memory_order_relaxed);
+            if (entries == nullptr) {
+                auto n = first_segment << seg;
+                entries = static_cast<_symbol_entry *>(sh.m_arena.allocate(n * sizeof(_symbol_entry), alignof(_symbol_entry)));
+                sh.m_segments[seg].store(entries, std::memory_order_release);
+            }
+            auto data = static_cast<char *>(sh.m_arena.allocate(sv.size() + 1, 1));
+            if (!sv.empty()) {
+                std::memcpy(data, sv.data(), sv.size()); // 空串的 data() 可能是空指针
+            }
+            data[sv.size()] = '\0';
+            new (entries + (i - (first_segment << seg))) _symbol_entry{data, sv.size(), hash};
+            ++sh.m_size;
+            return static_cast<uint32_t>(local);
+        }
+
+        // 容量翻倍并重新插入全部条目，然后发布新索引
+        auto grow(shard &sh, index *old) -> index * {
+            auto idx = make_index(sh, (old->mask + 1) * 2);
+            auto shard_id = static_cast<uint32_t>(&sh - m_shards);
+            // 分片 0 的空字符串不进入索引
+            for (auto local = shard_id == 0 ? uint32_t{1} : uint32_t{0}; local < sh.m_size; ++local) {
+                insert_slot(idx, entry(local << shard_bits | shard_id).hash, local);
+            }
+            sh.m_index.store(idx, std::memory_order_release);
+            return idx;
+        }
+
+      public:
+        shard m_shards[shard_count];
+    };
+} // namespace mtl
+
+// symbol
+namespace mtl {
+    // 指向全局驻留表的 4 字节句柄。相同内容的字符串得到相同的 symbol，比较只比较 id，哈希值在驻留时计算一次。
+    // 驻留的字符串在进程结束前一直有效，view() 和 c_str() 返回的指针不会失效。
+    class symbol {
+      public:
+        // 空字符串
+        constexpr symbol() noexcept = default;
+
+        explicit symbol(std::string_view sv) {
+            auto &t = _symbol_table::instance();
+            m_id = t.intern(sv, t.hash_of(sv));
+        }
+
+        explicit symbol(const char *s) : symbol(std::string_view(s)) {}
+
+        // 只查找不驻留，字符串尚未驻留时返回 nullopt
+        // 可能首次构造驻留表，不是 noexcept
+        static auto find(std::string_view sv) -> optional<symbol> {
+            auto &t = _symbol_table::instance();
+            auto id = t.find(sv, t.hash_of(sv));
+            if (id == _symbol_table::npos) {
+                return nullopt;
+            }
+            return from_id(id);
+        }
+
+        static constexpr auto from_id(uint32_t id) noexcept -> symbol {
+            auto s = symbol();
+            s.m_id = id;
+            return s;
+        }
+
+      public:
+        constexpr auto id() const noexcept -> uint32_t { return m_id; }
+
+        auto view() const noexcept -> std::string_view {
+            auto &e = entry();
+            return {e.data, e.size};
+        }
+
+        auto c_str() const noexcept -> const char * { return entry().data; }
+
+        auto size() const noexcept -> size_t { return entry().size; }
+
+        constexpr auto empty() const noexcept -> bool { return m_id == 0; }
+
+        auto hash() const noexcept -> size_t { return entry().hash; }
+
+        // 按 id 比较，与字典序无关，只在同一进程内稳定
+        constexpr auto operator==(const symbol &) const noexcept -> bool = default;
+
+        constexpr auto operator<=>(const symbol &) const noexcept = default;
+
+      private:
+        auto entry() const noexcept -> const _symbol_entry & { return _symbol_table::instance().entry(m_id); }
+
+      public:
+        uint32_t m_id{0};
+    };
+} // namespace mtl
+
+// hash
+namespace std {
+    template <>
+    struct hash<mtl::symbol> {
+        auto operator()(const mtl::symbol &s) const noexcept -> size_t { return s.hash(); }
+    };
+} // namespace std
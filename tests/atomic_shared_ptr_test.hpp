@@ -0,0 +1,101 @@
+#pragma once
+#include "utility/shared_ptr.hpp"
+#include "gtest/gtest.h"
+#include <thread>
+#include <vector>
+
+using namespace mtl;
+
+namespace {
+    // 三个字段总是相等，读到不相等说明读到了已释放或未构造完的对象
+    struct snapshot {
+        explicit snapshot(int v) : a(v), b(v), c(v) { live.fetch_add(1); }
+
+        ~snapshot() {
+            a = b = c = -1;
+            live.fetch_sub(1);
+        }
+
+        int a, b, c;
+        inline static std::atomic<int> live{0};
+    };
+} // namespace
+
+//  load / store / exchange / compare_exchange
+TEST(atomic_shared_ptr_test, case_1) {
+    EXPECT_TRUE(atomic_shared_ptr<int>::is_always_lock_free);
+    auto a = atomic_shared_ptr<int>();
+    EXPECT_FALSE(a.load());
+
+    auto p = shared_ptr<int>(new int(1));
+    a.store(p);
+    EXPECT_EQ(p.use_count(), 2);
+    auto q = a.load();
+    EXPECT_EQ(q.get(), p.get());
+    EXPECT_EQ(p.use_count(), 3);
+
+    auto old = a.exchange(shared_ptr<int>(new int(2)));
+    EXPECT_EQ(old.get(), p.get());
+    EXPECT_EQ(*a.load(), 2);
+    EXPECT_EQ(p.use_count(), 3);
+
+    auto expected = p;
+    EXPECT_FALSE(a.compare_exchange_strong(expected, shared_ptr<int>(new int(3))));
+    EXPECT_EQ(*expected, 2);
+    EXPECT_TRUE(a.compare_exchange_strong(expected, p));
+    EXPECT_EQ(a.load().get(), p.get());
+    EXPECT_EQ(expected.use_count(), 1);
+
+    a = shared_ptr<int>();
+    EXPECT_EQ(p.use_count(), 3);
+    q.reset();
+    old.reset();
+    EXPECT_EQ(p.use_count(), 1);
+}
+
+//  读者与写者并发：读到的对象总是完整的，全部对象最终都被释放
+TEST(atomic_shared_ptr_test, case_2) {
+    {
+        auto a = atomic_shared_ptr<snapshot>(shared_ptr<snapshot>(new snapshot(0)));
+        auto stop = std::atomic<bool>(false);
+        auto torn = std::atomic<int>(0);
+        auto spurious = std::atomic<int>(0);
+        auto threads = std::vector<std::thread>();
+        for (auto i = 0; i < 4; ++i) {
+            threads.emplace_back([&] {
+                while (!stop.load(std::memory_order_relaxed)) {
+                    auto s = a.load();
+                    if (s->a != s->b || s->b != s->c || s->a < 0) {
+                        torn.fetch_add(1);
+                    }
+                }
+            });
+        }
+        // 一个写者 store，一个写者 compare_exchange，交替使用相同的对象以覆盖控制块被重新存入的情况
+        auto keep = shared_ptr<snapshot>(new snapshot(7));
+        threads.emplace_back([&] {
+            for (auto i = 1; i <= 20'000; ++i) {
+                a.store(i % 3 == 0 ? keep : shared_ptr<snapshot>(new snapshot(i)));
+            }
+        });
+        threads.emplace_back([&] {
+            for (auto i = 1; i <= 20'000; ++i) {
+                auto e = a.load();
+                auto seen = e.get();
+                // 强版本失败时 expected 一定是与原值不同的当前值
+                if (!a.compare_exchange_strong(e, shared_ptr<snapshot>(new snapshot(i))) && e.get() == seen) {
+                    spurious.fetch_add(1);
+                }
+            }
+        });
+        threads[5].join();
+        threads[4].join();
+        stop = true;
+        for (auto i = 0; i < 4; ++i) {
+            threads[i].join();
+        }
+        EXPECT_EQ(torn.load(), 0);
+        EXPECT_EQ(spurious.load(), 0);
+    }
+    EXPECT_EQ(snapshot::live.load(), 0);
+}
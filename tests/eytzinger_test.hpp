@@ -0,0 +1,55 @@
+#pragma once
+#include "container/eytzinger.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+using namespace mtl;
+
+//  与 std::lower_bound 对照
+TEST(eytzinger_test, case_1) {
+    for (auto n : {0, 1, 2, 3, 7, 8, 100, 1023, 1024, 1025}) {
+        auto sorted = vector<int>();
+        for (auto i = 0; i < n; ++i) {
+            sorted.push_back(i * 2);
+        }
+        auto s = eytzinger_set<int>(sorted.begin(), sorted.end());
+        EXPECT_EQ(s.size(), static_cast<size_t>(n));
+        for (auto key = -1; key <= n * 2 + 1; ++key) {
+            auto expect = std::lower_bound(sorted.begin(), sorted.end(), key);
+            auto it = s.lower_bound(key);
+            if (expect == sorted.end()) {
+                EXPECT_EQ(it, s.end());
+            } else {
+                ASSERT_NE(it, s.end());
+                EXPECT_EQ(*it, *expect);
+            }
+            EXPECT_EQ(s.contains(key), key >= 0 && key < n * 2 && key % 2 == 0);
+        }
+    }
+
+    auto dup = eytzinger_set<int>{1, 1, 2, 3, 3};
+    EXPECT_EQ(dup.size(), 3);
+    EXPECT_EQ(std::distance(dup.begin(), dup.end()), 3);
+}
+
+//  eytzinger_map
+TEST(eytzinger_test, case_2) {
+    auto m = eytzinger_map<std::string, int, std::less<>>{{"a", 1}, {"b", 2}, {"c", 3}, {"d", 4}};
+    EXPECT_EQ(m.size(), 4);
+    EXPECT_EQ(*m.find("c"), 3);
+    EXPECT_EQ(m.find("e"), nullptr);
+    EXPECT_EQ(m.at(std::string_view("a")), 1);
+    EXPECT_THROW(m.at("x"), std::out_of_range);
+    auto [k, v] = m.lower_bound("bb");
+    EXPECT_EQ(*k, "c");
+    EXPECT_EQ(*v, 3);
+    EXPECT_EQ(m.lower_bound("z").first, nullptr);
+
+    auto keys = vector<int>{1, 5, 9};
+    auto values = vector<double>{0.1, 0.5, 0.9};
+    auto m2 = eytzinger_map<int, double>(sorted_unique, keys, values);
+    EXPECT_EQ(m2.at(5), 0.5);
+    EXPECT_FALSE(m2.contains(4));
+}
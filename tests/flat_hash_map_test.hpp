@@ -0,0 +1,228 @@
+#pragma once
+#include "container/flat_hash_map.hpp"
+#include "utility/memory_resource.hpp"
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+using namespace mtl;
+
+namespace {
+    // 拷贝可能抛出异常
+    struct fhm_value {
+        explicit fhm_value(int x) : v(x) { ++live; }
+
+        fhm_value(const fhm_value &o) : v(o.v) {
+            if (countdown > 0 && --countdown == 0) {
+                throw std::runtime_error("copy");
+            }
+            ++live;
+        }
+
+        ~fhm_value() { --live; }
+
+        int v;
+        inline static int live = 0;
+        inline static int countdown = 0;
+    };
+
+    // 被移动后不能再使用的哈希函数
+    struct fhm_hash {
+        fhm_hash() = default;
+
+        fhm_hash(const fhm_hash &) = default;
+
+        fhm_hash(fhm_hash &&h) noexcept : moved(std::exchange(h.moved, true)) {}
+
+        auto operator=(const fhm_hash &) -> fhm_hash & = default;
+
+        auto operator=(fhm_hash &&h) noexcept -> fhm_hash & {
+            moved = std::exchange(h.moved, true);
+            return *this;
+        }
+
+        auto operator()(int k) const -> size_t {
+            if (moved) {
+                throw std::logic_error("moved-from hash");
+            }
+            return std::hash<int>()(k);
+        }
+
+        bool moved{false};
+    };
+
+    // 带编号的分配器，编号不同即不相等；记录未归还的分配次数
+    template <typename T>
+    struct fhm_alloc {
+        using value_type = T;
+
+        explicit fhm_alloc(int i = 0) noexcept : id(i) {}
+
+        template <typename U>
+        fhm_alloc(const fhm_alloc<U> &a) noexcept : id(a.id) {}
+
+        auto allocate(size_t n) -> T * {
+            ++outstanding;
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+
+        auto deallocate(T *p, size_t) noexcept -> void {
+            --outstanding;
+            ::operator delete(p);
+        }
+
+        template <typename U>
+        auto operator==(const fhm_alloc<U> &a) const noexcept -> bool {
+            return id == a.id;
+        }
+
+        int id;
+        inline static int outstanding = 0;
+    };
+} // namespace
+
+//  基本操作
+TEST(flat_hash_map_test, case_1) {
+    auto m = flat_hash_map<int, std::string>();
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.find(1), m.end());
+    EXPECT_FALSE(m.contains(1));
+
+    EXPECT_TRUE(m.insert({1, "a"}).second);
+    EXPECT_FALSE(m.insert({1, "b"}).second);
+    EXPECT_EQ(m[1], "a");
+    m[2] = "b";
+    EXPECT_TRUE(m.try_emplace(3, 3, 'c').second);
+    EXPECT_EQ(m.at(3), "ccc");
+    EXPECT_FALSE(m.insert_or_assign(3, "d").second);
+    EXPECT_EQ(m.at(3), "d");
+    EXPECT_TRUE(m.emplace(4, "e").second);
+    EXPECT_EQ(m.size(), 4);
+    EXPECT_THROW(m.at(5), std::out_of_range);
+
+    EXPECT_EQ(m.erase(2), 1);
+    EXPECT_EQ(m.erase(2), 0);
+    EXPECT_EQ(m.count(2), 0);
+    auto n = 0;
+    for (auto &[k, v] : m) {
+        n += k;
+    }
+    EXPECT_EQ(n, 8);
+
+    auto m2 = m;
+    EXPECT_EQ(m, m2);
+    auto m3 = std::move(m2);
+    EXPECT_EQ(m, m3);
+    EXPECT_TRUE(m2.empty());
+    m3.clear();
+    EXPECT_TRUE(m3.empty());
+    EXPECT_EQ(m3.begin(), m3.end());
+    m3 = {{7, "x"}};
+    EXPECT_EQ(m3.at(7), "x");
+}
+
+//  大量插入删除，与 std::unordered_map 对照
+TEST(flat_hash_map_test, case_2) {
+    auto m = flat_hash_map<uint64_t, uint64_t>();
+    auto ref = std::unordered_map<uint64_t, uint64_t>();
+    auto x = uint64_t{12345};
+    for (auto i = 0; i < 200000; ++i) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        auto k = (x >> 33) % 5000;
+        if (x & 1) {
+            m[k] = i;
+            ref[k] = i;
+        } else {
+            EXPECT_EQ(m.erase(k), ref.erase(k));
+        }
+    }
+    EXPECT_EQ(m.size(), ref.size());
+    for (auto &[k, v] : ref) {
+        EXPECT_EQ(m.at(k), v);
+    }
+    auto n = size_t{0};
+    for (auto it = m.begin(); it != m.end(); ++it) {
+        ++n;
+    }
+    EXPECT_EQ(n, m.size());
+    EXPECT_LE(m.load_factor(), m.max_load_factor());
+
+    auto even = static_cast<size_t>(std::count_if(ref.begin(), ref.end(), [](auto &p) { return p.first % 2 == 0; }));
+    EXPECT_EQ(erase_if(m, [](auto &p) { return p.first % 2 == 0; }), even);
+    for (auto &[k, v] : m) {
+        EXPECT_EQ(k % 2, 1);
+    }
+
+    m.reserve(100000);
+    auto cap = m.capacity();
+    for (auto i = uint64_t{0}; i < 100000; ++i) {
+        m.try_emplace(i + 10000, i);
+    }
+    EXPECT_EQ(m.capacity(), cap);
+    m.rehash(0);
+    EXPECT_EQ(m.at(10000), 0);
+}
+
+//  异构查找
+struct string_hash {
+    using is_transparent = void;
+    auto operator()(std::string_view s) const -> size_t { return std::hash<std::string_view>{}(s); }
+};
+
+TEST(flat_hash_map_test, case_3) {
+    auto m = flat_hash_map<std::string, int, string_hash, std::equal_to<>>();
+    m["hello"] = 1;
+    m[std::string(100, 'x')] = 2;
+    EXPECT_TRUE(m.contains(std::string_view("hello")));
+    EXPECT_EQ(m.find("hello")->second, 1);
+    EXPECT_EQ(m.at(std::string_view(std::string(100, 'x'))), 2);
+    EXPECT_EQ(m.erase("hello"), 1);
+    EXPECT_EQ(m.size(), 1);
+
+    //  非平凡重定位的值在扩容时被正确搬移
+    for (auto i = 0; i < 1000; ++i) {
+        m[std::to_string(i)] = i;
+    }
+    EXPECT_EQ(m.at("999"), 999);
+
+    auto mr = monotonic_buffer_resource();
+    auto pm = flat_hash_map<int, int, std::hash<int>, std::equal_to<int>, polymorphic_allocator<pair<const int, int>>>(&mr);
+    for (auto i = 0; i < 100; ++i) {
+        pm[i] = i;
+    }
+    EXPECT_EQ(pm.get_allocator().resource(), &mr);
+    EXPECT_EQ(pm.at(99), 99);
+}
+
+//  拷贝或跨分配器移动时元素拷贝抛出异常不泄漏；跨分配器移动赋值使用源对象的哈希函数
+TEST(flat_hash_map_test, case_4) {
+    using M = flat_hash_map<int, fhm_value, fhm_hash, std::equal_to<int>, fhm_alloc<pair<const int, fhm_value>>>;
+    {
+        auto m = M(fhm_alloc<pair<const int, fhm_value>>(1));
+        for (auto i = 0; i < 20; ++i) {
+            m.emplace(i, i);
+        }
+        auto held = fhm_alloc<int>::outstanding;
+        for (auto fail = 1; fail <= 20; fail += 3) {
+            fhm_value::countdown = fail;
+            EXPECT_THROW(M(std::as_const(m)), std::runtime_error);
+            fhm_value::countdown = 0;
+            EXPECT_EQ(fhm_value::live, 20);
+            EXPECT_EQ(fhm_alloc<int>::outstanding, held);
+        }
+
+        auto other = M(fhm_alloc<pair<const int, fhm_value>>(2));
+        other.emplace(100, 100);
+        other = std::move(m);
+        EXPECT_EQ(other.size(), 20);
+        for (auto i = 0; i < 20; ++i) {
+            EXPECT_EQ(other.at(i).v, i);
+        }
+        EXPECT_FALSE(other.contains(100));
+    }
+    EXPECT_EQ(fhm_value::live, 0);
+    EXPECT_EQ(fhm_alloc<int>::outstanding, 0);
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "container/flat_map.hpp"
+#include "container/flat_set.hpp"
+#include "gtest/gtest.h"
+#include <map>
+#include <string>
+#include <string_view>
+
+using namespace mtl;
+
+//  flat_map 基本操作
+TEST(flat_map_test, case_1) {
+    auto m = flat_map<int, std::string>{{3, "c"}, {1, "a"}, {2, "b"}, {1, "x"}};
+    EXPECT_EQ(m.size(), 3);
+    EXPECT_EQ(m.keys(), (vector<int>{1, 2, 3}));
+    EXPECT_EQ(m.at(1), "a");
+    EXPECT_EQ(m.begin()->second, "a");
+    EXPECT_EQ((*(m.end() - 1)).first, 3);
+
+    EXPECT_FALSE(m.insert({2, "y"}).second);
+    EXPECT_TRUE(m.try_emplace(0, "z").second);
+    m[5] = "e";
+    EXPECT_FALSE(m.insert_or_assign(5, "f").second);
+    EXPECT_EQ(m.at(5), "f");
+    EXPECT_EQ(m.begin()->first, 0);
+    EXPECT_THROW(m.at(4), std::out_of_range);
+
+    EXPECT_EQ(m.lower_bound(4)->first, 5);
+    EXPECT_EQ(m.upper_bound(3)->first, 5);
+    auto [f, l] = m.equal_range(2);
+    EXPECT_EQ(l - f, 1);
+    EXPECT_EQ(m.find(4), m.end());
+    EXPECT_TRUE(m.contains(3));
+
+    EXPECT_EQ(m.erase(3), 1);
+    m.erase(m.begin());
+    EXPECT_EQ(m.keys(), (vector<int>{1, 2, 5}));
+    EXPECT_EQ(erase_if(m, [](auto p) { return p.first == 2; }), 1);
+    EXPECT_EQ(m.values(), (vector<std::string>{"a", "f"}));
+
+    for (auto [k, v] : m) {
+        v += "!";
+    }
+    EXPECT_EQ(m.at(1), "a!");
+
+    auto m2 = m;
+    EXPECT_EQ(m, m2);
+    m2[0] = "0";
+    EXPECT_TRUE(m2 < m);
+
+    auto c = std::move(m2).extract();
+    EXPECT_EQ(c.keys.size(), 3);
+    EXPECT_TRUE(m2.empty());
+}
+
+//  批量插入，与 std::map 对照
+TEST(flat_map_test, case_2) {
+    auto m = flat_map<int, int>();
+    auto ref = std::map<int, int>();
+    auto x = 1u;
+    for (auto round = 0; round < 20; ++round) {
+        auto batch = vector<pair<int, int>>();
+        for (auto i = 0; i < 200; ++i) {
+            x = x * 1103515245u + 12345u;
+            batch.push_back({static_cast<int>(x >> 20) % 3000, round});
+        }
+        m.insert(batch.begin(), batch.end());
+        for (auto &[k, v] : batch) {
+            ref.insert({k, v});
+        }
+    }
+    EXPECT_EQ(m.size(), ref.size());
+    auto it = m.begin();
+    for (auto &[k, v] : ref) {
+        EXPECT_EQ(it->first, k);
+        EXPECT_EQ(it->second, v);
+        ++it;
+    }
+
+    //  已排序输入
+    auto s = flat_map<int, int>();
+    s.insert(sorted_unique, {{1, 1}, {3, 3}});
+    s.insert(sorted_unique, {{5, 5}, {7, 7}});
+    s.insert(sorted_unique, {{0, 0}, {3, 30}, {4, 4}});
+    EXPECT_EQ(s.keys(), (vector<int>{0, 1, 3, 4, 5, 7}));
+    EXPECT_EQ(s.at(3), 3);
+
+    auto t = flat_map<int, int>(vector<int>{2, 1, 2}, vector<int>{20, 10, 21});
+    EXPECT_EQ(t.values(), (vector<int>{10, 20}));
+}
+
+//  flat_set 与异构查找
+TEST(flat_map_test, case_3) {
+    auto s = flat_set<int>{5, 1, 3, 3, 9};
+    EXPECT_EQ(s.size(), 4);
+    EXPECT_EQ(*s.begin(), 1);
+    EXPECT_FALSE(s.insert(5).second);
+    EXPECT_EQ(*s.insert(4).first, 4);
+    s.insert({10, 2, 2, 8});
+    EXPECT_EQ(s, (flat_set<int>{1, 2, 3, 4, 5, 8, 9, 10}));
+    s.insert(sorted_unique, {11, 12});
+    EXPECT_EQ(*s.rbegin(), 12);
+    EXPECT_EQ(*s.lower_bound(6), 8);
+    EXPECT_EQ(*s.upper_bound(8), 9);
+    EXPECT_EQ(s.erase(8), 1);
+    EXPECT_EQ(erase_if(s, [](int v) { return v % 2 == 0; }), 4);
+    EXPECT_EQ(s, (flat_set<int>{1, 3, 5, 9, 11}));
+
+    auto names = flat_set<std::string, std::less<>>{"b", "a"};
+    EXPECT_TRUE(names.contains(std::string_view("a")));
+    EXPECT_EQ(names.find("c"), names.end());
+    auto ages = flat_map<std::string, int, std::less<>>{{"x", 1}};
+    EXPECT_EQ(ages.at(std::string_view("x")), 1);
+    EXPECT_EQ(ages.erase("x"), 1);
+}
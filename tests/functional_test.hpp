@@ -79,4 +79,24 @@ TEST(function_test, case_6) {
     EXPECT_EQ(f2(), 10);
     EXPECT_EQ(f3(), 10);
     EXPECT_THROW(f1(), bad_function_call);
-}
\ No newline at end of file
+}
+
+//  function_ref 引用可调用对象、函数指针，不复制对象
+TEST(function_ref_test, case_1) {
+    struct counter {
+        auto operator()(int x) -> int { return m_sum += x; }
+
+        int m_sum{0};
+    };
+    auto c = counter();
+    auto r = function_ref<int(int)>(c);
+    r(1);
+    auto r2 = r;
+    EXPECT_EQ(r2(2), 3);
+    EXPECT_EQ(c.m_sum, 3);
+
+    auto r3 = function_ref<long(int)>(+[](int x) { return x * 2; });
+    EXPECT_EQ(r3(21), 42);
+    const auto k = [](int x) { return x + 1; };
+    EXPECT_EQ(function_ref<int(int)>(k)(1), 2);
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include "concurrency/future.hpp"
+#include "concurrency/thread_pool.hpp"
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace mtl;
+
+//  promise / future：值、引用、异常、跨线程阻塞等待与错误用法
+TEST(future_test, case_1) {
+    auto p = promise<std::string>();
+    auto f = p.get_future();
+    EXPECT_THROW(p.get_future(), future_error);
+    EXPECT_FALSE(f.is_ready());
+    auto t = std::thread([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        p.set_value("ready");
+    });
+    EXPECT_EQ(f.get(), "ready");
+    t.join();
+    EXPECT_FALSE(f.valid());
+    EXPECT_THROW(f.get(), future_error);
+    EXPECT_THROW(p.set_value("again"), future_error);
+
+    auto x = 1;
+    auto r = promise<int &>();
+    r.set_value(x);
+    EXPECT_EQ(&r.get_future().get(), &x);
+
+    auto e = promise<void>();
+    auto fe = e.get_future();
+    e.set_exception(std::make_exception_ptr(std::runtime_error("error")));
+    EXPECT_THROW(fe.get(), std::runtime_error);
+
+    auto broken = future<int>();
+    {
+        auto b = promise<int>();
+        broken = b.get_future();
+    }
+    EXPECT_THROW(broken.get(), broken_promise);
+}
+
+//  then：就绪前后挂载、异常跳过续延、void、链式调用与在执行器上执行
+TEST(future_test, case_2) {
+    auto p = promise<int>();
+    auto f = p.get_future().then([](int x) { return x * 2; }).then([](int x) { return std::to_string(x); });
+    EXPECT_FALSE(f.is_ready());
+    p.set_value(21);
+    EXPECT_TRUE(f.is_ready());
+    EXPECT_EQ(f.get(), "42");
+
+    auto calls = 0;
+    auto g = make_ready_future(1).then([&](int) { ++calls; }).then([&] {
+        ++calls;
+        return calls;
+    });
+    EXPECT_EQ(g.get(), 2);
+
+    auto skipped = false;
+    auto h = make_exceptional_future<int>(std::make_exception_ptr(std::runtime_error("error"))).then([&](int x) {
+        skipped = true;
+        return x;
+    });
+    EXPECT_THROW(h.get(), std::runtime_error);
+    EXPECT_FALSE(skipped);
+    EXPECT_THROW(make_ready_future().then([]() -> int { throw std::logic_error("then"); }).get(), std::logic_error);
+
+    auto pool = thread_pool(2);
+    auto q = promise<int>();
+    auto on_pool = q.get_future().then(pool, [&](int x) { return thread_pool::current() == &pool ? x : -1; });
+    q.set_value(7);
+    EXPECT_EQ(on_pool.get(), 7);
+    EXPECT_EQ(pool.submit([] { return 1; }).then(pool, [](int x) { return x + 1; }).get(), 2);
+}
+
+//  when_all / when_any：迭代器与可变参数两种形式，输入在其他线程上就绪
+TEST(future_test, case_3) {
+    auto pool = thread_pool(4);
+    auto fs = vector<future<int>>();
+    for (auto i = 0; i < 100; ++i) {
+        fs.push_back(pool.submit([i] { return i; }));
+    }
+    auto all = when_all(fs.begin(), fs.end()).get();
+    auto sum = 0;
+    for (auto &f : all) {
+        sum += f.get();
+    }
+    EXPECT_EQ(sum, 4950);
+
+    auto p = promise<std::string>();
+    auto both = when_all(make_ready_future(1), p.get_future());
+    EXPECT_FALSE(both.is_ready());
+    p.set_value("x");
+    auto t = both.get();
+    EXPECT_EQ(get<0>(t).get(), 1);
+    EXPECT_EQ(get<1>(t).get(), "x");
+
+    auto slow = promise<int>();
+    auto any = when_any(slow.get_future(), pool.submit([] { return std::string("fast"); })).get();
+    EXPECT_EQ(any.index, 1);
+    EXPECT_EQ(get<1>(any.futures).get(), "fast");
+    slow.set_value(0);
+    EXPECT_EQ(get<0>(any.futures).get(), 0);
+
+    auto none = vector<future<int>>();
+    EXPECT_EQ(when_all(none.begin(), none.end()).get().size(), 0);
+    EXPECT_EQ(when_any(none.begin(), none.end()).get().index, size_t(-1));
+}
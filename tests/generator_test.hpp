@@ -0,0 +1,75 @@
+#pragma once
+#include "coroutine/generator.hpp"
+#include "gtest/gtest.h"
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace mtl;
+
+namespace {
+    auto gen_iota(int n) -> generator<int> {
+        for (auto i = 0; i < n; ++i) {
+            co_yield i;
+        }
+    }
+
+    auto gen_words() -> generator<std::string> {
+        auto s = std::string("a");
+        co_yield s;
+        co_yield s + "b";
+        co_yield std::string("abc");
+    }
+
+    auto gen_refs(std::vector<int> &v) -> generator<int &> {
+        for (auto &x : v) {
+            co_yield x;
+        }
+    }
+
+    auto gen_throw() -> generator<int> {
+        co_yield 1;
+        throw std::runtime_error("generator");
+    }
+} // namespace
+
+//  基本迭代与 views 流水线
+TEST(generator_test, case_1) {
+    static_assert(std::ranges::input_range<generator<int>> && std::ranges::view<generator<int>>);
+    auto v = std::vector<int>();
+    for (auto x : gen_iota(5)) {
+        v.push_back(x);
+    }
+    EXPECT_EQ(v, (std::vector<int>{0, 1, 2, 3, 4}));
+
+    auto out = std::vector<int>();
+    for (auto x : gen_iota(100) | std::views::filter([](int x) { return x % 3 == 0; }) | std::views::transform([](int x) { return x * x; }) | std::views::take(4)) {
+        out.push_back(x);
+    }
+    EXPECT_EQ(out, (std::vector<int>{0, 9, 36, 81}));
+
+    auto words = std::vector<std::string>();
+    for (auto &w : gen_words()) {
+        words.push_back(w);
+    }
+    EXPECT_EQ(words, (std::vector<std::string>{"a", "ab", "abc"}));
+}
+
+//  引用产出、异常、提前销毁
+TEST(generator_test, case_2) {
+    auto v = std::vector<int>{1, 2, 3};
+    for (auto &x : gen_refs(v)) {
+        x *= 10;
+    }
+    EXPECT_EQ(v, (std::vector<int>{10, 20, 30}));
+
+    auto g = gen_throw();
+    auto it = g.begin();
+    EXPECT_EQ(*it, 1);
+    EXPECT_THROW(++it, std::runtime_error);
+    EXPECT_TRUE(it == std::default_sentinel);
+
+    auto partial = gen_iota(1000);
+    EXPECT_EQ(*partial.begin(), 0);
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include "concurrency/hazard_pointer.hpp"
+#include "gtest/gtest.h"
+#include <thread>
+#include <vector>
+
+using namespace mtl;
+
+namespace {
+    struct hp_object : hazard_pointer_obj_base<hp_object> {
+        explicit hp_object(int v) : a(v), b(v) { live.fetch_add(1); }
+
+        ~hp_object() {
+            a = b = -1;
+            live.fetch_sub(1);
+        }
+
+        int a, b;
+        inline static std::atomic<int> live{0};
+    };
+
+    struct counting_delete {
+        template <typename T>
+        auto operator()(T *p) const -> void {
+            ++*count;
+            delete p;
+        }
+
+        int *count;
+    };
+
+    struct hp_counted : hazard_pointer_obj_base<hp_counted, counting_delete> {};
+} // namespace
+
+//  被保护的对象退休后不会被回收，保护解除后由 cleanup 回收
+TEST(hazard_pointer_test, case_1) {
+    auto domain = hazard_pointer_domain();
+    auto src = std::atomic<hp_object *>(new hp_object(1));
+    {
+        auto h = make_hazard_pointer(domain);
+        EXPECT_FALSE(h.empty());
+        auto p = h.protect(src);
+        EXPECT_EQ(p->a, 1);
+
+        src.store(new hp_object(2));
+        p->retire(default_delete<hp_object>(), domain);
+        domain.cleanup();
+        EXPECT_EQ(hp_object::live.load(), 2);
+        EXPECT_EQ(p->a, 1);
+
+        // try_protect 失败时更新为当前值
+        auto q = p;
+        EXPECT_FALSE(h.try_protect(q, src));
+        EXPECT_EQ(q, src.load());
+        EXPECT_TRUE(h.try_protect(q, src));
+
+        auto moved = std::move(h);
+        EXPECT_TRUE(h.empty());
+        moved.reset_protection();
+        domain.cleanup();
+        EXPECT_EQ(hp_object::live.load(), 1);
+    }
+
+    // 删除器保存在对象内部；超过阈值后自动扫描
+    auto count = 0;
+    for (auto i = 0; i < 1000; ++i) {
+        (new hp_counted())->retire(counting_delete{&count}, domain);
+    }
+    EXPECT_GT(count, 0);
+    src.load()->retire(default_delete<hp_object>(), domain);
+    domain.cleanup();
+    EXPECT_EQ(count, 1000);
+    EXPECT_EQ(hp_object::live.load(), 0);
+}
+
+//  读者与写者并发：读到的对象总是完整的，线程退出后留下的对象也会被回收
+TEST(hazard_pointer_test, case_2) {
+    {
+        auto src = std::atomic<hp_object *>(new hp_object(0));
+        auto stop = std::atomic<bool>(false);
+        auto torn = std::atomic<int>(0);
+        auto threads = std::vector<std::thread>();
+        for (auto i = 0; i < 4; ++i) {
+            threads.emplace_back([&] {
+                while (!stop.load(std::memory_order_relaxed)) {
+                    auto h = make_hazard_pointer();
+                    auto p = h.protect(src);
+                    if (p->a != p->b || p->a < 0) {
+                        torn.fetch_add(1);
+                    }
+                }
+            });
+        }
+        for (auto w = 0; w < 2; ++w) {
+            threads.emplace_back([&, w] {
+                for (auto i = 1; i <= 20'000; ++i) {
+                    auto old = src.exchange(new hp_object(i * 2 + w));
+                    old->retire();
+                }
+            });
+        }
+        threads[5].join();
+        threads[4].join();
+        stop = true;
+        for (auto i = 0; i < 4; ++i) {
+            threads[i].join();
+        }
+        EXPECT_EQ(torn.load(), 0);
+        src.load()->retire();
+    }
+    hazard_pointer_default_domain().cleanup();
+    EXPECT_EQ(hp_object::live.load(), 0);
+}
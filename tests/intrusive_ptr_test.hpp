@@ -0,0 +1,120 @@
+#pragma once
+#include "utility/intrusive_ptr.hpp"
+#include "gtest/gtest.h"
+#include <thread>
+#include <vector>
+
+using namespace mtl;
+
+namespace {
+    struct intrusive_base : intrusive_ref_counter<intrusive_base> {
+        virtual ~intrusive_base() { ++destroyed; }
+
+        inline static int destroyed = 0;
+    };
+
+    struct intrusive_derived : intrusive_base {
+        explicit intrusive_derived(int v) : value(v) {}
+
+        int value;
+    };
+
+    struct local_node : intrusive_ref_counter<local_node, thread_unsafe_counter> {
+        int value{0};
+    };
+
+    // 不继承 intrusive_ref_counter，自己提供钩子
+    struct handle {
+        int refs{0};
+        bool closed{false};
+    };
+
+    auto add_ref(handle *h) noexcept -> void { ++h->refs; }
+
+    auto release(handle *h) noexcept -> void {
+        if (--h->refs == 0) {
+            h->closed = true;
+        }
+    }
+} // namespace
+
+//  计数、转换、比较与 unique_ptr 互操作
+TEST(intrusive_ptr_test, case_1) {
+    static_assert(sizeof(intrusive_ptr<intrusive_base>) == sizeof(void *));
+    static_assert(sizeof(local_node) == 2 * sizeof(size_t));
+    intrusive_base::destroyed = 0;
+    {
+        auto d = make_intrusive<intrusive_derived>(1);
+        EXPECT_EQ(d->use_count(), 1);
+        auto b = intrusive_ptr<intrusive_base>(d);
+        EXPECT_EQ(d->use_count(), 2);
+        EXPECT_TRUE(b == d);
+        auto back = dynamic_pointer_cast<intrusive_derived>(b);
+        EXPECT_EQ(back->value, 1);
+        EXPECT_EQ(d->use_count(), 3);
+
+        // 从原始指针重新得到 intrusive_ptr 仍然共享同一个计数
+        auto raw = intrusive_ptr<intrusive_derived>(d.get());
+        EXPECT_EQ(d->use_count(), 4);
+
+        auto other = make_intrusive<intrusive_derived>(2);
+        EXPECT_TRUE((b < other) == (b.get() < static_cast<intrusive_base *>(other.get())));
+        other.swap(raw);
+        EXPECT_EQ(raw->value, 2);
+        EXPECT_EQ(intrusive_base::destroyed, 0);
+    }
+    EXPECT_EQ(intrusive_base::destroyed, 2);
+
+    auto u = make_unique<intrusive_derived>(3);
+    auto p = intrusive_ptr<intrusive_base>(std::move(u));
+    EXPECT_FALSE(u);
+    EXPECT_EQ(p->use_count(), 1);
+    auto raw = p.detach();
+    EXPECT_FALSE(p);
+    EXPECT_EQ(raw->use_count(), 1);
+    p.reset(raw, false);
+    EXPECT_EQ(p->use_count(), 1);
+    p = nullptr;
+    EXPECT_EQ(intrusive_base::destroyed, 3);
+
+    auto n = make_intrusive<local_node>();
+    auto m = n;
+    EXPECT_EQ(n->use_count(), 2);
+    // 复制对象不复制计数
+    auto copy = local_node(*n);
+    EXPECT_EQ(copy.use_count(), 0);
+}
+
+//  自定义钩子
+TEST(intrusive_ptr_test, case_2) {
+    auto h = handle();
+    {
+        auto p = intrusive_ptr<handle>(&h);
+        auto q = p;
+        EXPECT_EQ(h.refs, 2);
+    }
+    EXPECT_EQ(h.refs, 0);
+    EXPECT_TRUE(h.closed);
+}
+
+//  多线程复制与释放同一个对象
+TEST(intrusive_ptr_test, case_3) {
+    intrusive_base::destroyed = 0;
+    {
+        auto p = make_intrusive<intrusive_derived>(0);
+        auto threads = std::vector<std::thread>();
+        for (auto i = 0; i < 4; ++i) {
+            threads.emplace_back([p] {
+                for (auto j = 0; j < 100'000; ++j) {
+                    auto q = p;
+                    auto r = std::move(q);
+                }
+            });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+        EXPECT_EQ(p->use_count(), 1);
+    }
+    EXPECT_EQ(intrusive_base::destroyed, 1);
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "utility/local_shared_ptr.hpp"
+#include "gtest/gtest.h"
+#include <string>
+#include <thread>
+
+using namespace mtl;
+
+namespace {
+    struct local_base {
+        virtual ~local_base() { ++destroyed; }
+
+        inline static int destroyed = 0;
+    };
+
+    struct local_derived : local_base {
+        explicit local_derived(std::string s) : name(std::move(s)) {}
+
+        std::string name;
+    };
+} // namespace
+
+//  计数、派生类到基类的转换、别名构造、删除器与 unique_ptr
+TEST(local_shared_ptr_test, case_1) {
+    local_base::destroyed = 0;
+    {
+        auto d = make_local_shared<local_derived>("obj");
+        EXPECT_EQ(d->name, "obj");
+        auto b = local_shared_ptr<local_base>(d);
+        EXPECT_EQ(d.use_count(), 2);
+        auto name = local_shared_ptr<std::string>(d, &d->name);
+        EXPECT_EQ(*name, "obj");
+        EXPECT_EQ(b.use_count(), 3);
+        d.reset();
+        b.reset();
+        EXPECT_EQ(local_base::destroyed, 0);
+    }
+    EXPECT_EQ(local_base::destroyed, 1);
+
+    auto deleted = 0;
+    {
+        auto p = local_shared_ptr<int>(new int(1), [&](int *p) {
+            ++deleted;
+            delete p;
+        });
+        auto q = p;
+        EXPECT_TRUE(p == q);
+    }
+    EXPECT_EQ(deleted, 1);
+
+    auto u = make_unique<local_derived>("unique");
+    auto s = local_shared_ptr<local_base>(std::move(u));
+    EXPECT_FALSE(u);
+    EXPECT_EQ(s.use_count(), 1);
+    auto arr = local_shared_ptr<int[]>(new int[4]{1, 2, 3, 4});
+    EXPECT_EQ(arr[3], 4);
+}
+
+//  local_weak_ptr
+TEST(local_shared_ptr_test, case_2) {
+    auto w = local_weak_ptr<local_derived>();
+    EXPECT_TRUE(w.expired());
+    {
+        auto p = make_local_shared<local_derived>("weak");
+        w = p;
+        EXPECT_EQ(w.use_count(), 1);
+        EXPECT_EQ(w.lock()->name, "weak");
+        auto b = local_weak_ptr<local_base>(w);
+        EXPECT_FALSE(b.expired());
+    }
+    EXPECT_TRUE(w.expired());
+    EXPECT_FALSE(w.lock());
+    EXPECT_THROW(auto p = local_shared_ptr<local_derived>(w), bad_weak_ptr);
+}
+
+//  share：只有唯一的所有者可以转换，转换后可以交给其他线程释放
+TEST(local_shared_ptr_test, case_3) {
+    local_base::destroyed = 0;
+    auto p = make_local_shared<local_derived>("escape");
+    auto q = p;
+    EXPECT_THROW(std::move(p).share(), bad_local_share);
+    q.reset();
+    auto w = local_weak_ptr<local_derived>(p);
+    EXPECT_THROW(std::move(p).share(), bad_local_share);
+    w.reset();
+
+    auto s = std::move(p).share();
+    EXPECT_FALSE(p);
+    EXPECT_EQ(s->name, "escape");
+    auto t = std::thread([s = std::move(s)]() mutable { s.reset(); });
+    t.join();
+    EXPECT_EQ(local_base::destroyed, 1);
+}
@@ -1,9 +1,34 @@
 #include "any_test.hpp"
+#include "atomic_shared_ptr_test.hpp"
 #include "bitset_test.hpp"
+#include "eytzinger_test.hpp"
+#include "flat_hash_map_test.hpp"
+#include "flat_map_test.hpp"
 #include "functional_test.hpp"
+#include "future_test.hpp"
+#include "generator_test.hpp"
+#include "hazard_pointer_test.hpp"
+#include "intrusive_ptr_test.hpp"
+#include "local_shared_ptr_test.hpp"
+#include "memory_resource_test.hpp"
+#include "memory_test.hpp"
+#include "mpmc_queue_test.hpp"
+#include "mutex_test.hpp"
 #include "optional_test.hpp"
 #include "pair_test.hpp"
+#include "parallel_test.hpp"
+#include "pool_allocator_test.hpp"
+#include "rcu_test.hpp"
+#include "relocation_test.hpp"
 #include "shared_ptr_test.hpp"
+#include "slot_map_test.hpp"
+#include "small_vector_test.hpp"
+#include "spsc_ring_test.hpp"
+#include "string_test.hpp"
+#include "symbol_test.hpp"
+#include "task_test.hpp"
+#include "thread_pool_test.hpp"
+#include "vector_test.hpp"
 
 auto main(int argc, char *argv[]) -> int {
     testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,101 @@
+#pragma once
+#include "utility/memory_resource.hpp"
+#include "gtest/gtest.h"
+
+using namespace mtl;
+
+//  统计上游分配次数
+class counting_resource : public memory_resource {
+  public:
+    size_t allocs = 0;
+    size_t deallocs = 0;
+
+  private:
+    auto do_allocate(size_t bytes, size_t alignment) -> void * override {
+        ++allocs;
+        return new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    auto do_deallocate(void *p, size_t bytes, size_t alignment) -> void override {
+        ++deallocs;
+        new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    auto do_is_equal(const memory_resource &other) const noexcept -> bool override { return this == &other; }
+};
+
+//  monotonic_buffer_resource
+TEST(memory_resource_test, case_1) {
+    auto upstream = counting_resource();
+    char buf[64];
+    {
+        auto mr = monotonic_buffer_resource(buf, sizeof(buf), &upstream);
+        //  初始缓冲区
+        auto p1 = mr.allocate(16, 8);
+        auto p2 = mr.allocate(16, 16);
+        EXPECT_GE(static_cast<char *>(p1), buf);
+        EXPECT_LT(static_cast<char *>(p2), buf + sizeof(buf));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p2) % 16, 0);
+        EXPECT_EQ(upstream.allocs, 0);
+
+        //  超出初始缓冲区
+        for (auto i = 0; i < 1000; ++i) {
+            auto p = static_cast<int *>(mr.allocate(sizeof(int), alignof(int)));
+            *p = i;
+        }
+        EXPECT_GT(upstream.allocs, 0);
+        EXPECT_LT(upstream.allocs, 10);
+
+        //  release 后重新使用初始缓冲区
+        mr.release();
+        EXPECT_EQ(upstream.allocs, upstream.deallocs);
+        EXPECT_EQ(mr.allocate(8), buf);
+    }
+    EXPECT_EQ(upstream.allocs, upstream.deallocs);
+}
+
+//  pool resource
+TEST(memory_resource_test, case_2) {
+    auto upstream = counting_resource();
+    {
+        auto mr = unsynchronized_pool_resource(pool_options{.largest_required_pool_block = 256}, &upstream);
+        auto p1 = mr.allocate(24);
+        mr.deallocate(p1, 24);
+        auto p2 = mr.allocate(32);
+        EXPECT_EQ(p1, p2);
+        auto p3 = mr.allocate(64, 64);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p3) % 64, 0);
+
+        //  大对象直接交给上游
+        auto allocs = upstream.allocs;
+        auto big = mr.allocate(1000, 128);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(big) % 128, 0);
+        EXPECT_EQ(upstream.allocs, allocs + 1);
+        mr.deallocate(big, 1000, 128);
+        EXPECT_EQ(upstream.deallocs, 1);
+        static_cast<void>(mr.allocate(2000));
+    }
+    EXPECT_EQ(upstream.allocs, upstream.deallocs);
+
+    auto sync = synchronized_pool_resource(&upstream);
+    auto p = sync.allocate(10);
+    sync.deallocate(p, 10);
+}
+
+//  polymorphic_allocator
+TEST(memory_resource_test, case_3) {
+    auto mr = monotonic_buffer_resource();
+    auto alloc = polymorphic_allocator<int>(&mr);
+    auto p = allocator_traits<polymorphic_allocator<int>>::allocate(alloc, 10);
+    allocator_traits<polymorphic_allocator<int>>::construct(alloc, p, 10);
+    EXPECT_EQ(*p, 10);
+    alloc.deallocate(p, 10);
+
+    auto s = alloc.new_object<std::string>("hello");
+    EXPECT_EQ(*s, "hello");
+    alloc.delete_object(s);
+
+    EXPECT_TRUE(alloc == polymorphic_allocator<double>(&mr));
+    EXPECT_FALSE(alloc == polymorphic_allocator<int>());
+    EXPECT_EQ(polymorphic_allocator<int>().resource(), get_default_resource());
+}
@@ -0,0 +1,157 @@
+#pragma once
+#include "utility/memory.hpp"
+#include "utility/memory_resource.hpp"
+#include "utility/pool_allocator.hpp"
+#include "gtest/gtest.h"
+#include <list>
+
+using namespace mtl;
+
+//  allocator_traits 类型成员
+TEST(memory_test, case_1) {
+    using traits = allocator_traits<allocator<int>>;
+    static_assert(std::is_same_v<traits::pointer, int *>);
+    static_assert(std::is_same_v<traits::const_pointer, const int *>);
+    static_assert(std::is_same_v<traits::size_type, size_t>);
+    static_assert(std::is_same_v<traits::rebind_alloc<double>, allocator<double>>);
+    static_assert(std::is_same_v<traits::rebind_traits<double>::value_type, double>);
+    static_assert(!traits::propagate_on_container_copy_assignment::value);
+    static_assert(traits::propagate_on_container_move_assignment::value);
+    static_assert(!traits::propagate_on_container_swap::value);
+    static_assert(traits::is_always_equal::value);
+
+    //  rebind 成员模板
+    static_assert(std::is_same_v<allocator_traits<pool_allocator<int, 4096>>::rebind_alloc<char>, pool_allocator<char, 4096>>);
+
+    //  有状态分配器
+    using ptraits = allocator_traits<polymorphic_allocator<int>>;
+    static_assert(std::is_same_v<ptraits::rebind_alloc<char>, polymorphic_allocator<char>>);
+    static_assert(!ptraits::is_always_equal::value);
+    static_assert(!ptraits::propagate_on_container_move_assignment::value);
+}
+
+//  allocate_at_least
+TEST(memory_test, case_2) {
+    auto a = allocator<char>();
+    auto [p, n] = allocator_traits<allocator<char>>::allocate_at_least(a, 13);
+    EXPECT_GE(n, 13);
+    for (auto i = size_t{0}; i < n; ++i) {
+        p[i] = 'a';
+    }
+    a.deallocate(p, n);
+
+    //  分配器未提供 allocate_at_least 时返回请求的数量
+    auto pa = polymorphic_allocator<int>();
+    auto [q, m] = allocator_traits<polymorphic_allocator<int>>::allocate_at_least(pa, 13);
+    EXPECT_EQ(m, 13);
+    pa.deallocate(q, m);
+
+    EXPECT_EQ(allocator_traits<polymorphic_allocator<int>>::max_size(pa), std::numeric_limits<size_t>::max() / sizeof(int));
+
+    //  超对齐类型
+    struct alignas(64) over {
+        char c;
+    };
+    auto oa = allocator<over>();
+    auto o = oa.allocate(3);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(o) % 64, 0);
+    oa.deallocate(o, 3);
+}
+
+//  记录构造、析构次数
+struct counted {
+    counted() { ++ctor; }
+    counted(int v) : val(v) { ++ctor; }
+    counted(const counted &o) : val(o.val) { ++ctor; }
+    counted(counted &&o) noexcept : val(o.val) {
+        ++ctor;
+        o.val = -1;
+    }
+    ~counted() { ++dtor; }
+    int val = 0;
+    inline static int ctor = 0;
+    inline static int dtor = 0;
+};
+
+//  构造过程中抛出异常
+struct throwing {
+    throwing(int v) : val(v) {}
+    throwing(const throwing &o) : val(o.val) {
+        if (o.val == 3) {
+            throw std::exception();
+        }
+        ++live;
+    }
+    ~throwing() { --live; }
+    int val;
+    inline static int live = 0;
+};
+
+//  uninitialized 算法
+TEST(memory_test, case_3) {
+    //  平凡类型
+    int src[5] = {1, 2, 3, 4, 5};
+    int dst[5];
+    EXPECT_EQ(uninitialized_copy(src, src + 5, dst), dst + 5);
+    EXPECT_TRUE(std::equal(src, src + 5, dst));
+    uninitialized_fill(dst, dst + 5, 0);
+    EXPECT_EQ(std::count(dst, dst + 5, 0), 5);
+    uninitialized_fill_n(dst, 3, 7);
+    EXPECT_EQ(dst[2], 7);
+    uninitialized_value_construct(dst, dst + 5);
+    EXPECT_EQ(std::count(dst, dst + 5, 0), 5);
+
+    //  非连续迭代器
+    auto lst = std::list<int>{1, 2, 3};
+    EXPECT_EQ(mtl::uninitialized_copy_n(lst.begin(), 3, dst), dst + 3);
+    EXPECT_EQ(dst[2], 3);
+
+    //  非平凡类型
+    auto mem = allocator<counted>().allocate(10);
+    counted::ctor = counted::dtor = 0;
+    uninitialized_value_construct_n(mem, 5);
+    uninitialized_fill(mem + 5, mem + 10, counted(3));
+    EXPECT_EQ(counted::ctor, 11);
+    EXPECT_EQ(mem[9].val, 3);
+    destroy_n(mem, 10);
+    EXPECT_EQ(counted::dtor, 11);
+    allocator<counted>().deallocate(mem, 10);
+
+    //  异常时销毁已构造元素
+    throwing tsrc[5] = {1, 2, 3, 4, 5};
+    auto tmem = allocator<throwing>().allocate(5);
+    throwing::live = 0;
+    EXPECT_THROW(uninitialized_copy(tsrc, tsrc + 5, tmem), std::exception);
+    EXPECT_EQ(throwing::live, 0);
+    allocator<throwing>().deallocate(tmem, 5);
+}
+
+//  重定位
+TEST(memory_test, case_4) {
+    //  平凡类型，区间重叠
+    int arr[6] = {1, 2, 3, 4, 5, 0};
+    EXPECT_EQ(uninitialized_relocate_backward(arr, arr + 5, arr + 6), arr + 1);
+    EXPECT_EQ(arr[1], 1);
+    EXPECT_EQ(arr[5], 5);
+    EXPECT_EQ(uninitialized_relocate(arr + 1, arr + 6, arr), arr + 5);
+    EXPECT_EQ(arr[0], 1);
+    EXPECT_EQ(arr[4], 5);
+
+    //  非平凡类型：移动构造并销毁源对象
+    auto a = allocator<counted>();
+    auto src = a.allocate(4);
+    auto dst = a.allocate(4);
+    uninitialized_fill_n(src, 4, counted(9));
+    counted::ctor = counted::dtor = 0;
+    uninitialized_relocate(src, src + 4, dst);
+    EXPECT_EQ(counted::ctor, 4);
+    EXPECT_EQ(counted::dtor, 4);
+    EXPECT_EQ(dst[3].val, 9);
+    destroy(dst, dst + 4);
+    a.deallocate(src, 4);
+    a.deallocate(dst, 4);
+
+    static_assert(is_trivially_relocatable_v<int>);
+    static_assert(is_trivially_relocatable_v<const int[3]>);
+    static_assert(!is_trivially_relocatable_v<counted>);
+}
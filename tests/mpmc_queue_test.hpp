@@ -0,0 +1,98 @@
+#pragma once
+#include "concurrency/mpmc_queue.hpp"
+#include "utility/unique_ptr.hpp"
+#include "gtest/gtest.h"
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mtl;
+
+//  单线程语义
+TEST(mpmc_queue_test, case_1) {
+    auto q = mpmc_queue<std::string>(3);
+    EXPECT_EQ(q.capacity(), 4);
+    EXPECT_TRUE(q.empty());
+    EXPECT_TRUE(q.try_push("a"));
+    EXPECT_TRUE(q.try_emplace(2, 'b'));
+    q.push("c");
+    EXPECT_TRUE(q.try_push("d"));
+    EXPECT_FALSE(q.try_push("e"));
+    EXPECT_EQ(q.size(), 4);
+
+    EXPECT_EQ(*q.try_pop(), "a");
+    auto s = std::string();
+    EXPECT_TRUE(q.try_pop(s));
+    EXPECT_EQ(s, "bb");
+    auto out = std::vector<std::string>(4);
+    EXPECT_EQ(q.try_pop_n(out.begin(), 4), 2);
+    EXPECT_EQ(out[0], "c");
+    EXPECT_EQ(out[1], "d");
+    EXPECT_FALSE(q.try_pop().has_value());
+    EXPECT_EQ(q.try_pop_n(out.begin(), 4), 0);
+
+    q.push("left in queue");
+    EXPECT_THROW(mpmc_queue<int>(0), std::invalid_argument);
+}
+
+//  只能移动的元素
+TEST(mpmc_queue_test, case_2) {
+    auto q = mpmc_queue<unique_ptr<int>>(8);
+    q.emplace(new int(1));
+    EXPECT_TRUE(q.try_push(unique_ptr<int>(new int(2))));
+    EXPECT_EQ(*q.pop(), 1);
+    auto p = q.try_pop();
+    EXPECT_EQ(**p, 2);
+}
+
+//  多生产者多消费者，阻塞与非阻塞混用，每个元素恰好被取出一次
+TEST(mpmc_queue_test, case_3) {
+    constexpr auto producers = 4;
+    constexpr auto consumers = 4;
+    constexpr auto per_producer = 20000;
+    auto q = mpmc_queue<int>(64);
+    auto seen = std::vector<std::atomic<int>>(producers * per_producer);
+    auto threads = std::vector<std::thread>();
+    for (auto p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (auto i = 0; i < per_producer; ++i) {
+                auto v = p * per_producer + i;
+                if (p % 2 == 0) {
+                    q.push(v);
+                } else {
+                    while (!q.try_push(v)) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        });
+    }
+    for (auto c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            constexpr auto quota = producers * per_producer / consumers;
+            auto got = 0;
+            int buf[8];
+            while (got < quota) {
+                if (c % 2 == 0) {
+                    seen[q.pop()].fetch_add(1);
+                    ++got;
+                } else {
+                    auto k = q.try_pop_n(buf, static_cast<size_t>(std::min(8, quota - got)));
+                    for (auto i = size_t{0}; i < k; ++i) {
+                        seen[buf[i]].fetch_add(1);
+                    }
+                    got += static_cast<int>(k);
+                    if (k == 0) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_TRUE(std::all_of(seen.begin(), seen.end(), [](auto &x) { return x.load() == 1; }));
+    EXPECT_TRUE(q.empty());
+}
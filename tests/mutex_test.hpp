@@ -0,0 +1,103 @@
+#pragma once
+#include "concurrency/mutex.hpp"
+#include "gtest/gtest.h"
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mtl;
+
+namespace {
+    // 多个线程在锁内对普通变量自增，结果正确说明互斥有效
+    template <typename Mutex>
+    auto mutex_count(int threads, int rounds) -> long long {
+        auto m = Mutex();
+        auto count = 0LL;
+        auto ts = std::vector<std::thread>();
+        for (auto i = 0; i < threads; ++i) {
+            ts.emplace_back([&] {
+                for (auto j = 0; j < rounds; ++j) {
+                    auto lock = std::lock_guard(m);
+                    ++count;
+                }
+            });
+        }
+        for (auto &t : ts) {
+            t.join();
+        }
+        return count;
+    }
+} // namespace
+
+//  spin_mutex / futex_mutex：大小、try_lock 与竞争下的互斥
+TEST(mutex_test, case_1) {
+    EXPECT_EQ(sizeof(spin_mutex), 1);
+    EXPECT_EQ(sizeof(futex_mutex), 4);
+
+    auto s = spin_mutex();
+    EXPECT_TRUE(s.try_lock());
+    EXPECT_FALSE(s.try_lock());
+    s.unlock();
+    auto f = futex_mutex();
+    {
+        auto lock = std::unique_lock(f);
+        EXPECT_FALSE(f.try_lock());
+    }
+    EXPECT_TRUE(f.try_lock());
+    f.unlock();
+
+    EXPECT_EQ(mutex_count<spin_mutex>(4, 20'000), 80'000);
+    EXPECT_EQ(mutex_count<futex_mutex>(4, 20'000), 80'000);
+}
+
+//  futex_mutex：持锁较久时等待者进入睡眠，解锁后被唤醒
+TEST(mutex_test, case_2) {
+    auto m = futex_mutex();
+    auto order = std::vector<int>();
+    m.lock();
+    auto t = std::thread([&] {
+        auto lock = std::lock_guard(m);
+        order.push_back(2);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    order.push_back(1);
+    m.unlock();
+    t.join();
+    EXPECT_EQ(order, (std::vector<int>{1, 2}));
+}
+
+//  seqlock：读者不会读到写入到一半的值
+TEST(mutex_test, case_3) {
+    struct point {
+        long long x, y, z;
+        int w;
+    };
+    auto sl = seqlock<point>(point{1, 1, 1, 1});
+    EXPECT_EQ(sl.load().z, 1);
+    sl.update([](point &p) { p.w = 2; });
+    EXPECT_EQ(sl.load().w, 2);
+    sl.store({0, 0, 0, 0});
+
+    auto stop = std::atomic<bool>(false);
+    auto torn = std::atomic<int>(0);
+    auto readers = std::vector<std::thread>();
+    for (auto i = 0; i < 3; ++i) {
+        readers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto p = sl.load();
+                if (p.x != p.y || p.y != p.z || p.z != p.w) {
+                    torn.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto i = 1; i <= 100'000; ++i) {
+        sl.store({i, i, i, i});
+    }
+    stop = true;
+    for (auto &t : readers) {
+        t.join();
+    }
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(sl.load().w, 100'000);
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include "concurrency/parallel.hpp"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mtl;
+
+//  for_each、transform、reduce、transform_reduce
+TEST(parallel_test, case_1) {
+    auto pool = thread_pool(4);
+    auto ex = par::pool_executor(pool);
+    auto v = std::vector<long long>(100'003);
+    std::iota(v.begin(), v.end(), 1);
+
+    par::for_each(ex, v.begin(), v.end(), [](long long &x) { x *= 2; });
+    EXPECT_EQ(v[0], 2);
+    EXPECT_EQ(v.back(), 200'006);
+
+    auto w = std::vector<long long>(v.size());
+    par::transform(ex, v.begin(), v.end(), w.begin(), [](long long x) { return x / 2; });
+    EXPECT_EQ(par::reduce(ex, w.begin(), w.end()), 100'003LL * 100'004 / 2);
+    EXPECT_EQ(par::reduce(w.begin(), w.end(), 0LL), 100'003LL * 100'004 / 2);
+    EXPECT_EQ(par::reduce(par::inline_executor(), w.begin(), w.end(), 5LL), 100'003LL * 100'004 / 2 + 5);
+
+    par::transform(ex, v.begin(), v.end(), w.begin(), w.begin(), [](long long a, long long b) { return a - b; });
+    EXPECT_EQ(w[10], 11);
+    EXPECT_EQ(par::transform_reduce(ex, w.begin(), w.end(), 0LL, std::plus<>(), [](long long x) { return x % 3; }),
+              std::transform_reduce(w.begin(), w.end(), 0LL, std::plus<>(), [](long long x) { return x % 3; }));
+    EXPECT_EQ(par::transform_reduce(ex, v.begin(), v.end(), w.begin(), 0LL), std::inner_product(v.begin(), v.end(), w.begin(), 0LL));
+
+    // 不可交换但可结合的归约按块的顺序合并
+    auto s = std::vector<std::string>(20'000, "a");
+    s[0] = "b";
+    auto cat = par::reduce(ex, s.begin(), s.end(), std::string(), std::plus<>());
+    EXPECT_EQ(cat.size(), 20'000);
+    EXPECT_EQ(cat[0], 'b');
+}
+
+//  inclusive_scan，包括原地扫描
+TEST(parallel_test, case_2) {
+    auto pool = thread_pool(3);
+    auto ex = par::pool_executor(pool);
+    auto v = std::vector<long long>(77'777);
+    std::iota(v.begin(), v.end(), 0);
+    auto expect = std::vector<long long>(v.size());
+    std::inclusive_scan(v.begin(), v.end(), expect.begin());
+
+    auto out = std::vector<long long>(v.size());
+    auto end = par::inclusive_scan(ex, v.begin(), v.end(), out.begin());
+    EXPECT_EQ(end, out.end());
+    EXPECT_EQ(out, expect);
+
+    par::inclusive_scan(ex, v.begin(), v.end(), v.begin(), std::plus<long long>());
+    EXPECT_EQ(v, expect);
+    auto small = std::vector<int>{3, 1, 2};
+    par::inclusive_scan(small.begin(), small.end(), small.begin(), [](int a, int b) { return std::max(a, b); });
+    EXPECT_EQ(small, (std::vector<int>{3, 3, 3}));
+}
+
+//  sort：随机、已排序、大量重复、非平凡元素、嵌套在线程池任务中调用
+TEST(parallel_test, case_3) {
+    auto pool = thread_pool(4);
+    auto ex = par::pool_executor(pool);
+    auto rng = std::mt19937(7);
+    auto v = std::vector<unsigned>(300'000);
+    for (auto &x : v) {
+        x = static_cast<unsigned>(rng());
+    }
+    auto expect = v;
+    std::sort(expect.begin(), expect.end());
+    par::sort(ex, v.begin(), v.end());
+    EXPECT_EQ(v, expect);
+    par::sort(ex, v.begin(), v.end(), std::greater<>());
+    EXPECT_TRUE(std::is_sorted(v.begin(), v.end(), std::greater<>()));
+
+    for (auto &x : v) {
+        x = static_cast<unsigned>(rng() % 3);
+    }
+    par::sort(ex, v.begin(), v.end());
+    EXPECT_TRUE(std::is_sorted(v.begin(), v.end()));
+
+    auto s = std::vector<std::string>(50'000);
+    for (auto &x : s) {
+        x = std::to_string(rng()) + std::string(20, 'x');
+    }
+    auto fut = pool.submit([&] { par::sort(ex, s.begin(), s.end()); });
+    fut.get();
+    EXPECT_TRUE(std::is_sorted(s.begin(), s.end()));
+}
+
+//  partition 稳定
+TEST(parallel_test, case_4) {
+    auto pool = thread_pool(4);
+    auto ex = par::pool_executor(pool);
+    auto v = std::vector<int>(100'001);
+    std::iota(v.begin(), v.end(), 0);
+    auto mid = par::partition(ex, v.begin(), v.end(), [](int x) { return x % 3 == 0; });
+    EXPECT_EQ(mid - v.begin(), 33'334);
+    EXPECT_TRUE(std::all_of(v.begin(), mid, [](int x) { return x % 3 == 0; }));
+    EXPECT_TRUE(std::none_of(mid, v.end(), [](int x) { return x % 3 == 0; }));
+    EXPECT_TRUE(std::is_sorted(v.begin(), mid));
+    EXPECT_TRUE(std::is_sorted(mid, v.end()));
+}
+
+//  工作线程都被占用时，调用线程独自做完所有单元后返回，不等待排队中的辅助任务
+TEST(parallel_test, case_5) {
+    auto pool = thread_pool(2);
+    auto ex = par::pool_executor(pool);
+    auto gate = std::atomic<bool>(false);
+    auto blocked = std::atomic<int>(0);
+    for (auto i = 0; i < 2; ++i) {
+        pool.execute([&] {
+            blocked.fetch_add(1);
+            while (!gate.load()) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    while (blocked.load() != 2) {
+        std::this_thread::yield();
+    }
+    auto count = std::atomic<int>(0);
+    ex.bulk_run(100, [&](size_t) { count.fetch_add(1); });
+    EXPECT_EQ(count.load(), 100);
+    gate.store(true);
+}
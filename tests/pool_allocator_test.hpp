@@ -0,0 +1,53 @@
+#pragma once
+#include "utility/pool_allocator.hpp"
+#include "gtest/gtest.h"
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace mtl;
+
+//  单对象分配走内存池，释放后的槽位被复用
+TEST(pool_allocator_test, case_1) {
+    auto alloc = pool_allocator<double>();
+    auto ptrs = std::set<double *>();
+    for (auto i = 0; i < 1000; ++i) {
+        auto p = allocator_traits<pool_allocator<double>>::allocate(alloc, 1);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(double), 0);
+        EXPECT_TRUE(ptrs.insert(p).second);
+        *p = i;
+    }
+    for (auto p : ptrs) {
+        alloc.deallocate(p, 1);
+    }
+    auto p = alloc.allocate(1);
+    EXPECT_TRUE(ptrs.contains(p));
+    alloc.deallocate(p, 1);
+
+    //  数组分配
+    auto arr = alloc.allocate(100);
+    arr[99] = 1;
+    alloc.deallocate(arr, 100);
+}
+
+//  跨线程释放
+TEST(pool_allocator_test, case_2) {
+    auto alloc = pool_allocator<std::string>();
+    auto ptrs = std::vector<std::string *>();
+    for (auto i = 0; i < 1000; ++i) {
+        auto p = alloc.allocate(1);
+        std::construct_at(p, std::to_string(i));
+        ptrs.push_back(p);
+    }
+    std::thread([&] {
+        for (auto p : ptrs) {
+            std::destroy_at(p);
+            alloc.deallocate(p, 1);
+        }
+    }).join();
+    auto p = alloc.allocate(1);
+    alloc.deallocate(p, 1);
+
+    //  rebind 后相等
+    EXPECT_TRUE(alloc == pool_allocator<int>());
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "concurrency/rcu.hpp"
+#include "gtest/gtest.h"
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mtl;
+
+namespace {
+    struct rcu_object : rcu_obj_base<rcu_object> {
+        explicit rcu_object(int v) : a(v), b(v) { live.fetch_add(1); }
+
+        ~rcu_object() {
+            a = b = -1;
+            live.fetch_sub(1);
+        }
+
+        int a, b;
+        inline static std::atomic<int> live{0};
+    };
+} // namespace
+
+//  读临界区可以嵌套；退休的对象在 rcu_barrier 之后全部被回收
+TEST(rcu_test, case_1) {
+    {
+        auto outer = rcu_reader();
+        auto lock = std::scoped_lock(rcu_default_domain());
+    }
+    rcu_synchronize();
+
+    (new rcu_object(1))->retire();
+    auto freed = 0;
+    rcu_retire(new int(2), [&](int *p) {
+        ++freed;
+        delete p;
+    });
+    rcu_barrier();
+    EXPECT_EQ(rcu_object::live.load(), 0);
+    EXPECT_EQ(freed, 1);
+}
+
+//  synchronize 等待之前开始的读临界区结束，不等待之后开始的
+TEST(rcu_test, case_2) {
+    auto entered = std::atomic<bool>(false);
+    auto leave = std::atomic<bool>(false);
+    auto reader = std::thread([&] {
+        auto r = rcu_reader();
+        entered = true;
+        while (!leave.load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+    auto done = std::atomic<bool>(false);
+    auto writer = std::thread([&] {
+        rcu_synchronize();
+        done = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(done.load());
+    {
+        // 本线程之后开始的临界区不会阻塞写者
+        auto r = rcu_reader();
+        leave = true;
+        writer.join();
+    }
+    EXPECT_TRUE(done.load());
+    reader.join();
+}
+
+//  读者与写者并发：读到的对象总是完整的
+TEST(rcu_test, case_3) {
+    auto src = std::atomic<rcu_object *>(new rcu_object(0));
+    auto stop = std::atomic<bool>(false);
+    auto torn = std::atomic<int>(0);
+    auto threads = std::vector<std::thread>();
+    for (auto i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto r = rcu_reader();
+                auto p = src.load(std::memory_order_acquire);
+                if (p->a != p->b || p->a < 0) {
+                    torn.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto w = 0; w < 2; ++w) {
+        threads.emplace_back([&, w] {
+            for (auto i = 1; i <= 20'000; ++i) {
+                src.exchange(new rcu_object(i * 2 + w))->retire();
+            }
+        });
+    }
+    threads[5].join();
+    threads[4].join();
+    stop = true;
+    for (auto i = 0; i < 4; ++i) {
+        threads[i].join();
+    }
+    EXPECT_EQ(torn.load(), 0);
+    src.load()->retire();
+    rcu_barrier();
+    EXPECT_EQ(rcu_object::live.load(), 0);
+}
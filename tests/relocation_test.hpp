@@ -0,0 +1,123 @@
+#pragma once
+#include "utility/any.hpp"
+#include "utility/functional.hpp"
+#include "utility/memory.hpp"
+#include "utility/optional.hpp"
+#include "utility/pair.hpp"
+#include "utility/shared_ptr.hpp"
+#include "utility/tuple.hpp"
+#include "utility/unique_ptr.hpp"
+#include "utility/variant.hpp"
+#include "gtest/gtest.h"
+
+using namespace mtl;
+
+//  析构时修改外部状态，若被 memcpy 搬移后仍调用析构，计数会出错
+struct reloc_tracked {
+    explicit reloc_tracked(int *c) : cnt(c) {}
+    reloc_tracked(reloc_tracked &&o) noexcept : cnt(o.cnt) { o.cnt = nullptr; }
+    ~reloc_tracked() {
+        if (cnt) {
+            ++*cnt;
+        }
+    }
+    int *cnt;
+};
+
+//  自引用类型，不可平凡重定位
+struct reloc_self {
+    reloc_self() : self(this) {}
+    reloc_self(const reloc_self &) : self(this) {}
+    reloc_self *self;
+};
+
+//  将 n 个对象重定位到新的缓冲区，返回新缓冲区
+template <typename T>
+auto reloc_move(T *src, size_t n) -> T * {
+    auto dst = allocator<T>().allocate(n);
+    mtl::uninitialized_relocate(src, src + n, dst);
+    allocator<T>().deallocate(src, n);
+    return dst;
+}
+
+//  trait
+TEST(relocation_test, case_1) {
+    static_assert(is_trivially_relocatable_v<unique_ptr<int>>);
+    static_assert(is_trivially_relocatable_v<unique_ptr<int[]>>);
+    static_assert(is_trivially_relocatable_v<shared_ptr<std::string>>);
+    static_assert(is_trivially_relocatable_v<function<int(int)>>);
+    static_assert(is_trivially_relocatable_v<any>);
+    static_assert(is_trivially_relocatable_v<optional<reloc_self>>);
+    static_assert(is_trivially_relocatable_v<pair<int, shared_ptr<int>>>);
+    static_assert(is_trivially_relocatable_v<tuple<int, unique_ptr<int>, double>>);
+    static_assert(is_trivially_relocatable_v<variant<int, shared_ptr<int>>>);
+
+    static_assert(!is_trivially_relocatable_v<reloc_self>);
+    static_assert(!is_trivially_relocatable_v<pair<int, reloc_self>>);
+    static_assert(!is_trivially_relocatable_v<tuple<reloc_self>>);
+    static_assert(!is_trivially_relocatable_v<variant<int, reloc_self>>);
+    static_assert(!is_trivially_relocatable_v<unique_ptr<int, std::function<void(int *)>>>);
+}
+
+//  shared_ptr、unique_ptr
+TEST(relocation_test, case_2) {
+    constexpr size_t n = 100;
+    auto origin = shared_ptr<int>(new int(7));
+    auto sp = allocator<shared_ptr<int>>().allocate(n);
+    mtl::uninitialized_fill_n(sp, n, origin);
+    EXPECT_EQ(origin.use_count(), n + 1);
+    sp = reloc_move(sp, n);
+    EXPECT_EQ(origin.use_count(), n + 1);
+    EXPECT_EQ(*sp[n - 1], 7);
+    mtl::destroy_n(sp, n);
+    allocator<shared_ptr<int>>().deallocate(sp, n);
+    EXPECT_EQ(origin.use_count(), 1);
+
+    auto up = allocator<unique_ptr<int>>().allocate(n);
+    for (auto i = size_t{0}; i < n; ++i) {
+        std::construct_at(up + i, new int(i));
+    }
+    up = reloc_move(up, n);
+    EXPECT_EQ(*up[42], 42);
+    mtl::destroy_n(up, n);
+    allocator<unique_ptr<int>>().deallocate(up, n);
+}
+
+//  function、any、optional
+TEST(relocation_test, case_3) {
+    auto count = 0;
+    {
+        auto tracked = shared_ptr<reloc_tracked>(new reloc_tracked(&count));
+        auto fp = allocator<function<int()>>().allocate(2);
+        std::construct_at(fp, [] { return 1; });
+        std::construct_at(fp + 1, [tracked, i = 2] { return i; });
+        fp = reloc_move(fp, 2);
+        EXPECT_EQ(fp[0](), 1);
+        EXPECT_EQ(fp[1](), 2);
+        mtl::destroy_n(fp, 2);
+        allocator<function<int()>>().deallocate(fp, 2);
+    }
+    EXPECT_EQ(count, 1);
+
+    auto ap = allocator<any>().allocate(2);
+    std::construct_at(ap, 1);
+    std::construct_at(ap + 1, std::string("hello"));
+    ap = reloc_move(ap, 2);
+    EXPECT_EQ(any_cast<int>(ap[0]), 1);
+    EXPECT_EQ(any_cast<std::string>(ap[1]), "hello");
+    mtl::destroy_n(ap, 2);
+    allocator<any>().deallocate(ap, 2);
+
+    //  自引用对象不会放入 any 的栈内存
+    auto a = any(reloc_self());
+    auto b = std::move(a);
+    EXPECT_EQ(any_cast<reloc_self &>(b).self, &any_cast<reloc_self &>(b));
+
+    auto op = allocator<optional<reloc_self>>().allocate(1);
+    std::construct_at(op, reloc_self());
+    auto self = op->operator->()->self;
+    op = reloc_move(op, 1);
+    EXPECT_EQ(op->operator->()->self, self);
+    std::destroy_at(op);
+    allocator<optional<reloc_self>>().deallocate(op, 1);
+}
@@ -1,5 +1,8 @@
 #include "utility/shared_ptr.hpp"
 #include "gtest/gtest.h"
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 using namespace mtl;
 
@@ -44,4 +47,58 @@ TEST(shared_ptr_test, case_2) {
     EXPECT_EQ(Case2T1::del_times, 11);
     p4.reset();
     EXPECT_EQ(Case2T1::del_times, 1);
-}
\ No newline at end of file
+}
+// 测试 weak_ptr::lock，以及多线程并发复制与释放
+TEST(shared_ptr_test, case_3) {
+    auto w = weak_ptr<Case2T1>();
+    EXPECT_FALSE(w.lock());
+    {
+        auto p = shared_ptr<Case2T1>(new Case2T1());
+        w = p;
+        auto q = w.lock();
+        EXPECT_EQ(q.get(), p.get());
+        EXPECT_EQ(p.use_count(), 2);
+    }
+    EXPECT_TRUE(w.expired());
+    EXPECT_FALSE(w.lock());
+    EXPECT_THROW(shared_ptr<Case2T1>{w}, bad_weak_ptr);
+
+    auto del_times = Case2T1::del_times;
+    auto p = shared_ptr<Case2T1>(new Case2T1());
+    auto wp = weak_ptr<Case2T1>(p);
+    auto threads = std::vector<std::thread>();
+    for (auto i = 0; i < 4; ++i) {
+        threads.emplace_back([p, wp] {
+            for (auto j = 0; j < 10'000; ++j) {
+                auto a = p;
+                auto b = wp.lock();
+                EXPECT_TRUE(b);
+            }
+        });
+    }
+    p.reset();
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(Case2T1::del_times, del_times + 1);
+    EXPECT_TRUE(wp.expired());
+}
+
+// 复制时抛出异常的删除器
+struct Case4Del {
+    Case4Del() = default;
+    Case4Del(Case4Del &&) = default;
+    Case4Del(const Case4Del &) { throw std::runtime_error("copy"); }
+    auto operator()(Case2T1 *p) const -> void {
+        calls += 1;
+        delete p;
+    }
+    inline static int calls = 0;
+};
+// 测试 shared_ptr(p, del) 构造失败时通过 del 释放对象
+TEST(shared_ptr_test, case_4) {
+    auto del_times = Case2T1::del_times;
+    EXPECT_THROW(shared_ptr<Case2T1>(new Case2T1(), Case4Del()), std::runtime_error);
+    EXPECT_EQ(Case4Del::calls, 1);
+    EXPECT_EQ(Case2T1::del_times, del_times + 1);
+}
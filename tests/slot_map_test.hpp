@@ -0,0 +1,89 @@
+#pragma once
+#include "container/slot_map.hpp"
+#include "utility/unique_ptr.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <string>
+
+using namespace mtl;
+
+//  插入、查找、删除与句柄失效
+TEST(slot_map_test, case_1) {
+    static_assert(sizeof(slot_key) == 8);
+
+    auto m = slot_map<std::string>();
+    auto a = m.insert("a");
+    auto b = m.emplace(3, 'b');
+    auto c = m.insert("c");
+    EXPECT_EQ(m.size(), 3);
+    EXPECT_EQ(m[a], "a");
+    EXPECT_EQ(*m.find(b), "bbb");
+    EXPECT_EQ(m.at(c), "c");
+
+    EXPECT_EQ(m.erase(a), 1);
+    EXPECT_EQ(m.erase(a), 0);
+    EXPECT_FALSE(m.contains(a));
+    EXPECT_EQ(m.find(a), nullptr);
+    EXPECT_THROW(m.at(a), std::out_of_range);
+    EXPECT_EQ(m[b], "bbb");
+    EXPECT_EQ(m[c], "c");
+
+    // 复用槽位，但代数不同
+    auto d = m.insert("d");
+    EXPECT_EQ(d.index, a.index);
+    EXPECT_NE(d.generation, a.generation);
+    EXPECT_FALSE(m.contains(a));
+    EXPECT_EQ(m[d], "d");
+
+    EXPECT_EQ(slot_key::from_integer(d.to_integer()), d);
+    EXPECT_FALSE(m.contains(slot_key()));
+
+    auto v = m.pop(b);
+    EXPECT_EQ(*v, "bbb");
+    EXPECT_FALSE(m.contains(b));
+    EXPECT_FALSE(m.pop(b).has_value());
+}
+
+//  迭代紧密数组、key_of、erase_if、clear
+TEST(slot_map_test, case_2) {
+    auto m = slot_map<int>();
+    auto keys = vector<slot_key>();
+    for (auto i = 0; i < 100; ++i) {
+        keys.push_back(m.insert(i));
+    }
+    for (auto it = m.begin(); it != m.end(); ++it) {
+        EXPECT_EQ(m[m.key_of(it)], *it);
+    }
+    EXPECT_EQ(erase_if(m, [](int x) { return x % 3 == 0; }), 34);
+    EXPECT_EQ(m.size(), 66);
+    for (auto i = 0; i < 100; ++i) {
+        EXPECT_EQ(m.contains(keys[i]), i % 3 != 0);
+        if (i % 3 != 0) {
+            EXPECT_EQ(m[keys[i]], i);
+        }
+    }
+    auto sum = 0;
+    for (auto x : m) {
+        sum += x;
+    }
+    EXPECT_EQ(sum, 4950 - 1683);
+
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_TRUE(std::none_of(keys.begin(), keys.end(), [&](slot_key k) { return m.contains(k); }));
+    auto k = m.insert(7);
+    EXPECT_EQ(m[k], 7);
+}
+
+//  只能移动的元素
+TEST(slot_map_test, case_3) {
+    auto m = slot_map<unique_ptr<int>>();
+    auto a = m.insert(unique_ptr<int>(new int(1)));
+    auto b = m.insert(unique_ptr<int>(new int(2)));
+    m.erase(a);
+    EXPECT_EQ(*m[b], 2);
+    auto n = slot_map<unique_ptr<int>>();
+    swap(m, n);
+    EXPECT_EQ(*n[b], 2);
+    EXPECT_TRUE(m.empty());
+}
@@ -0,0 +1,207 @@
+#pragma once
+#include "container/small_vector.hpp"
+#include "utility/memory_resource.hpp"
+#include "utility/shared_ptr.hpp"
+#include "gtest/gtest.h"
+#include <iterator>
+#include <list>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using namespace mtl;
+
+namespace {
+    // 只能拷贝且拷贝可能抛出异常，扩容时走拷贝路径；析构后写入 -999 以检测重复析构
+    struct small_vector_copy_only {
+        explicit small_vector_copy_only(int x) : v(x) { ++live; }
+
+        small_vector_copy_only(const small_vector_copy_only &o) : v(o.v) {
+            if (countdown > 0 && --countdown == 0) {
+                throw std::runtime_error("copy");
+            }
+            ++live;
+        }
+
+        ~small_vector_copy_only() {
+            if (v == -999) {
+                ++double_destroyed;
+            }
+            v = -999;
+            --live;
+        }
+
+        int v;
+        inline static int live = 0;
+        inline static int countdown = 0;
+        inline static int double_destroyed = 0;
+    };
+
+    // 记录未归还的分配次数
+    template <typename T>
+    struct small_vector_counting_alloc {
+        using value_type = T;
+
+        small_vector_counting_alloc() = default;
+
+        template <typename U>
+        small_vector_counting_alloc(const small_vector_counting_alloc<U> &) noexcept {}
+
+        auto allocate(size_t n) -> T * {
+            ++outstanding;
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+
+        auto deallocate(T *p, size_t) noexcept -> void {
+            --outstanding;
+            ::operator delete(p);
+        }
+
+        auto operator==(const small_vector_counting_alloc &) const -> bool = default;
+
+        inline static int outstanding = 0;
+    };
+} // namespace
+
+//  内联与堆模式切换
+TEST(small_vector_test, case_1) {
+    static_assert(sizeof(small_vector<int, 6>) <= 64);
+    static_assert(sizeof(small_vector<int>) == 64);
+
+    auto v = small_vector<std::string, 4>();
+    EXPECT_TRUE(v.is_inline());
+    EXPECT_EQ(v.capacity(), 4);
+    for (auto i = 0; i < 4; ++i) {
+        v.push_back(std::to_string(i));
+    }
+    EXPECT_TRUE(v.is_inline());
+    v.push_back("4");
+    EXPECT_FALSE(v.is_inline());
+    EXPECT_EQ(v[4], "4");
+    EXPECT_EQ(v.front(), "0");
+
+    v.insert(v.begin() + 1, 2, "x");
+    EXPECT_EQ(v[2], "x");
+    EXPECT_EQ(v[3], "1");
+    v.erase(v.begin() + 1, v.begin() + 3);
+    EXPECT_EQ(erase(v, "4"), 1);
+    v.shrink_to_fit();
+    EXPECT_TRUE(v.is_inline());
+    EXPECT_EQ(v, (small_vector<std::string, 4>{"0", "1", "2", "3"}));
+
+    v.resize(2);
+    v.resize(3, "r");
+    EXPECT_EQ(v.back(), "r");
+    v.assign(6, "a");
+    EXPECT_EQ(v.size(), 6);
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    EXPECT_THROW(v.at(0), std::out_of_range);
+}
+
+//  移动与交换
+TEST(small_vector_test, case_2) {
+    auto origin = shared_ptr<int>(new int(1));
+    using vec = small_vector<shared_ptr<int>, 3>;
+
+    auto a = vec(2, origin);
+    auto b = vec(5, origin);
+    EXPECT_EQ(origin.use_count(), 8);
+
+    auto heap = b.data();
+    a.swap(b);
+    EXPECT_EQ(a.size(), 5);
+    EXPECT_EQ(a.data(), heap);
+    EXPECT_TRUE(b.is_inline());
+    EXPECT_EQ(b.size(), 2);
+
+    auto c = vec(1, origin);
+    swap(b, c);
+    EXPECT_EQ(b.size(), 1);
+    EXPECT_EQ(c.size(), 2);
+
+    auto d = std::move(a);
+    EXPECT_EQ(d.data(), heap);
+    EXPECT_TRUE(a.empty());
+    auto e = std::move(c);
+    EXPECT_TRUE(e.is_inline());
+    EXPECT_EQ(e.size(), 2);
+    EXPECT_TRUE(c.empty());
+    EXPECT_EQ(origin.use_count(), 9);
+
+    d = std::move(e);
+    EXPECT_EQ(d.size(), 2);
+    EXPECT_TRUE(d.is_inline());
+    d = b;
+    EXPECT_EQ(d.size(), 1);
+    d.clear();
+    b.clear();
+    EXPECT_EQ(origin.use_count(), 1);
+}
+
+//  有状态分配器
+TEST(small_vector_test, case_3) {
+    auto mr = monotonic_buffer_resource();
+    auto v = small_vector<int, 2, polymorphic_allocator<int>>({1, 2, 3}, &mr);
+    EXPECT_FALSE(v.is_inline());
+    EXPECT_EQ(v.get_allocator().resource(), &mr);
+    auto w = small_vector<int, 2, polymorphic_allocator<int>>(std::move(v), get_default_resource());
+    EXPECT_EQ(w[2], 3);
+    EXPECT_NE(w.data(), v.data());
+}
+
+//  填满容量后插入，扩容时拷贝抛出异常：原有元素不变且只析构一次
+TEST(small_vector_test, case_4) {
+    for (auto fail = 1; fail <= 6; ++fail) {
+        {
+            auto v = small_vector<small_vector_copy_only, 4>();
+            while (v.size() < v.capacity()) {
+                v.emplace_back(static_cast<int>(v.size()));
+            }
+            auto n = v.size();
+            auto x = small_vector_copy_only(9);
+            small_vector_copy_only::countdown = fail;
+            if (fail % 2) {
+                EXPECT_THROW(v.emplace(v.begin() + 1, x), std::runtime_error);
+            } else {
+                EXPECT_THROW(v.insert(v.begin() + 1, 2, x), std::runtime_error);
+            }
+            small_vector_copy_only::countdown = 0;
+            EXPECT_EQ(v.size(), n);
+            for (auto i = size_t{0}; i < n; ++i) {
+                EXPECT_EQ(v[i].v, static_cast<int>(i));
+            }
+        }
+        EXPECT_EQ(small_vector_copy_only::live, 0);
+        EXPECT_EQ(small_vector_copy_only::double_destroyed, 0);
+    }
+}
+
+//  构造函数中元素拷贝抛出异常：已构造的元素被销毁，堆内存被释放
+TEST(small_vector_test, case_5) {
+    using V = small_vector<small_vector_copy_only, 2, small_vector_counting_alloc<small_vector_copy_only>>;
+    auto src = std::list<small_vector_copy_only>();
+    for (auto i = 0; i < 8; ++i) {
+        src.emplace_back(i);
+    }
+    auto full = V(src.begin(), src.end());
+    for (auto fail = 1; fail <= 8; ++fail) {
+        small_vector_copy_only::countdown = fail;
+        EXPECT_THROW(V(8, src.front()), std::runtime_error);
+        small_vector_copy_only::countdown = fail;
+        EXPECT_THROW(V(src.begin(), src.end()), std::runtime_error);
+        small_vector_copy_only::countdown = fail;
+        EXPECT_THROW(V(std::as_const(full)), std::runtime_error);
+        auto in = std::istringstream("1 2 3 4 5 6 7 8 9 10 11 12");
+        small_vector_copy_only::countdown = fail;
+        try {
+            auto v = V(std::istream_iterator<int>(in), std::istream_iterator<int>());
+        } catch (const std::runtime_error &) {
+        }
+        small_vector_copy_only::countdown = 0;
+        EXPECT_EQ(small_vector_copy_only::live, 16);
+        EXPECT_EQ(small_vector_counting_alloc<small_vector_copy_only>::outstanding, 1);
+    }
+    EXPECT_EQ(small_vector_copy_only::double_destroyed, 0);
+}
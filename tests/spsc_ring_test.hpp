@@ -0,0 +1,139 @@
+#pragma once
+#include "concurrency/spsc_ring.hpp"
+#include "utility/shared_ptr.hpp"
+#include "utility/unique_ptr.hpp"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mtl;
+
+//  单线程下的入队、出队与批量操作
+TEST(spsc_ring_test, case_1) {
+    auto q = spsc_ring<std::string, 4>();
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(q.front(), nullptr);
+    EXPECT_TRUE(q.try_push("a"));
+    EXPECT_TRUE(q.try_emplace(3, 'b'));
+    EXPECT_EQ(*q.front(), "a");
+    EXPECT_EQ(*q.try_pop(), "a");
+    EXPECT_EQ(q.size(), 1);
+
+    auto in = std::vector<std::string>{"c", "d", "e", "f"};
+    EXPECT_EQ(q.try_push_n(in.begin(), in.size()), 3);
+    EXPECT_FALSE(q.try_push("x"));
+
+    auto out = std::vector<std::string>(8);
+    EXPECT_EQ(q.try_pop_n(out.begin(), 8), 4);
+    EXPECT_EQ(out[0], "bbb");
+    EXPECT_EQ(out[3], "e");
+    EXPECT_TRUE(q.empty());
+    auto s = std::string();
+    EXPECT_FALSE(q.try_pop(s));
+
+    // 下标回绕
+    for (auto i = 0; i < 10; ++i) {
+        q.push(std::to_string(i));
+        EXPECT_EQ(q.pop_wait(), std::to_string(i));
+    }
+}
+
+//  只能移动的元素，析构时销毁剩余元素
+TEST(spsc_ring_test, case_2) {
+    auto q = spsc_ring<unique_ptr<int>, 8>();
+    q.emplace(new int(1));
+    q.push(unique_ptr<int>(new int(2)));
+    auto p = unique_ptr<int>();
+    EXPECT_TRUE(q.try_pop(p));
+    EXPECT_EQ(*p, 1);
+}
+
+//  两个线程之间传递，顺序与内容不变
+TEST(spsc_ring_test, case_3) {
+    constexpr auto n = 200000;
+    auto q = std::make_unique<spsc_ring<int, 1024>>();
+    auto producer = std::thread([&] {
+        auto batch = std::vector<int>(16);
+        auto i = 0;
+        while (i < n) {
+            if (i % 3 == 0) {
+                q->push(i++);
+                continue;
+            }
+            auto k = std::min<int>(16, n - i);
+            for (auto j = 0; j < k; ++j) {
+                batch[j] = i + j;
+            }
+            auto pushed = 0;
+            while (pushed < k) {
+                auto m = q->try_push_n(batch.begin() + pushed, static_cast<size_t>(k - pushed));
+                if (m == 0) {
+                    std::this_thread::yield();
+                }
+                pushed += static_cast<int>(m);
+            }
+            i += k;
+        }
+    });
+    // 第三个线程观察 size，读取期间两端都在前进，结果也不会超过容量
+    auto done = std::atomic<bool>(false);
+    auto sized = true;
+    auto observer = std::thread([&] {
+        while (!done.load(std::memory_order_relaxed)) {
+            sized &= q->size() <= q->capacity();
+        }
+    });
+    auto expect = 0;
+    auto buf = std::vector<int>(32);
+    auto ok = true;
+    while (expect < n) {
+        auto got = q->try_pop_n(buf.begin(), buf.size());
+        if (got == 0) {
+            std::this_thread::yield();
+        }
+        for (auto j = size_t{0}; j < got; ++j) {
+            ok &= buf[j] == expect++;
+        }
+    }
+    producer.join();
+    done = true;
+    observer.join();
+    EXPECT_TRUE(ok);
+    EXPECT_TRUE(sized);
+    EXPECT_TRUE(q->empty());
+}
+
+//  批量出队时赋值抛出异常：已出队的元素不再留在队列中，其余元素只析构一次
+TEST(spsc_ring_test, case_4) {
+    struct picky {
+        auto operator=(shared_ptr<int> &&p) -> picky & {
+            if (*p == 2) {
+                throw std::runtime_error("picky");
+            }
+            v = std::move(p);
+            return *this;
+        }
+
+        shared_ptr<int> v;
+    };
+
+    auto origin = shared_ptr<int>(new int(0));
+    auto two = shared_ptr<int>(new int(2));
+    {
+        auto q = spsc_ring<shared_ptr<int>, 8>();
+        q.push(origin);
+        q.push(origin);
+        q.push(two);
+        q.push(origin);
+        auto out = std::vector<picky>(4);
+        EXPECT_THROW(q.try_pop_n(out.begin(), 4), std::runtime_error);
+        EXPECT_EQ(q.size(), 2);
+        EXPECT_EQ(**q.front(), 2);
+        EXPECT_EQ(origin.use_count(), 4);
+    }
+    EXPECT_EQ(origin.use_count(), 1);
+    EXPECT_EQ(two.use_count(), 1);
+}
@@ -0,0 +1,212 @@
+#pragma once
+#include "container/vector.hpp"
+#include "string/string.hpp"
+#include "utility/any.hpp"
+#include "utility/memory_resource.hpp"
+#include "gtest/gtest.h"
+#include <sstream>
+#include <string>
+#include <unordered_set>
+
+using namespace mtl;
+
+//  短字符串与长字符串切换
+TEST(string_test, case_1) {
+    static_assert(sizeof(string) == 24);
+    static_assert(string::short_capacity == 23);
+    static_assert(u32string::short_capacity == 5);
+    static_assert(is_trivially_relocatable_v<string>);
+
+    auto s = string();
+    EXPECT_TRUE(s.empty());
+    EXPECT_EQ(s.capacity(), 23);
+    EXPECT_EQ(s.c_str()[0], '\0');
+
+    s = "0123456789abcdefghijklm";
+    EXPECT_EQ(s.size(), 23);
+    EXPECT_EQ(s.capacity(), 23);
+    EXPECT_EQ(s.c_str()[23], '\0');
+    EXPECT_EQ(s, "0123456789abcdefghijklm");
+
+    s.push_back('n');
+    EXPECT_GT(s.capacity(), 23);
+    EXPECT_EQ(s, "0123456789abcdefghijklmn");
+    EXPECT_EQ(s.c_str()[24], '\0');
+
+    s.resize(5);
+    s.shrink_to_fit();
+    EXPECT_EQ(s.capacity(), 23);
+    EXPECT_EQ(s, "01234");
+
+    s.resize(8, 'x');
+    EXPECT_EQ(s, "01234xxx");
+    s.pop_back();
+    EXPECT_EQ(s.back(), 'x');
+    EXPECT_EQ(s.front(), '0');
+    EXPECT_THROW(s.at(7), std::out_of_range);
+    s.clear();
+    EXPECT_EQ(s.size(), 0);
+
+    auto w = u32string(U"long long utf-32 string");
+    EXPECT_EQ(w.size(), 23);
+    EXPECT_EQ(w.substr(5, 4), U"long");
+}
+
+//  构造、赋值、移动、交换
+TEST(string_test, case_2) {
+    auto a = string(30, 'a');
+    auto b = string("short");
+    auto c = a;
+    EXPECT_EQ(c, a);
+    EXPECT_NE(c.data(), a.data());
+
+    auto d = std::move(c);
+    EXPECT_EQ(d, a);
+    EXPECT_TRUE(c.empty());
+
+    swap(b, d);
+    EXPECT_EQ(b, a);
+    EXPECT_EQ(d, "short");
+
+    d = b;
+    EXPECT_EQ(d, b);
+    d = std::move(b);
+    EXPECT_TRUE(b.empty());
+    b = 'z';
+    EXPECT_EQ(b, "z");
+    b = std::string_view("view");
+    EXPECT_EQ(b, "view");
+    b.assign({'x', 'y'});
+    EXPECT_EQ(b, "xy");
+
+    auto e = string(std::string("std"));
+    EXPECT_EQ(e, "std");
+    auto f = string(a, 25);
+    EXPECT_EQ(f, "aaaaa");
+    EXPECT_THROW(string(a, 31), std::out_of_range);
+
+    // 自赋值为自身的一部分
+    auto g = string("0123456789abcdefghijklmnopqrstuvwxyz");
+    g.assign(g.data() + 10, 10);
+    EXPECT_EQ(g, "abcdefghij");
+}
+
+//  修改操作
+TEST(string_test, case_3) {
+    auto s = string("hello");
+    s += ' ';
+    s += "world";
+    s.append(3, '!');
+    EXPECT_EQ(s, "hello world!!!");
+
+    s.insert(5, ",");
+    EXPECT_EQ(s, "hello, world!!!");
+    s.erase(s.size() - 2);
+    EXPECT_EQ(s, "hello, world!");
+    s.replace(0, 5, "goodbye cruel");
+    EXPECT_EQ(s, "goodbye cruel, world!");
+    s.replace(s.begin(), s.begin() + 8, "");
+    EXPECT_EQ(s, "cruel, world!");
+
+    // 源与自身重叠
+    s.append(s);
+    EXPECT_EQ(s, "cruel, world!cruel, world!");
+    s.replace(0, 5, s.data() + 7, 6);
+    EXPECT_EQ(s, "world!, world!cruel, world!");
+    s.insert(0, s.data(), 6);
+    EXPECT_EQ(s, "world!world!, world!cruel, world!");
+
+    EXPECT_EQ(erase(s, '!'), 4);
+    EXPECT_EQ(erase_if(s, [](char c) { return c == ','; }), 2);
+    EXPECT_EQ(s, "worldworld worldcruel world");
+
+    auto t = string("abc") + "def" + 'g' + string("h");
+    EXPECT_EQ(t, "abcdefgh");
+    EXPECT_EQ("x" + t, "xabcdefgh");
+
+    auto vec = mtl::vector<char>{'1', '2', '3'};
+    t.append(vec.begin(), vec.end());
+    t.insert(t.begin(), vec.begin(), vec.end());
+    EXPECT_EQ(t, "123abcdefgh123");
+}
+
+//  resize_and_overwrite
+TEST(string_test, case_4) {
+    auto s = string("prefix");
+    s.resize_and_overwrite(100, [](char *p, size_t n) {
+        EXPECT_EQ(std::string_view(p, 6), "prefix");
+        for (auto i = size_t{6}; i < n; ++i) {
+            p[i] = static_cast<char>('0' + i % 10);
+        }
+        return 16;
+    });
+    EXPECT_EQ(s, "prefix6789012345");
+    EXPECT_GE(s.capacity(), 100);
+    EXPECT_EQ(s.c_str()[16], '\0');
+
+    s.resize_and_overwrite(3, [](char *, size_t n) { return n; });
+    EXPECT_EQ(s, "pre");
+}
+
+//  查找与比较
+TEST(string_test, case_5) {
+    auto s = string("the quick brown fox jumps over the lazy dog, the end");
+    auto ref = std::string(s);
+    for (auto needle : {"the", "fox", "dog,", "end", "the lazy dog, the end", "x", "", "cat", "thee", "d"}) {
+        for (auto pos : {size_t{0}, size_t{1}, size_t{20}, size_t{51}, size_t{52}, size_t{60}}) {
+            EXPECT_EQ(s.find(needle, pos), ref.find(needle, pos)) << needle << " " << pos;
+            EXPECT_EQ(s.rfind(needle, pos), ref.rfind(needle, pos)) << needle << " " << pos;
+        }
+    }
+    EXPECT_EQ(s.find('q'), 4);
+    EXPECT_EQ(s.find_first_of("xyz"), ref.find_first_of("xyz"));
+    EXPECT_EQ(s.find_last_not_of("dne "), ref.find_last_not_of("dne "));
+    EXPECT_TRUE(s.starts_with("the"));
+    EXPECT_TRUE(s.ends_with('d'));
+    EXPECT_TRUE(s.contains("brown"));
+    EXPECT_FALSE(s.contains("purple"));
+
+    // 跨越 16 字节块边界的匹配
+    auto big = string(1000, 'a');
+    big.replace(990, 5, "abcde");
+    EXPECT_EQ(big.find("abcde"), 990);
+    big[15] = 'b';
+    big[16] = 'c';
+    EXPECT_EQ(big.find("abc"), 14);
+
+    EXPECT_LT(string("abc"), string("abd"));
+    EXPECT_GT(string("abcd"), "abc");
+    EXPECT_EQ(string("abc").compare(1, 2, "bc"), 0);
+    EXPECT_EQ(string("abc") <=> string("abc"), std::strong_ordering::equal);
+    EXPECT_EQ(std::hash<string>{}(string("key")), std::hash<std::string_view>{}("key"));
+
+    auto set = std::unordered_set<string>{"a", "b"};
+    EXPECT_TRUE(set.contains("a"));
+
+    auto os = std::ostringstream();
+    os << string("out");
+    EXPECT_EQ(os.str(), "out");
+}
+
+//  自定义分配器与内联存放在 any 中
+TEST(string_test, case_6) {
+    auto buf = std::array<std::byte, 1024>();
+    auto res = monotonic_buffer_resource(buf.data(), buf.size());
+    using pstring = basic_string<char, std::char_traits<char>, polymorphic_allocator<char>>;
+    auto s = pstring("this string lives in the monotonic buffer", &res);
+    EXPECT_GE(reinterpret_cast<std::byte *>(s.data()), buf.data());
+    EXPECT_LT(reinterpret_cast<std::byte *>(s.data()), buf.data() + buf.size());
+
+    auto a = any(string("inline"));
+    EXPECT_EQ(any_cast<string &>(a), "inline");
+    auto b = std::move(a);
+    EXPECT_EQ(any_cast<string &>(b), "inline");
+
+    auto v = mtl::vector<string>();
+    for (auto i = 0; i < 100; ++i) {
+        v.push_back(string(static_cast<size_t>(i), 'v'));
+    }
+    for (auto i = 0; i < 100; ++i) {
+        EXPECT_EQ(v[i].size(), i);
+    }
+}
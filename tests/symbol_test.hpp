@@ -0,0 +1,85 @@
+#pragma once
+#include "container/flat_hash_map.hpp"
+#include "string/symbol.hpp"
+#include "utility/any.hpp"
+#include "utility/variant.hpp"
+#include "gtest/gtest.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mtl;
+
+//  驻留与比较
+TEST(symbol_test, case_1) {
+    static_assert(sizeof(symbol) == 4);
+    static_assert(is_trivially_relocatable_v<symbol>);
+
+    auto empty = symbol();
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.view(), "");
+    EXPECT_EQ(symbol(""), empty);
+    EXPECT_EQ(empty.c_str()[0], '\0');
+
+    auto a = symbol("alpha");
+    auto b = symbol(std::string("alp") + "ha");
+    auto c = symbol("beta");
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_EQ(a.view(), "alpha");
+    EXPECT_EQ(a.size(), 5);
+    EXPECT_EQ(std::string(c.c_str()), "beta");
+    EXPECT_EQ(a.hash(), std::hash<std::string_view>{}("alpha"));
+    EXPECT_EQ(std::hash<symbol>{}(a), a.hash());
+
+    EXPECT_EQ(symbol::find("alpha"), a);
+    EXPECT_FALSE(symbol::find("never interned").has_value());
+    EXPECT_EQ(symbol::from_id(a.id()), a);
+}
+
+//  大量字符串（索引扩容）与作为键、any、variant 的负载
+TEST(symbol_test, case_2) {
+    auto syms = std::vector<symbol>();
+    for (auto i = 0; i < 20000; ++i) {
+        syms.push_back(symbol("tag_" + std::to_string(i)));
+    }
+    for (auto i = 0; i < 20000; ++i) {
+        EXPECT_EQ(symbol("tag_" + std::to_string(i)), syms[i]);
+        EXPECT_EQ(syms[i].view(), "tag_" + std::to_string(i));
+    }
+
+    auto m = flat_hash_map<symbol, int>();
+    for (auto i = 0; i < 100; ++i) {
+        m[syms[i]] = i;
+    }
+    EXPECT_EQ(m[symbol("tag_42")], 42);
+
+    auto x = any(syms[7]);
+    EXPECT_EQ(any_cast<symbol>(x).view(), "tag_7");
+    auto v = variant<int, symbol>(syms[8]);
+    EXPECT_EQ(get<symbol>(v).view(), "tag_8");
+}
+
+//  多线程并发驻留同一批字符串得到相同的 id
+TEST(symbol_test, case_3) {
+    constexpr auto n = 5000;
+    auto results = std::vector<std::vector<uint32_t>>(4, std::vector<uint32_t>(n));
+    auto threads = std::vector<std::thread>();
+    for (auto t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (auto i = 0; i < n; ++i) {
+                auto k = t % 2 == 0 ? i : n - 1 - i;
+                results[t][k] = symbol("concurrent_" + std::to_string(k)).id();
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    for (auto t = 1; t < 4; ++t) {
+        EXPECT_EQ(results[t], results[0]);
+    }
+    for (auto i = 0; i < n; ++i) {
+        EXPECT_EQ(symbol::from_id(results[0][i]).view(), "concurrent_" + std::to_string(i));
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "concurrency/thread_pool.hpp"
+#include "coroutine/task.hpp"
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace mtl;
+
+namespace {
+    auto task_value(int x) -> task<int> { co_return x * 2; }
+
+    auto task_ref(int &x) -> task<int &> { co_return x; }
+
+    auto task_chain(int n) -> task<std::string> {
+        auto s = std::string();
+        for (auto i = 0; i < n; ++i) {
+            s += std::to_string(co_await task_value(i));
+        }
+        co_return s;
+    }
+
+    auto task_throw() -> task<> {
+        throw std::runtime_error("task");
+        co_return;
+    }
+
+    auto task_sum(int n) -> task<long long> {
+        auto sum = 0LL;
+        for (auto i = 0; i < n; ++i) {
+            sum += co_await task_value(i);
+        }
+        co_return sum;
+    }
+} // namespace
+
+//  惰性执行、返回值、引用与异常
+TEST(task_test, case_1) {
+    // 协程 lambda 的捕获存放在 lambda 对象中，lambda 必须活得比协程久
+    auto started = false;
+    auto f = [&]() -> task<int> {
+        started = true;
+        co_return 1;
+    };
+    auto t = f();
+    EXPECT_FALSE(started);
+    EXPECT_EQ(sync_wait(std::move(t)), 1);
+    EXPECT_TRUE(started);
+
+    EXPECT_EQ(sync_wait(task_chain(4)), "0246");
+    auto x = 5;
+    auto &r = sync_wait(task_ref(x));
+    EXPECT_EQ(&r, &x);
+    EXPECT_THROW(sync_wait(task_throw()), std::runtime_error);
+}
+
+//  大量同步完成的 co_await，未优化构建下栈深度也不增长
+TEST(task_test, case_2) {
+    EXPECT_EQ(sync_wait(task_sum(1'000'000)), 999'999LL * 1'000'000);
+}
+
+//  通过 schedule 转移到线程池执行，协程帧在其他线程上释放
+TEST(task_test, case_3) {
+    auto pool = thread_pool(2);
+    auto caller = std::this_thread::get_id();
+    auto f = [&]() -> task<bool> {
+        co_await schedule(pool);
+        auto on_pool = thread_pool::current() == &pool;
+        auto v = co_await task_value(21);
+        co_return on_pool && v == 42 && std::this_thread::get_id() != caller;
+    };
+    EXPECT_TRUE(sync_wait(f()));
+
+    auto count = std::atomic<int>(0);
+    auto inc = [&]() -> task<> {
+        co_await schedule(pool);
+        count.fetch_add(1);
+    };
+    for (auto i = 0; i < 1000; ++i) {
+        sync_wait(inc());
+    }
+    EXPECT_EQ(count.load(), 1000);
+}
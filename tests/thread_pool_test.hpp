@@ -0,0 +1,86 @@
+#pragma once
+#include "concurrency/thread_pool.hpp"
+#include "gtest/gtest.h"
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace mtl;
+
+//  submit 的返回值、void 与异常
+TEST(thread_pool_test, case_1) {
+    auto pool = thread_pool(4);
+    EXPECT_EQ(pool.size(), 4);
+    auto a = pool.submit([] { return 42; });
+    auto b = pool.submit([s = std::string("not inline"), v = std::vector<int>(100, 1)] { return s.size() + v.size(); });
+    auto hit = std::atomic<bool>(false);
+    auto c = pool.submit([&] { hit = true; });
+    auto d = pool.submit([]() -> int { throw std::runtime_error("task"); });
+    EXPECT_EQ(a.get(), 42);
+    EXPECT_FALSE(a.valid());
+    EXPECT_EQ(b.get(), 110);
+    c.get();
+    EXPECT_TRUE(hit.load());
+    EXPECT_THROW(d.get(), std::runtime_error);
+    EXPECT_THROW(a.get(), future_error);
+}
+
+//  任务中递归提交任务：压入工作线程自己的队列、队列扩容、被其他线程窃取
+TEST(thread_pool_test, case_2) {
+    auto count = std::atomic<int>(0);
+    auto seen = std::vector<std::atomic<int>>(4);
+    auto in_pool = false;
+    {
+        auto pool = thread_pool(4);
+        auto split = [&](auto &self, int depth) -> void {
+            seen[thread_pool::current_index()].fetch_add(1, std::memory_order_relaxed);
+            count.fetch_add(1, std::memory_order_relaxed);
+            if (depth == 0) {
+                return;
+            }
+            for (auto i = 0; i < 4; ++i) {
+                pool.execute([&self, depth] { self(self, depth - 1); });
+            }
+        };
+        // 一个任务一次压入 1000 个任务，超过队列初始容量。工作线程中提交的任务进入本线程的队列
+        pool.execute([&] {
+            in_pool = thread_pool::current() == &pool;
+            for (auto i = 0; i < 1000; ++i) {
+                pool.execute([&] { split(split, 3); });
+            }
+        });
+    } // 析构时执行完所有任务
+    EXPECT_TRUE(in_pool);
+    EXPECT_EQ(count.load(), 1000 * (1 + 4 + 16 + 64));
+    EXPECT_EQ(thread_pool::current(), nullptr);
+}
+
+//  bulk_submit
+TEST(thread_pool_test, case_3) {
+    auto pool = thread_pool(3);
+    auto v = std::vector<int>(10007);
+    pool.bulk_submit(v.size(), [&](size_t i) { v[i] = static_cast<int>(i); }).get();
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0LL), 10006LL * 10007 / 2);
+
+    pool.bulk_submit(0, [](size_t) {}).get();
+    auto f = pool.bulk_submit(100, [](size_t i) {
+        if (i == 37) {
+            throw std::out_of_range("bulk");
+        }
+    });
+    EXPECT_THROW(f.get(), std::out_of_range);
+}
+
+//  外部线程协助执行、绑定 CPU
+TEST(thread_pool_test, case_4) {
+    auto pool = thread_pool(2, true);
+    auto count = std::atomic<int>(0);
+    for (auto i = 0; i < 100; ++i) {
+        pool.execute([&] { count.fetch_add(1); });
+    }
+    while (pool.try_run_one()) {
+    }
+    auto f = pool.submit([&] { return count.load(); });
+    EXPECT_EQ(f.get(), 100);
+}
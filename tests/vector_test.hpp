@@ -0,0 +1,242 @@
+#pragma once
+#include "container/vector.hpp"
+#include "utility/memory_resource.hpp"
+#include "utility/shared_ptr.hpp"
+#include "gtest/gtest.h"
+#include <iterator>
+#include <list>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+using namespace mtl;
+
+namespace {
+    // 只能拷贝且拷贝可能抛出异常，扩容时走拷贝路径；析构后写入 -999 以检测重复析构
+    struct vector_copy_only {
+        explicit vector_copy_only(int x) : v(x) { ++live; }
+
+        vector_copy_only(const vector_copy_only &o) : v(o.v) {
+            if (countdown > 0 && --countdown == 0) {
+                throw std::runtime_error("copy");
+            }
+            ++live;
+        }
+
+        ~vector_copy_only() {
+            if (v == -999) {
+                ++double_destroyed;
+            }
+            v = -999;
+            --live;
+        }
+
+        int v;
+        inline static int live = 0;
+        inline static int countdown = 0;
+        inline static int double_destroyed = 0;
+    };
+
+    // 记录未归还的分配次数
+    template <typename T>
+    struct vector_counting_alloc {
+        using value_type = T;
+
+        vector_counting_alloc() = default;
+
+        template <typename U>
+        vector_counting_alloc(const vector_counting_alloc<U> &) noexcept {}
+
+        auto allocate(size_t n) -> T * {
+            ++outstanding;
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+
+        auto deallocate(T *p, size_t) noexcept -> void {
+            --outstanding;
+            ::operator delete(p);
+        }
+
+        auto operator==(const vector_counting_alloc &) const -> bool = default;
+
+        inline static int outstanding = 0;
+    };
+} // namespace
+
+//  构造、赋值
+TEST(vector_test, case_1) {
+    auto v1 = vector<int>();
+    EXPECT_TRUE(v1.empty());
+    EXPECT_EQ(v1.capacity(), 0);
+
+    auto v2 = vector<int>(5);
+    EXPECT_EQ(v2.size(), 5);
+    EXPECT_EQ(v2[4], 0);
+
+    auto v3 = vector<std::string>(3, "abc");
+    EXPECT_EQ(v3.back(), "abc");
+
+    auto lst = std::list<int>{1, 2, 3};
+    auto v4 = vector(lst.begin(), lst.end());
+    EXPECT_EQ(v4, (vector<int>{1, 2, 3}));
+
+    auto v5 = v3;
+    auto v6 = std::move(v3);
+    EXPECT_EQ(v5, v6);
+    EXPECT_TRUE(v3.empty());
+
+    v5 = {"x", "y"};
+    EXPECT_EQ(v5.size(), 2);
+    v5 = v6;
+    EXPECT_EQ(v5.size(), 3);
+    v5.assign(10, "z");
+    EXPECT_EQ(v5[9], "z");
+    v5 = std::move(v4 == v4 ? v6 : v5);
+    EXPECT_EQ(v5[0], "abc");
+
+    EXPECT_THROW(v5.at(3), std::out_of_range);
+    EXPECT_TRUE((vector<int>{1, 2} < vector<int>{1, 3}));
+}
+
+//  增删
+TEST(vector_test, case_2) {
+    auto v = vector<std::string>();
+    for (auto i = 0; i < 100; ++i) {
+        v.push_back(std::to_string(i));
+    }
+    EXPECT_EQ(v.size(), 100);
+    EXPECT_GE(v.capacity(), 100);
+    EXPECT_EQ(v[99], "99");
+
+    v.insert(v.begin(), "front");
+    v.insert(v.begin() + 50, 3, "mid");
+    v.emplace(v.end(), "back");
+    EXPECT_EQ(v.front(), "front");
+    EXPECT_EQ(v[50], "mid");
+    EXPECT_EQ(v[52], "mid");
+    EXPECT_EQ(v[53], "49");
+    EXPECT_EQ(v.back(), "back");
+
+    //  插入容器内的元素
+    v.insert(v.begin(), v.back());
+    EXPECT_EQ(v.front(), "back");
+
+    v.erase(v.begin(), v.begin() + 2);
+    EXPECT_EQ(v.front(), "0");
+    EXPECT_EQ(erase(v, "mid"), 3);
+    EXPECT_EQ(v[49], "49");
+    v.pop_back();
+    EXPECT_EQ(v.back(), "99");
+
+    v.resize(10);
+    EXPECT_EQ(v.size(), 10);
+    v.resize(12, "r");
+    EXPECT_EQ(v.back(), "r");
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 12);
+    v.clear();
+    EXPECT_TRUE(v.empty());
+}
+
+//  可平凡重定位元素、reserve_exact、resize_for_overwrite、unchecked_push_back
+TEST(vector_test, case_3) {
+    auto origin = shared_ptr<int>(new int(1));
+    auto v = vector<shared_ptr<int>>();
+    for (auto i = 0; i < 1000; ++i) {
+        v.push_back(origin);
+    }
+    v.insert(v.begin() + 10, 10, shared_ptr<int>());
+    v.erase(v.begin(), v.begin() + 5);
+    EXPECT_EQ(origin.use_count(), 996);
+    v.clear();
+    EXPECT_EQ(origin.use_count(), 1);
+
+    auto iv = vector<int>();
+    iv.reserve_exact(100);
+    EXPECT_GE(iv.capacity(), 100);
+    for (auto i = 0; i < 100; ++i) {
+        iv.unchecked_push_back(i);
+    }
+    EXPECT_EQ(iv[99], 99);
+    iv.resize_for_overwrite(200);
+    EXPECT_EQ(iv.size(), 200);
+    EXPECT_EQ(iv[99], 99);
+
+    //  增长倍数
+    auto gv = vector<int, allocator<int>, std::ratio<3, 2>>(100);
+    auto cap = gv.capacity();
+    gv.resize(cap);
+    gv.push_back(1);
+    EXPECT_GE(gv.capacity(), cap * 3 / 2);
+    EXPECT_LT(gv.capacity(), cap * 2);
+}
+
+//  有状态分配器
+TEST(vector_test, case_4) {
+    auto mr1 = monotonic_buffer_resource();
+    auto mr2 = monotonic_buffer_resource();
+    auto v1 = vector<int, polymorphic_allocator<int>>({1, 2, 3}, &mr1);
+    auto v2 = vector<int, polymorphic_allocator<int>>(&mr2);
+    v2 = std::move(v1);
+    EXPECT_EQ(v2.get_allocator().resource(), &mr2);
+    EXPECT_EQ(v2.size(), 3);
+    auto v3 = vector<int, polymorphic_allocator<int>>(std::move(v2), &mr1);
+    EXPECT_EQ(v3[2], 3);
+}
+
+//  填满容量后插入，扩容时拷贝抛出异常：原有元素不变且只析构一次
+TEST(vector_test, case_5) {
+    for (auto fail = 1; fail <= 6; ++fail) {
+        {
+            auto v = vector<vector_copy_only>();
+            v.reserve_exact(4);
+            while (v.size() < v.capacity()) {
+                v.emplace_back(static_cast<int>(v.size()));
+            }
+            auto n = v.size();
+            auto x = vector_copy_only(9);
+            vector_copy_only::countdown = fail;
+            if (fail % 2) {
+                EXPECT_THROW(v.emplace(v.begin() + 1, x), std::runtime_error);
+            } else {
+                EXPECT_THROW(v.insert(v.begin() + 1, 2, x), std::runtime_error);
+            }
+            vector_copy_only::countdown = 0;
+            EXPECT_EQ(v.size(), n);
+            for (auto i = size_t{0}; i < n; ++i) {
+                EXPECT_EQ(v[i].v, static_cast<int>(i));
+            }
+        }
+        EXPECT_EQ(vector_copy_only::live, 0);
+        EXPECT_EQ(vector_copy_only::double_destroyed, 0);
+    }
+}
+
+//  构造函数中元素拷贝抛出异常：已构造的元素被销毁，内存被释放
+TEST(vector_test, case_6) {
+    using V = vector<vector_copy_only, vector_counting_alloc<vector_copy_only>>;
+    auto src = std::list<vector_copy_only>();
+    for (auto i = 0; i < 8; ++i) {
+        src.emplace_back(i);
+    }
+    auto full = V(src.begin(), src.end());
+    for (auto fail = 1; fail <= 8; ++fail) {
+        vector_copy_only::countdown = fail;
+        EXPECT_THROW(V(8, src.front()), std::runtime_error);
+        vector_copy_only::countdown = fail;
+        EXPECT_THROW(V(src.begin(), src.end()), std::runtime_error);
+        vector_copy_only::countdown = fail;
+        EXPECT_THROW(V(std::as_const(full)), std::runtime_error);
+        // 输入迭代器逐个 emplace_back，扩容时也会拷贝
+        auto in = std::istringstream("1 2 3 4 5 6 7 8 9 10 11 12");
+        vector_copy_only::countdown = fail;
+        try {
+            auto v = V(std::istream_iterator<int>(in), std::istream_iterator<int>());
+        } catch (const std::runtime_error &) {
+        }
+        vector_copy_only::countdown = 0;
+        EXPECT_EQ(vector_copy_only::live, 16);
+        EXPECT_EQ(vector_counting_alloc<vector_copy_only>::outstanding, 1);
+    }
+    EXPECT_EQ(vector_copy_only::double_destroyed, 0);
+}
@@ -246,13 +246,18 @@ namespace mtl {
         };
 
         // any 的默认构造函数是不会抛出异常的，因此如果 T 的默认构造函数可能抛出异常，那么其只能存放在堆中。这样 any 默认构造时，不会立即初始化，也就不会抛出异常。
+        // 栈内存中只存放可平凡重定位的对象，从而 any 本身也可平凡重定位。
+        // 栈内存为三个指针大小，可以容纳 SSO 字符串、vector 等常见对象。
+        static constexpr size_t _stack_mem_size = 3 * sizeof(void *);
+
         template <typename T>
-        using _any_manager_t = std::conditional_t<sizeof(T) <= sizeof(void *) && std::is_nothrow_constructible_v<T>,
+        using _any_manager_t = std::conditional_t<sizeof(T) <= _stack_mem_size && alignof(T) <= alignof(void *) && std::is_nothrow_constructible_v<T> &&
+                                                      is_trivially_relocatable_v<T>,
                                                   _any_stack_mem_manager<T>, _any_heap_mem_manager<T>>;
 
       public:
         union {
-            char m_stack_mem[sizeof(void *)];
+            char m_stack_mem[_stack_mem_size];
             void *m_heap_mem;
         };
         _any_manager_manage_t m_manage = nullptr;
@@ -291,4 +296,10 @@ namespace mtl {
 
     template <typename T, typename U, typename... Args>
     auto make_any(std::initializer_list<U> lst, Args &&...args) { return any(in_place_type<T>, lst, std::forward<Args>(args)...); }
-} // namespace mtl
\ No newline at end of file
+} // namespace mtl
+
+// trivially relocatable
+namespace mtl {
+    template <>
+    struct is_trivially_relocatable<any> : public std::true_type {};
+} // namespace mtl
@@ -1,4 +1,5 @@
 #pragma once
+#include "pool_allocator.hpp"
 #include "tuple.hpp"
 #include "utility.hpp"
 
@@ -180,6 +181,30 @@ namespace mtl {
 namespace mtl {
     class bad_function_call : public std::exception {};
 
+    // 堆上的可调用对象从内存池分配
+    template <typename F, typename... Args>
+    auto _function_heap_new(Args &&...args) -> F * {
+        auto alloc = pool_allocator<F>{};
+        auto p = alloc.allocate(1);
+        try {
+            std::construct_at(p, std::forward<Args>(args)...);
+        } catch (...) {
+            alloc.deallocate(p, 1);
+            throw;
+        }
+        return p;
+    }
+
+    template <typename F>
+    auto _function_heap_delete(F *p) -> void {
+        std::destroy_at(p);
+        pool_allocator<F>{}.deallocate(p, 1);
+    }
+
+    // 小对象且可平凡重定位时存放在栈内存中，移动 function 时直接拷贝 stack_mem 的字节
+    template <typename F>
+    constexpr bool _function_use_stack = sizeof(F) <= sizeof(void *) && is_trivially_relocatable_v<F>;
+
     template <typename Ret, typename... Args>
     class _function_storage {
         using del_type = void (*)(void *);                                         // 删除器，传入 stack_mem
@@ -191,19 +216,19 @@ namespace mtl {
         template <typename F>
             requires(!std::same_as<F, _function_storage>)
         constexpr _function_storage(F f) {
-            if constexpr (sizeof(F) <= sizeof(void *)) {
+            if constexpr (_function_use_stack<F>) {
                 std::construct_at(reinterpret_cast<F *>(stack_mem), std::forward<F>(f));
                 m_del = [](void *mem) { (*reinterpret_cast<F *>(mem)).~F(); };
             } else {
-                heap_mem = new F(std::forward<F>(f));
-                m_del = [](void *mem) { delete reinterpret_cast<F *>((*reinterpret_cast<std::ptrdiff_t *>(mem))); }; // 通过 stack_mem 获取 heap_mem 的值
+                heap_mem = _function_heap_new<F>(std::forward<F>(f));
+                m_del = [](void *mem) { _function_heap_delete(reinterpret_cast<F *>((*reinterpret_cast<std::ptrdiff_t *>(mem)))); }; // 通过 stack_mem 获取 heap_mem 的值
             }
             m_cop = [](const _function_storage *src, _function_storage *dst) {
                 dst->reset();
-                if constexpr (sizeof(F) <= sizeof(void *)) {
+                if constexpr (_function_use_stack<F>) {
                     std::construct_at(reinterpret_cast<F *>(dst->stack_mem), *reinterpret_cast<F *>(const_cast<char *>(src->stack_mem)));
                 } else {
-                    dst->heap_mem = new F(*reinterpret_cast<F *>(src->heap_mem));
+                    dst->heap_mem = _function_heap_new<F>(*reinterpret_cast<F *>(src->heap_mem));
                 }
                 dst->m_cop = src->m_cop;
                 dst->m_mov = src->m_mov;
@@ -222,7 +247,7 @@ namespace mtl {
                 src->m_tinfo = nullptr;
             };
             m_ivk = [](const _function_storage *_this, Args... args) -> Ret {
-                if constexpr (sizeof(F) <= sizeof(void *)) {
+                if constexpr (_function_use_stack<F>) {
                     return invoke(*reinterpret_cast<F *>(const_cast<char *>(_this->stack_mem)), std::forward<Args>(args)...);
                 } else {
                     return invoke(*reinterpret_cast<F *>(_this->heap_mem), std::forward<Args>(args)...);
@@ -319,7 +344,7 @@ namespace mtl {
 
         template <typename T>
         auto target() noexcept -> T * {
-            if constexpr (sizeof(T) <= sizeof(void *)) {
+            if constexpr (_function_use_stack<T>) {
                 return target_type() == typeid(T) ? const_cast<char *>(m_storage.stack_mem) : nullptr;
             } else {
                 return target_type() == typeid(T) ? m_storage.heap_mem : nullptr;
@@ -328,7 +353,7 @@ namespace mtl {
 
         template <typename T>
         auto target() const noexcept -> const T * {
-            if constexpr (sizeof(T) <= sizeof(void *)) {
+            if constexpr (_function_use_stack<T>) {
                 return target_type() == typeid(T) ? const_cast<char *>(m_storage.stack_mem) : nullptr;
             } else {
                 return target_type() == typeid(T) ? m_storage.heap_mem : nullptr;
@@ -386,4 +411,65 @@ namespace mtl {
     auto swap(function<R(Args...)> &lhs, function<R(Args...)> &rhs) -> void {
         lhs.swap(rhs);
     }
-} // namespace mtl
\ No newline at end of file
+} // namespace mtl
+
+// function_ref
+namespace mtl {
+    // https://wg21.link/p0792
+    // 不拥有可调用对象的类型擦除引用：只保存对象地址和一个调用入口，复制只是复制两个指针，不会分配内存。
+    // 引用的可调用对象必须比 function_ref 活得久，适合作为函数参数。
+    template <typename Sig>
+    class function_ref;
+
+    template <typename Ret, typename... Args>
+    class function_ref<Ret(Args...)> {
+        union storage {
+            void *obj;
+            void (*fn)();
+        };
+
+      public:
+        template <typename F>
+            requires(!std::is_same_v<std::remove_cvref_t<F>, function_ref> && !std::is_function_v<std::remove_reference_t<F>> &&
+                     std::is_invocable_r_v<Ret, std::remove_reference_t<F> &, Args...>)
+        function_ref(F &&f) noexcept {
+            using T = std::remove_reference_t<F>;
+            m_storage.obj = const_cast<void *>(static_cast<const void *>(std::addressof(f)));
+            m_call = [](storage s, Args... args) -> Ret { return invoke(*static_cast<T *>(s.obj), std::forward<Args>(args)...); };
+        }
+
+        template <typename F>
+            requires std::is_function_v<F> && std::is_invocable_r_v<Ret, F &, Args...>
+        function_ref(F *f) noexcept {
+            m_storage.fn = reinterpret_cast<void (*)()>(f);
+            m_call = [](storage s, Args... args) -> Ret { return invoke(reinterpret_cast<F *>(s.fn), std::forward<Args>(args)...); };
+        }
+
+        function_ref(const function_ref &) noexcept = default;
+
+        auto operator=(const function_ref &) noexcept -> function_ref & = default;
+
+      public:
+        auto operator()(Args... args) const -> Ret { return m_call(m_storage, std::forward<Args>(args)...); }
+
+      public:
+        storage m_storage;
+        Ret (*m_call)(storage, Args...);
+    };
+
+    template <typename Ret, typename... Args>
+    function_ref(Ret (*)(Args...)) -> function_ref<Ret(Args...)>;
+} // namespace mtl
+
+// trivially relocatable
+namespace mtl {
+    template <typename Ret, typename... Args>
+    struct is_trivially_relocatable<function_ref<Ret(Args...)>> : public std::true_type {};
+
+    // 栈内存中只存放可平凡重定位的对象，其余成员均为指针
+    template <typename Ret, typename... Args>
+    struct is_trivially_relocatable<function<Ret(Args...)>> : public std::true_type {};
+
+    template <typename T>
+    struct is_trivially_relocatable<reference_wrapper<T>> : public std::true_type {};
+} // namespace mtl
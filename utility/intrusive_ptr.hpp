@@ -0,0 +1,215 @@
+/*
+    引用计数保存在对象内部的智能指针
+    https://www.boost.org/doc/libs/release/libs/smart_ptr/doc/html/smart_ptr.html#intrusive_ptr
+*/
+#pragma once
+#include "unique_ptr.hpp"
+#include "utility.hpp"
+#include <atomic>
+#include <compare>
+#include <utility>
+
+// thread policy
+namespace mtl {
+    // 原子计数，可以在多个线程间共享对象
+    struct thread_safe_counter {
+        using type = std::atomic<size_t>;
+
+        static auto load(const type &c) noexcept -> size_t { return c.load(std::memory_order_relaxed); }
+
+        static auto increment(type &c) noexcept -> void { c.fetch_add(1, std::memory_order_relaxed); }
+
+        // 返回减少后的计数。减为 0 时需要看到其他线程在释放引用前对对象的全部修改
+        static auto decrement(type &c) noexcept -> size_t { return c.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+    };
+
+    // 普通整数计数，对象只在一个线程内使用
+    struct thread_unsafe_counter {
+        using type = size_t;
+
+        static auto load(const type &c) noexcept -> size_t { return c; }
+
+        static auto increment(type &c) noexcept -> void { ++c; }
+
+        static auto decrement(type &c) noexcept -> size_t { return --c; }
+    };
+} // namespace mtl
+
+// intrusive_ref_counter
+namespace mtl {
+    // CRTP 基类，为 Derived 提供引用计数与 add_ref / release 钩子。
+    // 计数从 0 开始，由第一个 intrusive_ptr 增加到 1；复制对象时不复制计数
+    template <typename Derived, typename ThreadPolicy = thread_safe_counter>
+    class intrusive_ref_counter {
+      public:
+        auto use_count() const noexcept -> size_t { return ThreadPolicy::load(m_refs); }
+
+      protected:
+        constexpr intrusive_ref_counter() noexcept = default;
+
+        intrusive_ref_counter(const intrusive_ref_counter &) noexcept {}
+
+        ~intrusive_ref_counter() = default;
+
+        auto operator=(const intrusive_ref_counter &) noexcept -> intrusive_ref_counter & { return *this; }
+
+        // 通过 ADL 查找
+      public:
+        friend auto add_ref(const intrusive_ref_counter *p) noexcept -> void { ThreadPolicy::increment(p->m_refs); }
+
+        friend auto release(const intrusive_ref_counter *p) noexcept -> void {
+            if (ThreadPolicy::decrement(p->m_refs) == 0) {
+                delete static_cast<const Derived *>(p);
+            }
+        }
+
+      private:
+        mutable typename ThreadPolicy::type m_refs{0};
+    };
+
+    // 在 mtl 命名空间内调用，避免与 intrusive_ptr 的成员函数同名而屏蔽 ADL
+    template <typename T>
+    auto _intrusive_add_ref(T *p) noexcept -> void { add_ref(p); }
+
+    template <typename T>
+    auto _intrusive_release(T *p) noexcept -> void { release(p); }
+} // namespace mtl
+
+// intrusive_ptr
+namespace mtl {
+    // T 需要提供可以通过 ADL 找到的 add_ref(T*) 与 release(T*)，可以继承 intrusive_ref_counter 得到。
+    // 只持有一个指针，没有控制块
+    template <typename T>
+    class intrusive_ptr {
+      public:
+        using element_type = T;
+
+        // 构造
+      public:
+        constexpr intrusive_ptr() noexcept = default;
+
+        constexpr intrusive_ptr(std::nullptr_t) noexcept {}
+
+        // add_ref 为 false 时接管 p 已有的一个引用
+        intrusive_ptr(T *p, bool add_ref = true) noexcept : m_ptr(p) {
+            if (m_ptr && add_ref) {
+                _intrusive_add_ref(m_ptr);
+            }
+        }
+
+        intrusive_ptr(const intrusive_ptr &p) noexcept : intrusive_ptr(p.m_ptr) {}
+
+        template <typename U>
+            requires(std::is_convertible_v<U *, T *>)
+        intrusive_ptr(const intrusive_ptr<U> &p) noexcept : intrusive_ptr(p.get()) {}
+
+        intrusive_ptr(intrusive_ptr &&p) noexcept : m_ptr(std::exchange(p.m_ptr, nullptr)) {}
+
+        template <typename U>
+            requires(std::is_convertible_v<U *, T *>)
+        intrusive_ptr(intrusive_ptr<U> &&p) noexcept : m_ptr(p.detach()) {}
+
+        // 接管 unique_ptr 释放的对象，之后由引用计数管理
+        template <typename U>
+            requires(std::is_convertible_v<U *, T *>)
+        intrusive_ptr(unique_ptr<U, default_delete<U>> &&u) noexcept : intrusive_ptr(u.release()) {}
+
+        ~intrusive_ptr() {
+            if (m_ptr) {
+                _intrusive_release(m_ptr);
+            }
+        }
+
+        // assignment
+      public:
+        auto operator=(const intrusive_ptr &p) noexcept -> intrusive_ptr & {
+            intrusive_ptr(p).swap(*this);
+            return *this;
+        }
+
+        template <typename U>
+        auto operator=(const intrusive_ptr<U> &p) noexcept -> intrusive_ptr & {
+            intrusive_ptr(p).swap(*this);
+            return *this;
+        }
+
+        auto operator=(intrusive_ptr &&p) noexcept -> intrusive_ptr & {
+            intrusive_ptr(std::move(p)).swap(*this);
+            return *this;
+        }
+
+        template <typename U>
+        auto operator=(intrusive_ptr<U> &&p) noexcept -> intrusive_ptr & {
+            intrusive_ptr(std::move(p)).swap(*this);
+            return *this;
+        }
+
+        auto operator=(T *p) noexcept -> intrusive_ptr & {
+            intrusive_ptr(p).swap(*this);
+            return *this;
+        }
+
+        template <typename U>
+        auto operator=(unique_ptr<U, default_delete<U>> &&u) noexcept -> intrusive_ptr & {
+            intrusive_ptr(std::move(u)).swap(*this);
+            return *this;
+        }
+
+        // observer
+      public:
+        auto operator*() const noexcept -> T & { return *m_ptr; }
+
+        auto operator->() const noexcept -> T * { return m_ptr; }
+
+        explicit operator bool() const noexcept { return m_ptr != nullptr; }
+
+        auto get() const noexcept -> T * { return m_ptr; }
+
+        // modifier
+      public:
+        auto swap(intrusive_ptr &p) noexcept { std::swap(m_ptr, p.m_ptr); }
+
+        auto reset() noexcept -> void { intrusive_ptr().swap(*this); }
+
+        auto reset(T *p) noexcept -> void { intrusive_ptr(p).swap(*this); }
+
+        auto reset(T *p, bool add_ref) noexcept -> void { intrusive_ptr(p, add_ref).swap(*this); }
+
+        // 放弃所有权但不减少计数，返回的指针持有一个引用，可以用 intrusive_ptr(p, false) 重新接管
+        auto detach() noexcept -> T * { return std::exchange(m_ptr, nullptr); }
+
+      public:
+        T *m_ptr{nullptr};
+    };
+
+    template <typename T, typename... Args>
+    auto make_intrusive(Args &&...args) -> intrusive_ptr<T> { return intrusive_ptr<T>(new T(std::forward<Args>(args)...)); }
+
+    template <typename T, typename U>
+    auto static_pointer_cast(const intrusive_ptr<U> &p) noexcept -> intrusive_ptr<T> { return intrusive_ptr<T>(static_cast<T *>(p.get())); }
+
+    template <typename T, typename U>
+    auto dynamic_pointer_cast(const intrusive_ptr<U> &p) noexcept -> intrusive_ptr<T> { return intrusive_ptr<T>(dynamic_cast<T *>(p.get())); }
+} // namespace mtl
+
+// relational operators
+namespace mtl {
+    template <typename T, typename U>
+    auto operator==(const intrusive_ptr<T> &lhs, const intrusive_ptr<U> &rhs) noexcept -> bool { return lhs.get() == rhs.get(); }
+
+    template <typename T, typename U>
+    auto operator<=>(const intrusive_ptr<T> &lhs, const intrusive_ptr<U> &rhs) noexcept { return lhs.get() <=> rhs.get(); }
+
+    template <typename T>
+    auto operator==(const intrusive_ptr<T> &lhs, std::nullptr_t) noexcept -> bool { return lhs.get() == nullptr; }
+
+    template <typename T>
+    auto swap(intrusive_ptr<T> &lhs, intrusive_ptr<T> &rhs) noexcept -> void { lhs.swap(rhs); }
+} // namespace mtl
+
+// trivially relocatable
+namespace mtl {
+    // 只持有一个指针，计数在对象内部，搬移时无需修改
+    template <typename T>
+    struct is_trivially_relocatable<intrusive_ptr<T>> : public std::true_type {};
+} // namespace mtl
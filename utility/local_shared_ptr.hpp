@@ -0,0 +1,459 @@
+/*
+    只在单个线程内共享所有权的智能指针，计数为普通整数
+    https://www.boost.org/doc/libs/release/libs/smart_ptr/doc/html/smart_ptr.html#local_shared_ptr
+*/
+#pragma once
+#include "shared_ptr.hpp"
+#include "unique_ptr.hpp"
+#include "utility.hpp"
+#include <cassert>
+#include <new>
+#include <thread>
+#include <utility>
+
+namespace mtl {
+    // 转换为 shared_ptr 时，local_shared_ptr 不是对象唯一的所有者
+    struct bad_local_share : public std::exception {};
+
+    template <typename T>
+    class local_shared_ptr;
+
+    template <typename T>
+    class local_weak_ptr;
+} // namespace mtl
+
+// storage
+namespace mtl {
+    // 控制块与元素类型无关，因此可以在 local_shared_ptr<Derived> 与 local_shared_ptr<Base> 之间转换。
+    // 调试模式下记录创建控制块的线程，每次修改计数时检查是否在同一线程
+    struct _local_ctlblk {
+        _local_ctlblk() noexcept = default;
+
+        _local_ctlblk(const _local_ctlblk &) = delete;
+
+        virtual ~_local_ctlblk() = default;
+
+        // 销毁对象
+        virtual auto dispose() noexcept -> void = 0;
+
+        auto check_thread() const noexcept -> void {
+#ifndef NDEBUG
+            assert(m_owner == std::this_thread::get_id() && "local_shared_ptr used from another thread");
+#endif
+        }
+
+        auto inc_s() noexcept -> void {
+            check_thread();
+            ++s_count;
+        }
+
+        auto try_inc_s() noexcept -> bool {
+            check_thread();
+            if (s_count == 0) {
+                return false;
+            }
+            ++s_count;
+            return true;
+        }
+
+        auto dec_s() noexcept -> void {
+            check_thread();
+            if (--s_count == 0) {
+                dispose();
+                dec_w();
+            }
+        }
+
+        auto inc_w() noexcept -> void {
+            check_thread();
+            ++w_count;
+        }
+
+        auto dec_w() noexcept -> void {
+            check_thread();
+            if (--w_count == 0) {
+                delete this;
+            }
+        }
+
+        size_t s_count{1};
+        size_t w_count{1}; // 所有 local_shared_ptr 共同持有一个弱引用
+#ifndef NDEBUG
+        std::thread::id m_owner{std::this_thread::get_id()};
+#endif
+    };
+
+    // 接管指针 p，通过删除器 d 销毁
+    template <typename P, typename D>
+    struct _local_ctlblk_ptr final : _local_ctlblk {
+        _local_ctlblk_ptr(P p, D d) noexcept : m_ptr(p), m_del(std::move(d)) {}
+
+        auto dispose() noexcept -> void override { m_del(m_ptr); }
+
+        P m_ptr;
+        D m_del;
+    };
+
+    // make_local_shared：对象与控制块在同一次分配中
+    template <typename T>
+    struct _local_ctlblk_inplace final : _local_ctlblk {
+        template <typename... Args>
+        explicit _local_ctlblk_inplace(Args &&...args) {
+            ::new (static_cast<void *>(&m_storage)) T(std::forward<Args>(args)...);
+        }
+
+        auto get() noexcept -> T * { return std::launder(reinterpret_cast<T *>(&m_storage)); }
+
+        auto dispose() noexcept -> void override { get()->~T(); }
+
+        alignas(T) unsigned char m_storage[sizeof(T)];
+    };
+
+    // local_shared_ptr::share() 得到的 shared_ptr 的删除器，在最后一个 shared_ptr 释放时释放原来的控制块
+    template <typename T>
+    struct _local_share_deleter {
+        auto operator()(T *) const noexcept -> void {
+#ifndef NDEBUG
+            m_ctlblk->m_owner = std::this_thread::get_id();
+#endif
+            m_ctlblk->dec_s();
+        }
+
+        _local_ctlblk *m_ctlblk{nullptr};
+    };
+} // namespace mtl
+
+// local_weak_ptr
+namespace mtl {
+    template <typename T>
+    class local_weak_ptr {
+      public:
+        using element_type = std::remove_extent_t<T>;
+
+        // 构造
+      public:
+        constexpr local_weak_ptr() noexcept = default;
+
+        local_weak_ptr(const local_weak_ptr &w) noexcept : m_ptr(w.m_ptr), m_ctlblk(w.m_ctlblk) {
+            if (m_ctlblk) {
+                m_ctlblk->inc_w();
+            }
+        }
+
+        template <typename U>
+            requires(std::is_convertible_v<U *, T *>)
+        local_weak_ptr(const local_weak_ptr<U> &w) noexcept : m_ptr(w.m_ptr), m_ctlblk(w.m_ctlblk) {
+            if (m_ctlblk) {
+                m_ctlblk->inc_w();
+            }
+        }
+
+        template <typename U>
+            requires(std::is_convertible_v<U *, T *>)
+        local_weak_ptr(const local_shared_ptr<U> &s) noexcept : m_ptr(s.m_ptr), m_ctlblk(s.m_ctlblk) {
+            if (m_ctlblk) {
+                m_ctlblk->inc_w();
+            }
+        }
+
+        local_weak_ptr(local_weak_ptr &&w) noexcept : m_ptr(std::exchange(w.m_ptr, nullptr)), m_ctlblk(std::exchange(w.m_ctlblk, nullptr)) {}
+
+        template <typename U>
+            requires(std::is_convertible_v<U *, T *>)
+        local_weak_ptr(local_weak_ptr<U> &&w) noexcept : m_ptr(std::exchange(w.m_ptr, nullptr)), m_ctlblk(std::exchange(w.m_ctlblk, nullptr)) {}
+
+        ~local_weak_ptr() {
+            if (m_ctlblk) {
+                m_ctlblk->dec_w();
+            }
+        }
+
+        // assignment
+      public:
+        auto operator=(const local_weak_ptr &w) noexcept -> local_weak_ptr & {
+            local_weak_ptr(w).swap(*this);
+            return *this;
+        }
+
+        template <typename U>
+        auto operator=(const local_weak_ptr<U> &w) noexcept -> local_weak_ptr & {
+            local_weak_ptr(w).swap(*this);
+            return *this;
+        }
+
+        template <typename U>
+        auto operator=(const local_shared_ptr<U> &s) noexcept -> local_weak_ptr & {
+            local_weak_ptr(s).swap(*this);
+            return *this;
+        }
+
+        auto operator=(local_weak_ptr &&w) noexcept -> local_weak_ptr & {
+            local_weak_ptr(std::move(w)).swap(*this);
+            return *this;
+        }
+
+        template <typename U>
+        auto operator=(local_weak_ptr<U> &&w) noexcept -> local_weak_ptr & {
+            local_weak_ptr(std::move(w)).swap(*this);
+            return *this;
+        }
+
+        // modifier
+      public:
+        auto swap(local_weak_ptr &w) noexcept {
+            std::swap(m_ptr, w.m_ptr);
+            std::swap(m_ctlblk, w.m_ctlblk);
+        }
+
+        auto reset() noexcept { local_weak_ptr().swap(*this); }
+
+        // observer
+      public:
+        auto use_count() const noexcept -> size_t { return m_ctlblk == nullptr ? 0 : m_ctlblk->s_count; }
+
+        auto expired() const noexcept -> bool { return use_count() == 0; }
+
+        auto lock() const noexcept -> local_shared_ptr<T> {
+            auto s = local_shared_ptr<T>();
+            if (m_ctlblk && m_ctlblk->try_inc_s()) {
+                s.m_ptr = m_ptr;
+                s.m_ctlblk = m_ctlblk;
+            }
+            return s;
+        }
+
+        template <typename U>
+        auto owner_before(const local_shared_ptr<U> &s) const noexcept -> bool { return m_ctlblk < s.m_ctlblk; }
+
+        template <typename U>
+        auto owner_before(const local_weak_ptr<U> &w) const noexcept -> bool { return m_ctlblk < w.m_ctlblk; }
+
+      public:
+        element_type *m_ptr{nullptr};
+        _local_ctlblk *m_ctlblk{nullptr};
+    };
+} // namespace mtl
+
+// local_shared_ptr
+namespace mtl {
+    // 接口与 shared_ptr 相同，但引用计数是普通整数，复制与销毁没有原子操作。
+    // 所有副本（包括 local_weak_ptr）必须在创建它的线程上使用，调试模式下违反时断言失败；
+    // 需要跨线程时，唯一的所有者可以通过 share() 显式转换为 shared_ptr
+    template <typename T>
+    class local_shared_ptr {
+      public:
+        using element_type = std::remove_extent_t<T>;
+        using weak_type = local_weak_ptr<T>;
+
+        // 构造
+      public:
+        constexpr local_shared_ptr() noexcept = default;
+
+        constexpr local_shared_ptr(std::nullptr_t) noexcept {}
+
+        template <typename U>
+            requires(std::is_convertible_v<U (*)[], T *> ||
+                     std::is_convertible_v<U *, T *>)
+        explicit local_shared_ptr(U *p) : local_shared_ptr(p, default_delete<std::conditional_t<std::is_array_v<T>, U[], U>>()) {}
+
+        // 分配控制块失败时用 d 销毁 p
+        template <typename U, typename D>
+            requires(std::is_move_constructible_v<D> &&
+                     (std::is_convertible_v<U (*)[], T *> ||
+                      std::is_convertible_v<U *, T *>))
+        local_shared_ptr(U *p, D d) : m_ptr(p) {
+            try {
+                m_ctlblk = new _local_ctlblk_ptr<U *, D>(p, std::move(d));
+            } catch (...) {
+                d(p);
+                throw;
+            }
+        }
+
+        // 别名构造：与 s 共享所有权，但指向 p
+        template <typename U>
+        local_shared_ptr(const local_shared_ptr<U> &s, element_type *p) noexcept : m_ptr(p), m_ctlblk(s.m_ctlblk) {
+            if (m_ctlblk) {
+                m_ctlblk->inc_s();
+            }
+        }
+
+        local_shared_ptr(const local_shared_ptr &s) noexcept : m_ptr(s.m_ptr), m_ctlblk(s.m_ctlblk) {
+            if (m_ctlblk) {
+                m_ctlblk->inc_s();
+            }
+        }
+
+        template <typename U>
+            requires(std::is_convertible_v<U *, T *>)
+        local_shared_ptr(const local_shared_ptr<U> &s) noexcept : m_ptr(s.m_ptr), m_ctlblk(s.m_ctlblk) {
+            if (m_ctlblk) {
+                m_ctlblk->inc_s();
+            }
+        }
+
+        local_shared_ptr(local_shared_ptr &&s) noexcept : m_ptr(std::exchange(s.m_ptr, nullptr)), m_ctlblk(std::exchange(s.m_ctlblk, nullptr)) {}
+
+        template <typename U>
+            requires(std::is_convertible_v<U *, T *>)
+        local_shared_ptr(local_shared_ptr<U> &&s) noexcept : m_ptr(std::exchange(s.m_ptr, nullptr)), m_ctlblk(std::exchange(s.m_ctlblk, nullptr)) {}
+
+        template <typename U>
+            requires(std::is_convertible_v<U *, T *>)
+        explicit local_shared_ptr(const local_weak_ptr<U> &w) {
+            if (w.m_ctlblk == nullptr || !w.m_ctlblk->try_inc_s()) {
+                throw bad_weak_ptr();
+            }
+            m_ptr = w.m_ptr;
+            m_ctlblk = w.m_ctlblk;
+        }
+
+        template <typename U, typename D>
+            requires(std::is_convertible_v<typename unique_ptr<U, D>::pointer, element_type *>)
+        local_shared_ptr(unique_ptr<U, D> &&u) {
+            if (u.get()) {
+                if constexpr (std::is_lvalue_reference_v<D>) {
+                    local_shared_ptr(u.get(), std::ref(u.get_deleter())).swap(*this);
+                } else {
+                    local_shared_ptr(u.get(), u.get_deleter()).swap(*this);
+                }
+                u.release();
+            }
+        }
+
+        ~local_shared_ptr() {
+            if (m_ctlblk) {
+                m_ctlblk->dec_s();
+            }
+        }
+
+        // assignment
+      public:
+        auto operator=(const local_shared_ptr &s) noexcept -> local_shared_ptr & {
+            local_shared_ptr(s).swap(*this);
+            return *this;
+        }
+
+        template <typename U>
+        auto operator=(const local_shared_ptr<U> &s) noexcept -> local_shared_ptr & {
+            local_shared_ptr(s).swap(*this);
+            return *this;
+        }
+
+        auto operator=(local_shared_ptr &&s) noexcept -> local_shared_ptr & {
+            local_shared_ptr(std::move(s)).swap(*this);
+            return *this;
+        }
+
+        template <typename U>
+        auto operator=(local_shared_ptr<U> &&s) noexcept -> local_shared_ptr & {
+            local_shared_ptr(std::move(s)).swap(*this);
+            return *this;
+        }
+
+        template <typename U, typename D>
+        auto operator=(unique_ptr<U, D> &&u) -> local_shared_ptr & {
+            local_shared_ptr(std::move(u)).swap(*this);
+            return *this;
+        }
+
+        // observer
+      public:
+        auto operator*() const noexcept -> element_type & { return *get(); }
+
+        auto operator->() const noexcept
+            requires(!std::is_array_v<T>)
+        { return get(); }
+
+        auto operator[](std::ptrdiff_t i) const -> element_type &
+            requires(std::is_array_v<T>)
+        { return get()[i]; }
+
+        explicit operator bool() const noexcept { return get() != nullptr; }
+
+        auto get() const noexcept -> element_type * { return m_ptr; }
+
+        auto use_count() const noexcept -> size_t { return m_ctlblk == nullptr ? 0 : m_ctlblk->s_count; }
+
+        template <typename U>
+        auto owner_before(const local_shared_ptr<U> &s) const noexcept -> bool { return m_ctlblk < s.m_ctlblk; }
+
+        template <typename U>
+        auto owner_before(const local_weak_ptr<U> &w) const noexcept -> bool { return m_ctlblk < w.m_ctlblk; }
+
+        // modifier
+      public:
+        auto swap(local_shared_ptr &s) noexcept {
+            std::swap(m_ptr, s.m_ptr);
+            std::swap(m_ctlblk, s.m_ctlblk);
+        }
+
+        auto reset() noexcept -> void { local_shared_ptr().swap(*this); }
+
+        template <typename U>
+        auto reset(U *p) -> void { local_shared_ptr(p).swap(*this); }
+
+        template <typename U, typename D>
+        auto reset(U *p, D d) -> void { local_shared_ptr(p, std::move(d)).swap(*this); }
+
+        // 转换为线程安全的 shared_ptr，之后可以交给其他线程。
+        // 要求本对象是唯一的所有者且没有 local_weak_ptr，否则抛出 bad_local_share，本对象不变。
+        // 转换后控制块由 shared_ptr 的删除器持有，只会在最后一个 shared_ptr 释放时被访问一次
+        auto share() && -> shared_ptr<T> {
+            if (m_ctlblk == nullptr) {
+                return shared_ptr<T>();
+            }
+            m_ctlblk->check_thread();
+            if (m_ctlblk->s_count != 1 || m_ctlblk->w_count != 1) {
+                throw bad_local_share();
+            }
+            // 先为删除器增加一个强引用：构造 shared_ptr 失败时删除器被调用，计数回到 1，对象不会被销毁
+            m_ctlblk->inc_s();
+            auto s = shared_ptr<T>(m_ptr, _local_share_deleter<element_type>{m_ctlblk});
+            m_ctlblk->dec_s();
+#ifndef NDEBUG
+            m_ctlblk->m_owner = std::thread::id(); // 释放时可能在任意线程
+#endif
+            m_ptr = nullptr;
+            m_ctlblk = nullptr;
+            return s;
+        }
+
+      public:
+        element_type *m_ptr{nullptr};
+        _local_ctlblk *m_ctlblk{nullptr};
+    };
+
+    // 对象与控制块一次分配
+    template <typename T, typename... Args>
+    auto make_local_shared(Args &&...args) -> local_shared_ptr<T> {
+        static_assert(!std::is_array_v<T>, "make_local_shared does not support arrays");
+        auto c = new _local_ctlblk_inplace<T>(std::forward<Args>(args)...);
+        auto s = local_shared_ptr<T>();
+        s.m_ptr = c->get();
+        s.m_ctlblk = c;
+        return s;
+    }
+} // namespace mtl
+
+// relational operators
+namespace mtl {
+    template <typename T, typename U>
+    auto operator==(const local_shared_ptr<T> &lhs, const local_shared_ptr<U> &rhs) noexcept -> bool { return lhs.get() == rhs.get(); }
+
+    template <typename T, typename U>
+    auto operator<=>(const local_shared_ptr<T> &lhs, const local_shared_ptr<U> &rhs) noexcept { return lhs.get() <=> rhs.get(); }
+
+    template <typename T>
+    auto operator==(const local_shared_ptr<T> &lhs, std::nullptr_t) noexcept -> bool { return lhs.get() == nullptr; }
+} // namespace mtl
+
+// trivially relocatable
+namespace mtl {
+    // 只持有两个指针，引用计数保存在控制块中，搬移时无需修改
+    template <typename T>
+    struct is_trivially_relocatable<local_shared_ptr<T>> : public std::true_type {};
+
+    template <typename T>
+    struct is_trivially_relocatable<local_weak_ptr<T>> : public std::true_type {};
+} // namespace mtl
@@ -4,6 +4,16 @@
 */
 #pragma once
 #include "utility.hpp"  // IWYU pragma: keep
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 // pointer traits
 namespace mtl {
@@ -132,8 +142,57 @@ namespace mtl {
         auto size_type_(long) -> std::make_unsigned_t<diff_type<Alc>>;
         template <typename Alc>
         using size_type = decltype(size_type_<Alc>(0));
+
+        template <typename Alc>
+        auto pocca_(int) -> Alc::propagate_on_container_copy_assignment;
+        template <typename Alc>
+        auto pocca_(long) -> std::false_type;
+        template <typename Alc>
+        using pocca = decltype(pocca_<Alc>(0));
+
+        template <typename Alc>
+        auto pocma_(int) -> Alc::propagate_on_container_move_assignment;
+        template <typename Alc>
+        auto pocma_(long) -> std::false_type;
+        template <typename Alc>
+        using pocma = decltype(pocma_<Alc>(0));
+
+        template <typename Alc>
+        auto pocs_(int) -> Alc::propagate_on_container_swap;
+        template <typename Alc>
+        auto pocs_(long) -> std::false_type;
+        template <typename Alc>
+        using pocs = decltype(pocs_<Alc>(0));
+
+        template <typename Alc>
+        auto always_equal_(int) -> Alc::is_always_equal;
+        template <typename Alc>
+        auto always_equal_(long) -> std::is_empty<Alc>::type;
+        template <typename Alc>
+        using always_equal = decltype(always_equal_<Alc>(0));
+
+        // Alc<T, Args...> 替换为 Alc<U, Args...>
+        template <typename Alc, typename U>
+        struct rebind_first_;
+        template <template <typename, typename...> typename Alc, typename T, typename... Args, typename U>
+        struct rebind_first_<Alc<T, Args...>, U> {
+            using type = Alc<U, Args...>;
+        };
+
+        template <typename Alc, typename U>
+        auto rebind_(int) -> Alc::template rebind<U>::other;
+        template <typename Alc, typename U>
+        auto rebind_(long) -> rebind_first_<Alc, U>::type;
+        template <typename Alc, typename U>
+        using rebind = decltype(rebind_<Alc, U>(0));
     }  // namespace _allocator_traits_detail
 
+    template <typename Pointer, typename SizeType = size_t>
+    struct allocation_result {
+        Pointer ptr;
+        SizeType count;
+    };
+
     template <typename Alloc>
     struct allocator_traits {
       private:
@@ -146,19 +205,37 @@ namespace mtl {
         using const_void_pointer = _allocator_traits_detail::cvptr<Alloc>;
         using difference_type = _allocator_traits_detail::diff_type<Alloc>;
         using size_type = _allocator_traits_detail::size_type<Alloc>;
-        // 剩下的不想写了
-        // using propagate_on_container_copy_assignment =
-        // using propagate_on_container_move_assignment =
-        // using propagate_on_container_swap =
-        // using is_always_equal =
+        using propagate_on_container_copy_assignment = _allocator_traits_detail::pocca<Alloc>;
+        using propagate_on_container_move_assignment = _allocator_traits_detail::pocma<Alloc>;
+        using propagate_on_container_swap = _allocator_traits_detail::pocs<Alloc>;
+        using is_always_equal = _allocator_traits_detail::always_equal<Alloc>;
+
+        template <typename T>
+        using rebind_alloc = _allocator_traits_detail::rebind<Alloc, T>;
 
         template <typename T>
-        using rebind_alloc = decltype(_allocator_traits_rebind<Alloc, T>(0));
+        using rebind_traits = allocator_traits<rebind_alloc<T>>;
 
       public:
         [[nodiscard]] static constexpr auto allocate(Alloc& a, size_type n) -> pointer { return a.allocate(n); }
 
-        [[nodiscard]] static constexpr auto allocate(Alloc& a, size_t n, const_void_pointer hint) -> pointer { return a.allocate(n, hint); }
+        [[nodiscard]] static constexpr auto allocate(Alloc& a, size_t n, const_void_pointer hint) -> pointer {
+            if constexpr (requires { a.allocate(n, hint); }) {
+                return a.allocate(n, hint);
+            } else {
+                return a.allocate(n);
+            }
+        }
+
+        // 分配器可能返回多于 n 个元素的空间，调用者可以使用全部 count 个元素，并以 count 归还
+        [[nodiscard]] static constexpr auto allocate_at_least(Alloc& a, size_type n) -> allocation_result<pointer, size_type> {
+            if constexpr (requires { a.allocate_at_least(n); }) {
+                auto [ptr, count] = a.allocate_at_least(n);
+                return {ptr, count};
+            } else {
+                return {a.allocate(n), n};
+            }
+        }
 
         static constexpr auto deallocate(Alloc& a, pointer p, size_type n) -> void { a.deallocate(p, n); }
 
@@ -180,7 +257,13 @@ namespace mtl {
             }
         }
 
-        static constexpr auto max_size(const Alloc& a) noexcept -> size_type { return a.max_size(); }
+        static constexpr auto max_size(const Alloc& a) noexcept -> size_type {
+            if constexpr (requires { a.max_size(); }) {
+                return a.max_size();
+            } else {
+                return std::numeric_limits<size_type>::max() / sizeof(value_type);
+            }
+        }
 
         static constexpr auto select_on_container_copy_construction(const Alloc& a) -> Alloc {
             if constexpr (requires { a.select_on_container_copy_construction(); }) {
@@ -194,8 +277,20 @@ namespace mtl {
 
 // default allocator
 namespace mtl {
+    // glibc 下默认对齐的类型直接使用 malloc，以便通过 malloc_usable_size 获取实际可用大小
     template <typename T>
     class allocator {
+        // 以函数形式给出，允许以不完整类型实例化 allocator<T>
+        static constexpr auto _use_malloc() -> bool {
+#if defined(__GLIBC__)
+            return alignof(T) <= alignof(std::max_align_t);
+#else
+            return false;
+#endif
+        }
+
+        static constexpr auto _over_aligned() -> bool { return alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__; }
+
       public:
         using value_type = T;
         using size_type = size_t;
@@ -218,11 +313,364 @@ namespace mtl {
             if (std::numeric_limits<size_t>::max() / sizeof(T) < n) {
                 throw std::bad_array_new_length{};
             }
-            return static_cast<T*>(::operator new(n * sizeof(T)));
+            if constexpr (_use_malloc()) {
+                auto p = std::malloc(n * sizeof(T));
+                if (p == nullptr) {
+                    throw std::bad_alloc{};
+                }
+                return static_cast<T*>(p);
+            } else if constexpr (_over_aligned()) {
+                return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+            } else {
+                return static_cast<T*>(::operator new(n * sizeof(T)));
+            }
         }
 
-        constexpr auto deallocate(T* p, size_t n) -> void {
-            ::operator delete(p);
+        [[nodiscard]] constexpr auto allocate_at_least(size_t n) -> allocation_result<T*> {
+            auto p = allocate(n);
+#if defined(__GLIBC__)
+            if constexpr (_use_malloc()) {
+                return {p, malloc_usable_size(p) / sizeof(T)};
+            }
+#endif
+            return {p, n};
+        }
+
+        constexpr auto deallocate(T* p, size_t) -> void {
+            if constexpr (_use_malloc()) {
+                std::free(p);
+            } else if constexpr (_over_aligned()) {
+                ::operator delete(p, std::align_val_t{alignof(T)});
+            } else {
+                ::operator delete(p);
+            }
         }
     };
-}  // namespace mtl
\ No newline at end of file
+
+    template <typename T, typename U>
+    constexpr auto operator==(const allocator<T>&, const allocator<U>&) noexcept -> bool { return true; }
+}  // namespace mtl
+
+// uninitialized memory algorithms
+namespace mtl {
+    namespace _uninitialized_detail {
+        // 源与目标均为连续迭代器，且元素类型相同
+        template <typename In, typename Out>
+        concept contiguous_same = std::contiguous_iterator<In> && std::contiguous_iterator<Out> &&
+                                  std::is_same_v<std::iter_value_t<In>, std::iter_value_t<Out>> &&
+                                  std::is_same_v<std::iter_reference_t<Out>, std::iter_value_t<Out>&>;
+
+        // 可以整体 memcpy 的拷贝、移动
+        template <typename In, typename Out>
+        concept memcpyable = contiguous_same<In, Out> && std::is_trivially_copyable_v<std::iter_value_t<Out>>;
+
+        // 可以整体 memmove 的重定位
+        template <typename In, typename Out>
+        concept relocatable = contiguous_same<In, Out> && is_trivially_relocatable_v<std::iter_value_t<Out>> &&
+                              std::is_same_v<std::iter_reference_t<In>, std::iter_value_t<In>&>;
+
+        template <typename T>
+        constexpr auto voidify(T& t) noexcept -> void* { return const_cast<void*>(static_cast<const volatile void*>(std::addressof(t))); }
+
+        // 判断对象的二进制表示是否全零
+        template <typename T>
+        auto all_zero(const T& t) noexcept -> bool {
+            auto bytes = reinterpret_cast<const unsigned char*>(std::addressof(t));
+            for (auto i = size_t{0}; i < sizeof(T); ++i) {
+                if (bytes[i] != 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }  // namespace _uninitialized_detail
+
+    template <typename It>
+    constexpr auto destroy(It first, It last) -> void {
+        using T = std::iter_value_t<It>;
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (; first != last; ++first) {
+                std::destroy_at(std::addressof(*first));
+            }
+        }
+    }
+
+    template <typename It, typename Size>
+    constexpr auto destroy_n(It first, Size n) -> It {
+        using T = std::iter_value_t<It>;
+        if constexpr (std::is_trivially_destructible_v<T>) {
+            return std::next(first, n);
+        } else {
+            for (; n > 0; ++first, --n) {
+                std::destroy_at(std::addressof(*first));
+            }
+            return first;
+        }
+    }
+
+    // 逐个构造，构造过程中抛出异常时销毁已构造的元素
+    template <typename In, typename Out, typename F>
+    constexpr auto _uninitialized_for_each(In first, In last, Out d_first, F&& f) -> Out {
+        auto cur = d_first;
+        try {
+            for (; first != last; ++first, ++cur) {
+                f(_uninitialized_detail::voidify(*cur), first);
+            }
+            return cur;
+        } catch (...) {
+            mtl::destroy(d_first, cur);
+            throw;
+        }
+    }
+
+    template <typename In, typename Out>
+    constexpr auto uninitialized_copy(In first, In last, Out d_first) -> Out {
+        using T = std::iter_value_t<Out>;
+        if constexpr (_uninitialized_detail::memcpyable<In, Out>) {
+            if (!std::is_constant_evaluated()) {
+                auto n = static_cast<size_t>(last - first);
+                if (n != 0) {
+                    std::memcpy(std::to_address(d_first), std::to_address(first), n * sizeof(T));
+                }
+                return d_first + n;
+            }
+        }
+        return _uninitialized_for_each(first, last, d_first, [](void* p, In& it) { ::new (p) T(*it); });
+    }
+
+    template <typename In, typename Size, typename Out>
+    constexpr auto uninitialized_copy_n(In first, Size n, Out d_first) -> Out {
+        if constexpr (std::random_access_iterator<In>) {
+            return mtl::uninitialized_copy(first, first + n, d_first);
+        } else {
+            using T = std::iter_value_t<Out>;
+            auto cur = d_first;
+            try {
+                for (; n > 0; ++first, ++cur, --n) {
+                    ::new (_uninitialized_detail::voidify(*cur)) T(*first);
+                }
+                return cur;
+            } catch (...) {
+                mtl::destroy(d_first, cur);
+                throw;
+            }
+        }
+    }
+
+    template <typename In, typename Out>
+    constexpr auto uninitialized_move(In first, In last, Out d_first) -> Out {
+        using T = std::iter_value_t<Out>;
+        if constexpr (_uninitialized_detail::memcpyable<In, Out>) {
+            if (!std::is_constant_evaluated()) {
+                auto n = static_cast<size_t>(last - first);
+                if (n != 0) {
+                    std::memcpy(std::to_address(d_first), std::to_address(first), n * sizeof(T));
+                }
+                return d_first + n;
+            }
+        }
+        return _uninitialized_for_each(first, last, d_first, [](void* p, In& it) { ::new (p) T(std::move(*it)); });
+    }
+
+    template <typename In, typename Size, typename Out>
+    constexpr auto uninitialized_move_n(In first, Size n, Out d_first) -> Out {
+        return mtl::uninitialized_move(first, std::next(first, n), d_first);
+    }
+
+    template <typename It, typename T>
+    constexpr auto uninitialized_fill(It first, It last, const T& value) -> void {
+        using VT = std::iter_value_t<It>;
+        if constexpr (std::contiguous_iterator<It> && std::is_same_v<VT, T> && std::is_trivially_copyable_v<VT>) {
+            if (!std::is_constant_evaluated()) {
+                auto n = static_cast<size_t>(last - first);
+                if (n == 0) {
+                    return;
+                }
+                if constexpr (sizeof(VT) == 1) {
+                    std::memset(std::to_address(first), *reinterpret_cast<const unsigned char*>(&value), n);
+                    return;
+                } else {
+                    if (_uninitialized_detail::all_zero(value)) {
+                        std::memset(std::to_address(first), 0, n * sizeof(VT));
+                        return;
+                    }
+                }
+            }
+        }
+        auto cur = first;
+        try {
+            for (; cur != last; ++cur) {
+                ::new (_uninitialized_detail::voidify(*cur)) VT(value);
+            }
+        } catch (...) {
+            mtl::destroy(first, cur);
+            throw;
+        }
+    }
+
+    template <typename It, typename Size, typename T>
+    constexpr auto uninitialized_fill_n(It first, Size n, const T& value) -> It {
+        auto last = std::next(first, n);
+        mtl::uninitialized_fill(first, last, value);
+        return last;
+    }
+
+    template <typename It>
+    constexpr auto uninitialized_value_construct(It first, It last) -> void {
+        using T = std::iter_value_t<It>;
+        // 标量的值初始化即零初始化（成员指针的空值并非全零，不在此列）
+        if constexpr (std::contiguous_iterator<It> && (std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>)) {
+            if (!std::is_constant_evaluated()) {
+                // 由编译器把循环合并为 memset：直接调用 memset 时，GCC 只看到请求的分配大小，
+                // 写入 allocate_at_least 多给的容量会误报 -Warray-bounds；空区间也不会传入空指针
+                std::fill_n(std::to_address(first), last - first, T());
+                return;
+            }
+        }
+        auto cur = first;
+        try {
+            for (; cur != last; ++cur) {
+                ::new (_uninitialized_detail::voidify(*cur)) T();
+            }
+        } catch (...) {
+            mtl::destroy(first, cur);
+            throw;
+        }
+    }
+
+    template <typename It, typename Size>
+    constexpr auto uninitialized_value_construct_n(It first, Size n) -> It {
+        auto last = std::next(first, n);
+        mtl::uninitialized_value_construct(first, last);
+        return last;
+    }
+
+    // 默认初始化，平凡类型不做任何事（不清零）
+    template <typename It>
+    constexpr auto uninitialized_default_construct(It first, It last) -> void {
+        using T = std::iter_value_t<It>;
+        if constexpr (!std::is_trivially_default_constructible_v<T>) {
+            auto cur = first;
+            try {
+                for (; cur != last; ++cur) {
+                    ::new (_uninitialized_detail::voidify(*cur)) T;
+                }
+            } catch (...) {
+                mtl::destroy(first, cur);
+                throw;
+            }
+        }
+    }
+
+    template <typename It, typename Size>
+    constexpr auto uninitialized_default_construct_n(It first, Size n) -> It {
+        auto last = std::next(first, n);
+        mtl::uninitialized_default_construct(first, last);
+        return last;
+    }
+
+    // 重定位：将 [first, last) 的对象搬到 d_first 开始的未初始化内存，结束后源区间视为未初始化。
+    // 可平凡重定位的类型直接 memmove，允许区间重叠；其他类型逐个移动构造并销毁源对象，要求区间不重叠。
+    template <typename In, typename Out>
+    constexpr auto uninitialized_relocate(In first, In last, Out d_first) -> Out {
+        using T = std::iter_value_t<Out>;
+        if constexpr (_uninitialized_detail::relocatable<In, Out>) {
+            if (!std::is_constant_evaluated()) {
+                auto n = static_cast<size_t>(last - first);
+                if (n != 0) {
+                    std::memmove(static_cast<void*>(std::to_address(d_first)), static_cast<const void*>(std::to_address(first)), n * sizeof(T));
+                }
+                return d_first + n;
+            }
+        }
+        if constexpr (std::is_nothrow_move_constructible_v<T>) {
+            for (; first != last; ++first, ++d_first) {
+                ::new (_uninitialized_detail::voidify(*d_first)) T(std::move(*first));
+                std::destroy_at(std::addressof(*first));
+            }
+            return d_first;
+        } else {
+            // 移动构造可能抛出异常：先全部构造，成功后再销毁源区间。异常时目标区间已构造的对象被销毁，
+            // 源区间的对象都还在，但已被移动的元素处于移出后的状态
+            auto d_last = mtl::uninitialized_move(first, last, d_first);
+            mtl::destroy(first, last);
+            return d_last;
+        }
+    }
+
+    template <typename In, typename Size, typename Out>
+    constexpr auto uninitialized_relocate_n(In first, Size n, Out d_first) -> Out {
+        return mtl::uninitialized_relocate(first, std::next(first, n), d_first);
+    }
+
+    // 从后向前重定位，用于目标区间与源区间尾部重叠（向高地址搬移）的情况
+    template <typename In, typename Out>
+    constexpr auto uninitialized_relocate_backward(In first, In last, Out d_last) -> Out {
+        using T = std::iter_value_t<Out>;
+        if constexpr (_uninitialized_detail::relocatable<In, Out>) {
+            if (!std::is_constant_evaluated()) {
+                auto n = static_cast<size_t>(last - first);
+                if (n != 0) {
+                    std::memmove(static_cast<void*>(std::to_address(d_last - n)), static_cast<const void*>(std::to_address(first)), n * sizeof(T));
+                }
+                return d_last - n;
+            }
+        }
+        static_assert(_uninitialized_detail::relocatable<In, Out> || std::is_nothrow_move_constructible_v<T>, "overlapping relocation requires nothrow move construction");
+        while (last != first) {
+            --last;
+            --d_last;
+            ::new (_uninitialized_detail::voidify(*d_last)) T(std::move(*last));
+            std::destroy_at(std::addressof(*last));
+        }
+        return d_last;
+    }
+
+    // 可以拷贝时拷贝，否则移动（此时失败只保证源区间的对象依然有效）
+    template <typename T>
+    constexpr auto _uninitialized_copy_or_move(T* first, T* last, T* dst) -> T* {
+        if constexpr (std::is_copy_constructible_v<T>) {
+            return mtl::uninitialized_copy(first, last, dst);
+        } else {
+            return mtl::uninitialized_move(first, last, dst);
+        }
+    }
+
+    // 容器扩容时将 [first, last) 搬到新内存 dst。移动构造可能抛出异常时退化为拷贝，
+    // 全部构造成功后才销毁源区间，失败时源区间完好，保证强异常安全
+    template <typename T>
+    constexpr auto _relocate_if_noexcept(T* first, T* last, T* dst) -> T* {
+        if constexpr (is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>) {
+            return mtl::uninitialized_relocate(first, last, dst);
+        } else {
+            auto d_last = mtl::_uninitialized_copy_or_move(first, last, dst);
+            mtl::destroy(first, last);
+            return d_last;
+        }
+    }
+
+    // 容器扩容插入：先由 fill 在新内存 dst + idx 处构造 n 个元素（参数可能引用旧元素），再把旧元素 [first, last) 搬到它们两侧。
+    // 两侧都构造成功后才销毁旧元素；任何一步失败时旧元素完好，新内存中已构造的元素被销毁，新内存由调用者释放
+    template <typename T, typename F>
+    constexpr auto _relocate_with_gap(T* first, T* last, T* dst, size_t idx, size_t n, F&& fill) -> void {
+        fill(dst + idx);
+        if constexpr (is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>) {
+            mtl::uninitialized_relocate(first, first + idx, dst);
+            mtl::uninitialized_relocate(first + idx, last, dst + idx + n);
+        } else {
+            try {
+                mtl::_uninitialized_copy_or_move(first, first + idx, dst);
+                try {
+                    mtl::_uninitialized_copy_or_move(first + idx, last, dst + idx + n);
+                } catch (...) {
+                    mtl::destroy(dst, dst + idx);
+                    throw;
+                }
+            } catch (...) {
+                mtl::destroy(dst + idx, dst + idx + n);
+                throw;
+            }
+            mtl::destroy(first, last);
+        }
+    }
+}  // namespace mtl
@@ -0,0 +1,471 @@
+/*
+    https://timsong-cpp.github.io/cppwp/n4861/mem.res
+*/
+#pragma once
+#include "pool_allocator.hpp" // IWYU pragma: keep
+#include <atomic>
+#include <bit>
+#include <mutex>
+
+// memory resource
+namespace mtl {
+    class memory_resource {
+        static constexpr size_t max_align = alignof(std::max_align_t);
+
+      public:
+        memory_resource() = default;
+
+        memory_resource(const memory_resource &) = default;
+
+        virtual ~memory_resource() = default;
+
+        auto operator=(const memory_resource &) -> memory_resource & = default;
+
+      public:
+        [[nodiscard]] auto allocate(size_t bytes, size_t alignment = max_align) -> void * { return do_allocate(bytes, alignment); }
+
+        auto deallocate(void *p, size_t bytes, size_t alignment = max_align) -> void { do_deallocate(p, bytes, alignment); }
+
+        auto is_equal(const memory_resource &other) const noexcept -> bool { return do_is_equal(other); }
+
+      private:
+        virtual auto do_allocate(size_t bytes, size_t alignment) -> void * = 0;
+
+        virtual auto do_deallocate(void *p, size_t bytes, size_t alignment) -> void = 0;
+
+        virtual auto do_is_equal(const memory_resource &other) const noexcept -> bool = 0;
+    };
+
+    inline auto operator==(const memory_resource &lhs, const memory_resource &rhs) noexcept -> bool { return &lhs == &rhs || lhs.is_equal(rhs); }
+} // namespace mtl
+
+// 全局 memory resource
+namespace mtl {
+    class _new_delete_resource : public memory_resource {
+      private:
+        auto do_allocate(size_t bytes, size_t alignment) -> void * override { return ::operator new(bytes, std::align_val_t{alignment}); }
+
+        auto do_deallocate(void *p, size_t bytes, size_t alignment) -> void override { ::operator delete(p, bytes, std::align_val_t{alignment}); }
+
+        auto do_is_equal(const memory_resource &other) const noexcept -> bool override { return this == &other; }
+    };
+
+    class _null_memory_resource : public memory_resource {
+      private:
+        auto do_allocate(size_t, size_t) -> void * override { throw std::bad_alloc{}; }
+
+        auto do_deallocate(void *, size_t, size_t) -> void override {}
+
+        auto do_is_equal(const memory_resource &other) const noexcept -> bool override { return this == &other; }
+    };
+
+    // 两个全局对象均不析构，静态析构期间依然可用
+    inline auto new_delete_resource() noexcept -> memory_resource * {
+        static auto *r = new _new_delete_resource();
+        return r;
+    }
+
+    inline auto null_memory_resource() noexcept -> memory_resource * {
+        static auto *r = new _null_memory_resource();
+        return r;
+    }
+
+    inline auto _default_resource() noexcept -> std::atomic<memory_resource *> & {
+        static auto r = std::atomic<memory_resource *>{new_delete_resource()};
+        return r;
+    }
+
+    inline auto set_default_resource(memory_resource *r) noexcept -> memory_resource * {
+        return _default_resource().exchange(r ? r : new_delete_resource());
+    }
+
+    inline auto get_default_resource() noexcept -> memory_resource * { return _default_resource().load(); }
+} // namespace mtl
+
+// polymorphic allocator
+namespace mtl {
+    // 忽略 uses-allocator 构造，construct 交由 allocator_traits 默认实现
+    template <typename T = std::byte>
+    class polymorphic_allocator {
+      public:
+        using value_type = T;
+
+      public:
+        polymorphic_allocator() noexcept : m_res(get_default_resource()) {}
+
+        polymorphic_allocator(memory_resource *r) : m_res(r) {}
+
+        polymorphic_allocator(const polymorphic_allocator &) = default;
+
+        template <typename U>
+        polymorphic_allocator(const polymorphic_allocator<U> &other) noexcept : m_res(other.resource()) {}
+
+        auto operator=(const polymorphic_allocator &) -> polymorphic_allocator & = delete;
+
+      public:
+        [[nodiscard]] auto allocate(size_t n) -> T * {
+            if (std::numeric_limits<size_t>::max() / sizeof(T) < n) {
+                throw std::bad_array_new_length{};
+            }
+            return static_cast<T *>(m_res->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        auto deallocate(T *p, size_t n) -> void { m_res->deallocate(p, n * sizeof(T), alignof(T)); }
+
+        [[nodiscard]] auto allocate_bytes(size_t bytes, size_t alignment = alignof(std::max_align_t)) -> void * { return m_res->allocate(bytes, alignment); }
+
+        auto deallocate_bytes(void *p, size_t bytes, size_t alignment = alignof(std::max_align_t)) -> void { m_res->deallocate(p, bytes, alignment); }
+
+        template <typename U>
+        [[nodiscard]] auto allocate_object(size_t n = 1) -> U * {
+            if (std::numeric_limits<size_t>::max() / sizeof(U) < n) {
+                throw std::bad_array_new_length{};
+            }
+            return static_cast<U *>(allocate_bytes(n * sizeof(U), alignof(U)));
+        }
+
+        template <typename U>
+        auto deallocate_object(U *p, size_t n = 1) -> void { deallocate_bytes(p, n * sizeof(U), alignof(U)); }
+
+        template <typename U, typename... Args>
+        [[nodiscard]] auto new_object(Args &&...args) -> U * {
+            auto p = allocate_object<U>();
+            try {
+                std::construct_at(p, std::forward<Args>(args)...);
+            } catch (...) {
+                deallocate_object(p);
+                throw;
+            }
+            return p;
+        }
+
+        template <typename U>
+        auto delete_object(U *p) -> void {
+            std::destroy_at(p);
+            deallocate_object(p);
+        }
+
+        auto select_on_container_copy_construction() const -> polymorphic_allocator { return polymorphic_allocator(); }
+
+        auto resource() const -> memory_resource * { return m_res; }
+
+      public:
+        memory_resource *m_res;
+    };
+
+    template <typename T1, typename T2>
+    auto operator==(const polymorphic_allocator<T1> &lhs, const polymorphic_allocator<T2> &rhs) noexcept -> bool { return *lhs.resource() == *rhs.resource(); }
+} // namespace mtl
+
+// monotonic buffer resource
+namespace mtl {
+    // 单调增长的缓冲区：分配只移动指针，释放为空操作，所有内存在 release() 或析构时一次性归还上游。
+    // 当前缓冲区不足时向上游申请新的大块内存，大小按几何级数增长。
+    class monotonic_buffer_resource : public memory_resource {
+        // 大块内存头部，串成链表以便 release
+        struct chunk {
+            chunk *next;
+            size_t size;
+            size_t align;
+        };
+
+        static constexpr size_t default_size = 1024;
+        static constexpr size_t growth_factor = 2;
+
+      public:
+        monotonic_buffer_resource() : monotonic_buffer_resource(get_default_resource()) {}
+
+        explicit monotonic_buffer_resource(memory_resource *upstream) : monotonic_buffer_resource(default_size, upstream) {}
+
+        explicit monotonic_buffer_resource(size_t initial_size) : monotonic_buffer_resource(initial_size, get_default_resource()) {}
+
+        monotonic_buffer_resource(size_t initial_size, memory_resource *upstream)
+            : m_upstream(upstream), m_next_size(std::max<size_t>(initial_size, 1)) {}
+
+        monotonic_buffer_resource(void *buffer, size_t buffer_size) : monotonic_buffer_resource(buffer, buffer_size, get_default_resource()) {}
+
+        // 初始缓冲区（例如栈上数组）由调用者持有，用完后才向上游申请
+        monotonic_buffer_resource(void *buffer, size_t buffer_size, memory_resource *upstream)
+            : m_upstream(upstream),
+              m_cur(static_cast<char *>(buffer)),
+              m_end(static_cast<char *>(buffer) + buffer_size),
+              m_init_buf(static_cast<char *>(buffer)),
+              m_init_size(buffer_size),
+              m_next_size(std::max<size_t>(buffer_size * growth_factor, default_size)) {}
+
+        monotonic_buffer_resource(const monotonic_buffer_resource &) = delete;
+
+        ~monotonic_buffer_resource() override { release(); }
+
+        auto operator=(const monotonic_buffer_resource &) -> monotonic_buffer_resource & = delete;
+
+      public:
+        // 归还所有大块内存，复杂度 O(大块数量)
+        auto release() -> void {
+            while (m_chunks) {
+                auto next = m_chunks->next;
+                m_upstream->deallocate(m_chunks, m_chunks->size, m_chunks->align);
+                m_chunks = next;
+            }
+            m_cur = m_init_buf;
+            m_end = m_init_buf + m_init_size;
+        }
+
+        auto upstream_resource() const -> memory_resource * { return m_upstream; }
+
+      private:
+        auto do_allocate(size_t bytes, size_t alignment) -> void * final {
+            auto p = reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(m_cur) + alignment - 1) & ~(alignment - 1));
+            if (m_cur != nullptr && p <= m_end && bytes <= static_cast<size_t>(m_end - p)) [[likely]] {
+                m_cur = p + bytes;
+                return p;
+            }
+            return allocate_slow(bytes, alignment);
+        }
+
+        auto do_deallocate(void *, size_t, size_t) -> void final {}
+
+        auto do_is_equal(const memory_resource &other) const noexcept -> bool final { return this == &other; }
+
+        [[gnu::noinline]] auto allocate_slow(size_t bytes, size_t alignment) -> void * {
+            auto align = std::max(alignment, alignof(chunk));
+            auto head = (sizeof(chunk) + align - 1) / align * align; // 头部之后的首个对齐位置
+            auto size = std::max(m_next_size, head + bytes);
+            auto c = static_cast<chunk *>(m_upstream->allocate(size, align));
+            c->next = m_chunks;
+            c->size = size;
+            c->align = align;
+            m_chunks = c;
+            m_next_size = size * growth_factor;
+            auto p = reinterpret_cast<char *>(c) + head;
+            m_cur = p + bytes;
+            m_end = reinterpret_cast<char *>(c) + size;
+            return p;
+        }
+
+      public:
+        memory_resource *m_upstream;
+        char *m_cur{nullptr};
+        char *m_end{nullptr};
+        char *m_init_buf{nullptr};
+        size_t m_init_size{0};
+        size_t m_next_size;
+        chunk *m_chunks{nullptr};
+    };
+} // namespace mtl
+
+// pool resource
+namespace mtl {
+    struct pool_options {
+        size_t max_blocks_per_chunk = 0;        // 单个大块内存最多容纳的块数量，0 表示使用默认值
+        size_t largest_required_pool_block = 0; // 由池管理的最大块大小，更大的请求直接交给上游，0 表示使用默认值
+    };
+
+    // 按 2 的幂划分大小级别，每个级别一个空闲链表，大块内存中的块数量按几何级数增长。
+    // 超过最大级别的请求直接交给上游，并串成双向链表以便 release。
+    class unsynchronized_pool_resource : public memory_resource {
+        static constexpr size_t min_block = 8;
+        static constexpr size_t default_max_blocks = 1024;
+        static constexpr size_t default_largest_block = 4096;
+
+        // 大块内存尾部，块从大块内存的起始处按块大小排列，保证块按 min(块大小, 大块对齐) 对齐
+        struct chunk {
+            chunk *next;
+            size_t size;
+        };
+
+        struct bucket {
+            _pool_free_node *free{nullptr};
+            chunk *chunks{nullptr};
+            size_t block_size{0};
+            size_t next_blocks{8};
+        };
+
+        // 直接交给上游的大对象头部
+        struct large {
+            large *prev;
+            large *next;
+            size_t size;
+            size_t align;
+        };
+
+      public:
+        unsynchronized_pool_resource() : unsynchronized_pool_resource(pool_options{}, get_default_resource()) {}
+
+        explicit unsynchronized_pool_resource(memory_resource *upstream) : unsynchronized_pool_resource(pool_options{}, upstream) {}
+
+        explicit unsynchronized_pool_resource(const pool_options &opts) : unsynchronized_pool_resource(opts, get_default_resource()) {}
+
+        unsynchronized_pool_resource(const pool_options &opts, memory_resource *upstream) : m_upstream(upstream) {
+            m_opts.max_blocks_per_chunk = opts.max_blocks_per_chunk ? opts.max_blocks_per_chunk : default_max_blocks;
+            m_opts.largest_required_pool_block = std::bit_ceil(std::max(opts.largest_required_pool_block ? opts.largest_required_pool_block : default_largest_block, min_block));
+            m_bucket_count = bucket_index(m_opts.largest_required_pool_block) + 1;
+            m_buckets = new bucket[m_bucket_count];
+            for (auto i = size_t{0}; i < m_bucket_count; ++i) {
+                m_buckets[i].block_size = min_block << i;
+            }
+        }
+
+        unsynchronized_pool_resource(const unsynchronized_pool_resource &) = delete;
+
+        ~unsynchronized_pool_resource() override {
+            release();
+            delete[] m_buckets;
+        }
+
+        auto operator=(const unsynchronized_pool_resource &) -> unsynchronized_pool_resource & = delete;
+
+      public:
+        auto release() -> void {
+            for (auto i = size_t{0}; i < m_bucket_count; ++i) {
+                auto &b = m_buckets[i];
+                while (b.chunks) {
+                    auto c = b.chunks;
+                    b.chunks = c->next;
+                    m_upstream->deallocate(reinterpret_cast<char *>(c) + sizeof(chunk) - c->size, c->size, b.block_size);
+                }
+                b.free = nullptr;
+                b.next_blocks = 8;
+            }
+            while (m_large) {
+                auto l = m_large;
+                m_large = l->next;
+                m_upstream->deallocate(l, l->size, l->align);
+            }
+        }
+
+        auto upstream_resource() const -> memory_resource * { return m_upstream; }
+
+        auto options() const -> pool_options { return m_opts; }
+
+      private:
+        static auto bucket_index(size_t size) -> size_t { return std::bit_width(std::max(size, min_block) - 1) - std::bit_width(min_block - 1); }
+
+        auto do_allocate(size_t bytes, size_t alignment) -> void * override {
+            auto size = std::max(bytes, alignment);
+            if (size > m_opts.largest_required_pool_block) {
+                return allocate_large(bytes, alignment);
+            }
+            auto &b = m_buckets[bucket_index(size)];
+            if (b.free == nullptr) {
+                refill(b);
+            }
+            auto node = b.free;
+            b.free = node->next;
+            return node;
+        }
+
+        auto do_deallocate(void *p, size_t bytes, size_t alignment) -> void override {
+            auto size = std::max(bytes, alignment);
+            if (size > m_opts.largest_required_pool_block) {
+                deallocate_large(p, alignment);
+                return;
+            }
+            auto &b = m_buckets[bucket_index(size)];
+            auto node = static_cast<_pool_free_node *>(p);
+            node->next = b.free;
+            b.free = node;
+        }
+
+        auto do_is_equal(const memory_resource &other) const noexcept -> bool override { return this == &other; }
+
+        auto refill(bucket &b) -> void {
+            auto blocks = b.next_blocks;
+            auto size = blocks * b.block_size + sizeof(chunk);
+            auto mem = static_cast<char *>(m_upstream->allocate(size, b.block_size));
+            auto c = reinterpret_cast<chunk *>(mem + blocks * b.block_size);
+            c->next = b.chunks;
+            c->size = size;
+            b.chunks = c;
+            for (auto i = blocks; i > 0; --i) {
+                auto node = reinterpret_cast<_pool_free_node *>(mem + (i - 1) * b.block_size);
+                node->next = b.free;
+                b.free = node;
+            }
+            b.next_blocks = std::min(blocks * 2, m_opts.max_blocks_per_chunk);
+        }
+
+        static auto large_head(size_t alignment) -> size_t {
+            auto align = std::max(alignment, alignof(large));
+            return (sizeof(large) + align - 1) / align * align;
+        }
+
+        auto allocate_large(size_t bytes, size_t alignment) -> void * {
+            auto align = std::max(alignment, alignof(large));
+            auto head = large_head(alignment);
+            auto l = static_cast<large *>(m_upstream->allocate(head + bytes, align));
+            l->prev = nullptr;
+            l->next = m_large;
+            l->size = head + bytes;
+            l->align = align;
+            if (m_large) {
+                m_large->prev = l;
+            }
+            m_large = l;
+            return reinterpret_cast<char *>(l) + head;
+        }
+
+        auto deallocate_large(void *p, size_t alignment) -> void {
+            auto l = reinterpret_cast<large *>(static_cast<char *>(p) - large_head(alignment));
+            if (l->prev) {
+                l->prev->next = l->next;
+            } else {
+                m_large = l->next;
+            }
+            if (l->next) {
+                l->next->prev = l->prev;
+            }
+            m_upstream->deallocate(l, l->size, l->align);
+        }
+
+      public:
+        memory_resource *m_upstream;
+        pool_options m_opts;
+        bucket *m_buckets{nullptr};
+        size_t m_bucket_count{0};
+        large *m_large{nullptr};
+    };
+
+    // 以互斥锁保护 unsynchronized_pool_resource
+    class synchronized_pool_resource : public memory_resource {
+      public:
+        synchronized_pool_resource() = default;
+
+        explicit synchronized_pool_resource(memory_resource *upstream) : m_pool(upstream) {}
+
+        explicit synchronized_pool_resource(const pool_options &opts) : m_pool(opts) {}
+
+        synchronized_pool_resource(const pool_options &opts, memory_resource *upstream) : m_pool(opts, upstream) {}
+
+        synchronized_pool_resource(const synchronized_pool_resource &) = delete;
+
+        auto operator=(const synchronized_pool_resource &) -> synchronized_pool_resource & = delete;
+
+      public:
+        auto release() -> void {
+            auto lock = std::lock_guard{m_mut};
+            m_pool.release();
+        }
+
+        auto upstream_resource() const -> memory_resource * { return m_pool.upstream_resource(); }
+
+        auto options() const -> pool_options { return m_pool.options(); }
+
+      private:
+        auto do_allocate(size_t bytes, size_t alignment) -> void * override {
+            auto lock = std::lock_guard{m_mut};
+            return m_pool.allocate(bytes, alignment);
+        }
+
+        auto do_deallocate(void *p, size_t bytes, size_t alignment) -> void override {
+            auto lock = std::lock_guard{m_mut};
+            m_pool.deallocate(p, bytes, alignment);
+        }
+
+        auto do_is_equal(const memory_resource &other) const noexcept -> bool override { return this == &other; }
+
+      public:
+        unsynchronized_pool_resource m_pool;
+        std::mutex m_mut;
+    };
+} // namespace mtl
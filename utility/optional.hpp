@@ -328,4 +328,11 @@ namespace mtl {
 
     template <typename T, typename U, typename... Args>
     constexpr auto make_optional(std::initializer_list<U> lst, Args &&...args) -> optional<T> { return {in_place, lst, std::forward<Args>(args)...}; }
-} // namespace mtl
\ No newline at end of file
+} // namespace mtl
+
+// trivially relocatable
+namespace mtl {
+    // 值存放在堆上，optional 只持有指针
+    template <typename T>
+    struct is_trivially_relocatable<optional<T>> : public std::true_type {};
+} // namespace mtl
@@ -235,4 +235,10 @@ namespace mtl {
             return p.second;
         }
     }
-} // namespace mtl
\ No newline at end of file
+} // namespace mtl
+
+// trivially relocatable
+namespace mtl {
+    template <typename T1, typename T2>
+    struct is_trivially_relocatable<pair<T1, T2>> : public std::bool_constant<is_trivially_relocatable_v<T1> && is_trivially_relocatable_v<T2>> {};
+} // namespace mtl
@@ -0,0 +1,231 @@
+/*
+    固定大小内存池分配器
+    https://en.wikipedia.org/wiki/Free_list
+    http://www.boost.org/doc/libs/release/libs/pool/doc/html/index.html
+*/
+#pragma once
+#include "memory.hpp" // IWYU pragma: keep
+#include <algorithm>
+#include <mutex>
+#include <new>
+
+// pool 上游
+namespace mtl {
+    // 空闲槽位直接复用为链表节点
+    struct _pool_free_node {
+        _pool_free_node *next;
+    };
+
+    // 所有线程共享的上游，以 (SlotSize, Align, ChunkSize) 区分。
+    // 线程缓存不足时从这里批量取出槽位，缓存过多或线程退出时批量归还，跨线程释放的槽位最终也会经由这里回到其他线程。
+    // 大块内存只申请不归还：上游对象本身也不析构，保证静态析构期间依然可以安全释放槽位。
+    template <size_t SlotSize, size_t Align, size_t ChunkSize>
+    class _pool_upstream {
+        static_assert(SlotSize >= sizeof(_pool_free_node) && SlotSize % Align == 0);
+        static_assert(ChunkSize >= SlotSize);
+
+      public:
+        static auto instance() -> _pool_upstream & {
+            static auto *p = new _pool_upstream();
+            return *p;
+        }
+
+      public:
+        // 取出至多 n 个槽位，以链表形式返回，count 为实际取出的数量
+        auto acquire(size_t n, size_t &count) -> _pool_free_node * {
+            auto lock = std::lock_guard{m_mut};
+            auto head = static_cast<_pool_free_node *>(nullptr);
+            count = 0;
+            while (count < n && m_free) {
+                auto node = m_free;
+                m_free = node->next;
+                node->next = head;
+                head = node;
+                ++count;
+            }
+            while (count < n) {
+                if (m_cur == m_end) {
+                    m_cur = static_cast<char *>(::operator new(ChunkSize, std::align_val_t{Align}));
+                    m_end = m_cur + ChunkSize / SlotSize * SlotSize;
+                }
+                auto node = reinterpret_cast<_pool_free_node *>(m_cur);
+                m_cur += SlotSize;
+                node->next = head;
+                head = node;
+                ++count;
+            }
+            return head;
+        }
+
+        // 归还链表 [first, last] 中的槽位
+        auto release(_pool_free_node *first, _pool_free_node *last) -> void {
+            auto lock = std::lock_guard{m_mut};
+            last->next = m_free;
+            m_free = first;
+        }
+
+      public:
+        std::mutex m_mut;
+        _pool_free_node *m_free{nullptr};
+        char *m_cur{nullptr};
+        char *m_end{nullptr};
+    };
+} // namespace mtl
+
+// pool 线程缓存
+namespace mtl {
+    template <size_t SlotSize, size_t Align, size_t ChunkSize>
+    class _pool_resource {
+        using upstream = _pool_upstream<SlotSize, Align, ChunkSize>;
+
+        // 单次和上游交换的槽位数量，线程缓存最多保留两倍
+        static constexpr size_t batch = std::clamp<size_t>(ChunkSize / SlotSize / 4, 1, 64);
+
+        // 平凡析构，线程退出后（例如静态析构期间）依然可以访问
+        struct cache {
+            _pool_free_node *head;
+            size_t count;
+            bool registered;
+            bool dead;
+        };
+
+        // 线程退出时将缓存归还上游
+        struct cache_guard {
+            ~cache_guard() {
+                flush(m_cache);
+                m_cache.dead = true;
+            }
+        };
+
+        static inline thread_local cache m_cache{};
+        static inline thread_local cache_guard m_guard{};
+
+      public:
+        static auto allocate() -> void * {
+            auto &c = m_cache;
+            if (c.head) [[likely]] {
+                auto node = c.head;
+                c.head = node->next;
+                --c.count;
+                return node;
+            }
+            return refill(c);
+        }
+
+        static auto deallocate(void *p) noexcept -> void {
+            auto &c = m_cache;
+            auto node = static_cast<_pool_free_node *>(p);
+            if (c.dead) [[unlikely]] {
+                upstream::instance().release(node, node);
+                return;
+            }
+            if (!c.registered) [[unlikely]] {
+                enroll(c);
+            }
+            node->next = c.head;
+            c.head = node;
+            if (++c.count > 2 * batch) [[unlikely]] {
+                drain(c, batch);
+            }
+        }
+
+      private:
+        static auto enroll(cache &c) -> void {
+            static_cast<void>(&m_guard); // 访问 thread_local 对象以触发其构造
+            c.registered = true;
+        }
+
+        static auto refill(cache &c) -> void * {
+            auto count = size_t{0};
+            if (c.dead) [[unlikely]] {
+                return upstream::instance().acquire(1, count);
+            }
+            if (!c.registered) [[unlikely]] {
+                enroll(c);
+            }
+            auto node = upstream::instance().acquire(batch, count);
+            c.head = node->next;
+            c.count = count - 1;
+            return node;
+        }
+
+        // 从缓存头部取出 n 个槽位归还上游
+        static auto drain(cache &c, size_t n) -> void {
+            if (n == 0 || c.head == nullptr) {
+                return;
+            }
+            auto first = c.head;
+            auto last = first;
+            for (auto i = size_t{1}; i < n && last->next; ++i) {
+                last = last->next;
+                --c.count;
+            }
+            --c.count;
+            c.head = last->next;
+            upstream::instance().release(first, last);
+        }
+
+        static auto flush(cache &c) -> void { drain(c, c.count); }
+    };
+} // namespace mtl
+
+// pool allocator
+namespace mtl {
+    // 固定大小槽位的空闲链表分配器。
+    // 只有单个对象的分配走内存池，数组分配或槽位过大时退化为 ::operator new。
+    // BlockSize 为每次向系统申请的大块内存字节数。
+    template <typename T, size_t BlockSize = 64 * 1024>
+    class pool_allocator {
+        static constexpr size_t _align = std::max(alignof(T), alignof(_pool_free_node));
+        static constexpr size_t _slot_size = (std::max(sizeof(T), sizeof(_pool_free_node)) + _align - 1) / _align * _align;
+        static constexpr bool _use_pool = _slot_size * 8 <= BlockSize;
+
+        using _resource = _pool_resource<_slot_size, _align, BlockSize>;
+
+      public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        template <typename U>
+        struct rebind {
+            using other = pool_allocator<U, BlockSize>;
+        };
+
+      public:
+        constexpr pool_allocator() noexcept = default;
+
+        constexpr pool_allocator(const pool_allocator &) noexcept = default;
+
+        template <typename U>
+        constexpr pool_allocator(const pool_allocator<U, BlockSize> &) noexcept {}
+
+      public:
+        [[nodiscard]] auto allocate(size_t n) -> T * {
+            if constexpr (_use_pool) {
+                if (n == 1) [[likely]] {
+                    return static_cast<T *>(_resource::allocate());
+                }
+            }
+            if (std::numeric_limits<size_t>::max() / sizeof(T) < n) {
+                throw std::bad_array_new_length{};
+            }
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+        }
+
+        auto deallocate(T *p, size_t n) noexcept -> void {
+            if constexpr (_use_pool) {
+                if (n == 1) [[likely]] {
+                    _resource::deallocate(p);
+                    return;
+                }
+            }
+            ::operator delete(p, std::align_val_t{alignof(T)});
+        }
+    };
+
+    template <typename T, typename U, size_t BlockSize>
+    constexpr auto operator==(const pool_allocator<T, BlockSize> &, const pool_allocator<U, BlockSize> &) noexcept -> bool { return true; }
+} // namespace mtl
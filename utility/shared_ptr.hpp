@@ -1,8 +1,11 @@
 #pragma once
+#include "pool_allocator.hpp"
 #include "unique_ptr.hpp"
 #include "utility.hpp"
+#include <atomic>
+#include <cstdint>
 #include <functional>
-#include <mutex>
+#include <utility>
 
 namespace mtl {
     struct bad_weak_ptr : public std::exception {};
@@ -23,30 +26,40 @@ namespace mtl {
         template <typename Y>
         _shared_ptr_ctlblk(Y *p) : _shared_ptr_ctlblk() { ptr = p; }
 
+        // 控制块大小固定，从内存池分配
       public:
-        auto inc_s() {
-            auto lock = std::lock_guard{m_mut};
-            ++s_count;
+        static auto operator new(size_t) -> void * { return pool_allocator<_shared_ptr_ctlblk>{}.allocate(1); }
+
+        static auto operator delete(void *p) noexcept -> void { pool_allocator<_shared_ptr_ctlblk>{}.deallocate(static_cast<_shared_ptr_ctlblk *>(p), 1); }
+
+      // 计数都是原子变量，增加计数不需要同步其他内存，减少到零时需要看到其他线程对对象的全部修改
+      public:
+        auto inc_s(size_t n = 1) { s_count.fetch_add(n, std::memory_order_relaxed); }
+
+        // 仍有 shared_ptr 时增加计数，用于从 weak_ptr 得到 shared_ptr
+        auto try_inc_s() -> bool {
+            auto c = s_count.load(std::memory_order_relaxed);
+            do {
+                if (c == 0) {
+                    return false;
+                }
+            } while (!s_count.compare_exchange_weak(c, c + 1, std::memory_order_relaxed));
+            return true;
         }
 
         auto dec_s() {
-            auto lock = std::lock_guard{m_mut};
-            if (--s_count == 0 && ptr) {
-                del(ptr);
-                if (w_count == 0) {
-                    delete this;
+            if (s_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                if (ptr) {
+                    del(ptr);
                 }
+                dec_w();
             }
         }
 
-        auto inc_w() {
-            auto lock = std::lock_guard{m_mut};
-            ++w_count;
-        }
+        auto inc_w() { w_count.fetch_add(1, std::memory_order_relaxed); }
 
         auto dec_w() {
-            auto lock = std::lock_guard{m_mut};
-            if (--w_count == 0 && s_count == 0) {
+            if (w_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
                 delete this;
             }
         }
@@ -54,9 +67,8 @@ namespace mtl {
       public:
         element_type *ptr;
         deleter del;
-        size_t s_count{0};
-        size_t w_count{0};
-        std::mutex m_mut; // 保证 inc 和 dec 为原子操作
+        std::atomic<size_t> s_count{0};
+        std::atomic<size_t> w_count{1}; // 所有 shared_ptr 共同持有一个弱引用，最后一个 shared_ptr 删除对象后释放它
     };
 } // namespace mtl
 
@@ -147,20 +159,25 @@ namespace mtl {
         // modfier
       public:
         auto swap(weak_ptr &w) noexcept {
-            std::swap(w.m_ctlblk, m_ctlblk); // mutex 不需要且不能交换
+            std::swap(w.m_ctlblk, m_ctlblk);
         }
 
         auto reset() noexcept { weak_ptr().swap(*this); }
 
         // observer
       public:
-        auto use_count() const noexcept -> size_t { return m_ctlblk == nullptr ? 0 : m_ctlblk->s_count; }
+        auto use_count() const noexcept -> size_t { return m_ctlblk == nullptr ? 0 : m_ctlblk->s_count.load(std::memory_order_relaxed); }
 
         auto expired() const noexcept -> bool { return use_count() == 0; }
 
+        // 检查与增加计数是同一次 CAS，不会与最后一个 shared_ptr 的析构竞争
         auto lock() const noexcept -> shared_ptr<T> {
-            auto lock = std::lock_guard{m_mut};
-            return expired() ? shared_ptr<T>() : shared_ptr<T>(*this);
+            auto s = shared_ptr<T>();
+            if (m_ctlblk && m_ctlblk->try_inc_s()) {
+                s.m_ctlblk = m_ctlblk;
+                s.m_ptr = m_ctlblk->ptr;
+            }
+            return s;
         }
 
         template <typename U>
@@ -171,7 +188,6 @@ namespace mtl {
 
       public:
         _shared_ptr_ctlblk<T> *m_ctlblk{nullptr};
-        std::mutex m_mut; // 确保 lock() 原子执行
     };
 } // namespace mtl
 
@@ -217,8 +233,17 @@ namespace mtl {
                      requires { D{}(std::declval<U *>()); } &&
                      (std::is_convertible_v<U (*)[], T *> ||
                       std::is_convertible_v<U *, T *>))
-        shared_ptr(U *p, D d) : shared_ptr(p) {
-            m_ctlblk->del = [d = std::move(d)](T *p) { d(p); };
+        // 与标准一致，构造失败时通过 d(p) 释放对象，不会落到默认删除器上
+        shared_ptr(U *p, D d) {
+            auto del = typename _shared_ptr_ctlblk<T>::deleter();
+            try {
+                del = [d](T *p) { d(p); };
+                shared_ptr(p).swap(*this);
+            } catch (...) {
+                d(p);
+                throw;
+            }
+            m_ctlblk->del = std::move(del);
         }
 
         template <typename U, typename D, typename A>
@@ -237,7 +262,8 @@ namespace mtl {
                 m_ctlblk->dec_s();
             }
             m_ctlblk = s.m_ctlblk;
-            s.m_ptr = s.m_ctlblk = nullptr;
+            s.m_ptr = nullptr;
+            s.m_ctlblk = nullptr;
         }
 
         template <typename U>
@@ -259,7 +285,8 @@ namespace mtl {
                 m_ctlblk->dec_s();
             }
             m_ctlblk = s.m_ctlblk;
-            s.m_ptr = s.m_ctlblk = nullptr;
+            s.m_ptr = nullptr;
+            s.m_ctlblk = nullptr;
         }
 
         shared_ptr(shared_ptr &&s) noexcept : m_ptr(s.m_ptr) {
@@ -267,17 +294,17 @@ namespace mtl {
                 m_ctlblk->dec_s();
             }
             m_ctlblk = s.m_ctlblk;
-            s.m_ptr = s.m_ctlblk = nullptr;
+            s.m_ptr = nullptr;
+            s.m_ctlblk = nullptr;
         }
 
         template <typename U>
         shared_ptr(const weak_ptr<U> &w) {
-            if (w.expired()) {
+            if (w.m_ctlblk == nullptr || !w.m_ctlblk->try_inc_s()) {
                 throw bad_weak_ptr();
             }
             m_ctlblk = w.m_ctlblk;
             m_ptr = m_ctlblk->ptr;
-            m_ctlblk->inc_s();
         }
 
         template <typename U, typename D>
@@ -344,7 +371,7 @@ namespace mtl {
 
         auto get() const noexcept -> element_type * { return m_ptr; }
 
-        auto use_count() const noexcept -> size_t { return m_ctlblk == nullptr ? 0 : m_ctlblk->s_count; }
+        auto use_count() const noexcept -> size_t { return m_ctlblk == nullptr ? 0 : m_ctlblk->s_count.load(std::memory_order_relaxed); }
 
         template <typename U>
         auto owner_before(const shared_ptr<U> &s) const noexcept -> bool { return m_ctlblk == s.m_ctlblk; }
@@ -401,4 +428,151 @@ namespace mtl {
       public:
         mutable weak_ptr<T> m_this;
     };
-} // namespace mtl
\ No newline at end of file
+} // namespace mtl
+
+// atomic<shared_ptr>
+namespace mtl {
+    // 只为 shared_ptr 提供特化，其他类型使用 std::atomic
+    template <typename T>
+    class atomic;
+
+    // 无锁的 atomic<shared_ptr>，使用分离引用计数：
+    // 存放的 64 位字中，低 48 位是控制块指针，高 16 位是局部计数。
+    // load 先对整个字 fetch_add 一个局部计数「借用」当前的控制块，此时控制块不会被释放；再增加控制块的全局计数得到自己的引用；
+    // 最后通过 CAS 把借用的局部计数还回去。如果期间控制块已被替换，替换者已把它看到的局部计数全部转为全局计数，
+    // 借用者改为减少一次全局计数。局部计数可以互相替代，总数始终守恒。
+    // 简化：shared_ptr 的 get() 需要与控制块管理的指针相同，不支持别名构造的 shared_ptr
+    template <typename T>
+    class atomic<shared_ptr<T>> {
+        using ctlblk = _shared_ptr_ctlblk<T>;
+
+        static_assert(sizeof(void *) == 8, "控制块指针与局部计数打包在 64 位字中");
+
+        static constexpr int count_shift = 48;
+        static constexpr uint64_t count_one = uint64_t{1} << count_shift;
+        static constexpr uint64_t ptr_mask = count_one - 1;
+
+      public:
+        using value_type = shared_ptr<T>;
+
+        static constexpr bool is_always_lock_free = std::atomic<uint64_t>::is_always_lock_free;
+
+      public:
+        constexpr atomic() noexcept = default;
+
+        atomic(shared_ptr<T> s) noexcept : m_word(adopt(s)) {}
+
+        atomic(const atomic &) = delete;
+
+        auto operator=(const atomic &) -> atomic & = delete;
+
+        ~atomic() {
+            if (auto c = unpack(m_word.load(std::memory_order_relaxed))) {
+                c->dec_s();
+            }
+        }
+
+      public:
+        auto is_lock_free() const noexcept -> bool { return is_always_lock_free; }
+
+        auto load(std::memory_order = std::memory_order_seq_cst) const noexcept -> shared_ptr<T> {
+            return take_borrowed(m_word.fetch_add(count_one, std::memory_order_acquire) + count_one);
+        }
+
+        operator shared_ptr<T>() const noexcept { return load(); }
+
+        auto store(shared_ptr<T> s, std::memory_order = std::memory_order_seq_cst) noexcept -> void { exchange(std::move(s)).reset(); }
+
+        auto operator=(shared_ptr<T> s) noexcept -> void { store(std::move(s)); }
+
+        auto exchange(shared_ptr<T> s, std::memory_order = std::memory_order_seq_cst) noexcept -> shared_ptr<T> {
+            auto w = m_word.exchange(adopt(s), std::memory_order_acq_rel);
+            return retire(w);
+        }
+
+        // 比较控制块。失败时 expected 被更新为当前值
+        auto compare_exchange_strong(shared_ptr<T> &expected, shared_ptr<T> desired, std::memory_order = std::memory_order_seq_cst) noexcept -> bool {
+            auto cur = m_word.load(std::memory_order_acquire);
+            while (true) {
+                if (unpack(cur) == expected.m_ctlblk) {
+                    // 局部计数变化也会导致 CAS 失败，此时重试
+                    if (m_word.compare_exchange_weak(cur, reinterpret_cast<uint64_t>(desired.m_ctlblk), std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        desired.m_ctlblk = nullptr;
+                        desired.m_ptr = nullptr;
+                        retire(cur);
+                        return true;
+                    }
+                } else if (m_word.compare_exchange_weak(cur, cur + count_one, std::memory_order_acquire)) {
+                    // 从导致失败的那个字借用引用，而不是重新 load：重新读到的值可能又等于 expected
+                    expected = take_borrowed(cur + count_one);
+                    return false;
+                }
+            }
+        }
+
+        auto compare_exchange_weak(shared_ptr<T> &expected, shared_ptr<T> desired, std::memory_order order = std::memory_order_seq_cst) noexcept -> bool {
+            return compare_exchange_strong(expected, std::move(desired), order);
+        }
+
+      private:
+        static auto unpack(uint64_t w) noexcept -> ctlblk * { return reinterpret_cast<ctlblk *>(w & ptr_mask); }
+
+        // w 是已包含本次借用的局部计数的字：增加全局计数得到自己的引用，再归还借用
+        auto take_borrowed(uint64_t w) const noexcept -> shared_ptr<T> {
+            auto c = unpack(w);
+            auto s = shared_ptr<T>();
+            if (c) {
+                c->inc_s();
+                s.m_ctlblk = c;
+                s.m_ptr = c->ptr;
+            }
+            // 归还借用：控制块未变且局部计数不为零时减少局部计数，否则借用已被转为全局计数
+            auto cur = w;
+            while (unpack(cur) == c && (cur >> count_shift) != 0) {
+                if (m_word.compare_exchange_weak(cur, cur - count_one, std::memory_order_relaxed)) {
+                    return s;
+                }
+            }
+            if (c) {
+                c->dec_s();
+            }
+            return s;
+        }
+
+        // 接管 s 的引用，返回打包后的字
+        static auto adopt(shared_ptr<T> &s) noexcept -> uint64_t {
+            s.m_ptr = nullptr;
+            return reinterpret_cast<uint64_t>(std::exchange(s.m_ctlblk, nullptr));
+        }
+
+        // 被替换下来的字：局部计数转为全局计数，存放时持有的引用交给返回值
+        static auto retire(uint64_t w) noexcept -> shared_ptr<T> {
+            auto c = unpack(w);
+            auto s = shared_ptr<T>();
+            if (c) {
+                if (auto borrowed = w >> count_shift) {
+                    c->inc_s(borrowed);
+                }
+                s.m_ctlblk = c;
+                s.m_ptr = c->ptr;
+            }
+            return s;
+        }
+
+      public:
+        mutable std::atomic<uint64_t> m_word{0};
+    };
+
+    template <typename T>
+    using atomic_shared_ptr = atomic<shared_ptr<T>>;
+} // namespace mtl
+
+// trivially relocatable
+namespace mtl {
+    // 只持有两个指针，引用计数保存在控制块中，搬移时无需修改
+    template <typename T>
+    struct is_trivially_relocatable<shared_ptr<T>> : public std::true_type {};
+
+    template <typename T>
+    struct is_trivially_relocatable<weak_ptr<T>> : public std::true_type {};
+} // namespace mtl
@@ -294,4 +294,10 @@ namespace mtl {
 
     template <typename... Tups>
     constexpr auto tuple_cat(Tups&&... tups) -> decltype(auto) { return _tuple_tuple_cat_impl(std::forward<Tups>(tups)...); }
-}  // namespace mtl
\ No newline at end of file
+}  // namespace mtl
+
+// trivially relocatable
+namespace mtl {
+    template <typename... Types>
+    struct is_trivially_relocatable<tuple<Types...>> : public std::bool_constant<(is_trivially_relocatable_v<Types> && ...)> {};
+}  // namespace mtl
@@ -353,4 +353,11 @@ template <typename T>
 auto make_unique_for_overwrite(size_t n) -> unique_ptr<T> {
     return unique_ptr<T>(new std::remove_extent_t<T>[n]);
 }
-} // namespace mtl
\ No newline at end of file
+} // namespace mtl
+
+// trivially relocatable
+namespace mtl {
+template <typename T, typename D>
+struct is_trivially_relocatable<unique_ptr<T, D>>
+    : public std::bool_constant<is_trivially_relocatable_v<typename unique_ptr<T, D>::pointer> && is_trivially_relocatable_v<D>> {};
+} // namespace mtl
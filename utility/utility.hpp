@@ -45,8 +45,8 @@ namespace mtl {
             } else if (lhs > rhs) {
                 return std::weak_ordering::greater;
             }
+            return std::weak_ordering::equivalent;
         }
-        return std::weak_ordering::equivalent;
     };
 
     template <typename T1, typename T2>
@@ -94,6 +94,20 @@ namespace mtl {
     class function;
 } // namespace mtl
 
+// trivially relocatable
+namespace mtl {
+    // 可平凡重定位：可以用 memcpy 将对象搬到新地址，且之后不再对源对象调用析构函数。
+    // 平凡可复制类型天然满足，其他类型（例如只持有指针的句柄类型）可通过特化自行声明。
+    template <typename T>
+    struct is_trivially_relocatable : public std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+    template <typename T>
+    struct is_trivially_relocatable<const T> : public is_trivially_relocatable<T> {};
+
+    template <typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+} // namespace mtl
+
 // tuple size
 namespace mtl {
     template <typename>
@@ -114,12 +114,13 @@ namespace mtl {
         }
     }
 
+    // 在未构造的存储上原地构造
     template <size_t Idx, typename... Types, typename... Args>
-    constexpr auto _varaint_data_assign(_variant_data<Types...>& v, Args&&... args) {
+    constexpr auto _variant_data_construct(_variant_data<Types...>& v, Args&&... args) {
         if constexpr (Idx == 0) {
             std::construct_at(&v.val, std::forward<Args>(args)...);
         } else {
-            _variant_data_assign<Idx - 1>(v.next, std::forward<Args>(args)...);
+            _variant_data_construct<Idx - 1>(v.next, std::forward<Args>(args)...);
         }
     }
 
@@ -211,16 +212,16 @@ namespace mtl {
     constexpr auto get(const variant<Types...>&& v) -> const nth_type_t<Idx, Types...>&& { return std::move(_variant_data_get<Idx>(v.m_data)); }
 
     template <typename T, typename... Types, size_t Idx = type_idx_v<T, Types...>>
-    constexpr auto get(variant<Types...>& v) -> T& { return get(v); }
+    constexpr auto get(variant<Types...>& v) -> T& { return get<Idx>(v); }
 
     template <typename T, typename... Types, size_t Idx = type_idx_v<T, Types...>>
-    constexpr auto get(const variant<Types...>& v) -> const T& { return get(v); }
+    constexpr auto get(const variant<Types...>& v) -> const T& { return get<Idx>(v); }
 
     template <typename T, typename... Types, size_t Idx = type_idx_v<T, Types...>>
-    constexpr auto get(variant<Types...>&& v) -> T&& { return std::move(get(v)); }
+    constexpr auto get(variant<Types...>&& v) -> T&& { return std::move(get<Idx>(v)); }
 
     template <typename T, typename... Types, size_t Idx = type_idx_v<T, Types...>>
-    constexpr auto get(const variant<Types...>&& v) -> const T&& { return std::move(get(v)); }
+    constexpr auto get(const variant<Types...>&& v) -> const T&& { return std::move(get<Idx>(v)); }
 }  // namespace mtl
 
 // variant
@@ -241,12 +242,12 @@ namespace mtl {
         template <typename T, typename Ti = _variant_accept_t<T, Types...>, size_t Idx = type_idx_v<Ti, Types...>>
         requires(sizeof...(Types) > 0 && !std::is_same_v<std::remove_cvref_t<T>, variant>)
         constexpr variant(T&& t)
-            : m_idx(Idx) { _variant_data_assign<Idx>(m_data, std::forward<T>(t)); }
+            : m_idx(Idx) { _variant_data_construct<Idx>(m_data, std::forward<T>(t)); }
 
         template <typename T, typename... Args, size_t Idx = type_idx_v<T, Types...>>
         requires(std::is_constructible_v<T, Args...>)
         constexpr explicit variant(in_place_type_t<T>, Args&&... args)
-            : m_idx(Idx) { _variant_data_assign<Idx>(m_data, std::forward<Args>(args)...); }
+            : m_idx(Idx) { _variant_data_construct<Idx>(m_data, std::forward<Args>(args)...); }
 
         template <typename T, typename U, typename... Args, size_t Idx = type_idx_v<T, Types...>>
         requires(std::is_constructible_v<T, std::initializer_list<U>, Args...>)
@@ -256,7 +257,7 @@ namespace mtl {
         template <size_t Idx, typename... Args>
         requires(Idx < sizeof...(Types))
         constexpr explicit variant(in_place_index_t<Idx>, Args&&... args)
-            : m_idx(Idx) { _variant_data_assign<Idx>(m_data, std::forward<Args>(args)...); }
+            : m_idx(Idx) { _variant_data_construct<Idx>(m_data, std::forward<Args>(args)...); }
 
         template <size_t Idx, typename U, typename... Args>
         requires(Idx < sizeof...(Types))
@@ -304,7 +305,7 @@ namespace mtl {
         template <size_t Idx, typename... Args>
         constexpr auto emplace(Args&&... args) -> nth_type_t<Idx, Types...>& {
             _variant_destroy();
-            _variant_data_assign<Idx>(m_data, std::forward<Args>(args)...);
+            _variant_data_construct<Idx>(m_data, std::forward<Args>(args)...);
             m_idx = Idx;
             return get<Idx>(*this);
         }
@@ -474,4 +475,9 @@ namespace mtl {
         auto dispatcher = _variant_get_dispatch(_variant_dispatchers<F, Variants...>, variants.index()...);
         return dispatcher(std::forward<F>(f), std::forward<Variants>(variants)...);
     }
-}  // namespace mtl
\ No newline at end of file
+}  // namespace mtl
+// trivially relocatable
+namespace mtl {
+    template <typename... Types>
+    struct is_trivially_relocatable<variant<Types...>> : public std::bool_constant<(is_trivially_relocatable_v<Types> && ...)> {};
+}  // namespace mtl